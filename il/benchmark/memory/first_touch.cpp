@@ -0,0 +1,116 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+//
+// Compile with
+// g++ -std=c++11 -O3 -march=native -fopenmp -DIL_OPENMP -DNDEBUG
+//     first_touch.cpp -o first_touch -lpthread -lbenchmark
+//
+// On a multi-socket machine, run it with all the cores, for instance with
+// OMP_NUM_THREADS=64 OMP_PROC_BIND=spread ./first_touch
+//
+// The arrays initialized serially have all their pages on the NUMA node of
+// the main thread, and the triad is limited by the bandwidth of a single
+// socket. The arrays initialized with il::parallel have their pages spread
+// among the sockets in the same way as the triad loop, which uses the same
+// static schedule.
+
+#include <benchmark/benchmark.h>
+
+#include <il/Array.h>
+#include <il/Array2D.h>
+
+static void Triad_Serial(benchmark::State& state) {
+  const il::int_t n = state.range(0);
+  il::Array<double> a{n, 0.0};
+  il::Array<double> b{n, 1.0};
+  il::Array<double> c{n, 2.0};
+  const double alpha = 3.0;
+  while (state.KeepRunning()) {
+#pragma omp parallel for schedule(static)
+    for (il::int_t i = 0; i < n; ++i) {
+      a[i] = b[i] + alpha * c[i];
+    }
+    benchmark::DoNotOptimize(a.data());
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * 3 * n *
+                          sizeof(double));
+}
+
+static void Triad_FirstTouch(benchmark::State& state) {
+  const il::int_t n = state.range(0);
+  il::Array<double> a{n, 0.0, il::parallel};
+  il::Array<double> b{n, 1.0, il::parallel};
+  il::Array<double> c{n, 2.0, il::parallel};
+  const double alpha = 3.0;
+  while (state.KeepRunning()) {
+#pragma omp parallel for schedule(static)
+    for (il::int_t i = 0; i < n; ++i) {
+      a[i] = b[i] + alpha * c[i];
+    }
+    benchmark::DoNotOptimize(a.data());
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * 3 * n *
+                          sizeof(double));
+}
+
+static void MatrixVector_Serial(benchmark::State& state) {
+  const il::int_t n = state.range(0);
+  il::Array2D<double> A{n, n, 1.0};
+  il::Array<double> x{n, 1.0};
+  il::Array<double> y{n, 0.0};
+  while (state.KeepRunning()) {
+#pragma omp parallel for schedule(static)
+    for (il::int_t i1 = 0; i1 < n; ++i1) {
+      double sum = 0.0;
+      for (il::int_t i0 = 0; i0 < n; ++i0) {
+        sum += A(i0, i1) * x[i0];
+      }
+      y[i1] = sum;
+    }
+    benchmark::DoNotOptimize(y.data());
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * n * n *
+                          sizeof(double));
+}
+
+static void MatrixVector_FirstTouch(benchmark::State& state) {
+  const il::int_t n = state.range(0);
+  il::Array2D<double> A{n, n, 1.0, il::parallel};
+  il::Array<double> x{n, 1.0};
+  il::Array<double> y{n, 0.0};
+  while (state.KeepRunning()) {
+#pragma omp parallel for schedule(static)
+    for (il::int_t i1 = 0; i1 < n; ++i1) {
+      double sum = 0.0;
+      for (il::int_t i0 = 0; i0 < n; ++i0) {
+        sum += A(i0, i1) * x[i0];
+      }
+      y[i1] = sum;
+    }
+    benchmark::DoNotOptimize(y.data());
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * n * n *
+                          sizeof(double));
+}
+
+BENCHMARK(Triad_Serial)->Arg(1 << 24)->Arg(1 << 26)->UseRealTime();
+BENCHMARK(Triad_FirstTouch)->Arg(1 << 24)->Arg(1 << 26)->UseRealTime();
+BENCHMARK(MatrixVector_Serial)->Arg(4096)->Arg(16384)->UseRealTime();
+BENCHMARK(MatrixVector_FirstTouch)->Arg(4096)->Arg(16384)->UseRealTime();
+
+BENCHMARK_MAIN()
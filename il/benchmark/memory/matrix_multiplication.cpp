@@ -20,6 +20,8 @@
 
 #include <immintrin.h>
 
+#include <benchmark/benchmark.h>
+
 namespace il {
 
 void matrix_multiplication_0(const il::Array2C<double> &A,
@@ -159,7 +161,7 @@ void matrix_multiplication_5(const il::Array2C<double> &A,
   IL_EXPECT_FAST(C.size(1) == B.size(1));
   IL_EXPECT_FAST(A.size(1) == B.size(0));
 
-  aux_matrix_multiplication(A.data(), B.data(), C.data(), A.size(0), A.size(1),
+  aux_matrix_multiplication(A.data(), B.data(), C.Data(), A.size(0), A.size(1),
                             B.size(1), A.capacity(1), B.capacity(1),
                             C.capacity(1));
 }
@@ -239,4 +241,266 @@ void matrix_multiplication_6(const il::Array2C<double> &A,
     }
   }
 }
+
+void transpose(const il::Array2D<double> &A, il::Array2D<double> &B) {
+  IL_EXPECT_FAST(B.size(0) == A.size(1));
+  IL_EXPECT_FAST(B.size(1) == A.size(0));
+
+  for (il::int_t i1 = 0; i1 < A.size(1); ++i1) {
+    for (il::int_t i0 = 0; i0 < A.size(0); ++i0) {
+      B(i1, i0) = A(i0, i1);
+    }
+  }
+}
+
+void transpose(const il::Array2C<double> &A, il::Array2C<double> &B) {
+  IL_EXPECT_FAST(B.size(0) == A.size(1));
+  IL_EXPECT_FAST(B.size(1) == A.size(0));
+
+  for (il::int_t i0 = 0; i0 < A.size(0); ++i0) {
+    for (il::int_t i1 = 0; i1 < A.size(1); ++i1) {
+      B(i1, i0) = A(i0, i1);
+    }
+  }
+}
+
+// Every tile is transposed in the L1 cache
+void transpose(const il::Array2Tiled32 &A, il::Array2Tiled32 &B) {
+  IL_EXPECT_FAST(B.size(0) == A.size(1));
+  IL_EXPECT_FAST(B.size(1) == A.size(0));
+
+  for (il::int_t b1 = 0; b1 < A.nbTiles(1); ++b1) {
+    for (il::int_t b0 = 0; b0 < A.nbTiles(0); ++b0) {
+      il::Array2DView<double> a = A.tile(b0, b1);
+      il::Array2DEdit<double> b = B.Tile(b1, b0);
+      for (il::int_t j1 = 0; j1 < a.size(1); ++j1) {
+        for (il::int_t j0 = 0; j0 < a.size(0); ++j0) {
+          b(j1, j0) = a(j0, j1);
+        }
+      }
+    }
+  }
+}
+
+void stencil(const il::Array2D<double> &A, il::Array2D<double> &B) {
+  IL_EXPECT_FAST(B.size(0) == A.size(0));
+  IL_EXPECT_FAST(B.size(1) == A.size(1));
+
+  for (il::int_t i1 = 1; i1 < A.size(1) - 1; ++i1) {
+    for (il::int_t i0 = 1; i0 < A.size(0) - 1; ++i0) {
+      B(i0, i1) = A(i0 - 1, i1) + A(i0 + 1, i1) + A(i0, i1 - 1) +
+                  A(i0, i1 + 1) - 4.0 * A(i0, i1);
+    }
+  }
+}
+
+void stencil(const il::Array2C<double> &A, il::Array2C<double> &B) {
+  IL_EXPECT_FAST(B.size(0) == A.size(0));
+  IL_EXPECT_FAST(B.size(1) == A.size(1));
+
+  for (il::int_t i0 = 1; i0 < A.size(0) - 1; ++i0) {
+    for (il::int_t i1 = 1; i1 < A.size(1) - 1; ++i1) {
+      B(i0, i1) = A(i0 - 1, i1) + A(i0 + 1, i1) + A(i0, i1 - 1) +
+                  A(i0, i1 + 1) - 4.0 * A(i0, i1);
+    }
+  }
+}
+
+// The neighbours of the elements inside a tile are in the same tile, and
+// this loop is vectorized. The elements on the border of a tile read their
+// neighbours in the adjacent tiles.
+static double tiledElement(const il::Array2Tiled32 &A, il::int_t b0,
+                           il::int_t b1, il::int_t j0, il::int_t j1) {
+  const il::int_t t = 32;
+  if (j0 < 0) {
+    --b0;
+    j0 += t;
+  } else if (j0 >= t) {
+    ++b0;
+    j0 -= t;
+  }
+  if (j1 < 0) {
+    --b1;
+    j1 += t;
+  } else if (j1 >= t) {
+    ++b1;
+    j1 -= t;
+  }
+  return A.data()[(b1 * A.nbTiles(0) + b0) * il::Array2Tiled32::tile_size +
+                  j1 * t + j0];
+}
+
+static double stencilElement(const il::Array2Tiled32 &A, il::int_t b0,
+                             il::int_t b1, il::int_t j0, il::int_t j1) {
+  return tiledElement(A, b0, b1, j0 - 1, j1) +
+         tiledElement(A, b0, b1, j0 + 1, j1) +
+         tiledElement(A, b0, b1, j0, j1 - 1) +
+         tiledElement(A, b0, b1, j0, j1 + 1) -
+         4.0 * tiledElement(A, b0, b1, j0, j1);
+}
+
+void stencil(const il::Array2Tiled32 &A, il::Array2Tiled32 &B) {
+  IL_EXPECT_FAST(B.size(0) == A.size(0));
+  IL_EXPECT_FAST(B.size(1) == A.size(1));
+
+  const il::int_t n0 = A.size(0);
+  const il::int_t n1 = A.size(1);
+  const il::int_t t = 32;
+  for (il::int_t b1 = 0; b1 < A.nbTiles(1); ++b1) {
+    for (il::int_t b0 = 0; b0 < A.nbTiles(0); ++b0) {
+      const double *a = A.tile(b0, b1).data();
+      double *b = B.Tile(b0, b1).Data();
+      const il::int_t m0 = il::min(t, n0 - b0 * t);
+      const il::int_t m1 = il::min(t, n1 - b1 * t);
+      for (il::int_t j1 = 0; j1 < m1; ++j1) {
+        const il::int_t i1 = b1 * t + j1;
+        if (i1 == 0 || i1 == n1 - 1) {
+          continue;
+        }
+        if (j1 == 0 || j1 == m1 - 1) {
+          for (il::int_t j0 = 0; j0 < m0; ++j0) {
+            const il::int_t i0 = b0 * t + j0;
+            if (i0 > 0 && i0 < n0 - 1) {
+              b[j1 * t + j0] = stencilElement(A, b0, b1, j0, j1);
+            }
+          }
+          continue;
+        }
+        const il::int_t i0_first = b0 * t;
+        const il::int_t i0_last = b0 * t + m0 - 1;
+        if (i0_first > 0 && i0_first < n0 - 1) {
+          b[j1 * t] = stencilElement(A, b0, b1, 0, j1);
+        }
+        if (i0_last > 0 && i0_last < n0 - 1) {
+          b[j1 * t + m0 - 1] = stencilElement(A, b0, b1, m0 - 1, j1);
+        }
+        for (il::int_t j0 = 1; j0 < m0 - 1; ++j0) {
+          b[j1 * t + j0] = a[j1 * t + j0 - 1] + a[j1 * t + j0 + 1] +
+                           a[(j1 - 1) * t + j0] + a[(j1 + 1) * t + j0] -
+                           4.0 * a[j1 * t + j0];
+        }
+      }
+    }
+  }
+}
+
+// The three kernels add A.B to C
+void matrix_multiplication(const il::Array2D<double> &A,
+                           const il::Array2D<double> &B,
+                           il::Array2D<double> &C) {
+  IL_EXPECT_FAST(C.size(0) == A.size(0));
+  IL_EXPECT_FAST(C.size(1) == B.size(1));
+  IL_EXPECT_FAST(A.size(1) == B.size(0));
+
+  for (il::int_t j = 0; j < C.size(1); ++j) {
+    for (il::int_t k = 0; k < A.size(1); ++k) {
+      const double b = B(k, j);
+      for (il::int_t i = 0; i < C.size(0); ++i) {
+        C(i, j) += A(i, k) * b;
+      }
+    }
+  }
+}
+
+void matrix_multiplication(const il::Array2C<double> &A,
+                           const il::Array2C<double> &B,
+                           il::Array2C<double> &C) {
+  IL_EXPECT_FAST(C.size(0) == A.size(0));
+  IL_EXPECT_FAST(C.size(1) == B.size(1));
+  IL_EXPECT_FAST(A.size(1) == B.size(0));
+
+  for (il::int_t i = 0; i < C.size(0); ++i) {
+    for (il::int_t k = 0; k < A.size(1); ++k) {
+      const double a = A(i, k);
+      for (il::int_t j = 0; j < C.size(1); ++j) {
+        C(i, j) += a * B(k, j);
+      }
+    }
+  }
+}
+
+void matrix_multiplication(const il::Array2Tiled32 &A,
+                           const il::Array2Tiled32 &B, il::Array2Tiled32 &C) {
+  IL_EXPECT_FAST(C.size(0) == A.size(0));
+  IL_EXPECT_FAST(C.size(1) == B.size(1));
+  IL_EXPECT_FAST(A.size(1) == B.size(0));
+
+  for (il::int_t b1 = 0; b1 < C.nbTiles(1); ++b1) {
+    for (il::int_t b0 = 0; b0 < C.nbTiles(0); ++b0) {
+      il::Array2DEdit<double> c = C.Tile(b0, b1);
+      for (il::int_t bk = 0; bk < A.nbTiles(1); ++bk) {
+        il::Array2DView<double> a = A.tile(b0, bk);
+        il::Array2DView<double> b = B.tile(bk, b1);
+        for (il::int_t j = 0; j < c.size(1); ++j) {
+          for (il::int_t k = 0; k < a.size(1); ++k) {
+            const double b_kj = b(k, j);
+            for (il::int_t i = 0; i < c.size(0); ++i) {
+              c(i, j) += a(i, k) * b_kj;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
 }  // namespace il
+
+////////////////////////////////////////////////////////////////////////////////
+// Layout benchmark
+////////////////////////////////////////////////////////////////////////////////
+//
+// Compile with
+// g++ -std=c++11 -O3 -march=native -DNDEBUG
+//     matrix_multiplication.cpp -o matrix_multiplication -lpthread -lbenchmark
+
+template <typename M>
+static void Transpose(benchmark::State &state) {
+  const il::int_t n = state.range(0);
+  const M A{n, n, 1.0};
+  M B{n, n, 0.0};
+  while (state.KeepRunning()) {
+    il::transpose(A, B);
+    benchmark::DoNotOptimize(B.data());
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * 2 * n * n *
+                          sizeof(double));
+}
+
+template <typename M>
+static void Stencil(benchmark::State &state) {
+  const il::int_t n = state.range(0);
+  const M A{n, n, 1.0};
+  M B{n, n, 0.0};
+  while (state.KeepRunning()) {
+    il::stencil(A, B);
+    benchmark::DoNotOptimize(B.data());
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * 2 * n * n *
+                          sizeof(double));
+}
+
+template <typename M>
+static void MatrixMultiplication(benchmark::State &state) {
+  const il::int_t n = state.range(0);
+  const M A{n, n, 1.0};
+  const M B{n, n, 1.0};
+  M C{n, n, 0.0};
+  while (state.KeepRunning()) {
+    il::matrix_multiplication(A, B, C);
+    benchmark::DoNotOptimize(C.data());
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * 2 * n * n * n);
+}
+
+BENCHMARK_TEMPLATE(Transpose, il::Array2D<double>)->Arg(1024)->Arg(4096);
+BENCHMARK_TEMPLATE(Transpose, il::Array2C<double>)->Arg(1024)->Arg(4096);
+BENCHMARK_TEMPLATE(Transpose, il::Array2Tiled32)->Arg(1024)->Arg(4096);
+BENCHMARK_TEMPLATE(Stencil, il::Array2D<double>)->Arg(1024)->Arg(4096);
+BENCHMARK_TEMPLATE(Stencil, il::Array2C<double>)->Arg(1024)->Arg(4096);
+BENCHMARK_TEMPLATE(Stencil, il::Array2Tiled32)->Arg(1024)->Arg(4096);
+BENCHMARK_TEMPLATE(MatrixMultiplication, il::Array2D<double>)->Arg(1024);
+BENCHMARK_TEMPLATE(MatrixMultiplication, il::Array2C<double>)->Arg(1024);
+BENCHMARK_TEMPLATE(MatrixMultiplication, il::Array2Tiled32)->Arg(1024);
+
+BENCHMARK_MAIN()
@@ -20,6 +20,8 @@
 #define IL_MATRIX_MULTIPLICATION_H
 
 #include <il/Array2C.h>
+#include <il/Array2D.h>
+#include <il/Array2Tiled.h>
 
 namespace il {
 
@@ -45,6 +47,27 @@ void matrix_multiplication_6(const il::Array2C<double> &A,
                              const il::Array2C<double> &B,
                              il::Array2C<double> &C);
 
+// The same kernels on column-major, row-major and tiled storage, to compare
+// the layouts. The tiles of 32 x 32 doubles take 8 KiB.
+using Array2Tiled32 = il::Array2Tiled<double, 32, 32>;
+
+void transpose(const il::Array2D<double> &A, il::Array2D<double> &B);
+void transpose(const il::Array2C<double> &A, il::Array2C<double> &B);
+void transpose(const il::Array2Tiled32 &A, il::Array2Tiled32 &B);
+
+void stencil(const il::Array2D<double> &A, il::Array2D<double> &B);
+void stencil(const il::Array2C<double> &A, il::Array2C<double> &B);
+void stencil(const il::Array2Tiled32 &A, il::Array2Tiled32 &B);
+
+void matrix_multiplication(const il::Array2D<double> &A,
+                           const il::Array2D<double> &B,
+                           il::Array2D<double> &C);
+void matrix_multiplication(const il::Array2C<double> &A,
+                           const il::Array2C<double> &B,
+                           il::Array2C<double> &C);
+void matrix_multiplication(const il::Array2Tiled32 &A,
+                           const il::Array2Tiled32 &B, il::Array2Tiled32 &C);
+
 }  // namespace il
 
 #endif  // IL_MATRIX_MULTIPLICATION_H
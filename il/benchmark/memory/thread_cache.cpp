@@ -0,0 +1,107 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+//
+// Compile with
+// g++ -std=c++11 -O3 -march=native -DNDEBUG
+//     thread_cache.cpp -o thread_cache -lpthread -lbenchmark
+//
+// Every thread creates and destroys small containers in a loop, and the
+// benchmark reports the number of allocations per second for all the threads.
+// The Default benchmarks use il::allocateArray without any allocator scope,
+// which goes to std::malloc, or to the thread caches of the pool allocator
+// when compiled with -DIL_THREAD_CACHE. The Pool benchmarks always use the
+// pool allocator, with an il::AllocatorScope.
+
+#include <cstdlib>
+
+#include <benchmark/benchmark.h>
+
+#include <il/Array.h>
+#include <il/Map.h>
+#include <il/String.h>
+#include <il/core/memory/Pool.h>
+
+// Creates 4 arrays of 2 to 1024 elements and a map holding a few strings that
+// do not fit in the small buffer
+static void CreateContainers(il::int_t seed) {
+  for (il::int_t k = 0; k < 4; ++k) {
+    const il::int_t n = static_cast<il::int_t>(2) << ((seed + 3 * k) % 10);
+    il::Array<double> v{n, il::uninitialized};
+    v[0] = 0.0;
+    benchmark::DoNotOptimize(v.data());
+  }
+  il::Map<il::String, il::int_t> map{4};
+  for (il::int_t k = 0; k < 4; ++k) {
+    il::String key{"A key that does not fit in the small buffer: "};
+    key.Append(static_cast<char>('a' + (seed + k) % 26));
+    map.Set(key, k);
+  }
+  benchmark::DoNotOptimize(map.nbElements());
+}
+
+// Allocator that counts the allocations and reallocations of its scope
+class CountingAllocator : public il::Allocator {
+ public:
+  il::int_t nb_allocations = 0;
+  void* Allocate(std::size_t n_bytes) override {
+    ++nb_allocations;
+    return std::malloc(n_bytes);
+  }
+  void Deallocate(void* p, std::size_t) override { std::free(p); }
+  void* Reallocate(void* p, std::size_t, std::size_t n_bytes) override {
+    ++nb_allocations;
+    return std::realloc(p, n_bytes);
+  }
+};
+
+// The number of allocations made by CreateContainers, counted once at startup
+// so that it stays right when the containers change
+static il::int_t countAllocations() {
+  CountingAllocator allocator{};
+  {
+    il::AllocatorScope scope{allocator};
+    CreateContainers(0);
+  }
+  return allocator.nb_allocations;
+}
+
+static const il::int_t nb_allocations = countAllocations();
+
+static void Containers_Default(benchmark::State& state) {
+  il::int_t seed = 0;
+  while (state.KeepRunning()) {
+    CreateContainers(seed);
+    ++seed;
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * nb_allocations);
+}
+
+static void Containers_Pool(benchmark::State& state) {
+  il::AllocatorScope scope{il::poolAllocator()};
+  il::int_t seed = 0;
+  while (state.KeepRunning()) {
+    CreateContainers(seed);
+    ++seed;
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * nb_allocations);
+}
+
+BENCHMARK(Containers_Default)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(Containers_Pool)->ThreadRange(1, 64)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -25,11 +25,15 @@
 #include <initializer_list>
 // <new> is needed for placement new
 #include <new>
+// <type_traits> is needed for std::is_trivial
+#include <type_traits>
 // <utility> is needed for std::move
 #include <utility>
 
 #include <il/container/1d/ArrayView.h>
+#include <il/container/expression/Expression.h>
 #include <il/core/memory/allocate.h>
+#include <il/core/thread/parallel.h>
 
 namespace il {
 
@@ -69,6 +73,15 @@ class Array {
   */
   explicit Array(il::int_t n);
 
+  /* \brief Construct an array of n elements without initializing them
+  // \details When T is trivial, the elements are left uninitialized, even in
+  // debug mode. It should be used for arrays that are overwritten right after
+  // their construction. Otherwise, the elements are default constructed.
+  //
+  // il::Array<double> v{n, il::uninitialized};
+  */
+  explicit Array(il::int_t n, il::uninitialized_t);
+
   /* \brief Construct an aligned array of n elements
   // \details The pointer data, when considered as an integer, satisfies
   // data_ = 0 (Modulo align_mod)
@@ -89,6 +102,26 @@ class Array {
   */
   explicit Array(il::int_t n, const T& x);
 
+  /* \brief Construct an array of n elements with a value, in parallel
+  // \details The elements are initialized by il::parallelForStatic, which
+  // splits them in il::nbThreads() contiguous chunks as an OpenMP loop with a
+  // static schedule on all the threads. As a page of memory is placed on the
+  // NUMA node of the thread that first touches it, the array gets distributed
+  // among the sockets in the same way as the loops on [0, n) that use the
+  // same static schedule, with no chunk size and the default number of
+  // threads, or il::parallelForStatic. Other schedules, or il::parallelFor
+  // which uses fewer threads on small ranges, do not get local memory. Arrays
+  // with less than a page of memory per thread are initialized by the calling
+  // thread. All the members taking il::parallel use the same chunks.
+  //
+  // il::Array<double> v{n, 0.0, il::parallel};
+  // #pragma omp parallel for schedule(static)
+  // for (il::int_t i = 0; i < n; ++i) {
+  //   v[i] += ...;
+  // }
+  */
+  explicit Array(il::int_t n, const T& x, il::parallel_t);
+
   template <typename... Args>
   explicit Array(il::int_t n, il::emplace_t, Args&&... args);
 
@@ -122,6 +155,14 @@ class Array {
   */
   Array(const Array<T>& v);
 
+  /* \brief The copy constructor, in parallel
+  // \details The elements are copied by il::parallelForStatic. The constructed
+  // array is the same as the one given by the copy constructor.
+  //
+  // il::Array<double> w{v, il::parallel};
+  */
+  Array(const Array<T>& v, il::parallel_t);
+
   /* \brief The move constructor
    */
   Array(Array<T>&& v);
@@ -137,6 +178,25 @@ class Array {
    */
   Array& operator=(Array<T>&& v);
 
+  /* \brief The copy assignment, in parallel
+  // \details The elements are copied by il::parallelForStatic. The array ends
+  // up in the same state as with the copy assignment.
+  */
+  void Assign(const Array<T>& v, il::parallel_t);
+
+  /* \brief Evaluate an expression
+  // \details The array takes the size of the expression and keeps its
+  // alignment, and all its elements are computed in a single loop. When the
+  // size does not change, the elements are written in place: an operand may be
+  // this array itself, but not a view of it with shifted indices. See
+  // <il/expression.h>.
+  //
+  // il::Array<double> z{};
+  // z = a * x + b * y + c;
+  */
+  template <typename E>
+  Array& operator=(const il::Expression<E>& expression);
+
   /* \brief The destructor
    */
   ~Array();
@@ -163,6 +223,10 @@ class Array {
 
   void Set(const T& x);
 
+  /* \brief Set all the elements of the array to x, in parallel
+   */
+  void Set(const T& x, il::parallel_t);
+
   /* \brief Accessor to the last element of a const il::Array<T>
   // \details In debug mode, calling this method on an array of size 0 aborts
   // the program. In release mode, it will lead to undefined behavior.
@@ -197,8 +261,22 @@ class Array {
   */
   void Resize(il::int_t n);
 
+  /* \brief Resizing an il::Array<T> without initializing the new elements
+  // \details When T is trivial, the new elements are left uninitialized, even
+  // in debug mode. Otherwise, they are default constructed.
+  */
+  void Resize(il::int_t n, il::uninitialized_t);
+
   void Resize(il::int_t n, const T& x);
 
+  /* \brief Resizing an il::Array<T>, the new elements being set to x in
+  // parallel
+  // \details The new elements are initialized by il::parallelForStatic on
+  // [0, n) when T is trivial. Otherwise, this method is the same as
+  // Resize(n, x).
+  */
+  void Resize(il::int_t n, const T& x, il::parallel_t);
+
   template <typename... Args>
   void Resize(il::int_t n, il::emplace_t, Args&&... args);
 
@@ -231,6 +309,15 @@ class Array {
   template <typename... Args>
   void Append(il::emplace_t, Args&&... args);
 
+  /* \brief Insert an element at position i, the elements that follow being
+  // shifted to the right
+  // \details Reallocation is done only if it is needed. In case reallocation
+  // happens, then new capacity is roughly 2 times the previous capacity.
+  */
+  void Insert(il::int_t i, const T& x);
+
+  void Insert(il::int_t i, T&& x);
+
   /* \brief Get the alignment of the pointer returned by data()
    */
   il::int_t alignment() const;
@@ -265,6 +352,12 @@ class Array {
    */
   void IncreaseCapacity(il::int_t r);
 
+  /* \brief Used internally by Resize
+  // \details The new elements are initialized, as in Resize(n), unless
+  // initialize is false and T is trivial
+  */
+  void SetSize(il::int_t n, bool initialize);
+
   /* \brief Used internally in debug mode to check the invariance of the object
    */
   bool invariance() const;
@@ -341,10 +434,11 @@ Array<T>::Array(il::int_t n, il::align_t, il::int_t alignment,
     }
 #endif
   } else {
+    // The alignment is kept for the memory allocated by Reserve or Append
     data_ = nullptr;
-    alignment_ = 0;
-    align_r_ = 0;
-    align_mod_ = 0;
+    alignment_ = static_cast<short>(alignment);
+    align_r_ = static_cast<short>(align_r);
+    align_mod_ = static_cast<short>(align_mod);
     shift_ = 0;
   }
   size_ = data_ + n;
@@ -375,6 +469,36 @@ Array<T>::Array(il::int_t n, const T& x) {
   shift_ = 0;
 }
 
+template <typename T>
+Array<T>::Array(il::int_t n, il::uninitialized_t) : Array{} {
+  SetSize(n, false);
+}
+
+template <typename T>
+Array<T>::Array(il::int_t n, const T& x, il::parallel_t) {
+  IL_EXPECT_FAST(n >= 0);
+
+  if (n > 0) {
+    data_ = il::allocateArray<T>(n);
+    T* const data = data_;
+    il::parallelForStatic(
+        0, n, il::pageGrain<T>(),
+        [data, &x](il::int_t i_begin, il::int_t i_end) {
+          for (il::int_t i = i_begin; i < i_end; ++i) {
+            new (data + i) T(x);
+          }
+        });
+  } else {
+    data_ = nullptr;
+  }
+  size_ = data_ + n;
+  capacity_ = data_ + n;
+  alignment_ = 0;
+  align_r_ = 0;
+  align_mod_ = 0;
+  shift_ = 0;
+}
+
 template <typename T>
 template <typename... Args>
 Array<T>::Array(il::int_t n, il::emplace_t, Args&&... args) {
@@ -426,10 +550,11 @@ Array<T>::Array(il::int_t n, const T& x, il::align_t, il::int_t alignment,
       data_[i] = x;
     }
   } else {
+    // The alignment is kept for the memory allocated by Reserve or Append
     data_ = nullptr;
-    alignment_ = 0;
-    align_r_ = 0;
-    align_mod_ = 0;
+    alignment_ = static_cast<short>(alignment);
+    align_r_ = static_cast<short>(align_r);
+    align_mod_ = static_cast<short>(align_mod);
     shift_ = 0;
   }
   size_ = data_ + n;
@@ -519,6 +644,44 @@ Array<T>::Array(const Array<T>& v) {
   capacity_ = data_ + n;
 }
 
+template <typename T>
+Array<T>::Array(const Array<T>& v, il::parallel_t) {
+  const il::int_t n = v.size();
+  const il::int_t alignment = v.alignment_;
+  const il::int_t align_r = v.align_r_;
+  const il::int_t align_mod = v.align_mod_;
+  if (alignment == 0) {
+    data_ = il::allocateArray<T>(n);
+    alignment_ = 0;
+    align_r_ = 0;
+    align_mod_ = 0;
+    shift_ = 0;
+  } else {
+    il::int_t shift;
+    data_ = il::allocateArray<T>(n, align_r, align_mod, il::io, shift);
+    alignment_ = static_cast<short>(alignment);
+    align_r_ = static_cast<short>(align_r);
+    align_mod_ = static_cast<short>(align_mod);
+    shift_ = static_cast<short>(shift);
+  }
+  T* const data = data_;
+  const T* const v_data = v.data_;
+  il::parallelForStatic(
+      0, n, il::pageGrain<T>(),
+      [data, v_data](il::int_t i_begin, il::int_t i_end) {
+        if (il::isTrivial<T>::value) {
+          memcpy(data + i_begin, v_data + i_begin,
+                 (i_end - i_begin) * sizeof(T));
+        } else {
+          for (il::int_t i = i_begin; i < i_end; ++i) {
+            new (data + i) T(v_data[i]);
+          }
+        }
+      });
+  size_ = data_ + n;
+  capacity_ = data_ + n;
+}
+
 template <typename T>
 Array<T>::Array(Array<T>&& v) {
   data_ = v.data_;
@@ -628,6 +791,69 @@ Array<T>& Array<T>::operator=(Array<T>&& v) {
   return *this;
 }
 
+template <typename T>
+void Array<T>::Assign(const Array<T>& v, il::parallel_t) {
+  if (this == &v) {
+    return;
+  }
+
+  const il::int_t n = v.size();
+  const bool needs_memory = n > capacity() || alignment_ != v.alignment_ ||
+                            align_r_ != v.align_r_ ||
+                            align_mod_ != v.align_mod_;
+  if (needs_memory) {
+    *this = il::Array<T>{v, il::parallel};
+    return;
+  }
+
+  // The elements below n_old are assigned, the ones above are constructed
+  T* const data = data_;
+  const T* const v_data = v.data_;
+  const il::int_t n_old = size();
+  il::parallelForStatic(
+      0, n, il::pageGrain<T>(),
+      [data, v_data, n_old](il::int_t i_begin, il::int_t i_end) {
+        if (il::isTrivial<T>::value) {
+          memcpy(data + i_begin, v_data + i_begin,
+                 (i_end - i_begin) * sizeof(T));
+        } else {
+          for (il::int_t i = i_begin; i < i_end; ++i) {
+            if (i < n_old) {
+              data[i] = v_data[i];
+            } else {
+              new (data + i) T(v_data[i]);
+            }
+          }
+        }
+      });
+  if (!il::isTrivial<T>::value) {
+    for (il::int_t i = n_old - 1; i >= n; --i) {
+      (data_ + i)->~T();
+    }
+  }
+  size_ = data_ + n;
+}
+
+template <typename T>
+template <typename E>
+Array<T>& Array<T>::operator=(const il::Expression<E>& expression) {
+  static_assert(E::rank == 1, "il::Array<T>: expression must be of rank 1");
+  const il::int_t n = expression.derived().size(0);
+  if (n == size()) {
+    il::evaluate(expression, n, il::io, data_);
+  } else {
+    // The expression might read the elements of this array
+    il::Array<T> v{};
+    v.alignment_ = alignment_;
+    v.align_r_ = align_r_;
+    v.align_mod_ = align_mod_;
+    v.Resize(n, il::uninitialized);
+    il::evaluate(expression, n, il::io, v.data_);
+    *this = std::move(v);
+  }
+  return *this;
+}
+
 template <typename T>
 Array<T>::~Array() {
   IL_EXPECT_FAST_NOTHROW(invariance());
@@ -665,6 +891,18 @@ void Array<T>::Set(const T& x) {
   }
 }
 
+template <typename T>
+void Array<T>::Set(const T& x, il::parallel_t) {
+  T* const data = data_;
+  il::parallelForStatic(
+      0, size(), il::pageGrain<T>(),
+      [data, &x](il::int_t i_begin, il::int_t i_end) {
+        for (il::int_t i = i_begin; i < i_end; ++i) {
+          data[i] = x;
+        }
+      });
+}
+
 template <typename T>
 const T& Array<T>::back() const {
   IL_EXPECT_MEDIUM(size() > 0);
@@ -686,21 +924,35 @@ il::int_t Array<T>::size() const {
 
 template <typename T>
 void Array<T>::Resize(il::int_t n) {
+  SetSize(n, true);
+}
+
+template <typename T>
+void Array<T>::Resize(il::int_t n, il::uninitialized_t) {
+  SetSize(n, false);
+}
+
+template <typename T>
+void Array<T>::SetSize(il::int_t n, bool initialize) {
   IL_EXPECT_FAST(n >= 0);
 
   if (n <= capacity()) {
     if (il::isTrivial<T>::value) {
 #ifdef IL_DEFAULT_VALUE
-      for (il::int_t i = size(); i < n; ++i) {
-        data_[i] = il::defaultValue<T>();
+      if (initialize) {
+        for (il::int_t i = size(); i < n; ++i) {
+          data_[i] = il::defaultValue<T>();
+        }
       }
 #endif
     } else {
       for (il::int_t i = size() - 1; i >= n; --i) {
         (data_ + i)->~T();
       }
-      for (il::int_t i = size(); i < n; ++i) {
-        new (data_ + i) T();
+      if (initialize || !std::is_trivial<T>::value) {
+        for (il::int_t i = size(); i < n; ++i) {
+          new (data_ + i) T();
+        }
       }
     }
   } else {
@@ -708,11 +960,13 @@ void Array<T>::Resize(il::int_t n) {
     IncreaseCapacity(n);
     if (il::isTrivial<T>::value) {
 #ifdef IL_DEFAULT_VALUE
-      for (il::int_t i = n_old; i < n; ++i) {
-        data_[i] = il::defaultValue<T>();
+      if (initialize) {
+        for (il::int_t i = n_old; i < n; ++i) {
+          data_[i] = il::defaultValue<T>();
+        }
       }
 #endif
-    } else {
+    } else if (initialize || !std::is_trivial<T>::value) {
       for (il::int_t i = n_old; i < n; ++i) {
         new (data_ + i) T{};
       }
@@ -754,6 +1008,29 @@ void Array<T>::Resize(il::int_t n, const T& x) {
   size_ = data_ + n;
 }
 
+template <typename T>
+void Array<T>::Resize(il::int_t n, const T& x, il::parallel_t) {
+  IL_EXPECT_FAST(n >= 0);
+
+  if (!il::isTrivial<T>::value) {
+    Resize(n, x);
+    return;
+  }
+
+  const il::int_t n_old = size();
+  SetSize(n, false);
+  T* const data = data_;
+  // The chunks are the ones of [0, n) so that the new pages are touched by
+  // the threads which use them later on
+  il::parallelForStatic(
+      0, n, il::pageGrain<T>(),
+      [data, n_old, &x](il::int_t i_begin, il::int_t i_end) {
+        for (il::int_t i = i_begin > n_old ? i_begin : n_old; i < i_end; ++i) {
+          data[i] = x;
+        }
+      });
+}
+
 template <typename T>
 template <typename... Args>
 void Array<T>::Resize(il::int_t n, il::emplace_t, Args&&... args) {
@@ -861,6 +1138,47 @@ void Array<T>::Append(il::emplace_t, Args&&... args) {
   ++size_;
 }
 
+template <typename T>
+void Array<T>::Insert(il::int_t i, const T& x) {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i) <=
+                   static_cast<std::size_t>(size()));
+
+  // x might be an element of the array
+  T x_copy = x;
+  Insert(i, std::move(x_copy));
+}
+
+template <typename T>
+void Array<T>::Insert(il::int_t i, T&& x) {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i) <=
+                   static_cast<std::size_t>(size()));
+
+  const il::int_t n = size();
+  if (size_ == capacity_) {
+    bool error = false;
+    il::int_t new_capacity =
+        n > 1 ? il::safeProduct(static_cast<il::int_t>(2), n, il::io, error)
+              : il::safeSum(n, static_cast<il::int_t>(1), il::io, error);
+    if (error) {
+      il::abort();
+    }
+    IncreaseCapacity(new_capacity);
+  }
+  if (i == n) {
+    new (size_) T(std::move(x));
+  } else if (il::isTrivial<T>::value) {
+    memmove(data_ + i + 1, data_ + i, (n - i) * sizeof(T));
+    data_[i] = std::move(x);
+  } else {
+    new (size_) T(std::move(data_[n - 1]));
+    for (il::int_t k = n - 1; k > i; --k) {
+      data_[k] = std::move(data_[k - 1]);
+    }
+    data_[i] = std::move(x);
+  }
+  ++size_;
+}
+
 template <typename T>
 il::int_t Array<T>::alignment() const {
   return alignment_;
@@ -941,13 +1259,20 @@ void Array<T>::IncreaseCapacity(il::int_t r) {
   IL_EXPECT_FAST(capacity() < r);
 
   const il::int_t n = size();
+  if (il::isRelocatable<T>::value && alignment_ == 0 && data_) {
+    data_ = il::reallocateArray(data_, r);
+    size_ = data_ + n;
+    capacity_ = data_ + r;
+    return;
+  }
+
   T* new_data;
   il::int_t new_shift;
   if (alignment_ == 0) {
     new_data = il::allocateArray<T>(r);
     new_shift = 0;
   } else {
-    new_data = il::allocateArray<T>(n, align_r_, align_mod_, il::io, new_shift);
+    new_data = il::allocateArray<T>(r, align_r_, align_mod_, il::io, new_shift);
   }
   if (data_) {
     if (il::isTrivial<T>::value) {
@@ -986,9 +1311,10 @@ bool Array<T>::invariance() const {
     ans = ans && (shift_ == 0);
   } else {
     ans = ans && (align_r_ < align_mod_);
-    ans = ans && (reinterpret_cast<std::size_t>(data_) %
-                      static_cast<std::size_t>(align_mod_) ==
-                  static_cast<std::size_t>(align_r_));
+    ans = ans && (data_ == nullptr ||
+                  reinterpret_cast<std::size_t>(data_) %
+                          static_cast<std::size_t>(align_mod_) ==
+                      static_cast<std::size_t>(align_r_));
   }
   return ans;
 }
@@ -19,6 +19,7 @@
 #ifndef IL_ARRAYVIEW_H
 #define IL_ARRAYVIEW_H
 
+#include <il/container/expression/Expression.h>
 #include <il/core.h>
 
 namespace il {
@@ -105,6 +106,16 @@ class ArrayEdit : public ArrayView<T> {
   explicit ArrayEdit(T* data, il::int_t n, il::int_t align_mod,
                      il::int_t align_r);
 
+  /* \brief Evaluate an expression in the elements of the array view
+  // \details The expression must have the same size as the array view. See
+  // <il/expression.h>.
+  //
+  // il::ArrayEdit<double> z = v.Edit(il::Range{0, n});
+  // z = a * x + y;
+  */
+  template <typename E>
+  ArrayEdit& operator=(const il::Expression<E>& expression);
+
   /* \brief Accessor
   // \details Access (read or write) the i-th element of the array view. Bound
   // checking is done in debug mode but not in release mode.
@@ -266,6 +277,13 @@ il::ArrayEdit<T> ArrayEdit<T>::Edit(il::Range range) {
   return il::ArrayEdit<T>{this->data_ + range.begin, range.end - range.begin};
 };
 
+template <typename T>
+template <typename E>
+ArrayEdit<T>& ArrayEdit<T>::operator=(const il::Expression<E>& expression) {
+  il::evaluate(expression, this->size(), il::io, this->data_);
+  return *this;
+}
+
 template <typename T>
 T* ArrayEdit<T>::Data() {
   return this->data_;
@@ -0,0 +1,477 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#ifndef IL_CHUNKEDARRAY_H
+#define IL_CHUNKEDARRAY_H
+
+// <cstddef> is needed for std::size_t
+#include <cstddef>
+// <new> is needed for placement new
+#include <new>
+// <utility> is needed for std::move
+#include <utility>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include <il/container/1d/ArrayView.h>
+#include <il/core/memory/allocate.h>
+
+namespace il {
+
+/* \brief A growable array whose elements never move in memory
+// \details The elements are stored in chunks of chunk_size elements that are
+// allocated one at a time when the array grows. As a consequence:
+// - Appending an element never copies nor moves the other elements. The
+//   pointers to the chunks are stored in blocks of 1, 2, 4, 8, ... pointers
+//   that are never reallocated either, so Append is O(1) in the worst case.
+// - Pointers and references to the elements stay valid until the elements are
+//   removed by Resize or the array is destroyed.
+// The elements of a chunk are contiguous, and the chunks are accessed with
+// chunk(k) and Chunk(k). As chunk_size is a power of 2, the chunk of v[i] and
+// the position in that chunk are found with an unsigned shift and mask, and
+// the block that holds the pointer to the chunk with a bit scan.
+//
+// il::ChunkedArray<double> v{};
+// for (il::int_t i = 0; i < n; ++i) {
+//   v.Append(0.5 * i);
+// }
+// il::parallelFor(0, v.nbChunks(), 1, [&v](il::int_t k0, il::int_t k1) {
+//   for (il::int_t k = k0; k < k1; ++k) {
+//     il::ArrayEdit<double> w = v.Chunk(k);
+//     ...
+//   }
+// });
+*/
+template <typename T, il::int_t chunk_size = 1024>
+class ChunkedArray {
+  static_assert(chunk_size >= 1 && (chunk_size & (chunk_size - 1)) == 0,
+                "il::ChunkedArray<T, chunk_size>: chunk_size must be a power "
+                "of 2");
+
+ private:
+  // block_[j] points to the pointers to the chunks 2^j - 1, ..., 2^(j+1) - 2.
+  // As the number of chunks is < 2^63, at most 63 blocks are used.
+  static const int nb_blocks = 64;
+  T** block_[nb_blocks];
+  il::int_t nb_chunks_;
+  il::int_t size_;
+
+ public:
+  /* \brief Default constructor
+  // \details The size and the capacity of the array are set to 0 and no
+  // memory allocation is done.
+  */
+  ChunkedArray();
+
+  /* \brief Construct an array of n elements
+  // \details The elements are initialized as in il::Array<T>{n}.
+  */
+  explicit ChunkedArray(il::int_t n);
+
+  /* \brief Construct an array of n elements with a value
+   */
+  explicit ChunkedArray(il::int_t n, const T& x);
+
+  /* \brief The copy constructor
+  // \details The capacity of the constructed array is the smallest multiple
+  // of chunk_size that is >= to its size.
+  */
+  ChunkedArray(const ChunkedArray<T, chunk_size>& v);
+
+  /* \brief The move constructor
+  // \details The elements keep their addresses.
+  */
+  ChunkedArray(ChunkedArray<T, chunk_size>&& v);
+
+  ChunkedArray& operator=(const ChunkedArray<T, chunk_size>& v);
+
+  ChunkedArray& operator=(ChunkedArray<T, chunk_size>&& v);
+
+  ~ChunkedArray();
+
+  /* \brief Accessor
+  // \details Bound checking is done in debug mode but not in release mode.
+  */
+  const T& operator[](il::int_t i) const;
+
+  T& operator[](il::int_t i);
+
+  const T& back() const;
+
+  T& Back();
+
+  il::int_t size() const;
+
+  /* \brief Get the capacity of the array
+  // \details It is always a multiple of chunk_size.
+  */
+  il::int_t capacity() const;
+
+  /* \brief Change the capacity of the array to at least r
+  // \details The chunks that are needed are allocated, and the elements are
+  // not moved.
+  */
+  void Reserve(il::int_t r);
+
+  /* \brief Resize the array
+  // \details The new elements are initialized as in il::Array<T>::Resize.
+  // The chunks are kept when the size decreases.
+  */
+  void Resize(il::int_t n);
+
+  /* \brief Add an element at the end of the array
+  // \details A new chunk is allocated when the last one is full. The other
+  // elements are neither copied nor moved.
+  */
+  void Append(const T& x);
+
+  void Append(T&& x);
+
+  template <typename... Args>
+  void Append(il::emplace_t, Args&&... args);
+
+  /* \brief Get the number of chunks that contain elements
+  // \details The chunks 0, ..., nbChunks() - 2 are full, and the last one
+  // contains the other elements.
+  */
+  il::int_t nbChunks() const;
+
+  /* \brief Get a view on the elements of the chunk k
+  // \details The elements of the chunk k are v[k * chunk_size + i] for
+  // 0 <= i < v.chunk(k).size(). Different chunks can be edited by different
+  // threads at the same time.
+  */
+  il::ArrayView<T> chunk(il::int_t k) const;
+
+  il::ArrayEdit<T> Chunk(il::int_t k);
+
+ private:
+  /* \brief Used internally to get the address of the element i
+   */
+  T* address(il::int_t i) const;
+
+  /* \brief Used internally to get the address of the first element of the
+  // chunk k
+  */
+  T* chunkData(il::int_t k) const;
+
+  /* \brief Used internally to get the index of the highest bit set in m > 0
+   */
+  static int highestBit(std::size_t m);
+
+  /* \brief Used internally to allocate a new chunk at the end of the table
+  // \details A new block of pointers is allocated when the chunk is the first
+  // one of its block. Nothing is copied.
+  */
+  void AddChunk();
+
+  /* \brief Used internally to destroy the elements of index >= n
+   */
+  void Destroy(il::int_t n);
+
+  /* \brief Used internally to release the memory of all the chunks and of
+  // the blocks of pointers
+  */
+  void Release();
+};
+
+template <typename T, il::int_t chunk_size>
+ChunkedArray<T, chunk_size>::ChunkedArray() : nb_chunks_{0}, size_{0} {
+  for (int j = 0; j < nb_blocks; ++j) {
+    block_[j] = nullptr;
+  }
+}
+
+template <typename T, il::int_t chunk_size>
+ChunkedArray<T, chunk_size>::ChunkedArray(il::int_t n) : ChunkedArray{} {
+  IL_EXPECT_FAST(n >= 0);
+
+  Resize(n);
+}
+
+template <typename T, il::int_t chunk_size>
+ChunkedArray<T, chunk_size>::ChunkedArray(il::int_t n, const T& x)
+    : ChunkedArray{} {
+  IL_EXPECT_FAST(n >= 0);
+
+  Reserve(n);
+  for (il::int_t i = 0; i < n; ++i) {
+    new (address(i)) T(x);
+  }
+  size_ = n;
+}
+
+template <typename T, il::int_t chunk_size>
+ChunkedArray<T, chunk_size>::ChunkedArray(const ChunkedArray<T, chunk_size>& v)
+    : ChunkedArray{} {
+  const il::int_t n = v.size_;
+  Reserve(n);
+  for (il::int_t i = 0; i < n; ++i) {
+    new (address(i)) T(v[i]);
+  }
+  size_ = n;
+}
+
+template <typename T, il::int_t chunk_size>
+ChunkedArray<T, chunk_size>::ChunkedArray(ChunkedArray<T, chunk_size>&& v)
+    : nb_chunks_{v.nb_chunks_}, size_{v.size_} {
+  for (int j = 0; j < nb_blocks; ++j) {
+    block_[j] = v.block_[j];
+    v.block_[j] = nullptr;
+  }
+  v.nb_chunks_ = 0;
+  v.size_ = 0;
+}
+
+template <typename T, il::int_t chunk_size>
+ChunkedArray<T, chunk_size>& ChunkedArray<T, chunk_size>::operator=(
+    const ChunkedArray<T, chunk_size>& v) {
+  if (this != &v) {
+    Destroy(0);
+    Reserve(v.size_);
+    for (il::int_t i = 0; i < v.size_; ++i) {
+      new (address(i)) T(v[i]);
+    }
+    size_ = v.size_;
+  }
+  return *this;
+}
+
+template <typename T, il::int_t chunk_size>
+ChunkedArray<T, chunk_size>& ChunkedArray<T, chunk_size>::operator=(
+    ChunkedArray<T, chunk_size>&& v) {
+  if (this != &v) {
+    Release();
+    for (int j = 0; j < nb_blocks; ++j) {
+      block_[j] = v.block_[j];
+      v.block_[j] = nullptr;
+    }
+    nb_chunks_ = v.nb_chunks_;
+    size_ = v.size_;
+    v.nb_chunks_ = 0;
+    v.size_ = 0;
+  }
+  return *this;
+}
+
+template <typename T, il::int_t chunk_size>
+ChunkedArray<T, chunk_size>::~ChunkedArray() {
+  Release();
+}
+
+template <typename T, il::int_t chunk_size>
+const T& ChunkedArray<T, chunk_size>::operator[](il::int_t i) const {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i) <
+                   static_cast<std::size_t>(size_));
+
+  return *address(i);
+}
+
+template <typename T, il::int_t chunk_size>
+T& ChunkedArray<T, chunk_size>::operator[](il::int_t i) {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i) <
+                   static_cast<std::size_t>(size_));
+
+  return *address(i);
+}
+
+template <typename T, il::int_t chunk_size>
+const T& ChunkedArray<T, chunk_size>::back() const {
+  IL_EXPECT_MEDIUM(size_ > 0);
+
+  return (*this)[size_ - 1];
+}
+
+template <typename T, il::int_t chunk_size>
+T& ChunkedArray<T, chunk_size>::Back() {
+  IL_EXPECT_MEDIUM(size_ > 0);
+
+  return (*this)[size_ - 1];
+}
+
+template <typename T, il::int_t chunk_size>
+il::int_t ChunkedArray<T, chunk_size>::size() const {
+  return size_;
+}
+
+template <typename T, il::int_t chunk_size>
+il::int_t ChunkedArray<T, chunk_size>::capacity() const {
+  return nb_chunks_ * chunk_size;
+}
+
+template <typename T, il::int_t chunk_size>
+void ChunkedArray<T, chunk_size>::Reserve(il::int_t r) {
+  IL_EXPECT_FAST(r >= 0);
+
+  const il::int_t nb_chunks = r / chunk_size + (r % chunk_size == 0 ? 0 : 1);
+  while (nb_chunks_ < nb_chunks) {
+    AddChunk();
+  }
+}
+
+template <typename T, il::int_t chunk_size>
+void ChunkedArray<T, chunk_size>::Resize(il::int_t n) {
+  IL_EXPECT_FAST(n >= 0);
+
+  if (n < size_) {
+    Destroy(n);
+    return;
+  }
+  Reserve(n);
+  for (il::int_t i = size_; i < n; ++i) {
+    T* p = address(i);
+    if (il::isTrivial<T>::value) {
+#ifdef IL_DEFAULT_VALUE
+      *p = il::defaultValue<T>();
+#endif
+    } else {
+      new (p) T{};
+    }
+  }
+  size_ = n;
+}
+
+template <typename T, il::int_t chunk_size>
+void ChunkedArray<T, chunk_size>::Append(const T& x) {
+  if (size_ == capacity()) {
+    AddChunk();
+  }
+  new (address(size_)) T(x);
+  ++size_;
+}
+
+template <typename T, il::int_t chunk_size>
+void ChunkedArray<T, chunk_size>::Append(T&& x) {
+  if (size_ == capacity()) {
+    AddChunk();
+  }
+  new (address(size_)) T(std::move(x));
+  ++size_;
+}
+
+template <typename T, il::int_t chunk_size>
+template <typename... Args>
+void ChunkedArray<T, chunk_size>::Append(il::emplace_t, Args&&... args) {
+  if (size_ == capacity()) {
+    AddChunk();
+  }
+  new (address(size_))
+      T(std::forward<Args>(args)...);
+  ++size_;
+}
+
+template <typename T, il::int_t chunk_size>
+il::int_t ChunkedArray<T, chunk_size>::nbChunks() const {
+  return size_ / chunk_size + (size_ % chunk_size == 0 ? 0 : 1);
+}
+
+template <typename T, il::int_t chunk_size>
+il::ArrayView<T> ChunkedArray<T, chunk_size>::chunk(il::int_t k) const {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(k) <
+                   static_cast<std::size_t>(nbChunks()));
+
+  const il::int_t n = size_ - k * chunk_size;
+  return il::ArrayView<T>{chunkData(k), n < chunk_size ? n : chunk_size};
+}
+
+template <typename T, il::int_t chunk_size>
+il::ArrayEdit<T> ChunkedArray<T, chunk_size>::Chunk(il::int_t k) {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(k) <
+                   static_cast<std::size_t>(nbChunks()));
+
+  const il::int_t n = size_ - k * chunk_size;
+  return il::ArrayEdit<T>{chunkData(k), n < chunk_size ? n : chunk_size};
+}
+
+template <typename T, il::int_t chunk_size>
+T* ChunkedArray<T, chunk_size>::address(il::int_t i) const {
+  const std::size_t ui = static_cast<std::size_t>(i);
+  const std::size_t cs = static_cast<std::size_t>(chunk_size);
+  return chunkData(static_cast<il::int_t>(ui / cs)) + ui % cs;
+}
+
+template <typename T, il::int_t chunk_size>
+T* ChunkedArray<T, chunk_size>::chunkData(il::int_t k) const {
+  const std::size_t m = static_cast<std::size_t>(k) + 1;
+  const int j = highestBit(m);
+  return block_[j][m - (std::size_t{1} << j)];
+}
+
+template <typename T, il::int_t chunk_size>
+int ChunkedArray<T, chunk_size>::highestBit(std::size_t m) {
+  IL_EXPECT_MEDIUM(m != 0);
+
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<int>(8 * sizeof(unsigned long long) - 1) -
+         __builtin_clzll(static_cast<unsigned long long>(m));
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long j;
+  _BitScanReverse64(&j, m);
+  return static_cast<int>(j);
+#else
+  int j = 0;
+  while (m > 1) {
+    m >>= 1;
+    ++j;
+  }
+  return j;
+#endif
+}
+
+template <typename T, il::int_t chunk_size>
+void ChunkedArray<T, chunk_size>::AddChunk() {
+  const std::size_t m = static_cast<std::size_t>(nb_chunks_) + 1;
+  const int j = highestBit(m);
+  const std::size_t offset = m - (std::size_t{1} << j);
+  if (offset == 0) {
+    block_[j] = il::allocateArray<T*>(il::int_t{1} << j);
+  }
+  block_[j][offset] = il::allocateArray<T>(chunk_size);
+  ++nb_chunks_;
+}
+
+template <typename T, il::int_t chunk_size>
+void ChunkedArray<T, chunk_size>::Destroy(il::int_t n) {
+  if (!il::isTrivial<T>::value) {
+    for (il::int_t i = size_ - 1; i >= n; --i) {
+      address(i)->~T();
+    }
+  }
+  size_ = n;
+}
+
+template <typename T, il::int_t chunk_size>
+void ChunkedArray<T, chunk_size>::Release() {
+  Destroy(0);
+  for (il::int_t k = nb_chunks_ - 1; k >= 0; --k) {
+    il::deallocate(chunkData(k));
+  }
+  for (int j = nb_blocks - 1; j >= 0; --j) {
+    if (block_[j]) {
+      il::deallocate(block_[j]);
+      block_[j] = nullptr;
+    }
+  }
+  nb_chunks_ = 0;
+}
+
+}  // namespace il
+
+#endif  // IL_CHUNKEDARRAY_H
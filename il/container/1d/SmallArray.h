@@ -19,12 +19,16 @@
 #ifndef IL_SMALLARRAY_H
 #define IL_SMALLARRAY_H
 
-// <cstring> is needed for memcpy
+// <climits> is needed for SHRT_MAX
+#include <climits>
+// <cstring> is needed for memcpy and memmove
 #include <cstring>
 // <initializer_list> is needed for std::initializer_list<T>
 #include <initializer_list>
 // <new> is needed for placement new
 #include <new>
+// <type_traits> is needed for std::is_trivial and std::integral_constant
+#include <type_traits>
 // <utility> is needed for std::move
 #include <utility>
 
@@ -33,6 +37,17 @@
 
 namespace il {
 
+/* \brief An array that keeps up to small_size elements inside the object
+// \details It has the same interface as il::Array<T>. As long as its capacity
+// is below small_size, no memory allocation is done, which makes it a good
+// choice for the many small lists of a mesh such as the connectivity of an
+// element. Beyond that, the elements are stored on the heap as in an
+// il::Array<T>. The algorithms work on it through view() and Edit().
+//
+// il::SmallArray<il::int_t, 8> nodes{};
+// nodes.Append(i0);
+// nodes.Append(i1);
+*/
 template <typename T, il::int_t small_size>
 class SmallArray {
   static_assert(small_size >= 1,
@@ -42,7 +57,13 @@ class SmallArray {
   T* data_;
   T* size_;
   T* capacity_;
+  short alignment_;
+  short align_r_;
+  short align_mod_;
+  short shift_;
   alignas(T) char small_data_[small_size * sizeof(T)];
+  // Tag used to choose at compile time the raw memory copies for trivial T
+  using trivial_t = std::integral_constant<bool, il::isTrivial<T>::value>;
 
  public:
   /* \brief Default constructor
@@ -68,6 +89,27 @@ class SmallArray {
   */
   explicit SmallArray(il::int_t n);
 
+  /* \brief Construct a small array of n elements without initializing them
+  // \details When T is trivial, the elements are left uninitialized, even in
+  // debug mode. Otherwise, the elements are default constructed.
+  */
+  explicit SmallArray(il::int_t n, il::uninitialized_t);
+
+  /* \brief Construct an aligned small array of n elements
+  // \details The pointer data, when considered as an integer, satisfies
+  // data_ = 0 (Modulo alignment). The small buffer is only used if it
+  // satisfies this constraint.
+  */
+  explicit SmallArray(il::int_t n, il::align_t, il::int_t alignment);
+
+  /* \brief Construct an aligned small array of n elements
+  // \details The pointer data, when considered as an integer, satisfies
+  // data_ = align_r (Modulo align_mod). The small buffer is only used if it
+  // satisfies this constraint.
+  */
+  explicit SmallArray(il::int_t n, il::align_t, il::int_t alignment,
+                      il::int_t align_r, il::int_t align_mod);
+
   /* \brief Construct a small array of n elements from a value
   // \details Initialize the array of length n with a given value.
   /
@@ -76,6 +118,23 @@ class SmallArray {
   */
   explicit SmallArray(il::int_t n, const T& x);
 
+  /* \brief Construct a small array of n elements, each of them being
+  // constructed from the arguments
+  */
+  template <typename... Args>
+  explicit SmallArray(il::int_t n, il::emplace_t, Args&&... args);
+
+  explicit SmallArray(il::int_t n, const T& x, il::align_t,
+                      il::int_t alignment, il::int_t align_r,
+                      il::int_t align_mod);
+
+  explicit SmallArray(il::int_t n, const T& x, il::align_t,
+                      il::int_t alignment);
+
+  /* \brief Construct a small array from a view
+   */
+  explicit SmallArray(il::ArrayView<T> v);
+
   /* \brief Construct a il::SmallArray<T, small_size> from a brace-initialized
   // list
   // \details The size and the capacity of the il::SmallArray<T, small_size> is
@@ -135,6 +194,10 @@ class SmallArray {
   */
   T& operator[](il::int_t i);
 
+  /* \brief Set all the elements of the array to x
+   */
+  void Set(const T& x);
+
   /* \brief Accessor to the last element of a const
   // il::SmallArray<T, small_size>
   // \details In debug mode, calling this method on an array of size 0 aborts
@@ -165,6 +228,17 @@ class SmallArray {
   */
   void Resize(il::int_t n);
 
+  /* \brief Change the size of the array without initializing the new elements
+  // \details When T is trivial, the new elements are left uninitialized, even
+  // in debug mode. Otherwise, they are default constructed.
+  */
+  void Resize(il::int_t n, il::uninitialized_t);
+
+  void Resize(il::int_t n, const T& x);
+
+  template <typename... Args>
+  void Resize(il::int_t n, il::emplace_t, Args&&... args);
+
   /* \brief Get the capacity of the array
    */
   il::int_t capacity() const;
@@ -181,12 +255,31 @@ class SmallArray {
   */
   void Append(const T& x);
 
+  /* \brief Add an element at the end of the array
+  // \details Reallocation is done only if it is needed. In case reallocation
+  // happens, then new capacity is roughly (3/2) the previous capacity.
+  */
+  void Append(T&& x);
+
   /* \brief Construct an element at the end of the array
   // \details Reallocation is done only if it is needed. In case reallocation
   // happens, then new capacity is roughly (3/2) the previous capacity.
   */
   template <typename... Args>
-  void Append(Args&&... args);
+  void Append(il::emplace_t, Args&&... args);
+
+  /* \brief Insert an element at position i, the elements that follow being
+  // shifted to the right
+  // \details Reallocation is done only if it is needed. In case reallocation
+  // happens, then new capacity is roughly (3/2) the previous capacity.
+  */
+  void Insert(il::int_t i, const T& x);
+
+  void Insert(il::int_t i, T&& x);
+
+  /* \brief Get the alignment of the pointer returned by data()
+   */
+  il::int_t alignment() const;
 
   il::ArrayView<T> view() const;
 
@@ -206,15 +299,76 @@ class SmallArray {
   */
   T* Data();
 
+  const T* begin() const;
+  const T* cbegin() const;
+  T* begin();
+  const T* end() const;
+  const T* cend() const;
+  T* end();
+
  private:
   /* \brief Used internally to check if the stack array is used
    */
   bool smallDataUsed() const;
 
+  /* \brief Used internally to check if the stack array satisfies the
+  // alignment constraints of the array
+  */
+  bool smallDataAligned() const;
+
+  /* \brief Used internally to get the memory for r elements on an empty array
+  // \details The stack array is used if it is large enough and aligned.
+  */
+  void Allocate(il::int_t r);
+
+  /* \brief Used internally to destroy the elements and release the memory
+  // \details The array is left in the state of a default constructed array,
+  // except for its alignment.
+  */
+  void Release();
+
   /* \brief Used internally to increase the capacity of the array
    */
   void IncreaseCapacity(il::int_t r);
 
+  /* \brief Used internally to copy construct n elements from q into the
+  // uninitialized memory p
+  // \details The overload is chosen with trivial_t so that memcpy is never
+  // instantiated for an object.
+  */
+  static void CopyConstruct(T* p, const T* q, il::int_t n, std::true_type);
+  static void CopyConstruct(T* p, const T* q, il::int_t n, std::false_type);
+
+  /* \brief Used internally to move n elements from q into the uninitialized
+  // memory p, the elements of q being destroyed
+  */
+  static void Relocate(T* p, T* q, il::int_t n, std::true_type);
+  static void Relocate(T* p, T* q, il::int_t n, std::false_type);
+
+  /* \brief Used internally to copy n elements from q into the array whose
+  // capacity is large enough, the elements beyond n being destroyed
+  */
+  void CopyAssign(const T* q, il::int_t n, std::true_type);
+  void CopyAssign(const T* q, il::int_t n, std::false_type);
+
+  /* \brief Used internally to shift the elements from i to the end by one
+  // slot to the right
+  // \details There must be room for one more element. The element at i is
+  // left in a moved-from state.
+  */
+  void ShiftRight(il::int_t i, std::true_type);
+  void ShiftRight(il::int_t i, std::false_type);
+
+  /* \brief Used internally to get the capacity after a growth
+   */
+  il::int_t nextCapacity() const;
+
+  /* \brief Used internally by Resize
+  // \details The new elements are initialized, as in Resize(n), unless
+  // initialize is false and T is trivial
+  */
+  void SetSize(il::int_t n, bool initialize);
+
   /* \brief Used internally in debug mode to check the invariance of the object
    */
   bool invariance() const;
@@ -225,199 +379,198 @@ SmallArray<T, small_size>::SmallArray() {
   data_ = reinterpret_cast<T*>(small_data_);
   size_ = data_;
   capacity_ = data_ + small_size;
+  alignment_ = 0;
+  align_r_ = 0;
+  align_mod_ = 0;
+  shift_ = 0;
 }
 
 template <typename T, il::int_t small_size>
-SmallArray<T, small_size>::SmallArray(il::int_t n) {
-  IL_EXPECT_FAST(n >= 0);
+SmallArray<T, small_size>::SmallArray(il::int_t n) : SmallArray{} {
+  SetSize(n, true);
+}
 
-  if (n <= small_size) {
-    data_ = reinterpret_cast<T*>(small_data_);
-    size_ = data_ + n;
-    capacity_ = data_ + small_size;
-  } else {
-    data_ = il::allocateArray<T>(n);
-    size_ = data_ + n;
-    capacity_ = data_ + n;
-  }
-  if (il::isTrivial<T>::value) {
-#ifdef IL_DEFAULT_VALUE
-    for (il::int_t i = 0; i < n; ++i) {
-      data_[i] = il::defaultValue<T>();
-    }
-#endif
-  } else {
-    for (il::int_t i = 0; i < n; ++i) {
-      new (data_ + i) T{};
-    }
-  }
+template <typename T, il::int_t small_size>
+SmallArray<T, small_size>::SmallArray(il::int_t n, il::uninitialized_t)
+    : SmallArray{} {
+  SetSize(n, false);
 }
 
 template <typename T, il::int_t small_size>
-SmallArray<T, small_size>::SmallArray(il::int_t n, const T& x) {
+SmallArray<T, small_size>::SmallArray(il::int_t n, il::align_t,
+                                      il::int_t alignment, il::int_t align_r,
+                                      il::int_t align_mod)
+    : SmallArray{} {
+  IL_EXPECT_FAST(il::isTrivial<T>::value);
+  IL_EXPECT_FAST(sizeof(T) % alignof(T) == 0);
   IL_EXPECT_FAST(n >= 0);
+  IL_EXPECT_FAST(alignment > 0);
+  IL_EXPECT_FAST(alignment % alignof(T) == 0);
+  IL_EXPECT_FAST(alignment <= SHRT_MAX);
+  IL_EXPECT_FAST(align_mod > 0);
+  IL_EXPECT_FAST(align_mod % alignof(T) == 0);
+  IL_EXPECT_FAST(align_mod % alignment == 0);
+  IL_EXPECT_FAST(align_mod <= SHRT_MAX);
+  IL_EXPECT_FAST(align_r >= 0);
+  IL_EXPECT_FAST(align_r < align_mod);
+  IL_EXPECT_FAST(align_r % alignof(T) == 0);
+  IL_EXPECT_FAST(align_r % alignment == 0);
+  IL_EXPECT_FAST(align_r <= SHRT_MAX);
+
+  alignment_ = static_cast<short>(alignment);
+  align_r_ = static_cast<short>(align_r);
+  align_mod_ = static_cast<short>(align_mod);
+  Allocate(n);
+  SetSize(n, true);
+}
 
-  if (n <= small_size) {
-    data_ = reinterpret_cast<T*>(small_data_);
-    size_ = data_ + n;
-    capacity_ = data_ + small_size;
-  } else {
-    data_ = il::allocateArray<T>(n);
-    size_ = data_ + n;
-    capacity_ = data_ + n;
-  }
+template <typename T, il::int_t small_size>
+SmallArray<T, small_size>::SmallArray(il::int_t n, il::align_t,
+                                      il::int_t alignment)
+    : SmallArray{n, il::align, alignment, 0, alignment} {}
+
+template <typename T, il::int_t small_size>
+SmallArray<T, small_size>::SmallArray(il::int_t n, const T& x)
+    : SmallArray{} {
+  Resize(n, x);
+}
+
+template <typename T, il::int_t small_size>
+template <typename... Args>
+SmallArray<T, small_size>::SmallArray(il::int_t n, il::emplace_t,
+                                      Args&&... args)
+    : SmallArray{} {
+  Resize(n, il::emplace, args...);
+}
+
+template <typename T, il::int_t small_size>
+SmallArray<T, small_size>::SmallArray(il::int_t n, const T& x, il::align_t,
+                                      il::int_t alignment, il::int_t align_r,
+                                      il::int_t align_mod)
+    : SmallArray{0, il::align, alignment, align_r, align_mod} {
+  Resize(n, x);
+}
+
+template <typename T, il::int_t small_size>
+SmallArray<T, small_size>::SmallArray(il::int_t n, const T& x, il::align_t,
+                                      il::int_t alignment)
+    : SmallArray{0, il::align, alignment, 0, alignment} {
+  Resize(n, x);
+}
+
+template <typename T, il::int_t small_size>
+SmallArray<T, small_size>::SmallArray(il::ArrayView<T> v) : SmallArray{} {
+  const il::int_t n = v.size();
+  Reserve(n);
   for (il::int_t i = 0; i < n; ++i) {
-    new (data_ + i) T(x);
+    new (data_ + i) T(v[i]);
   }
+  size_ = data_ + n;
 }
 
 template <typename T, il::int_t small_size>
 SmallArray<T, small_size>::SmallArray(il::value_t,
-                                      std::initializer_list<T> list) {
+                                      std::initializer_list<T> list)
+    : SmallArray{} {
   const il::int_t n = static_cast<il::int_t>(list.size());
-  if (n <= small_size) {
-    data_ = reinterpret_cast<T*>(small_data_);
-    size_ = data_ + n;
-    capacity_ = data_ + small_size;
-  } else {
-    data_ = il::allocateArray<T>(n);
-    size_ = data_ + n;
-    capacity_ = data_ + n;
-  }
-  if (il::isTrivial<T>::value) {
-    memcpy(data_, list.begin(), n * sizeof(T));
-  } else {
-    for (il::int_t i = 0; i < n; ++i) {
-      new (data_ + i) T(*(list.begin() + i));
-    }
-  }
+  Reserve(n);
+  CopyConstruct(data_, list.begin(), n, trivial_t{});
+  size_ = data_ + n;
 }
 
 template <typename T, il::int_t small_size>
-SmallArray<T, small_size>::SmallArray(const SmallArray<T, small_size>& A) {
+SmallArray<T, small_size>::SmallArray(const SmallArray<T, small_size>& A)
+    : SmallArray{} {
   const il::int_t n = A.size();
-  if (n <= small_size) {
-    data_ = reinterpret_cast<T*>(small_data_);
-    size_ = data_ + n;
-    capacity_ = data_ + small_size;
-  } else {
-    data_ = il::allocateArray<T>(n);
-    size_ = data_ + n;
-    capacity_ = data_ + n;
-  }
-  if (il::isTrivial<T>::value) {
-    memcpy(data_, A.data_, n * sizeof(T));
-  } else {
-    for (il::int_t i = 0; i < n; ++i) {
-      new (data_ + i) T(A.data_[i]);
-    }
-  }
+  alignment_ = A.alignment_;
+  align_r_ = A.align_r_;
+  align_mod_ = A.align_mod_;
+  Allocate(n);
+  CopyConstruct(data_, A.data_, n, trivial_t{});
+  size_ = data_ + n;
 }
 
 template <typename T, il::int_t small_size>
-SmallArray<T, small_size>::SmallArray(SmallArray<T, small_size>&& A) {
+SmallArray<T, small_size>::SmallArray(SmallArray<T, small_size>&& A)
+    : SmallArray{} {
   const il::int_t n = A.size();
+  alignment_ = A.alignment_;
+  align_r_ = A.align_r_;
+  align_mod_ = A.align_mod_;
   if (A.smallDataUsed()) {
-    data_ = reinterpret_cast<T*>(small_data_);
-    if (il::isTrivial<T>::value) {
-      memcpy(data_, A.data_, n * sizeof(T));
-    } else {
-      for (il::int_t i = n - 1; i >= 0; --i) {
-        new (data_ + i) T(std::move(A.data_[i]));
-        (A.data_ + i)->~T();
-      }
-    }
+    Allocate(n);
+    Relocate(data_, A.data_, n, trivial_t{});
     size_ = data_ + n;
-    capacity_ = data_ + small_size;
+    A.size_ = A.data_;
   } else {
     data_ = A.data_;
     size_ = A.size_;
     capacity_ = A.capacity_;
+    shift_ = A.shift_;
+    A.data_ = reinterpret_cast<T*>(A.small_data_);
+    A.size_ = A.data_;
+    A.capacity_ = A.data_ + small_size;
+    A.alignment_ = 0;
+    A.align_r_ = 0;
+    A.align_mod_ = 0;
+    A.shift_ = 0;
   }
-  A.data_ = reinterpret_cast<T*>(A.small_data_);
-  A.size_ = A.data_ + 0;
-  A.capacity_ = A.data_ + small_size;
 }
 
 template <typename T, il::int_t small_size>
 SmallArray<T, small_size>& SmallArray<T, small_size>::operator=(
     const SmallArray<T, small_size>& A) {
-  if (this != &A) {
-    const il::int_t n = A.size();
-    const bool needs_memory = capacity() < n;
-    if (needs_memory) {
-      if (il::isTrivial<T>::value) {
-        if (!smallDataUsed()) {
-          il::deallocate(data_);
-        }
-        data_ = il::allocateArray<T>(n);
-        memcpy(data_, A.data_, n * sizeof(T));
-      } else {
-        for (il::int_t i = size() - 1; i >= 0; --i) {
-          (data_ + i)->~T();
-        }
-        if (!smallDataUsed()) {
-          il::deallocate(data_);
-        }
-        data_ = il::allocateArray<T>(n);
-        for (il::int_t i = 0; i < n; ++i) {
-          new (data_ + i) T(A.data_[i]);
-        }
-      }
-      size_ = data_ + n;
-      capacity_ = data_ + n;
-    } else {
-      if (!il::isTrivial<T>::value) {
-        for (il::int_t i = size() - 1; i >= n; --i) {
-          (data_ + i)->~T();
-        }
-      }
-      for (il::int_t i = 0; i < n; ++i) {
-        data_[i] = A.data_[i];
-      }
-      size_ = data_ + n;
-    }
+  if (this == &A) {
+    return *this;
+  }
+
+  const il::int_t n = A.size();
+  const bool needs_memory = n > capacity() || alignment_ != A.alignment_ ||
+                            align_r_ != A.align_r_ ||
+                            align_mod_ != A.align_mod_;
+  if (needs_memory) {
+    Release();
+    alignment_ = A.alignment_;
+    align_r_ = A.align_r_;
+    align_mod_ = A.align_mod_;
+    Allocate(n);
+    CopyConstruct(data_, A.data_, n, trivial_t{});
+  } else {
+    CopyAssign(A.data_, n, trivial_t{});
   }
+  size_ = data_ + n;
   return *this;
 }
 
 template <typename T, il::int_t small_size>
 SmallArray<T, small_size>& SmallArray<T, small_size>::operator=(
     SmallArray<T, small_size>&& A) {
-  if (this != &A) {
-    if (il::isTrivial<T>::value) {
-      if (!smallDataUsed()) {
-        il::deallocate(data_);
-      }
-    } else {
-      for (il::int_t i = size() - 1; i >= 0; --i) {
-        (data_ + i)->~T();
-      }
-      if (!smallDataUsed()) {
-        il::deallocate(data_);
-      }
-    }
-    const il::int_t n = A.size();
-    if (A.smallDataUsed()) {
-      data_ = reinterpret_cast<T*>(small_data_);
-      if (il::isTrivial<T>::value) {
-        memcpy(data_, A.data_, n * sizeof(T));
-      } else {
-        for (il::int_t i = n - 1; i >= 0; --i) {
-          new (data_ + i) T(std::move(A.data_[i]));
-          (data_ + i)->~T();
-        }
-      }
-      size_ = data_ + n;
-      capacity_ = data_ + small_size;
-    } else {
-      data_ = A.data_;
-      size_ = A.size_;
-      capacity_ = A.capacity_;
-    }
-    data_ = reinterpret_cast<T*>(small_data_);
-    A.size_ = A.data_ + 0;
+  if (this == &A) {
+    return *this;
+  }
+
+  Release();
+  const il::int_t n = A.size();
+  alignment_ = A.alignment_;
+  align_r_ = A.align_r_;
+  align_mod_ = A.align_mod_;
+  if (A.smallDataUsed()) {
+    Allocate(n);
+    Relocate(data_, A.data_, n, trivial_t{});
+    size_ = data_ + n;
+    A.size_ = A.data_;
+  } else {
+    data_ = A.data_;
+    size_ = A.size_;
+    capacity_ = A.capacity_;
+    shift_ = A.shift_;
+    A.data_ = reinterpret_cast<T*>(A.small_data_);
+    A.size_ = A.data_;
     A.capacity_ = A.data_ + small_size;
+    A.alignment_ = 0;
+    A.align_r_ = 0;
+    A.align_mod_ = 0;
+    A.shift_ = 0;
   }
   return *this;
 }
@@ -426,14 +579,7 @@ template <typename T, il::int_t small_size>
 SmallArray<T, small_size>::~SmallArray() {
   IL_EXPECT_FAST_NOTHROW(invariance());
 
-  if (!il::isTrivial<T>::value) {
-    for (il::int_t i = size() - 1; i >= 0; --i) {
-      (data_ + i)->~T();
-    }
-  }
-  if (!smallDataUsed()) {
-    il::deallocate(data_);
-  }
+  Release();
 }
 
 template <typename T, il::int_t small_size>
@@ -450,6 +596,13 @@ T& SmallArray<T, small_size>::operator[](il::int_t i) {
   return data_[i];
 }
 
+template <typename T, il::int_t small_size>
+void SmallArray<T, small_size>::Set(const T& x) {
+  for (il::int_t i = 0; i < size(); ++i) {
+    data_[i] = x;
+  }
+}
+
 template <typename T, il::int_t small_size>
 const T& SmallArray<T, small_size>::back() const {
   IL_EXPECT_MEDIUM(size() > 0);
@@ -469,33 +622,35 @@ il::int_t SmallArray<T, small_size>::size() const {
 
 template <typename T, il::int_t small_size>
 void SmallArray<T, small_size>::Resize(il::int_t n) {
+  SetSize(n, true);
+}
+
+template <typename T, il::int_t small_size>
+void SmallArray<T, small_size>::Resize(il::int_t n, il::uninitialized_t) {
+  SetSize(n, false);
+}
+
+template <typename T, il::int_t small_size>
+void SmallArray<T, small_size>::SetSize(il::int_t n, bool initialize) {
   IL_EXPECT_FAST(n >= 0);
 
-  if (n <= capacity()) {
-    if (il::isTrivial<T>::value) {
-#ifdef IL_DEFAULT_VALUE
-      for (il::int_t i = size(); i < n; ++i) {
-        data_[i] = il::defaultValue<T>();
-      }
-#endif
-    } else {
-      for (il::int_t i = size() - 1; i >= 0; --i) {
-        (data_ + i)->~T();
-      }
-      for (il::int_t i = size(); i < n; ++i) {
-        new (data_ + i) T{};
-      }
-    }
-  } else {
-    const il::int_t n_old = size();
+  const il::int_t n_old = size();
+  if (n > capacity()) {
     IncreaseCapacity(n);
-    if (il::isTrivial<T>::value) {
+  }
+  if (il::isTrivial<T>::value) {
 #ifdef IL_DEFAULT_VALUE
+    if (initialize) {
       for (il::int_t i = n_old; i < n; ++i) {
         data_[i] = il::defaultValue<T>();
       }
+    }
 #endif
-    } else {
+  } else {
+    for (il::int_t i = n_old - 1; i >= n; --i) {
+      (data_ + i)->~T();
+    }
+    if (initialize || !std::is_trivial<T>::value) {
       for (il::int_t i = n_old; i < n; ++i) {
         new (data_ + i) T{};
       }
@@ -504,6 +659,46 @@ void SmallArray<T, small_size>::Resize(il::int_t n) {
   size_ = data_ + n;
 }
 
+template <typename T, il::int_t small_size>
+void SmallArray<T, small_size>::Resize(il::int_t n, const T& x) {
+  IL_EXPECT_FAST(n >= 0);
+
+  const il::int_t n_old = size();
+  if (n > capacity()) {
+    IncreaseCapacity(n);
+  }
+  if (!il::isTrivial<T>::value) {
+    for (il::int_t i = n_old - 1; i >= n; --i) {
+      (data_ + i)->~T();
+    }
+  }
+  for (il::int_t i = n_old; i < n; ++i) {
+    new (data_ + i) T(x);
+  }
+  size_ = data_ + n;
+}
+
+template <typename T, il::int_t small_size>
+template <typename... Args>
+void SmallArray<T, small_size>::Resize(il::int_t n, il::emplace_t,
+                                       Args&&... args) {
+  IL_EXPECT_FAST(n >= 0);
+
+  const il::int_t n_old = size();
+  if (n > capacity()) {
+    IncreaseCapacity(n);
+  }
+  if (!il::isTrivial<T>::value) {
+    for (il::int_t i = n_old - 1; i >= n; --i) {
+      (data_ + i)->~T();
+    }
+  }
+  for (il::int_t i = n_old; i < n; ++i) {
+    new (data_ + i) T(args...);
+  }
+  size_ = data_ + n;
+}
+
 template <typename T, il::int_t small_size>
 il::int_t SmallArray<T, small_size>::capacity() const {
   return capacity_ - data_;
@@ -521,16 +716,8 @@ void SmallArray<T, small_size>::Reserve(il::int_t r) {
 template <typename T, il::int_t small_size>
 void SmallArray<T, small_size>::Append(const T& x) {
   if (size_ == capacity_) {
-    const il::int_t n = size();
-    bool error = false;
-    il::int_t new_capacity =
-        n > 1 ? il::safeSum(n, n / 2, il::io, error)
-              : il::safeSum(n, static_cast<il::int_t>(1), il::io, error);
-    if (error) {
-      il::abort();
-    }
     T x_copy = x;
-    IncreaseCapacity(new_capacity);
+    IncreaseCapacity(nextCapacity());
     new (size_) T(std::move(x_copy));
   } else {
     new (size_) T(x);
@@ -538,27 +725,56 @@ void SmallArray<T, small_size>::Append(const T& x) {
   ++size_;
 }
 
+template <typename T, il::int_t small_size>
+void SmallArray<T, small_size>::Append(T&& x) {
+  if (size_ == capacity_) {
+    IncreaseCapacity(nextCapacity());
+  }
+  new (size_) T(std::move(x));
+  ++size_;
+}
+
 template <typename T, il::int_t small_size>
 template <typename... Args>
-void SmallArray<T, small_size>::Append(Args&&... args) {
+void SmallArray<T, small_size>::Append(il::emplace_t, Args&&... args) {
   if (size_ == capacity_) {
-    const il::int_t n = size();
-    bool error = false;
-    il::int_t new_capacity =
-        n > 1 ? il::safeSum(n, n / 2, il::io, error)
-              : il::safeSum(n, static_cast<il::int_t>(1), il::io, error);
-    if (error) {
-      il::abort();
-    }
-    IncreaseCapacity(new_capacity);
-  };
-  new (size_) T(args...);
+    IncreaseCapacity(nextCapacity());
+  }
+  new (size_) T(std::forward<Args>(args)...);
   ++size_;
 }
 
 template <typename T, il::int_t small_size>
-T* SmallArray<T, small_size>::Data() {
-  return data_;
+void SmallArray<T, small_size>::Insert(il::int_t i, const T& x) {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i) <=
+                   static_cast<std::size_t>(size()));
+
+  // x might be an element of the array
+  T x_copy = x;
+  Insert(i, std::move(x_copy));
+}
+
+template <typename T, il::int_t small_size>
+void SmallArray<T, small_size>::Insert(il::int_t i, T&& x) {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i) <=
+                   static_cast<std::size_t>(size()));
+
+  if (size_ == capacity_) {
+    IncreaseCapacity(nextCapacity());
+  }
+  const il::int_t n = size();
+  if (i == n) {
+    new (size_) T(std::move(x));
+  } else {
+    ShiftRight(i, trivial_t{});
+    data_[i] = std::move(x);
+  }
+  ++size_;
+}
+
+template <typename T, il::int_t small_size>
+il::int_t SmallArray<T, small_size>::alignment() const {
+  return alignment_;
 }
 
 template <typename T, il::int_t small_size>
@@ -596,35 +812,193 @@ const T* SmallArray<T, small_size>::data() const {
   return data_;
 }
 
+template <typename T, il::int_t small_size>
+T* SmallArray<T, small_size>::Data() {
+  return data_;
+}
+
+template <typename T, il::int_t small_size>
+const T* SmallArray<T, small_size>::begin() const {
+  return data_;
+}
+
+template <typename T, il::int_t small_size>
+const T* SmallArray<T, small_size>::cbegin() const {
+  return data_;
+}
+
+template <typename T, il::int_t small_size>
+T* SmallArray<T, small_size>::begin() {
+  return data_;
+}
+
+template <typename T, il::int_t small_size>
+const T* SmallArray<T, small_size>::end() const {
+  return size_;
+}
+
+template <typename T, il::int_t small_size>
+const T* SmallArray<T, small_size>::cend() const {
+  return size_;
+}
+
+template <typename T, il::int_t small_size>
+T* SmallArray<T, small_size>::end() {
+  return size_;
+}
+
 template <typename T, il::int_t small_size>
 bool SmallArray<T, small_size>::smallDataUsed() const {
   return data_ == reinterpret_cast<const T*>(small_data_);
 }
 
+template <typename T, il::int_t small_size>
+bool SmallArray<T, small_size>::smallDataAligned() const {
+  return align_mod_ == 0 || reinterpret_cast<std::size_t>(small_data_) %
+                                    static_cast<std::size_t>(align_mod_) ==
+                                static_cast<std::size_t>(align_r_);
+}
+
+template <typename T, il::int_t small_size>
+void SmallArray<T, small_size>::Allocate(il::int_t r) {
+  IL_EXPECT_FAST(smallDataUsed() && size() == 0);
+
+  if (r <= small_size && smallDataAligned()) {
+    return;
+  }
+  il::int_t shift;
+  if (alignment_ == 0) {
+    data_ = il::allocateArray<T>(r);
+    shift = 0;
+  } else {
+    data_ = il::allocateArray<T>(r, align_r_, align_mod_, il::io, shift);
+  }
+  size_ = data_;
+  capacity_ = data_ + r;
+  shift_ = static_cast<short>(shift);
+}
+
+template <typename T, il::int_t small_size>
+void SmallArray<T, small_size>::Release() {
+  if (!il::isTrivial<T>::value) {
+    for (il::int_t i = size() - 1; i >= 0; --i) {
+      (data_ + i)->~T();
+    }
+  }
+  if (!smallDataUsed()) {
+    il::deallocate(data_ - shift_);
+  }
+  data_ = reinterpret_cast<T*>(small_data_);
+  size_ = data_;
+  capacity_ = data_ + small_size;
+  shift_ = 0;
+}
+
 template <typename T, il::int_t small_size>
 void SmallArray<T, small_size>::IncreaseCapacity(il::int_t r) {
   IL_EXPECT_FAST(size() <= r);
 
   const il::int_t n = size();
+  if (il::isRelocatable<T>::value && alignment_ == 0 && !smallDataUsed()) {
+    data_ = il::reallocateArray(data_, r);
+    size_ = data_ + n;
+    capacity_ = data_ + r;
+    return;
+  }
+
   T* new_data;
-  new_data = il::allocateArray<T>(r);
-  if (il::isTrivial<T>::value) {
-    memcpy(new_data, data_, n * sizeof(T));
-    if (!smallDataUsed()) {
-      il::deallocate(data_);
-    }
+  il::int_t new_shift;
+  if (alignment_ == 0) {
+    new_data = il::allocateArray<T>(r);
+    new_shift = 0;
   } else {
-    for (il::int_t i = n - 1; i >= 0; --i) {
-      new (new_data + i) T(std::move(data_[i]));
-      (data_ + i)->~T();
-    }
-    if (!smallDataUsed()) {
-      il::deallocate(data_);
-    }
+    new_data = il::allocateArray<T>(r, align_r_, align_mod_, il::io, new_shift);
+  }
+  Relocate(new_data, data_, n, trivial_t{});
+  if (!smallDataUsed()) {
+    il::deallocate(data_ - shift_);
   }
   data_ = new_data;
   size_ = data_ + n;
   capacity_ = data_ + r;
+  shift_ = static_cast<short>(new_shift);
+}
+
+template <typename T, il::int_t small_size>
+void SmallArray<T, small_size>::CopyConstruct(T* p, const T* q, il::int_t n,
+                                              std::true_type) {
+  memcpy(p, q, n * sizeof(T));
+}
+
+template <typename T, il::int_t small_size>
+void SmallArray<T, small_size>::CopyConstruct(T* p, const T* q, il::int_t n,
+                                              std::false_type) {
+  for (il::int_t i = 0; i < n; ++i) {
+    new (p + i) T(q[i]);
+  }
+}
+
+template <typename T, il::int_t small_size>
+void SmallArray<T, small_size>::Relocate(T* p, T* q, il::int_t n,
+                                         std::true_type) {
+  memcpy(p, q, n * sizeof(T));
+}
+
+template <typename T, il::int_t small_size>
+void SmallArray<T, small_size>::Relocate(T* p, T* q, il::int_t n,
+                                         std::false_type) {
+  for (il::int_t i = n - 1; i >= 0; --i) {
+    new (p + i) T(std::move(q[i]));
+    (q + i)->~T();
+  }
+}
+
+template <typename T, il::int_t small_size>
+void SmallArray<T, small_size>::CopyAssign(const T* q, il::int_t n,
+                                           std::true_type) {
+  memcpy(data_, q, n * sizeof(T));
+}
+
+template <typename T, il::int_t small_size>
+void SmallArray<T, small_size>::CopyAssign(const T* q, il::int_t n,
+                                           std::false_type) {
+  const il::int_t n_old = size();
+  for (il::int_t i = 0; i < (n < n_old ? n : n_old); ++i) {
+    data_[i] = q[i];
+  }
+  for (il::int_t i = n_old; i < n; ++i) {
+    new (data_ + i) T(q[i]);
+  }
+  for (il::int_t i = n_old - 1; i >= n; --i) {
+    (data_ + i)->~T();
+  }
+}
+
+template <typename T, il::int_t small_size>
+void SmallArray<T, small_size>::ShiftRight(il::int_t i, std::true_type) {
+  memmove(data_ + i + 1, data_ + i, (size() - i) * sizeof(T));
+}
+
+template <typename T, il::int_t small_size>
+void SmallArray<T, small_size>::ShiftRight(il::int_t i, std::false_type) {
+  const il::int_t n = size();
+  new (size_) T(std::move(data_[n - 1]));
+  for (il::int_t k = n - 1; k > i; --k) {
+    data_[k] = std::move(data_[k - 1]);
+  }
+}
+
+template <typename T, il::int_t small_size>
+il::int_t SmallArray<T, small_size>::nextCapacity() const {
+  const il::int_t n = size();
+  bool error = false;
+  const il::int_t r =
+      n > 1 ? il::safeSum(n, n / 2, il::io, error)
+            : il::safeSum(n, static_cast<il::int_t>(1), il::io, error);
+  if (error) {
+    il::abort();
+  }
+  return r;
 }
 
 template <typename T, il::int_t small_size>
@@ -634,13 +1008,24 @@ bool SmallArray<T, small_size>::invariance() const {
   if (data_ == reinterpret_cast<const T*>(small_data_)) {
     ans = ans && (size_ - data_ <= small_size);
     ans = ans && (capacity_ - data_ == small_size);
+    ans = ans && (shift_ == 0);
   } else {
     ans = ans && (size_ - data_ >= 0);
     ans = ans && (capacity_ - data_ >= 0);
     ans = ans && ((size_ - data_) <= (capacity_ - data_));
   }
+  if (align_mod_ == 0) {
+    ans = ans && (align_r_ == 0);
+    ans = ans && (shift_ == 0);
+  } else {
+    ans = ans && (align_r_ < align_mod_);
+    ans = ans && (reinterpret_cast<std::size_t>(data_) %
+                      static_cast<std::size_t>(align_mod_) ==
+                  static_cast<std::size_t>(align_r_));
+  }
   return ans;
 }
+
 }  // namespace il
 
 #endif  // IL_SMALLARRAY_H
@@ -0,0 +1,336 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#ifndef IL_SOAARRAY_H
+#define IL_SOAARRAY_H
+
+// <cstddef> is needed for std::size_t
+#include <cstddef>
+// <tuple> is needed for std::tuple
+#include <tuple>
+// <type_traits> is needed for std::integral_constant
+#include <type_traits>
+
+#include <il/container/1d/Array.h>
+#include <il/container/1d/ArrayView.h>
+
+namespace il {
+
+// The type of the k-th field of a record made of Ts...
+template <il::int_t k, typename... Ts>
+using SoAField = typename std::tuple_element<static_cast<std::size_t>(k),
+                                             std::tuple<Ts...>>::type;
+
+// The fields of trivial types are aligned on a cache line so the loops on
+// them can use aligned SIMD loads
+template <typename T>
+il::Array<T> makeSoAField(il::int_t n, std::true_type) {
+  return il::Array<T>{n, il::align, 64};
+}
+
+template <typename T>
+il::Array<T> makeSoAField(il::int_t n, std::false_type) {
+  return il::Array<T>{n};
+}
+
+// As there are no fold expressions in C++11, il::SoAFields<k, n> applies an
+// operation to the fields k, ..., n - 1 of an il::SoAArray
+template <std::size_t k, std::size_t n>
+struct SoAFields {
+  template <typename Fields>
+  static void Resize(il::int_t m, il::io_t, Fields& field) {
+    std::get<k>(field).Resize(m);
+    il::SoAFields<k + 1, n>::Resize(m, il::io, field);
+  }
+  template <typename Fields>
+  static void Reserve(il::int_t r, il::io_t, Fields& field) {
+    std::get<k>(field).Reserve(r);
+    il::SoAFields<k + 1, n>::Reserve(r, il::io, field);
+  }
+  template <typename Values, typename Fields>
+  static void Append(const Values& x, il::io_t, Fields& field) {
+    std::get<k>(field).Append(std::get<k>(x));
+    il::SoAFields<k + 1, n>::Append(x, il::io, field);
+  }
+  template <typename Values, typename Fields>
+  static void Set(il::int_t i, const Values& x, il::io_t, Fields& field) {
+    std::get<k>(field)[i] = std::get<k>(x);
+    il::SoAFields<k + 1, n>::Set(i, x, il::io, field);
+  }
+};
+
+template <std::size_t n>
+struct SoAFields<n, n> {
+  template <typename Fields>
+  static void Resize(il::int_t, il::io_t, Fields&) {}
+  template <typename Fields>
+  static void Reserve(il::int_t, il::io_t, Fields&) {}
+  template <typename Values, typename Fields>
+  static void Append(const Values&, il::io_t, Fields&) {}
+  template <typename Values, typename Fields>
+  static void Set(il::int_t, const Values&, il::io_t, Fields&) {}
+};
+
+/* \brief Read access to the record i of an il::SoAArray
+//
+// il::SoARowView<double, int> row = particle[i];
+// const double mass = row.get<0>();
+*/
+template <typename... Ts>
+class SoARowView {
+ private:
+  const std::tuple<il::Array<Ts>...>* field_;
+  il::int_t i_;
+
+ public:
+  SoARowView(const std::tuple<il::Array<Ts>...>& field, il::int_t i);
+  template <il::int_t k>
+  const il::SoAField<k, Ts...>& get() const;
+};
+
+/* \brief Read and write access to the record i of an il::SoAArray
+//
+// il::SoARowEdit<double, int> row = particle[i];
+// row.Get<0>() = 1.0;
+// row.Set(1.0, 3);
+*/
+template <typename... Ts>
+class SoARowEdit {
+ private:
+  std::tuple<il::Array<Ts>...>* field_;
+  il::int_t i_;
+
+ public:
+  SoARowEdit(il::io_t, std::tuple<il::Array<Ts>...>& field, il::int_t i);
+  template <il::int_t k>
+  const il::SoAField<k, Ts...>& get() const;
+  template <il::int_t k>
+  il::SoAField<k, Ts...>& Get();
+  void Set(const Ts&... x);
+};
+
+/* \brief An array of records stored as one array per field
+// \details A record is made of the fields Ts..., and the k-th field of all the
+// records is stored contiguously in an il::Array, aligned on a cache line when
+// its type is trivial. A loop that only needs a few fields of the records only
+// reads them from memory, and the loops on a field vectorize as they would on
+// an il::Array. All the fields share the same size and capacity.
+//
+// // The mass and the position of particles
+// il::SoAArray<double, double, double> particle{};
+// particle.Append(1.0, 0.5, 0.5);
+// il::ArrayEdit<double> mass = particle.Edit<0>();
+*/
+template <typename... Ts>
+class SoAArray {
+  static_assert(sizeof...(Ts) >= 1,
+                "il::SoAArray<Ts...>: there must be at least one field");
+
+ private:
+  std::tuple<il::Array<Ts>...> field_;
+
+ public:
+  /* \brief Default constructor
+  // \details The size and the capacity of the array are set to 0.
+  */
+  SoAArray();
+
+  /* \brief Construct an array of n records
+  // \details The fields are initialized as in il::Array<T>{n}.
+  */
+  explicit SoAArray(il::int_t n);
+
+  /* \brief Get the number of records
+   */
+  il::int_t size() const;
+
+  /* \brief Get the capacity of the array, which is the same for all fields
+   */
+  il::int_t capacity() const;
+
+  /* \brief Resize all the fields of the array
+  // \details The new elements are initialized as in il::Array<T>::Resize.
+  */
+  void Resize(il::int_t n);
+
+  /* \brief Change the capacity of all the fields to at least r
+   */
+  void Reserve(il::int_t r);
+
+  /* \brief Add a record at the end of the array
+  // \details Reallocation is done only if it is needed, for all the fields at
+  // once, and the new capacity is roughly 2 times the previous one.
+  //
+  // il::SoAArray<double, int> v{};
+  // v.Append(3.14, 2);
+  */
+  void Append(const Ts&... x);
+
+  /* \brief Access the record i
+  // \details Bound checking is done in debug mode but not in release mode.
+  */
+  il::SoARowView<Ts...> operator[](il::int_t i) const;
+
+  il::SoARowEdit<Ts...> operator[](il::int_t i);
+
+  /* \brief Get a view on the field k of all the records
+   */
+  template <il::int_t k>
+  il::ArrayView<il::SoAField<k, Ts...>> view() const;
+
+  template <il::int_t k>
+  il::ArrayEdit<il::SoAField<k, Ts...>> Edit();
+
+  /* \brief Get a pointer to the field k of the first record
+   */
+  template <il::int_t k>
+  const il::SoAField<k, Ts...>* data() const;
+
+  template <il::int_t k>
+  il::SoAField<k, Ts...>* Data();
+};
+
+template <typename... Ts>
+SoARowView<Ts...>::SoARowView(const std::tuple<il::Array<Ts>...>& field,
+                              il::int_t i)
+    : field_{&field}, i_{i} {}
+
+template <typename... Ts>
+template <il::int_t k>
+const il::SoAField<k, Ts...>& SoARowView<Ts...>::get() const {
+  return std::get<static_cast<std::size_t>(k)>(*field_)[i_];
+}
+
+template <typename... Ts>
+SoARowEdit<Ts...>::SoARowEdit(il::io_t, std::tuple<il::Array<Ts>...>& field,
+                              il::int_t i)
+    : field_{&field}, i_{i} {}
+
+template <typename... Ts>
+template <il::int_t k>
+const il::SoAField<k, Ts...>& SoARowEdit<Ts...>::get() const {
+  const std::tuple<il::Array<Ts>...>& field = *field_;
+  return std::get<static_cast<std::size_t>(k)>(field)[i_];
+}
+
+template <typename... Ts>
+template <il::int_t k>
+il::SoAField<k, Ts...>& SoARowEdit<Ts...>::Get() {
+  return std::get<static_cast<std::size_t>(k)>(*field_)[i_];
+}
+
+template <typename... Ts>
+void SoARowEdit<Ts...>::Set(const Ts&... x) {
+  il::SoAFields<0, sizeof...(Ts)>::Set(i_, std::forward_as_tuple(x...), il::io,
+                                       *field_);
+}
+
+template <typename... Ts>
+SoAArray<Ts...>::SoAArray() : SoAArray{0} {}
+
+template <typename... Ts>
+SoAArray<Ts...>::SoAArray(il::int_t n)
+    : field_{il::makeSoAField<Ts>(
+          n, std::integral_constant<bool, il::isTrivial<Ts>::value>{})...} {
+  IL_EXPECT_FAST(n >= 0);
+}
+
+template <typename... Ts>
+il::int_t SoAArray<Ts...>::size() const {
+  return std::get<0>(field_).size();
+}
+
+template <typename... Ts>
+il::int_t SoAArray<Ts...>::capacity() const {
+  return std::get<0>(field_).capacity();
+}
+
+template <typename... Ts>
+void SoAArray<Ts...>::Resize(il::int_t n) {
+  IL_EXPECT_FAST(n >= 0);
+
+  il::SoAFields<0, sizeof...(Ts)>::Resize(n, il::io, field_);
+}
+
+template <typename... Ts>
+void SoAArray<Ts...>::Reserve(il::int_t r) {
+  IL_EXPECT_FAST(r >= 0);
+
+  il::SoAFields<0, sizeof...(Ts)>::Reserve(r, il::io, field_);
+}
+
+template <typename... Ts>
+void SoAArray<Ts...>::Append(const Ts&... x) {
+  const il::int_t n = size();
+  if (n == capacity()) {
+    bool error = false;
+    const il::int_t new_capacity =
+        n > 1 ? il::safeProduct(static_cast<il::int_t>(2), n, il::io, error)
+              : il::safeSum(n, static_cast<il::int_t>(1), il::io, error);
+    if (error) {
+      il::abort();
+    }
+    Reserve(new_capacity);
+  }
+  il::SoAFields<0, sizeof...(Ts)>::Append(std::forward_as_tuple(x...), il::io,
+                                          field_);
+}
+
+template <typename... Ts>
+il::SoARowView<Ts...> SoAArray<Ts...>::operator[](il::int_t i) const {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i) <
+                   static_cast<std::size_t>(size()));
+
+  return il::SoARowView<Ts...>{field_, i};
+}
+
+template <typename... Ts>
+il::SoARowEdit<Ts...> SoAArray<Ts...>::operator[](il::int_t i) {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i) <
+                   static_cast<std::size_t>(size()));
+
+  return il::SoARowEdit<Ts...>{il::io, field_, i};
+}
+
+template <typename... Ts>
+template <il::int_t k>
+il::ArrayView<il::SoAField<k, Ts...>> SoAArray<Ts...>::view() const {
+  return std::get<static_cast<std::size_t>(k)>(field_).view();
+}
+
+template <typename... Ts>
+template <il::int_t k>
+il::ArrayEdit<il::SoAField<k, Ts...>> SoAArray<Ts...>::Edit() {
+  return std::get<static_cast<std::size_t>(k)>(field_).Edit();
+}
+
+template <typename... Ts>
+template <il::int_t k>
+const il::SoAField<k, Ts...>* SoAArray<Ts...>::data() const {
+  return std::get<static_cast<std::size_t>(k)>(field_).data();
+}
+
+template <typename... Ts>
+template <il::int_t k>
+il::SoAField<k, Ts...>* SoAArray<Ts...>::Data() {
+  return std::get<static_cast<std::size_t>(k)>(field_).Data();
+}
+
+}  // namespace il
+
+#endif  // IL_SOAARRAY_H
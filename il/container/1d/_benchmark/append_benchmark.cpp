@@ -423,6 +423,88 @@ static void Append_10000_long_long_int_Il(benchmark::State& state) {
   }
 }
 
+// Large appends, as in the mesh builders. Point is relocatable, so the
+// il::Array grows with realloc, in place if possible. NonRelocatablePoint has
+// a user-defined copy constructor and is grown with a new block where every
+// element is moved.
+
+struct Point {
+  double x;
+  double y;
+  double z;
+};
+
+struct NonRelocatablePoint {
+  double x;
+  double y;
+  double z;
+  NonRelocatablePoint(double x0, double y0, double z0) {
+    x = x0;
+    y = y0;
+    z = z0;
+  }
+  NonRelocatablePoint(const NonRelocatablePoint& p) {
+    x = p.x;
+    y = p.y;
+    z = p.z;
+  }
+};
+
+static void Append_Large_Std(benchmark::State& state) {
+  const il::int_t n = state.range(0);
+  while (state.KeepRunning()) {
+    std::vector<double> v;
+    for (il::int_t i = 0; i < n; ++i) {
+      v.push_back(0.0);
+    }
+    benchmark::DoNotOptimize(v.data());
+  }
+}
+
+static void Append_Large_Il(benchmark::State& state) {
+  const il::int_t n = state.range(0);
+  while (state.KeepRunning()) {
+    il::Array<double> v{};
+    for (il::int_t i = 0; i < n; ++i) {
+      v.Append(0.0);
+    }
+    benchmark::DoNotOptimize(v.data());
+  }
+}
+
+static void Append_Large_Point_Std(benchmark::State& state) {
+  const il::int_t n = state.range(0);
+  while (state.KeepRunning()) {
+    std::vector<Point> v;
+    for (il::int_t i = 0; i < n; ++i) {
+      v.push_back(Point{0.0, 0.0, 0.0});
+    }
+    benchmark::DoNotOptimize(v.data());
+  }
+}
+
+static void Append_Large_Point_Il(benchmark::State& state) {
+  const il::int_t n = state.range(0);
+  while (state.KeepRunning()) {
+    il::Array<Point> v{};
+    for (il::int_t i = 0; i < n; ++i) {
+      v.Append(Point{0.0, 0.0, 0.0});
+    }
+    benchmark::DoNotOptimize(v.data());
+  }
+}
+
+static void Append_Large_NonRelocatablePoint_Il(benchmark::State& state) {
+  const il::int_t n = state.range(0);
+  while (state.KeepRunning()) {
+    il::Array<NonRelocatablePoint> v{};
+    for (il::int_t i = 0; i < n; ++i) {
+      v.Append(NonRelocatablePoint{0.0, 0.0, 0.0});
+    }
+    benchmark::DoNotOptimize(v.data());
+  }
+}
+
 BENCHMARK(Append_1_Std);
 BENCHMARK(Append_1_Il);
 BENCHMARK(Append_2_Std);
@@ -465,5 +547,13 @@ BENCHMARK(Append_1000_long_long_int_Std);
 BENCHMARK(Append_1000_long_long_int_Il);
 BENCHMARK(Append_10000_long_long_int_Std);
 BENCHMARK(Append_10000_long_long_int_Il);
+BENCHMARK(Append_Large_Std)->Arg(1 << 16)->Arg(1 << 20)->Arg(1 << 24);
+BENCHMARK(Append_Large_Il)->Arg(1 << 16)->Arg(1 << 20)->Arg(1 << 24);
+BENCHMARK(Append_Large_Point_Std)->Arg(1 << 16)->Arg(1 << 20)->Arg(1 << 24);
+BENCHMARK(Append_Large_Point_Il)->Arg(1 << 16)->Arg(1 << 20)->Arg(1 << 24);
+BENCHMARK(Append_Large_NonRelocatablePoint_Il)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20)
+    ->Arg(1 << 24);
 
 BENCHMARK_MAIN()
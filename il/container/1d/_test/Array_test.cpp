@@ -19,6 +19,7 @@
 #include <gtest/gtest.h>
 
 #include <il/Array.h>
+#include <il/String.h>
 #include <il/container/1d/_test/Dummy_test.h>
 
 TEST(Array, default_constructor) {
@@ -495,3 +496,110 @@ TEST(Array, emplace_back) {
               Dummy::destroyed[1] == -(1 + 1) &&
               Dummy::destroyed[2] == -(1 + 0));
 }
+
+TEST(Array, parallel_constructor) {
+  const il::int_t n = 1000;
+  const il::int_t x = 5;
+  il::Array<il::int_t> v{n, x, il::parallel};
+
+  bool correct_elements{true};
+  for (il::int_t i = 0; i < n; ++i) {
+    if (v[i] != x) {
+      correct_elements = false;
+    }
+  }
+
+  ASSERT_TRUE(v.size() == n && v.capacity() == n && correct_elements);
+}
+
+TEST(Array, uninitialized_constructor) {
+  const il::int_t n = 10;
+  il::Array<double> v{n, il::uninitialized};
+  for (il::int_t i = 0; i < n; ++i) {
+    v[i] = static_cast<double>(i);
+  }
+
+  ASSERT_TRUE(v.size() == n && v.capacity() == n && v[n - 1] == n - 1);
+}
+
+TEST(Array, uninitialized_constructor_object) {
+  il::Array<il::Array<double>> v{3, il::uninitialized};
+
+  ASSERT_TRUE(v.size() == 3 && v[0].size() == 0 && v[2].size() == 0);
+}
+
+TEST(Array, resize_uninitialized) {
+  il::Array<il::int_t> v{3, 5};
+  v.Resize(10, il::uninitialized);
+
+  ASSERT_TRUE(v.size() == 10 && v[0] == 5 && v[1] == 5 && v[2] == 5);
+}
+
+TEST(Array, insert) {
+  il::Array<il::int_t> v{il::value, {0, 2, 3}};
+  v.Insert(1, 1);
+  v.Insert(4, 4);
+  v.Insert(0, v[4]);
+
+  ASSERT_TRUE(v.size() == 6 && v[0] == 4 && v[1] == 0 && v[2] == 1 &&
+              v[5] == 4);
+}
+
+TEST(Array, parallel_copy) {
+  const il::int_t n = 100000;
+  il::Array<il::int_t> v{n};
+  for (il::int_t i = 0; i < n; ++i) {
+    v[i] = i;
+  }
+  il::Array<il::int_t> w{v, il::parallel};
+  il::Array<il::int_t> z{10, 0};
+  z.Assign(v, il::parallel);
+
+  bool correct_elements{true};
+  for (il::int_t i = 0; i < n; ++i) {
+    if (w[i] != i || z[i] != i) {
+      correct_elements = false;
+    }
+  }
+
+  ASSERT_TRUE(w.size() == n && z.size() == n && correct_elements);
+}
+
+TEST(Array, parallel_assign_object) {
+  const il::int_t n = 1000;
+  const il::String long_string{
+      "A string that is too long to fit in the small buffer"};
+  il::Array<il::String> v{n};
+  for (il::int_t i = 0; i < n; ++i) {
+    v[i] = long_string;
+    v[i].Append(static_cast<char>('a' + i % 26));
+  }
+  // The array grows within its capacity, and then shrinks
+  il::Array<il::String> w{3, long_string};
+  w.Reserve(n);
+  w.Assign(v, il::parallel);
+  bool correct_elements = w.size() == n;
+  for (il::int_t i = 0; i < n; ++i) {
+    correct_elements = correct_elements && w[i] == v[i];
+  }
+  il::Array<il::String> z{il::value, {long_string}};
+  w.Assign(z, il::parallel);
+
+  ASSERT_TRUE(correct_elements && w.size() == 1 && w[0] == long_string);
+}
+
+TEST(Array, parallel_set) {
+  const il::int_t n = 100000;
+  il::Array<il::int_t> v{n};
+  v.Set(5, il::parallel);
+  v.Resize(2 * n, 3, il::parallel);
+
+  bool correct_elements{true};
+  for (il::int_t i = 0; i < 2 * n; ++i) {
+    if (v[i] != (i < n ? 5 : 3)) {
+      correct_elements = false;
+    }
+  }
+
+  ASSERT_TRUE(v.size() == 2 * n && correct_elements);
+}
@@ -0,0 +1,122 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#include <gtest/gtest.h>
+
+#include <il/Array.h>
+#include <il/ChunkedArray.h>
+#include <il/String.h>
+
+TEST(ChunkedArray, default_constructor) {
+  il::ChunkedArray<double> v{};
+
+  ASSERT_TRUE(v.size() == 0 && v.capacity() == 0 && v.nbChunks() == 0);
+}
+
+TEST(ChunkedArray, constructor) {
+  il::ChunkedArray<il::int_t, 4> v{10, 3};
+
+  ASSERT_TRUE(v.size() == 10 && v.capacity() == 12 && v.nbChunks() == 3 &&
+              v[0] == 3 && v[9] == 3);
+}
+
+TEST(ChunkedArray, stable_address) {
+  il::ChunkedArray<il::int_t, 4> v{};
+  v.Append(0);
+  const il::int_t* p = &v[0];
+  for (il::int_t i = 1; i < 100; ++i) {
+    v.Append(i);
+  }
+
+  bool correct = true;
+  for (il::int_t i = 0; i < 100; ++i) {
+    if (v[i] != i) {
+      correct = false;
+    }
+  }
+
+  ASSERT_TRUE(correct && p == &v[0] && v.size() == 100 &&
+              v.capacity() == 100 && v.back() == 99);
+}
+
+TEST(ChunkedArray, many_chunks) {
+  const il::int_t n = 1000;
+  il::ChunkedArray<il::int_t, 1> v{};
+  il::Array<const il::int_t*> p{n};
+  for (il::int_t i = 0; i < n; ++i) {
+    v.Append(i);
+    p[i] = &v[i];
+  }
+  il::ChunkedArray<il::int_t, 1> w{};
+  w = std::move(v);
+
+  bool correct = true;
+  for (il::int_t i = 0; i < n; ++i) {
+    if (w[i] != i || &w[i] != p[i] || w.chunk(i).data() != p[i]) {
+      correct = false;
+    }
+  }
+
+  ASSERT_TRUE(correct && w.size() == n && w.nbChunks() == n &&
+              w.capacity() == n && v.size() == 0 && v.capacity() == 0);
+}
+
+TEST(ChunkedArray, append_self) {
+  il::ChunkedArray<il::int_t, 2> v{};
+  v.Append(1);
+  v.Append(2);
+  v.Append(v[0]);
+
+  ASSERT_TRUE(v.size() == 3 && v[2] == 1);
+}
+
+TEST(ChunkedArray, chunk) {
+  il::ChunkedArray<il::int_t, 4> v{10, 0};
+  for (il::int_t k = 0; k < v.nbChunks(); ++k) {
+    il::ArrayEdit<il::int_t> w = v.Chunk(k);
+    for (il::int_t i = 0; i < w.size(); ++i) {
+      w[i] = k;
+    }
+  }
+
+  ASSERT_TRUE(v.chunk(0).size() == 4 && v.chunk(2).size() == 2 &&
+              v[3] == 0 && v[4] == 1 && v[9] == 2);
+}
+
+TEST(ChunkedArray, resize) {
+  il::ChunkedArray<il::int_t, 4> v{3, 1};
+  v.Resize(9);
+  v[8] = 2;
+  v.Resize(2);
+
+  ASSERT_TRUE(v.size() == 2 && v.capacity() == 12 && v[1] == 1 &&
+              v.nbChunks() == 1);
+}
+
+TEST(ChunkedArray, object) {
+  il::ChunkedArray<il::String, 2> v{};
+  v.Append(il::String{"Hello"});
+  v.Append(il::emplace, "World");
+  v.Append(il::String{"!"});
+  il::ChunkedArray<il::String, 2> w = v;
+  v[0] = il::String{"Bye"};
+  il::ChunkedArray<il::String, 2> z = std::move(v);
+
+  ASSERT_TRUE(w.size() == 3 && w[0] == "Hello" && w[1] == "World" &&
+              w[2] == "!" && z.size() == 3 && z[0] == "Bye" && v.size() == 0);
+}
@@ -0,0 +1,148 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#include <gtest/gtest.h>
+
+#include <il/Array.h>
+#include <il/SmallArray.h>
+#include <il/String.h>
+
+TEST(SmallArray, default_constructor) {
+  il::SmallArray<double, 4> v{};
+
+  ASSERT_TRUE(v.size() == 0 && v.capacity() == 4);
+}
+
+TEST(SmallArray, size_constructor) {
+  il::SmallArray<il::String, 4> v{6};
+
+  ASSERT_TRUE(v.size() == 6 && v.capacity() == 6 && v[5].size() == 0);
+}
+
+TEST(SmallArray, emplace_constructor) {
+  il::SmallArray<il::String, 4> v{3, il::emplace, "abc"};
+
+  ASSERT_TRUE(v.size() == 3 && v[0].isEqual("abc") && v[2].isEqual("abc"));
+}
+
+TEST(SmallArray, view_constructor) {
+  il::Array<il::int_t> w{il::value, {1, 2, 3, 4, 5}};
+  il::SmallArray<il::int_t, 4> v{w.view()};
+
+  ASSERT_TRUE(v.size() == 5 && v[0] == 1 && v[4] == 5);
+}
+
+TEST(SmallArray, align_constructor) {
+  il::SmallArray<double, 4> v{3, 0.0, il::align, 64};
+  v.Append(1.0);
+  v.Append(2.0);
+
+  ASSERT_TRUE(v.alignment() == 64 &&
+              reinterpret_cast<std::size_t>(v.data()) % 64 == 0 &&
+              v.size() == 5 && v[0] == 0.0 && v[4] == 2.0);
+}
+
+TEST(SmallArray, resize) {
+  il::SmallArray<il::String, 4> v{3, il::String{"abc"}};
+  v.Resize(1);
+  v.Resize(6, il::emplace, "def");
+
+  ASSERT_TRUE(v.size() == 6 && v[0].isEqual("abc") && v[1].isEqual("def") &&
+              v[5].isEqual("def"));
+}
+
+TEST(SmallArray, reserve) {
+  il::SmallArray<il::int_t, 4> v{il::value, {1, 2}};
+  v.Reserve(3);
+  const bool small = v.capacity() == 4;
+  v.Reserve(10);
+
+  ASSERT_TRUE(small && v.capacity() == 10 && v.size() == 2 && v[1] == 2);
+}
+
+TEST(SmallArray, append) {
+  il::SmallArray<il::String, 2> v{};
+  v.Append(il::String{"a"});
+  v.Append(il::emplace, "b");
+  const il::String c{"c"};
+  v.Append(c);
+
+  ASSERT_TRUE(v.size() == 3 && v[0].isEqual("a") && v[1].isEqual("b") &&
+              v[2].isEqual("c"));
+}
+
+TEST(SmallArray, insert) {
+  il::SmallArray<il::int_t, 4> v{il::value, {0, 2, 3, 4}};
+  v.Insert(1, 1);
+  v.Insert(5, 5);
+  v.Insert(0, v[0]);
+
+  ASSERT_TRUE(v.size() == 7 && v[0] == 0 && v[1] == 0 && v[2] == 1 &&
+              v[3] == 2 && v[6] == 5);
+}
+
+TEST(SmallArray, insert_object) {
+  il::SmallArray<il::String, 4> v{};
+  v.Append(il::String{"b"});
+  v.Insert(0, il::String{"a"});
+  v.Insert(2, il::String{"c"});
+
+  ASSERT_TRUE(v.size() == 3 && v[0].isEqual("a") && v[1].isEqual("b") &&
+              v[2].isEqual("c"));
+}
+
+TEST(SmallArray, move_constructor_small) {
+  il::SmallArray<il::String, 4> v{};
+  v.Append(il::String{"a"});
+  il::SmallArray<il::String, 4> w{std::move(v)};
+
+  ASSERT_TRUE(w.size() == 1 && w[0].isEqual("a") && v.size() == 0);
+}
+
+TEST(SmallArray, move_assignment) {
+  il::SmallArray<il::int_t, 2> v{il::value, {1, 2, 3}};
+  il::SmallArray<il::int_t, 2> w{il::value, {4}};
+  const il::int_t* p = v.data();
+  w = std::move(v);
+  il::SmallArray<il::int_t, 2> z{il::value, {5, 6, 7}};
+  z = std::move(w);
+
+  ASSERT_TRUE(z.size() == 3 && z.data() == p && z[2] == 3 && v.size() == 0 &&
+              w.size() == 0 && w.capacity() == 2);
+}
+
+TEST(SmallArray, copy_assignment) {
+  il::SmallArray<il::String, 2> v{};
+  v.Append(il::String{"a"});
+  il::SmallArray<il::String, 2> w{3};
+  w = v;
+
+  ASSERT_TRUE(w.size() == 1 && w[0].isEqual("a"));
+}
+
+TEST(SmallArray, edit) {
+  il::SmallArray<il::int_t, 4> v{3, 0};
+  il::ArrayEdit<il::int_t> e = v.Edit();
+  e[1] = 1;
+  il::int_t sum = 0;
+  for (il::int_t x : v) {
+    sum += x;
+  }
+
+  ASSERT_TRUE(v.view()[1] == 1 && sum == 1);
+}
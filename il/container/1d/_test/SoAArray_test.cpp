@@ -0,0 +1,102 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#include <gtest/gtest.h>
+
+#include <il/SoAArray.h>
+#include <il/String.h>
+
+TEST(SoAArray, default_constructor) {
+  il::SoAArray<double, int> v{};
+
+  ASSERT_TRUE(v.size() == 0 && v.capacity() == 0);
+}
+
+TEST(SoAArray, constructor) {
+  il::SoAArray<double, float, int> v{5};
+
+  ASSERT_TRUE(v.size() == 5 && v.capacity() == 5 &&
+              v.view<0>().size() == 5 && v.view<2>().size() == 5 &&
+              reinterpret_cast<std::size_t>(v.data<0>()) % 64 == 0 &&
+              reinterpret_cast<std::size_t>(v.data<1>()) % 64 == 0 &&
+              reinterpret_cast<std::size_t>(v.data<2>()) % 64 == 0);
+}
+
+TEST(SoAArray, append) {
+  il::SoAArray<double, int> v{};
+  for (il::int_t i = 0; i < 100; ++i) {
+    v.Append(0.5 * i, static_cast<int>(i));
+  }
+
+  bool correct = v.size() == 100 && v.view<0>().size() == 100 &&
+                 v.view<1>().size() == 100;
+  for (il::int_t i = 0; i < 100; ++i) {
+    if (v[i].get<0>() != 0.5 * i || v[i].get<1>() != i) {
+      correct = false;
+    }
+  }
+  ASSERT_TRUE(correct &&
+              reinterpret_cast<std::size_t>(v.data<0>()) % 64 == 0 &&
+              reinterpret_cast<std::size_t>(v.data<1>()) % 64 == 0);
+}
+
+TEST(SoAArray, resize) {
+  il::SoAArray<double, int> v{2};
+  v[1].Set(1.0, 1);
+  v.Resize(5);
+  v.Reserve(10);
+
+  ASSERT_TRUE(v.size() == 5 && v.capacity() == 10 && v[1].get<0>() == 1.0 &&
+              v[1].get<1>() == 1 && v.view<1>().size() == 5);
+}
+
+TEST(SoAArray, row) {
+  il::SoAArray<double, int> v{3};
+  for (il::int_t i = 0; i < 3; ++i) {
+    il::SoARowEdit<double, int> row = v[i];
+    row.Get<0>() = 2.0 * i;
+    row.Get<1>() = static_cast<int>(i);
+  }
+  const il::SoAArray<double, int>& w = v;
+  il::SoARowView<double, int> row = w[2];
+
+  ASSERT_TRUE(row.get<0>() == 4.0 && row.get<1>() == 2 && v.data<0>()[1] == 2.0);
+}
+
+TEST(SoAArray, edit) {
+  il::SoAArray<float, float> v{4};
+  il::ArrayEdit<float> x = v.Edit<0>();
+  il::ArrayEdit<float> y = v.Edit<1>();
+  for (il::int_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<float>(i);
+    y[i] = 2 * x[i];
+  }
+
+  ASSERT_TRUE(v[3].get<0>() == 3.0f && v[3].get<1>() == 6.0f);
+}
+
+TEST(SoAArray, object) {
+  il::SoAArray<il::String, double> v{};
+  v.Append(il::String{"Hello"}, 1.0);
+  v.Append(il::String{"World"}, 2.0);
+  il::SoAArray<il::String, double> w = v;
+  v[0].Get<0>() = il::String{"Bye"};
+
+  ASSERT_TRUE(w.size() == 2 && w[0].get<0>() == "Hello" &&
+              w[1].get<1>() == 2.0 && v[0].get<0>() == "Bye");
+}
@@ -25,6 +25,8 @@
 #include <initializer_list>
 // <new> is needed for placement new
 #include <new>
+// <type_traits> is needed for std::is_trivial
+#include <type_traits>
 // <utility> is needed for std::move
 #include <utility>
 
@@ -44,6 +46,7 @@ class Array2C {
   short align_r_;
   short align_mod_;
   short shift_;
+  bool pad_;
 
  public:
   /* \brief Default constructor
@@ -70,6 +73,15 @@ class Array2C {
   */
   explicit Array2C(il::int_t n0, il::int_t n1);
 
+  /* \brief Construct an array without initializing its elements
+  // \details When T is trivial, the elements are left uninitialized, even in
+  // debug mode. It should be used for arrays that are overwritten right after
+  // their construction. Otherwise, the elements are default constructed.
+  //
+  // il::Array2C<double> A{n0, n1, il::uninitialized};
+  */
+  explicit Array2C(il::int_t n0, il::int_t n1, il::uninitialized_t);
+
   /* \brief Construct an il::Array2C<T> of n rows and p columns
   // \details The pointer data, when considered as an integer, satisfies
   // data_ = align_r (Modulo align_mod)
@@ -84,6 +96,19 @@ class Array2C {
   explicit Array2C(il::int_t n0, il::int_t n1, il::align_t,
                    il::int_t alignment);
 
+  /* \brief Construct an array with a padded leading dimension
+  // \details The array is aligned on a cache line and its column capacity is a
+  // multiple of a cache line, so every row is aligned for SIMD. The column
+  // capacity is then increased by a cache line when the distance between two
+  // rows is a multiple of 512 bytes, which would map the rows on a few cache
+  // sets. The padding is kept by the copies, Resize and Reserve.
+  //
+  // il::Array2C<double> A{1024, 1024, il::pad};
+  */
+  explicit Array2C(il::int_t n0, il::int_t n1, il::pad_t);
+
+  explicit Array2C(il::int_t n0, il::int_t n1, const T& x, il::pad_t);
+
   /* \brief Construct an array of n rows and p columns with a value
   /
   // // Construct an array of double with 3 rows and 5 columns, initialized with
@@ -180,6 +205,12 @@ class Array2C {
   */
   void Resize(il::int_t n0, il::int_t n1);
 
+  /* \brief Resizing an il::Array2C<T> without initializing the new elements
+  // \details When T is trivial, the new elements are left uninitialized, even
+  // in debug mode. Otherwise, they are default constructed.
+  */
+  void Resize(il::int_t n0, il::int_t n1, il::uninitialized_t);
+
   /* \brief Get the capacity of the il::Array2C<T>
   // \details capacity(0) gives the capacity in terms of rows and capacity(1)
   // gives the capacity in terms of columns.
@@ -226,6 +257,12 @@ class Array2C {
   il::int_t stride(il::int_t d) const;
 
  private:
+  /* \brief Used internally by Resize
+  // \details The new elements are initialized, as in Resize(n0, n1), unless
+  // initialize is false and T is trivial
+  */
+  void SetSize(il::int_t n0, il::int_t n1, bool initialize);
+
   /* \brief Used internally in debug mode to check the invariance of the object
    */
   bool invariance() const;
@@ -239,6 +276,7 @@ Array2C<T>::Array2C() {
   capacity_[0] = nullptr;
   capacity_[1] = nullptr;
   alignment_ = 0;
+  pad_ = false;
   align_r_ = 0;
   align_mod_ = 0;
   shift_ = 0;
@@ -281,6 +319,7 @@ Array2C<T>::Array2C(il::int_t n0, il::int_t n1) {
   capacity_[0] = data_ + r0;
   capacity_[1] = data_ + r1;
   alignment_ = 0;
+  pad_ = false;
   align_r_ = 0;
   align_mod_ = 0;
   shift_ = 0;
@@ -355,6 +394,7 @@ Array2C<T>::Array2C(il::int_t n0, il::int_t n1, il::align_t,
   capacity_[0] = data_ + r0;
   capacity_[1] = data_ + r1;
   alignment_ = static_cast<short>(alignment);
+  pad_ = false;
   align_r_ = static_cast<short>(align_r);
   align_mod_ = static_cast<short>(align_mod);
 }
@@ -391,6 +431,7 @@ Array2C<T>::Array2C(il::int_t n0, il::int_t n1, const T& x) {
   capacity_[0] = data_ + r0;
   capacity_[1] = data_ + r1;
   alignment_ = 0;
+  pad_ = false;
   align_r_ = 0;
   align_mod_ = 0;
   shift_ = 0;
@@ -463,6 +504,7 @@ Array2C<T>::Array2C(il::int_t n0, il::int_t n1, const T& x, il::align_t,
   capacity_[0] = data_ + r0;
   capacity_[1] = data_ + r1;
   alignment_ = static_cast<short>(alignment);
+  pad_ = false;
   align_r_ = static_cast<short>(align_r);
   align_mod_ = static_cast<short>(align_mod);
 }
@@ -533,11 +575,40 @@ Array2C<T>::Array2C(il::value_t,
   capacity_[0] = data_ + r0;
   capacity_[1] = data_ + r1;
   alignment_ = 0;
+  pad_ = false;
   align_r_ = 0;
   align_mod_ = 0;
   shift_ = 0;
 }
 
+template <typename T>
+Array2C<T>::Array2C(il::int_t n0, il::int_t n1, il::pad_t) : Array2C{} {
+  IL_EXPECT_FAST(il::isTrivial<T>::value);
+  IL_EXPECT_FAST(64 % alignof(T) == 0);
+
+  alignment_ = 64;
+  align_r_ = 0;
+  align_mod_ = 64;
+  pad_ = true;
+  SetSize(n0, n1, true);
+}
+
+template <typename T>
+Array2C<T>::Array2C(il::int_t n0, il::int_t n1, const T& x, il::pad_t)
+    : Array2C{n0, n1, il::pad} {
+  for (il::int_t i0 = 0; i0 < n0; ++i0) {
+    for (il::int_t i1 = 0; i1 < n1; ++i1) {
+      data_[i0 * (capacity_[1] - data_) + i1] = x;
+    }
+  }
+}
+
+template <typename T>
+Array2C<T>::Array2C(il::int_t n0, il::int_t n1, il::uninitialized_t)
+    : Array2C{} {
+  SetSize(n0, n1, false);
+}
+
 template <typename T>
 Array2C<T>::Array2C(const Array2C<T>& A) {
   const il::int_t n0 = A.size(0);
@@ -545,15 +616,21 @@ Array2C<T>::Array2C(const Array2C<T>& A) {
   il::int_t r0;
   il::int_t r1;
   if (n0 > 0 && n1 > 0) {
-    if (il::isTrivial<T>::value && A.align_mod_ != 0) {
+    if (il::isTrivial<T>::value && A.alignment_ != 0) {
       r0 = n0;
       const il::int_t nb_lanes = static_cast<il::int_t>(
-          static_cast<std::size_t>(alignment_) / alignof(T));
+          static_cast<std::size_t>(A.alignment_) / alignof(T));
       bool error = false;
       r1 = il::safeUpperRound(n1, nb_lanes, il::io, error);
       if (error) {
         il::abort();
       }
+      if (A.pad_) {
+        r1 = il::padLeadingDimension<T>(r1, nb_lanes, il::io, error);
+        if (error) {
+          il::abort();
+        }
+      }
     } else {
       r0 = n0;
       r1 = n1;
@@ -596,6 +673,7 @@ Array2C<T>::Array2C(const Array2C<T>& A) {
   capacity_[0] = data_ + r0;
   capacity_[1] = data_ + r1;
   alignment_ = A.alignment_;
+  pad_ = A.pad_;
   align_r_ = A.align_r_;
   align_mod_ = A.align_mod_;
 }
@@ -608,6 +686,7 @@ Array2C<T>::Array2C(Array2C<T>&& A) {
   capacity_[0] = A.capacity_[0];
   capacity_[1] = A.capacity_[1];
   alignment_ = A.alignment_;
+  pad_ = A.pad_;
   align_r_ = A.align_r_;
   align_mod_ = A.align_mod_;
   shift_ = A.shift_;
@@ -617,6 +696,7 @@ Array2C<T>::Array2C(Array2C<T>&& A) {
   A.capacity_[0] = nullptr;
   A.capacity_[1] = nullptr;
   A.alignment_ = 0;
+  A.pad_ = false;
   A.align_r_ = 0;
   A.align_mod_ = 0;
   A.shift_ = 0;
@@ -632,7 +712,7 @@ Array2C<T>& Array2C<T>::operator=(const Array2C<T>& A) {
     const il::int_t align_mod = A.align_mod_;
     const bool need_memory = capacity(0) < n0 || capacity(1) < n1 ||
                              align_mod_ != align_mod || align_r_ != align_r ||
-                             alignment_ != alignment;
+                             alignment_ != alignment || pad_ != A.pad_;
     if (need_memory) {
       il::int_t r0;
       il::int_t r1;
@@ -646,6 +726,12 @@ Array2C<T>& Array2C<T>::operator=(const Array2C<T>& A) {
           if (error) {
             il::abort();
           }
+          if (A.pad_) {
+            r1 = il::padLeadingDimension<T>(r1, nb_lanes, il::io, error);
+            if (error) {
+              il::abort();
+            }
+          }
         } else {
           r0 = n0;
           r1 = n1;
@@ -696,6 +782,7 @@ Array2C<T>& Array2C<T>::operator=(const Array2C<T>& A) {
       capacity_[0] = data_ + r0;
       capacity_[1] = data_ + r1;
       alignment_ = static_cast<short>(alignment);
+      pad_ = A.pad_;
       align_r_ = static_cast<short>(align_r);
       align_mod_ = static_cast<short>(align_mod);
     } else {
@@ -742,6 +829,7 @@ Array2C<T>& Array2C<T>::operator=(Array2C<T>&& A) {
     capacity_[0] = A.capacity_[0];
     capacity_[1] = A.capacity_[1];
     alignment_ = A.alignment_;
+    pad_ = A.pad_;
     align_r_ = A.align_r_;
     align_mod_ = A.align_mod_;
     shift_ = A.shift_;
@@ -751,6 +839,7 @@ Array2C<T>& Array2C<T>::operator=(Array2C<T>&& A) {
     A.capacity_[0] = nullptr;
     A.capacity_[1] = nullptr;
     A.alignment_ = 0;
+    A.pad_ = false;
     A.align_r_ = 0;
     A.align_mod_ = 0;
     A.shift_ = 0;
@@ -812,6 +901,16 @@ il::int_t Array2C<T>::size(il::int_t d) const {
 
 template <typename T>
 void Array2C<T>::Resize(il::int_t n0, il::int_t n1) {
+  SetSize(n0, n1, true);
+}
+
+template <typename T>
+void Array2C<T>::Resize(il::int_t n0, il::int_t n1, il::uninitialized_t) {
+  SetSize(n0, n1, false);
+}
+
+template <typename T>
+void Array2C<T>::SetSize(il::int_t n0, il::int_t n1, bool initialize) {
   IL_EXPECT_FAST(n0 >= 0);
   IL_EXPECT_FAST(n1 >= 0);
 
@@ -831,6 +930,12 @@ void Array2C<T>::Resize(il::int_t n0, il::int_t n1) {
         if (error) {
           il::abort();
         }
+        if (pad_) {
+          r1 = il::padLeadingDimension<T>(r1, nb_lanes, il::io, error);
+          if (error) {
+            il::abort();
+          }
+        }
       } else {
         r0 = n0;
         r1 = n1;
@@ -865,9 +970,11 @@ void Array2C<T>::Resize(il::int_t n0, il::int_t n1) {
         il::deallocate(data_ - shift_);
       }
 #ifdef IL_DEFAULT_VALUE
-      for (il::int_t i0 = 0; i0 < n0; ++i0) {
-        for (il::int_t i1 = i0 < n0_old ? n1_old : 0; i1 < n1; ++i1) {
-          new_data[i0 * r1 + i1] = il::defaultValue<T>();
+      if (initialize) {
+        for (il::int_t i0 = 0; i0 < n0; ++i0) {
+          for (il::int_t i1 = i0 < n0_old ? n1_old : 0; i1 < n1; ++i1) {
+            new_data[i0 * r1 + i1] = il::defaultValue<T>();
+          }
         }
       }
 #endif
@@ -889,9 +996,11 @@ void Array2C<T>::Resize(il::int_t n0, il::int_t n1) {
         }
         il::deallocate(data_);
       }
-      for (il::int_t i0 = 0; i0 < n0; ++i0) {
-        for (il::int_t j1 = i0 < n0_old ? n1_old : 0; j1 < n1; ++j1) {
-          new (new_data + i0 * r1 + j1) T{};
+      if (initialize || !std::is_trivial<T>::value) {
+        for (il::int_t i0 = 0; i0 < n0; ++i0) {
+          for (il::int_t j1 = i0 < n0_old ? n1_old : 0; j1 < n1; ++j1) {
+            new (new_data + i0 * r1 + j1) T{};
+          }
         }
       }
     }
@@ -902,9 +1011,11 @@ void Array2C<T>::Resize(il::int_t n0, il::int_t n1) {
   } else {
     if (il::isTrivial<T>::value) {
 #ifdef IL_DEFAULT_VALUE
-      for (il::int_t i0 = 0; i0 < n0; ++i0) {
-        for (il::int_t i1 = i0 < n0_old ? n1_old : 0; i1 < n1; ++i1) {
-          data_[i0 * capacity(1) + i1] = il::defaultValue<T>();
+      if (initialize) {
+        for (il::int_t i0 = 0; i0 < n0; ++i0) {
+          for (il::int_t i1 = i0 < n0_old ? n1_old : 0; i1 < n1; ++i1) {
+            data_[i0 * capacity(1) + i1] = il::defaultValue<T>();
+          }
         }
       }
 #endif
@@ -914,9 +1025,11 @@ void Array2C<T>::Resize(il::int_t n0, il::int_t n1) {
           (data_ + i0 * capacity(1) + j1)->~T();
         }
       }
-      for (il::int_t i0 = 0; i0 < n0; ++i0) {
-        for (il::int_t i1 = i0 < n0_old ? n1_old : 0; i1 < n1; ++i1) {
-          new (data_ + i0 * capacity(1) + i1) T{};
+      if (initialize || !std::is_trivial<T>::value) {
+        for (il::int_t i0 = 0; i0 < n0; ++i0) {
+          for (il::int_t i1 = i0 < n0_old ? n1_old : 0; i1 < n1; ++i1) {
+            new (data_ + i0 * capacity(1) + i1) T{};
+          }
         }
       }
     }
@@ -950,6 +1063,12 @@ void Array2C<T>::Reserve(il::int_t r0, il::int_t r1) {
       if (error) {
         il::abort();
       }
+      if (pad_) {
+        r1 = il::padLeadingDimension<T>(r1, nb_lanes, il::io, error);
+        if (error) {
+          il::abort();
+        }
+      }
     }
     bool error = false;
     const il::int_t r = il::safeProduct(r0, r1, il::io, error);
@@ -1086,9 +1205,12 @@ bool Array2C<T>::invariance() const {
     ans = ans && (size_[1] == nullptr);
     ans = ans && (capacity_[0] == nullptr);
     ans = ans && (capacity_[1] == nullptr);
-    ans = ans && (align_mod_ == 0);
-    ans = ans && (align_r_ == 0);
-    ans = ans && (alignment_ == 0);
+    // An empty padded array keeps its alignment for the next allocation
+    if (!pad_) {
+      ans = ans && (align_mod_ == 0);
+      ans = ans && (align_r_ == 0);
+      ans = ans && (alignment_ == 0);
+    }
     ans = ans && (shift_ == 0);
   } else {
     ans = ans && (size_[0] != nullptr);
@@ -1104,6 +1226,7 @@ bool Array2C<T>::invariance() const {
       ans = ans && (align_r_ % alignof(T) == 0);
       ans = ans && (align_mod_ % alignof(T) == 0);
       ans = ans && (alignment_ % alignof(T) == 0);
+      ans = ans && (!pad_ || alignment_ > 0);
       if (alignment_ > 0) {
         ans = ans && (align_r_ % alignment_ == 0);
         ans = ans && (align_mod_ > 0);
@@ -1120,6 +1243,7 @@ bool Array2C<T>::invariance() const {
       ans = ans && (align_r_ == 0);
       ans = ans && (align_mod_ == 0);
       ans = ans && (alignment_ == 0);
+      ans = ans && !pad_;
     }
   }
   return ans;
@@ -25,12 +25,17 @@
 #include <initializer_list>
 // <new> is needed for placement new
 #include <new>
+// <type_traits> is needed for std::is_trivial
+#include <type_traits>
 // <utility> is needed for std::move
 #include <utility>
 
 #include <il/container/1d/ArrayView.h>
 #include <il/container/2d/Array2DView.h>
+#include <il/container/expression/Expression.h>
+#include <il/core/memory/HugePage.h>
 #include <il/core/memory/allocate.h>
+#include <il/core/thread/parallel.h>
 
 namespace il {
 
@@ -44,6 +49,7 @@ class Array2D {
   short align_r_;
   short align_mod_;
   short shift_;
+  bool pad_;
 
  public:
   /* \brief Default constructor
@@ -70,6 +76,15 @@ class Array2D {
   */
   explicit Array2D(il::int_t n0, il::int_t n1);
 
+  /* \brief Construct an array without initializing its elements
+  // \details When T is trivial, the elements are left uninitialized, even in
+  // debug mode. It should be used for arrays that are overwritten right after
+  // their construction. Otherwise, the elements are default constructed.
+  //
+  // il::Array2D<double> A{n0, n1, il::uninitialized};
+  */
+  explicit Array2D(il::int_t n0, il::int_t n1, il::uninitialized_t);
+
   /* \brief Construct an aligned array
   // \details The pointer data, when considered as an integer, satisfies
   // data_ = 0 (Modulo align_mod)
@@ -84,6 +99,22 @@ class Array2D {
   explicit Array2D(il::int_t n0, il::int_t n1, il::align_t, il::int_t alignment,
                    il::int_t align_r, il::int_t align_mod);
 
+  /* \brief Construct an array with a padded leading dimension
+  // \details The array is aligned on a cache line and its row capacity is a
+  // multiple of a cache line, so every column is aligned for SIMD. The row
+  // capacity is then increased by a cache line when the distance between two
+  // columns is a multiple of 512 bytes, which would map the columns on a few
+  // cache sets. For instance, with n0 = 1024, the columns of an
+  // il::Array2D<double> are 8200 bytes apart instead of 8192. The padding is
+  // kept by the copies, Resize and Reserve. As stride(1) gives the distance
+  // between two columns, the BLAS and LAPACK wrappers can be used as usual.
+  //
+  // il::Array2D<double> A{1024, 1024, il::pad};
+  */
+  explicit Array2D(il::int_t n0, il::int_t n1, il::pad_t);
+
+  explicit Array2D(il::int_t n0, il::int_t n1, const T& x, il::pad_t);
+
   /* \brief Construct an array of n rows and p columns with a value
   /
   // // Construct an array of double with 3 rows and 5 columns, initialized with
@@ -92,6 +123,34 @@ class Array2D {
   */
   explicit Array2D(il::int_t n0, il::int_t n1, const T& x);
 
+  /* \brief Construct an array backed by huge pages
+  // \details The memory is obtained from il::hugePageAllocator() which uses a
+  // 2 MiB aligned mmap with madvise(MADV_HUGEPAGE), and falls back to the heap
+  // when it is not possible. Use backing() to know which one has been used.
+  // Reallocations done later by Resize or Reserve use the allocator of the
+  // thread.
+  //
+  // il::Array2D<double> A{n0, n1, il::hugepage};
+  */
+  explicit Array2D(il::int_t n0, il::int_t n1, il::hugepage_t);
+
+  explicit Array2D(il::int_t n0, il::int_t n1, const T& x, il::hugepage_t);
+
+  /* \brief Construct an array of n0 rows and n1 columns with a value, in
+  // parallel
+  // \details The columns are initialized by il::parallelForStatic, which
+  // splits them in il::nbThreads() contiguous chunks as an OpenMP loop on the
+  // columns with a static schedule on all the threads. As a page of memory is
+  // placed on the NUMA node of the thread that first touches it, loops on
+  // [0, n1) with the same static schedule, with no chunk size and the default
+  // number of threads, or il::parallelForStatic, only access local memory.
+  // Arrays with less than a page of memory per thread are initialized by the
+  // calling thread. All the members taking il::parallel use the same chunks.
+  //
+  // il::Array2D<double> A{n0, n1, 0.0, il::parallel};
+  */
+  explicit Array2D(il::int_t n0, il::int_t n1, const T& x, il::parallel_t);
+
   template <typename... Args>
   explicit Array2D(il::int_t n0, il::int_t n1, il::emplace_t, Args&&... args);
 
@@ -116,6 +175,14 @@ class Array2D {
   */
   Array2D(const Array2D<T>& A);
 
+  /* \brief The copy constructor, in parallel
+  // \details The columns are copied by il::parallelForStatic. The constructed
+  // array is the same as the one given by the copy constructor.
+  //
+  // il::Array2D<double> B{A, il::parallel};
+  */
+  Array2D(const Array2D<T>& A, il::parallel_t);
+
   /* \brief The move constructor
    */
   Array2D(Array2D<T>&& A);
@@ -131,6 +198,25 @@ class Array2D {
    */
   Array2D& operator=(Array2D<T>&& A);
 
+  /* \brief The copy assignment, in parallel
+  // \details The columns are copied by il::parallelForStatic. The array ends
+  // up in the same state as with the copy assignment.
+  */
+  void Assign(const Array2D<T>& A, il::parallel_t);
+
+  /* \brief Evaluate an expression
+  // \details The array takes the sizes of the expression and keeps its
+  // alignment, and all its elements are computed in a single loop. When the
+  // sizes do not change, the elements are written in place: an operand may be
+  // this array itself, but not a view of it with shifted indices. See
+  // <il/expression.h>.
+  //
+  // il::Array2D<double> C{};
+  // C = a * A + B;
+  */
+  template <typename E>
+  Array2D& operator=(const il::Expression<E>& expression);
+
   /* \brief The destructor
    */
   ~Array2D();
@@ -155,6 +241,14 @@ class Array2D {
   */
   T& operator()(il::int_t i0, il::int_t i1);
 
+  /* \brief Set all the elements of the array to x
+   */
+  void Set(const T& x);
+
+  /* \brief Set all the elements of the array to x, in parallel
+   */
+  void Set(const T& x, il::parallel_t);
+
   /* \brief Get the size of the il::Array2D<T>
   // \details size(0) returns the number of rows of the array and size(1)
   // returns the number of columns of the same array. The library has been
@@ -181,8 +275,21 @@ class Array2D {
   */
   void Resize(il::int_t n0, il::int_t n1);
 
+  /* \brief Resizing an il::Array2D<T> without initializing the new elements
+  // \details When T is trivial, the new elements are left uninitialized, even
+  // in debug mode. Otherwise, they are default constructed.
+  */
+  void Resize(il::int_t n0, il::int_t n1, il::uninitialized_t);
+
   void Resize(il::int_t n0, il::int_t n1, const T& x);
 
+  /* \brief Resizing an il::Array2D<T>, the new elements being set to x in
+  // parallel
+  // \details The new elements are initialized by il::parallelForStatic when T
+  // is trivial. Otherwise, this method is the same as Resize(n0, n1, x).
+  */
+  void Resize(il::int_t n0, il::int_t n1, const T& x, il::parallel_t);
+
   template <typename... Args>
   void Resize(il::int_t n0, il::int_t n1, il::emplace_t, Args&&... args);
 
@@ -240,7 +347,29 @@ class Array2D {
   */
   il::int_t stride(il::int_t d) const;
 
+  /* \brief Get the memory backing the array
+   */
+  il::Backing backing() const;
+
  private:
+  Array2D(il::int_t n0, il::int_t n1, const il::AllocatorScope&);
+
+  Array2D(il::int_t n0, il::int_t n1, const T& x, const il::AllocatorScope&);
+
+  Array2D(const Array2D<T>& A, bool parallel);
+
+  /* \brief Used internally to get the number of columns in a page of
+  // memory, the minimum number of columns given to a thread by
+  // il::parallelForStatic
+  */
+  static il::int_t pageGrain(il::int_t n0);
+
+  /* \brief Used internally by Resize
+  // \details The new elements are initialized, as in Resize(n0, n1), unless
+  // initialize is false and T is trivial
+  */
+  void SetSize(il::int_t n0, il::int_t n1, bool initialize);
+
   /* \brief Used internally in debug mode to check the invariance of the object
    */
   bool invariance() const;
@@ -254,6 +383,7 @@ Array2D<T>::Array2D() {
   capacity_[0] = nullptr;
   capacity_[1] = nullptr;
   alignment_ = 0;
+  pad_ = false;
   align_r_ = 0;
   align_mod_ = 0;
   shift_ = 0;
@@ -296,6 +426,7 @@ Array2D<T>::Array2D(il::int_t n0, il::int_t n1) {
   capacity_[0] = data_ + r0;
   capacity_[1] = data_ + r1;
   alignment_ = 0;
+  pad_ = false;
   align_r_ = 0;
   align_mod_ = 0;
   shift_ = 0;
@@ -370,6 +501,7 @@ Array2D<T>::Array2D(il::int_t n0, il::int_t n1, il::align_t,
   capacity_[0] = data_ + r0;
   capacity_[1] = data_ + r1;
   alignment_ = static_cast<short>(alignment);
+  pad_ = false;
   align_r_ = static_cast<short>(align_r);
   align_mod_ = static_cast<short>(align_mod);
 }
@@ -406,6 +538,45 @@ Array2D<T>::Array2D(il::int_t n0, il::int_t n1, const T& x) {
   capacity_[0] = data_ + r0;
   capacity_[1] = data_ + r1;
   alignment_ = 0;
+  pad_ = false;
+  align_r_ = 0;
+  align_mod_ = 0;
+  shift_ = 0;
+}
+
+template <typename T>
+Array2D<T>::Array2D(il::int_t n0, il::int_t n1, const T& x, il::parallel_t) {
+  IL_EXPECT_FAST(n0 >= 0);
+  IL_EXPECT_FAST(n1 >= 0);
+
+  const il::int_t r0 = n0 > 0 ? n0 : (n1 == 0 ? 0 : 1);
+  const il::int_t r1 = n1 > 0 ? n1 : (n0 == 0 ? 0 : 1);
+  bool error = false;
+  const il::int_t r = il::safeProduct(r0, r1, il::io, error);
+  if (error) {
+    il::abort();
+  }
+  if (r > 0) {
+    data_ = il::allocateArray<T>(r);
+    T* const data = data_;
+    il::parallelForStatic(
+        0, n1, pageGrain(n0),
+        [data, n0, r0, &x](il::int_t i1_begin, il::int_t i1_end) {
+          for (il::int_t i1 = i1_begin; i1 < i1_end; ++i1) {
+            for (il::int_t i0 = 0; i0 < n0; ++i0) {
+              new (data + i1 * r0 + i0) T(x);
+            }
+          }
+        });
+  } else {
+    data_ = nullptr;
+  }
+  size_[0] = data_ + n0;
+  size_[1] = data_ + n1;
+  capacity_[0] = data_ + r0;
+  capacity_[1] = data_ + r1;
+  alignment_ = 0;
+  pad_ = false;
   align_r_ = 0;
   align_mod_ = 0;
   shift_ = 0;
@@ -439,6 +610,7 @@ Array2D<T>::Array2D(il::int_t n0, il::int_t n1, il::emplace_t, Args&&... args) {
   capacity_[0] = data_ + r0;
   capacity_[1] = data_ + r1;
   alignment_ = 0;
+  pad_ = false;
   align_r_ = 0;
   align_mod_ = 0;
   shift_ = 0;
@@ -511,6 +683,7 @@ Array2D<T>::Array2D(il::int_t n0, il::int_t n1, const T& x, il::align_t,
   capacity_[0] = data_ + r0;
   capacity_[1] = data_ + r1;
   alignment_ = static_cast<short>(alignment);
+  pad_ = false;
   align_r_ = static_cast<short>(align_r);
   align_mod_ = static_cast<short>(align_mod);
 }
@@ -581,13 +754,67 @@ Array2D<T>::Array2D(il::value_t,
   capacity_[0] = data_ + r0;
   capacity_[1] = data_ + r1;
   alignment_ = 0;
+  pad_ = false;
   align_r_ = 0;
   align_mod_ = 0;
   shift_ = 0;
 }
 
 template <typename T>
-Array2D<T>::Array2D(const Array2D<T>& A) {
+Array2D<T>::Array2D(il::int_t n0, il::int_t n1, il::hugepage_t)
+    : Array2D{n0, n1, il::AllocatorScope{il::hugePageAllocator()}} {}
+
+template <typename T>
+Array2D<T>::Array2D(il::int_t n0, il::int_t n1, const T& x, il::hugepage_t)
+    : Array2D{n0, n1, x, il::AllocatorScope{il::hugePageAllocator()}} {}
+
+// The scope is a temporary of the delegating constructor, which keeps the huge
+// page allocator in place while the array is allocated
+template <typename T>
+Array2D<T>::Array2D(il::int_t n0, il::int_t n1, const il::AllocatorScope&)
+    : Array2D{n0, n1} {}
+
+template <typename T>
+Array2D<T>::Array2D(il::int_t n0, il::int_t n1, const T& x,
+                    const il::AllocatorScope&)
+    : Array2D{n0, n1, x} {}
+
+template <typename T>
+Array2D<T>::Array2D(il::int_t n0, il::int_t n1, il::pad_t) : Array2D{} {
+  IL_EXPECT_FAST(il::isTrivial<T>::value);
+  IL_EXPECT_FAST(64 % alignof(T) == 0);
+
+  alignment_ = 64;
+  align_r_ = 0;
+  align_mod_ = 64;
+  pad_ = true;
+  SetSize(n0, n1, true);
+}
+
+template <typename T>
+Array2D<T>::Array2D(il::int_t n0, il::int_t n1, const T& x, il::pad_t)
+    : Array2D{n0, n1, il::pad} {
+  for (il::int_t i1 = 0; i1 < n1; ++i1) {
+    for (il::int_t i0 = 0; i0 < n0; ++i0) {
+      data_[i1 * (capacity_[0] - data_) + i0] = x;
+    }
+  }
+}
+
+template <typename T>
+Array2D<T>::Array2D(il::int_t n0, il::int_t n1, il::uninitialized_t)
+    : Array2D{} {
+  SetSize(n0, n1, false);
+}
+
+template <typename T>
+Array2D<T>::Array2D(const Array2D<T>& A) : Array2D{A, false} {}
+
+template <typename T>
+Array2D<T>::Array2D(const Array2D<T>& A, il::parallel_t) : Array2D{A, true} {}
+
+template <typename T>
+Array2D<T>::Array2D(const Array2D<T>& A, bool parallel) {
   const il::int_t n0 = A.size(0);
   const il::int_t n1 = A.size(1);
   il::int_t r0;
@@ -601,6 +828,12 @@ Array2D<T>::Array2D(const Array2D<T>& A) {
       if (error) {
         il::abort();
       }
+      if (A.pad_) {
+        r0 = il::padLeadingDimension<T>(r0, nb_lanes, il::io, error);
+        if (error) {
+          il::abort();
+        }
+      }
       r1 = n1;
     } else {
       r0 = n0;
@@ -627,23 +860,36 @@ Array2D<T>::Array2D(const Array2D<T>& A) {
       data_ = il::allocateArray<T>(r, A.align_r_, A.align_mod_, il::io, shift);
       shift_ = static_cast<short>(shift);
     }
-    for (il::int_t i1 = 0; i1 < n1; ++i1) {
-      memcpy(data_ + i1 * r0, A.data() + i1 * A.capacity(0), n0 * sizeof(T));
-    }
   } else {
     data_ = il::allocateArray<T>(r);
     shift_ = 0;
-    for (il::int_t i1 = 0; i1 < n1; ++i1) {
-      for (il::int_t i0 = 0; i0 < n0; ++i0) {
-        new (data_ + i1 * r0 + i0) T(A(i0, i1));
+  }
+  T* const data = data_;
+  const T* const a_data = A.data_;
+  const il::int_t a_r0 = A.capacity(0);
+  auto copy = [data, a_data, n0, r0, a_r0](il::int_t i1_begin,
+                                          il::int_t i1_end) {
+    for (il::int_t i1 = i1_begin; i1 < i1_end; ++i1) {
+      if (il::isTrivial<T>::value) {
+        memcpy(data + i1 * r0, a_data + i1 * a_r0, n0 * sizeof(T));
+      } else {
+        for (il::int_t i0 = 0; i0 < n0; ++i0) {
+          new (data + i1 * r0 + i0) T(a_data[i1 * a_r0 + i0]);
+        }
       }
     }
+  };
+  if (parallel) {
+    il::parallelForStatic(0, n1, pageGrain(n0), copy);
+  } else {
+    copy(0, n1);
   }
   size_[0] = data_ + n0;
   size_[1] = data_ + n1;
   capacity_[0] = data_ + r0;
   capacity_[1] = data_ + r1;
   alignment_ = A.alignment_;
+  pad_ = A.pad_;
   align_r_ = A.align_r_;
   align_mod_ = A.align_mod_;
 }
@@ -656,6 +902,7 @@ Array2D<T>::Array2D(Array2D<T>&& A) {
   capacity_[0] = A.capacity_[0];
   capacity_[1] = A.capacity_[1];
   alignment_ = A.alignment_;
+  pad_ = A.pad_;
   align_r_ = A.align_r_;
   align_mod_ = A.align_mod_;
   shift_ = A.shift_;
@@ -665,6 +912,7 @@ Array2D<T>::Array2D(Array2D<T>&& A) {
   A.capacity_[0] = nullptr;
   A.capacity_[1] = nullptr;
   A.alignment_ = 0;
+  A.pad_ = false;
   A.align_r_ = 0;
   A.align_mod_ = 0;
   A.shift_ = 0;
@@ -680,7 +928,7 @@ Array2D<T>& Array2D<T>::operator=(const Array2D<T>& A) {
     const il::int_t align_mod = A.align_mod_;
     const bool need_memory = capacity(0) < n0 || capacity(1) < n1 ||
                              align_mod_ != align_mod || align_r_ != align_r ||
-                             alignment_ != alignment;
+                             alignment_ != alignment || pad_ != A.pad_;
     if (need_memory) {
       il::int_t r0;
       il::int_t r1;
@@ -693,6 +941,12 @@ Array2D<T>& Array2D<T>::operator=(const Array2D<T>& A) {
           if (error) {
             il::abort();
           }
+          if (A.pad_) {
+            r0 = il::padLeadingDimension<T>(r0, nb_lanes, il::io, error);
+            if (error) {
+              il::abort();
+            }
+          }
           r1 = n1;
         } else {
           r0 = n0;
@@ -744,6 +998,7 @@ Array2D<T>& Array2D<T>::operator=(const Array2D<T>& A) {
       capacity_[0] = data_ + r0;
       capacity_[1] = data_ + r1;
       alignment_ = static_cast<short>(alignment);
+      pad_ = A.pad_;
       align_r_ = static_cast<short>(align_r);
       align_mod_ = static_cast<short>(align_mod);
     } else {
@@ -790,6 +1045,7 @@ Array2D<T>& Array2D<T>::operator=(Array2D<T>&& A) {
     capacity_[0] = A.capacity_[0];
     capacity_[1] = A.capacity_[1];
     alignment_ = A.alignment_;
+    pad_ = A.pad_;
     align_r_ = A.align_r_;
     align_mod_ = A.align_mod_;
     shift_ = A.shift_;
@@ -799,6 +1055,7 @@ Array2D<T>& Array2D<T>::operator=(Array2D<T>&& A) {
     A.capacity_[0] = nullptr;
     A.capacity_[1] = nullptr;
     A.alignment_ = 0;
+    A.pad_ = false;
     A.align_r_ = 0;
     A.align_mod_ = 0;
     A.shift_ = 0;
@@ -806,6 +1063,83 @@ Array2D<T>& Array2D<T>::operator=(Array2D<T>&& A) {
   return *this;
 }
 
+template <typename T>
+void Array2D<T>::Assign(const Array2D<T>& A, il::parallel_t) {
+  if (this == &A) {
+    return;
+  }
+
+  const il::int_t n0 = A.size(0);
+  const il::int_t n1 = A.size(1);
+  const bool need_memory = capacity(0) < n0 || capacity(1) < n1 ||
+                           align_mod_ != A.align_mod_ ||
+                           align_r_ != A.align_r_ ||
+                           alignment_ != A.alignment_ || pad_ != A.pad_;
+  if (need_memory) {
+    *this = il::Array2D<T>{A, il::parallel};
+    return;
+  }
+
+  // The elements inside the old n0_old x n1_old array are assigned, the other
+  // ones are constructed
+  T* const data = data_;
+  const T* const a_data = A.data_;
+  const il::int_t r0 = capacity(0);
+  const il::int_t a_r0 = A.capacity(0);
+  const il::int_t n0_old = size(0);
+  const il::int_t n1_old = size(1);
+  il::parallelForStatic(
+      0, n1, pageGrain(n0),
+      [data, a_data, n0, r0, a_r0, n0_old, n1_old](il::int_t i1_begin,
+                                                   il::int_t i1_end) {
+        for (il::int_t i1 = i1_begin; i1 < i1_end; ++i1) {
+          if (il::isTrivial<T>::value) {
+            memcpy(data + i1 * r0, a_data + i1 * a_r0, n0 * sizeof(T));
+          } else {
+            const il::int_t n0_assign =
+                i1 < n1_old ? (n0 < n0_old ? n0 : n0_old) : 0;
+            for (il::int_t i0 = 0; i0 < n0_assign; ++i0) {
+              data[i1 * r0 + i0] = a_data[i1 * a_r0 + i0];
+            }
+            for (il::int_t i0 = n0_assign; i0 < n0; ++i0) {
+              new (data + i1 * r0 + i0) T(a_data[i1 * a_r0 + i0]);
+            }
+          }
+        }
+      });
+  if (!il::isTrivial<T>::value) {
+    for (il::int_t i1 = n1_old - 1; i1 >= 0; --i1) {
+      for (il::int_t i0 = n0_old - 1; i0 >= (i1 < n1 ? n0 : 0); --i0) {
+        (data_ + i1 * r0 + i0)->~T();
+      }
+    }
+  }
+  size_[0] = data_ + n0;
+  size_[1] = data_ + n1;
+}
+
+template <typename T>
+template <typename E>
+Array2D<T>& Array2D<T>::operator=(const il::Expression<E>& expression) {
+  static_assert(E::rank == 2, "il::Array2D<T>: expression must be of rank 2");
+  const il::int_t n0 = expression.derived().size(0);
+  const il::int_t n1 = expression.derived().size(1);
+  if (n0 == size(0) && n1 == size(1)) {
+    il::evaluate(expression, n0, n1, stride(1), il::io, data_);
+  } else {
+    // The expression might read the elements of this array
+    il::Array2D<T> A{};
+    A.alignment_ = alignment_;
+    A.align_r_ = align_r_;
+    A.align_mod_ = align_mod_;
+    A.pad_ = pad_;
+    A.Resize(n0, n1, il::uninitialized);
+    il::evaluate(expression, n0, n1, A.stride(1), il::io, A.data_);
+    *this = std::move(A);
+  }
+  return *this;
+}
+
 template <typename T>
 Array2D<T>::~Array2D() {
   IL_EXPECT_FAST_NOTHROW(invariance());
@@ -842,6 +1176,34 @@ T& Array2D<T>::operator()(il::int_t i0, il::int_t i1) {
   return data_[i1 * (capacity_[0] - data_) + i0];
 }
 
+template <typename T>
+void Array2D<T>::Set(const T& x) {
+  const il::int_t n0 = size(0);
+  const il::int_t n1 = size(1);
+  const il::int_t r0 = capacity(0);
+  for (il::int_t i1 = 0; i1 < n1; ++i1) {
+    for (il::int_t i0 = 0; i0 < n0; ++i0) {
+      data_[i1 * r0 + i0] = x;
+    }
+  }
+}
+
+template <typename T>
+void Array2D<T>::Set(const T& x, il::parallel_t) {
+  T* const data = data_;
+  const il::int_t n0 = size(0);
+  const il::int_t r0 = capacity(0);
+  il::parallelForStatic(
+      0, size(1), pageGrain(n0),
+      [data, n0, r0, &x](il::int_t i1_begin, il::int_t i1_end) {
+        for (il::int_t i1 = i1_begin; i1 < i1_end; ++i1) {
+          for (il::int_t i0 = 0; i0 < n0; ++i0) {
+            data[i1 * r0 + i0] = x;
+          }
+        }
+      });
+}
+
 template <typename T>
 il::int_t Array2D<T>::size(il::int_t d) const {
   IL_EXPECT_MEDIUM(static_cast<std::size_t>(d) < static_cast<std::size_t>(2));
@@ -851,6 +1213,16 @@ il::int_t Array2D<T>::size(il::int_t d) const {
 
 template <typename T>
 void Array2D<T>::Resize(il::int_t n0, il::int_t n1) {
+  SetSize(n0, n1, true);
+}
+
+template <typename T>
+void Array2D<T>::Resize(il::int_t n0, il::int_t n1, il::uninitialized_t) {
+  SetSize(n0, n1, false);
+}
+
+template <typename T>
+void Array2D<T>::SetSize(il::int_t n0, il::int_t n1, bool initialize) {
   IL_EXPECT_FAST(n0 >= 0);
   IL_EXPECT_FAST(n1 >= 0);
 
@@ -869,6 +1241,12 @@ void Array2D<T>::Resize(il::int_t n0, il::int_t n1) {
         if (error) {
           il::abort();
         }
+        if (pad_) {
+          r0 = il::padLeadingDimension<T>(r0, nb_lanes, il::io, error);
+          if (error) {
+            il::abort();
+          }
+        }
         r1 = n1;
       } else {
         r0 = n0;
@@ -904,9 +1282,11 @@ void Array2D<T>::Resize(il::int_t n0, il::int_t n1) {
         il::deallocate(data_ - shift_);
       }
 #ifdef IL_DEFAULT_VALUE
-      for (il::int_t i1 = 0; i1 < n1; ++i1) {
-        for (il::int_t i0 = i1 < n1_old ? n0_old : 0; i0 < n0; ++i0) {
-          new_data[i1 * r0 + i0] = il::defaultValue<T>();
+      if (initialize) {
+        for (il::int_t i1 = 0; i1 < n1; ++i1) {
+          for (il::int_t i0 = i1 < n1_old ? n0_old : 0; i0 < n0; ++i0) {
+            new_data[i1 * r0 + i0] = il::defaultValue<T>();
+          }
         }
       }
 #endif
@@ -928,9 +1308,11 @@ void Array2D<T>::Resize(il::int_t n0, il::int_t n1) {
         }
         il::deallocate(data_);
       }
-      for (il::int_t i1 = 0; i1 < n1; ++i1) {
-        for (il::int_t i0 = i1 < n1_old ? n0_old : 0; i0 < n0; ++i0) {
-          new (new_data + i1 * r0 + i0) T{};
+      if (initialize || !std::is_trivial<T>::value) {
+        for (il::int_t i1 = 0; i1 < n1; ++i1) {
+          for (il::int_t i0 = i1 < n1_old ? n0_old : 0; i0 < n0; ++i0) {
+            new (new_data + i1 * r0 + i0) T{};
+          }
         }
       }
     }
@@ -941,9 +1323,11 @@ void Array2D<T>::Resize(il::int_t n0, il::int_t n1) {
   } else {
     if (il::isTrivial<T>::value) {
 #ifdef IL_DEFAULT_VALUE
-      for (il::int_t i1 = 0; i1 < n1; ++i1) {
-        for (il::int_t i0 = (i1 < n1_old ? n0_old : 0); i0 < n0; ++i0) {
-          data_[i1 * capacity(0) + i0] = il::defaultValue<T>();
+      if (initialize) {
+        for (il::int_t i1 = 0; i1 < n1; ++i1) {
+          for (il::int_t i0 = (i1 < n1_old ? n0_old : 0); i0 < n0; ++i0) {
+            data_[i1 * capacity(0) + i0] = il::defaultValue<T>();
+          }
         }
       }
 #endif
@@ -953,9 +1337,11 @@ void Array2D<T>::Resize(il::int_t n0, il::int_t n1) {
           (data_ + i1 * capacity(0) + i0)->~T();
         }
       }
-      for (il::int_t i1 = 0; i1 < n1; ++i1) {
-        for (il::int_t i0 = i1 < n1_old ? n0_old : 0; i0 < n0; ++i0) {
-          new (data_ + i1 * capacity(0) + i0) T{};
+      if (initialize || !std::is_trivial<T>::value) {
+        for (il::int_t i1 = 0; i1 < n1; ++i1) {
+          for (il::int_t i0 = i1 < n1_old ? n0_old : 0; i0 < n0; ++i0) {
+            new (data_ + i1 * capacity(0) + i0) T{};
+          }
         }
       }
     }
@@ -984,6 +1370,12 @@ void Array2D<T>::Resize(il::int_t n0, il::int_t n1, const T& x) {
         if (error) {
           il::abort();
         }
+        if (pad_) {
+          r0 = il::padLeadingDimension<T>(r0, nb_lanes, il::io, error);
+          if (error) {
+            il::abort();
+          }
+        }
         r1 = n1;
       } else {
         r0 = n0;
@@ -1075,6 +1467,34 @@ void Array2D<T>::Resize(il::int_t n0, il::int_t n1, const T& x) {
   size_[1] = data_ + n1;
 }
 
+template <typename T>
+void Array2D<T>::Resize(il::int_t n0, il::int_t n1, const T& x,
+                        il::parallel_t) {
+  IL_EXPECT_FAST(n0 >= 0);
+  IL_EXPECT_FAST(n1 >= 0);
+
+  if (!il::isTrivial<T>::value) {
+    Resize(n0, n1, x);
+    return;
+  }
+
+  const il::int_t n0_old = size(0);
+  const il::int_t n1_old = size(1);
+  SetSize(n0, n1, false);
+  T* const data = data_;
+  const il::int_t r0 = capacity(0);
+  il::parallelForStatic(
+      0, n1, pageGrain(n0),
+      [data, n0, n0_old, n1_old, r0, &x](il::int_t i1_begin,
+                                         il::int_t i1_end) {
+        for (il::int_t i1 = i1_begin; i1 < i1_end; ++i1) {
+          for (il::int_t i0 = i1 < n1_old ? n0_old : 0; i0 < n0; ++i0) {
+            data[i1 * r0 + i0] = x;
+          }
+        }
+      });
+}
+
 template <typename T>
 template <typename... Args>
 void Array2D<T>::Resize(il::int_t n0, il::int_t n1, il::emplace_t,
@@ -1097,6 +1517,12 @@ void Array2D<T>::Resize(il::int_t n0, il::int_t n1, il::emplace_t,
         if (error) {
           il::abort();
         }
+        if (pad_) {
+          r0 = il::padLeadingDimension<T>(r0, nb_lanes, il::io, error);
+          if (error) {
+            il::abort();
+          }
+        }
         r1 = n1;
       } else {
         r0 = n0;
@@ -1214,6 +1640,12 @@ void Array2D<T>::Reserve(il::int_t r0, il::int_t r1) {
       if (error) {
         il::abort();
       }
+      if (pad_) {
+        r0 = il::padLeadingDimension<T>(r0, nb_lanes, il::io, error);
+        if (error) {
+          il::abort();
+        }
+      }
     }
     bool error = false;
     const il::int_t r = il::safeProduct(r0, r1, il::io, error);
@@ -1358,6 +1790,17 @@ il::int_t Array2D<T>::stride(il::int_t d) const {
   return (d == 0) ? 1 : static_cast<il::int_t>(capacity_[0] - data_);
 }
 
+template <typename T>
+il::Backing Array2D<T>::backing() const {
+  return data_ ? il::backing(data_ - shift_) : il::Backing::Heap;
+}
+
+template <typename T>
+il::int_t Array2D<T>::pageGrain(il::int_t n0) {
+  const il::int_t grain = il::pageGrain<T>() / (n0 > 0 ? n0 : 1);
+  return grain > 0 ? grain : 1;
+}
+
 template <typename T>
 bool Array2D<T>::invariance() const {
   bool ans = true;
@@ -1367,9 +1810,12 @@ bool Array2D<T>::invariance() const {
     ans = ans && (size_[1] == nullptr);
     ans = ans && (capacity_[0] == nullptr);
     ans = ans && (capacity_[1] == nullptr);
-    ans = ans && (alignment_ == 0);
-    ans = ans && (align_r_ == 0);
-    ans = ans && (align_mod_ == 0);
+    // An empty padded array keeps its alignment for the next allocation
+    if (!pad_) {
+      ans = ans && (alignment_ == 0);
+      ans = ans && (align_r_ == 0);
+      ans = ans && (align_mod_ == 0);
+    }
     ans = ans && (shift_ == 0);
   } else {
     ans = ans && (size_[0] != nullptr);
@@ -1385,6 +1831,7 @@ bool Array2D<T>::invariance() const {
       ans = ans && (align_r_ % alignof(T) == 0);
       ans = ans && (align_mod_ % alignof(T) == 0);
       ans = ans && (alignment_ % alignof(T) == 0);
+      ans = ans && (!pad_ || alignment_ > 0);
       if (alignment_ > 0) {
         ans = ans && (align_r_ % alignment_ == 0);
         ans = ans && (align_mod_ > 0);
@@ -1401,6 +1848,7 @@ bool Array2D<T>::invariance() const {
       ans = ans && (align_r_ == 0);
       ans = ans && (align_mod_ == 0);
       ans = ans && (alignment_ == 0);
+      ans = ans && !pad_;
     }
   }
   return ans;
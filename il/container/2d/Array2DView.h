@@ -19,6 +19,7 @@
 #ifndef IL_ARRAY2DVIEW_H
 #define IL_ARRAY2DVIEW_H
 
+#include <il/container/expression/Expression.h>
 #include <il/core.h>
 
 namespace il {
@@ -109,6 +110,13 @@ class Array2DEdit : public Array2DView<T> {
   Array2DEdit(T* data, il::int_t n0, il::int_t n1, il::int_t stride,
               short align_mod, short align_r);
 
+  /* \brief Evaluate an expression in the elements of the array view
+  // \details The expression must have the same sizes as the array view. See
+  // <il/expression.h>.
+  */
+  template <typename E>
+  Array2DEdit& operator=(const il::Expression<E>& expression);
+
   /* \brief Accessor
   // \details Access (read and write) the (i, j)-th element of the array view.
   // Bound checking is done in debug mode but not in release mode.
@@ -259,6 +267,15 @@ Array2DEdit<T> Array2DEdit<T>::Edit(il::Range r0, il::Range r1) {
                             0};
 }
 
+template <typename T>
+template <typename E>
+Array2DEdit<T>& Array2DEdit<T>::operator=(
+    const il::Expression<E>& expression) {
+  il::evaluate(expression, this->size(0), this->size(1), this->stride(1),
+               il::io, this->data_);
+  return *this;
+}
+
 template <typename T>
 T* Array2DEdit<T>::Data() {
   return this->data_;
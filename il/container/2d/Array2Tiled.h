@@ -0,0 +1,433 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#ifndef IL_ARRAY2TILED_H
+#define IL_ARRAY2TILED_H
+
+// <cstring> is needed for std::memcpy
+#include <cstring>
+// <new> is needed for placement new
+#include <new>
+// <utility> is needed for std::move
+#include <utility>
+
+#include <il/container/2d/Array2C.h>
+#include <il/container/2d/Array2D.h>
+#include <il/container/2d/Array2DView.h>
+#include <il/core/memory/allocate.h>
+
+namespace il {
+
+/* \brief A matrix stored by tiles
+// \details The matrix is cut in tiles of tile0 rows and tile1 columns. The
+// elements of a tile are contiguous in memory and stored in column-major
+// order, and the tiles themselves are stored in column-major order. A tile
+// of 32 x 32 doubles takes 8 KiB and fits in the L1 cache, so kernels that
+// walk the matrix in both directions, such as a transpose, a stencil or a
+// blocked matrix multiplication, touch far fewer cache lines and pages than
+// with il::Array2D or il::Array2C. Every tile starts on a cache line.
+//
+// The last tiles of each dimension are padded, so every tile has the same
+// layout. The tiles are visited with il::Array2DEdit views:
+//
+// il::Array2Tiled<double, 32, 32> A{n0, n1, 0.0};
+// for (il::int_t b1 = 0; b1 < A.nbTiles(1); ++b1) {
+//   for (il::int_t b0 = 0; b0 < A.nbTiles(0); ++b0) {
+//     il::Array2DEdit<double> tile = A.Tile(b0, b1);
+//     for (il::int_t i1 = 0; i1 < tile.size(1); ++i1) {
+//       for (il::int_t i0 = 0; i0 < tile.size(0); ++i0) {
+//         tile(i0, i1) = ...;
+//       }
+//     }
+//   }
+// }
+*/
+template <typename T, il::int_t tile0, il::int_t tile1>
+class Array2Tiled {
+  static_assert(tile0 > 0 && tile1 > 0,
+                "il::Array2Tiled<T, tile0, tile1>: tiles can't be empty");
+
+ public:
+  static const il::int_t tile_size = tile0 * tile1;
+
+ private:
+  T* data_;
+  il::int_t size_[2];
+  il::int_t nb_tiles_[2];
+  short shift_;
+
+ public:
+  /* \brief Default constructor
+  // \details The sizes are 0 and no memory is allocated.
+  */
+  Array2Tiled();
+
+  /* \brief Construct an array of n0 rows and n1 columns
+  // \details The elements are default-initialized when T is a numeric type
+  // and value-initialized otherwise.
+  */
+  Array2Tiled(il::int_t n0, il::int_t n1);
+
+  /* \brief Construct an array of n0 rows and n1 columns set to x
+   */
+  Array2Tiled(il::int_t n0, il::int_t n1, const T& x);
+
+  /* \brief Convert a column-major or a row-major array
+   */
+  explicit Array2Tiled(const il::Array2D<T>& A);
+  explicit Array2Tiled(const il::Array2C<T>& A);
+
+  Array2Tiled(const Array2Tiled<T, tile0, tile1>& A);
+  Array2Tiled(Array2Tiled<T, tile0, tile1>&& A);
+  Array2Tiled& operator=(const Array2Tiled<T, tile0, tile1>& A);
+  Array2Tiled& operator=(Array2Tiled<T, tile0, tile1>&& A);
+  ~Array2Tiled();
+
+  /* \brief Accessor
+  // \details Bound checking is done in debug mode but not in release mode. A
+  // loop on the elements with this accessor is slower than a loop on the
+  // tiles as the position of each element needs a few integer operations.
+  */
+  const T& operator()(il::int_t i0, il::int_t i1) const;
+  T& operator()(il::int_t i0, il::int_t i1);
+
+  il::int_t size(il::int_t d) const;
+
+  /* \brief Get the number of tiles along the dimension d
+   */
+  il::int_t nbTiles(il::int_t d) const;
+
+  /* \brief Get a view on the tile (b0, b1)
+  // \details The view covers the elements (i0, i1) with
+  // b0 * tile0 <= i0 < min((b0 + 1) * tile0, size(0)) and
+  // b1 * tile1 <= i1 < min((b1 + 1) * tile1, size(1)). Its stride is tile0.
+  */
+  il::Array2DView<T> tile(il::int_t b0, il::int_t b1) const;
+  il::Array2DEdit<T> Tile(il::int_t b0, il::int_t b1);
+
+  /* \brief Convert to a column-major or a row-major array
+   */
+  il::Array2D<T> array2D() const;
+  il::Array2C<T> array2C() const;
+
+  /* \brief Get a pointer to the first element of the first tile
+  // \details The tile (b0, b1) starts at data() + (b1 * nbTiles(0) + b0) *
+  // tile_size.
+  */
+  const T* data() const;
+  T* Data();
+
+ private:
+  il::int_t offset(il::int_t i0, il::int_t i1) const;
+  void Allocate(il::int_t n0, il::int_t n1);
+  void Release();
+};
+
+template <typename T, il::int_t tile0, il::int_t tile1>
+const il::int_t Array2Tiled<T, tile0, tile1>::tile_size;
+
+template <typename T, il::int_t tile0, il::int_t tile1>
+Array2Tiled<T, tile0, tile1>::Array2Tiled() {
+  data_ = nullptr;
+  size_[0] = 0;
+  size_[1] = 0;
+  nb_tiles_[0] = 0;
+  nb_tiles_[1] = 0;
+  shift_ = 0;
+}
+
+template <typename T, il::int_t tile0, il::int_t tile1>
+Array2Tiled<T, tile0, tile1>::Array2Tiled(il::int_t n0, il::int_t n1) {
+  Allocate(n0, n1);
+  if (il::isTrivial<T>::value) {
+#ifdef IL_DEFAULT_VALUE
+    const il::int_t r = nb_tiles_[0] * nb_tiles_[1] * tile_size;
+    for (il::int_t i = 0; i < r; ++i) {
+      data_[i] = il::defaultValue<T>();
+    }
+#endif
+  } else {
+    const il::int_t r = nb_tiles_[0] * nb_tiles_[1] * tile_size;
+    for (il::int_t i = 0; i < r; ++i) {
+      new (data_ + i) T{};
+    }
+  }
+}
+
+template <typename T, il::int_t tile0, il::int_t tile1>
+Array2Tiled<T, tile0, tile1>::Array2Tiled(il::int_t n0, il::int_t n1,
+                                          const T& x) {
+  Allocate(n0, n1);
+  const il::int_t r = nb_tiles_[0] * nb_tiles_[1] * tile_size;
+  for (il::int_t i = 0; i < r; ++i) {
+    new (data_ + i) T(x);
+  }
+}
+
+template <typename T, il::int_t tile0, il::int_t tile1>
+Array2Tiled<T, tile0, tile1>::Array2Tiled(const il::Array2D<T>& A)
+    : Array2Tiled{A.size(0), A.size(1)} {
+  for (il::int_t b1 = 0; b1 < nb_tiles_[1]; ++b1) {
+    for (il::int_t b0 = 0; b0 < nb_tiles_[0]; ++b0) {
+      il::Array2DEdit<T> tile = Tile(b0, b1);
+      for (il::int_t i1 = 0; i1 < tile.size(1); ++i1) {
+        for (il::int_t i0 = 0; i0 < tile.size(0); ++i0) {
+          tile(i0, i1) = A(b0 * tile0 + i0, b1 * tile1 + i1);
+        }
+      }
+    }
+  }
+}
+
+template <typename T, il::int_t tile0, il::int_t tile1>
+Array2Tiled<T, tile0, tile1>::Array2Tiled(const il::Array2C<T>& A)
+    : Array2Tiled{A.size(0), A.size(1)} {
+  for (il::int_t b1 = 0; b1 < nb_tiles_[1]; ++b1) {
+    for (il::int_t b0 = 0; b0 < nb_tiles_[0]; ++b0) {
+      il::Array2DEdit<T> tile = Tile(b0, b1);
+      for (il::int_t i0 = 0; i0 < tile.size(0); ++i0) {
+        for (il::int_t i1 = 0; i1 < tile.size(1); ++i1) {
+          tile(i0, i1) = A(b0 * tile0 + i0, b1 * tile1 + i1);
+        }
+      }
+    }
+  }
+}
+
+template <typename T, il::int_t tile0, il::int_t tile1>
+Array2Tiled<T, tile0, tile1>::Array2Tiled(
+    const Array2Tiled<T, tile0, tile1>& A) {
+  Allocate(A.size_[0], A.size_[1]);
+  const il::int_t r = nb_tiles_[0] * nb_tiles_[1] * tile_size;
+  if (il::isTrivial<T>::value) {
+    if (r > 0) {
+      std::memcpy(data_, A.data_, r * sizeof(T));
+    }
+  } else {
+    for (il::int_t i = 0; i < r; ++i) {
+      new (data_ + i) T(A.data_[i]);
+    }
+  }
+}
+
+template <typename T, il::int_t tile0, il::int_t tile1>
+Array2Tiled<T, tile0, tile1>::Array2Tiled(Array2Tiled<T, tile0, tile1>&& A) {
+  data_ = A.data_;
+  size_[0] = A.size_[0];
+  size_[1] = A.size_[1];
+  nb_tiles_[0] = A.nb_tiles_[0];
+  nb_tiles_[1] = A.nb_tiles_[1];
+  shift_ = A.shift_;
+  A.data_ = nullptr;
+  A.size_[0] = 0;
+  A.size_[1] = 0;
+  A.nb_tiles_[0] = 0;
+  A.nb_tiles_[1] = 0;
+  A.shift_ = 0;
+}
+
+template <typename T, il::int_t tile0, il::int_t tile1>
+Array2Tiled<T, tile0, tile1>& Array2Tiled<T, tile0, tile1>::operator=(
+    const Array2Tiled<T, tile0, tile1>& A) {
+  if (this != &A) {
+    Array2Tiled<T, tile0, tile1> B{A};
+    *this = std::move(B);
+  }
+  return *this;
+}
+
+template <typename T, il::int_t tile0, il::int_t tile1>
+Array2Tiled<T, tile0, tile1>& Array2Tiled<T, tile0, tile1>::operator=(
+    Array2Tiled<T, tile0, tile1>&& A) {
+  if (this != &A) {
+    Release();
+    data_ = A.data_;
+    size_[0] = A.size_[0];
+    size_[1] = A.size_[1];
+    nb_tiles_[0] = A.nb_tiles_[0];
+    nb_tiles_[1] = A.nb_tiles_[1];
+    shift_ = A.shift_;
+    A.data_ = nullptr;
+    A.size_[0] = 0;
+    A.size_[1] = 0;
+    A.nb_tiles_[0] = 0;
+    A.nb_tiles_[1] = 0;
+    A.shift_ = 0;
+  }
+  return *this;
+}
+
+template <typename T, il::int_t tile0, il::int_t tile1>
+Array2Tiled<T, tile0, tile1>::~Array2Tiled() {
+  Release();
+}
+
+template <typename T, il::int_t tile0, il::int_t tile1>
+const T& Array2Tiled<T, tile0, tile1>::operator()(il::int_t i0,
+                                                  il::int_t i1) const {
+  return data_[offset(i0, i1)];
+}
+
+template <typename T, il::int_t tile0, il::int_t tile1>
+T& Array2Tiled<T, tile0, tile1>::operator()(il::int_t i0, il::int_t i1) {
+  return data_[offset(i0, i1)];
+}
+
+template <typename T, il::int_t tile0, il::int_t tile1>
+il::int_t Array2Tiled<T, tile0, tile1>::size(il::int_t d) const {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(d) < static_cast<std::size_t>(2));
+  return size_[d];
+}
+
+template <typename T, il::int_t tile0, il::int_t tile1>
+il::int_t Array2Tiled<T, tile0, tile1>::nbTiles(il::int_t d) const {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(d) < static_cast<std::size_t>(2));
+  return nb_tiles_[d];
+}
+
+template <typename T, il::int_t tile0, il::int_t tile1>
+il::Array2DView<T> Array2Tiled<T, tile0, tile1>::tile(il::int_t b0,
+                                                      il::int_t b1) const {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(b0) <
+                   static_cast<std::size_t>(nb_tiles_[0]));
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(b1) <
+                   static_cast<std::size_t>(nb_tiles_[1]));
+
+  return il::Array2DView<T>{data_ + (b1 * nb_tiles_[0] + b0) * tile_size,
+                            il::min(tile0, size_[0] - b0 * tile0),
+                            il::min(tile1, size_[1] - b1 * tile1), tile0};
+}
+
+template <typename T, il::int_t tile0, il::int_t tile1>
+il::Array2DEdit<T> Array2Tiled<T, tile0, tile1>::Tile(il::int_t b0,
+                                                      il::int_t b1) {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(b0) <
+                   static_cast<std::size_t>(nb_tiles_[0]));
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(b1) <
+                   static_cast<std::size_t>(nb_tiles_[1]));
+
+  return il::Array2DEdit<T>{data_ + (b1 * nb_tiles_[0] + b0) * tile_size,
+                            il::min(tile0, size_[0] - b0 * tile0),
+                            il::min(tile1, size_[1] - b1 * tile1), tile0, 0,
+                            0};
+}
+
+template <typename T, il::int_t tile0, il::int_t tile1>
+il::Array2D<T> Array2Tiled<T, tile0, tile1>::array2D() const {
+  il::Array2D<T> A{size_[0], size_[1]};
+  for (il::int_t b1 = 0; b1 < nb_tiles_[1]; ++b1) {
+    for (il::int_t b0 = 0; b0 < nb_tiles_[0]; ++b0) {
+      il::Array2DView<T> tile = this->tile(b0, b1);
+      for (il::int_t i1 = 0; i1 < tile.size(1); ++i1) {
+        for (il::int_t i0 = 0; i0 < tile.size(0); ++i0) {
+          A(b0 * tile0 + i0, b1 * tile1 + i1) = tile(i0, i1);
+        }
+      }
+    }
+  }
+  return A;
+}
+
+template <typename T, il::int_t tile0, il::int_t tile1>
+il::Array2C<T> Array2Tiled<T, tile0, tile1>::array2C() const {
+  il::Array2C<T> A{size_[0], size_[1]};
+  for (il::int_t b0 = 0; b0 < nb_tiles_[0]; ++b0) {
+    for (il::int_t b1 = 0; b1 < nb_tiles_[1]; ++b1) {
+      il::Array2DView<T> tile = this->tile(b0, b1);
+      for (il::int_t i0 = 0; i0 < tile.size(0); ++i0) {
+        for (il::int_t i1 = 0; i1 < tile.size(1); ++i1) {
+          A(b0 * tile0 + i0, b1 * tile1 + i1) = tile(i0, i1);
+        }
+      }
+    }
+  }
+  return A;
+}
+
+template <typename T, il::int_t tile0, il::int_t tile1>
+const T* Array2Tiled<T, tile0, tile1>::data() const {
+  return data_;
+}
+
+template <typename T, il::int_t tile0, il::int_t tile1>
+T* Array2Tiled<T, tile0, tile1>::Data() {
+  return data_;
+}
+
+// The divisions are shifts and the remainders are masks when the sizes of the
+// tiles are powers of 2, which is what one should use
+template <typename T, il::int_t tile0, il::int_t tile1>
+il::int_t Array2Tiled<T, tile0, tile1>::offset(il::int_t i0,
+                                               il::int_t i1) const {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i0) <
+                   static_cast<std::size_t>(size_[0]));
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i1) <
+                   static_cast<std::size_t>(size_[1]));
+
+  const std::size_t j0 = static_cast<std::size_t>(i0);
+  const std::size_t j1 = static_cast<std::size_t>(i1);
+  const std::size_t t0 = static_cast<std::size_t>(tile0);
+  const std::size_t t1 = static_cast<std::size_t>(tile1);
+  const std::size_t b = (j1 / t1) * static_cast<std::size_t>(nb_tiles_[0]) +
+                        j0 / t0;
+  return static_cast<il::int_t>(b * t0 * t1 + (j1 % t1) * t0 + j0 % t0);
+}
+
+template <typename T, il::int_t tile0, il::int_t tile1>
+void Array2Tiled<T, tile0, tile1>::Allocate(il::int_t n0, il::int_t n1) {
+  IL_EXPECT_FAST(n0 >= 0);
+  IL_EXPECT_FAST(n1 >= 0);
+
+  size_[0] = n0;
+  size_[1] = n1;
+  nb_tiles_[0] = (n0 + tile0 - 1) / tile0;
+  nb_tiles_[1] = (n1 + tile1 - 1) / tile1;
+  bool error = false;
+  const il::int_t r =
+      il::safeProduct(nb_tiles_[0], nb_tiles_[1], tile_size, il::io, error);
+  if (error) {
+    il::abort();
+  }
+  if (r > 0) {
+    const il::int_t cache_line = 64;
+    il::int_t shift;
+    data_ = il::allocateArray<T>(r, 0, cache_line, il::io, shift);
+    shift_ = static_cast<short>(shift);
+  } else {
+    data_ = nullptr;
+    shift_ = 0;
+  }
+}
+
+template <typename T, il::int_t tile0, il::int_t tile1>
+void Array2Tiled<T, tile0, tile1>::Release() {
+  if (data_) {
+    if (!il::isTrivial<T>::value) {
+      const il::int_t r = nb_tiles_[0] * nb_tiles_[1] * tile_size;
+      for (il::int_t i = r - 1; i >= 0; --i) {
+        (data_ + i)->~T();
+      }
+    }
+    il::deallocate(data_ - shift_);
+    data_ = nullptr;
+  }
+}
+
+}  // namespace il
+
+#endif  // IL_ARRAY2TILED_H
@@ -0,0 +1,197 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#ifndef IL_INTERLEAVEDARRAY2D_H
+#define IL_INTERLEAVEDARRAY2D_H
+
+#include <il/container/1d/Array.h>
+#include <il/container/2d/StaticArray2D.h>
+
+namespace il {
+
+/* \brief A batch of n0 x n1 matrices whose entries are interleaved
+// \details The entries (i0, i1) of all the matrices are stored contiguously:
+// the entry (i0, i1) of the k-th matrix is at
+// data()[(i1 * n0 + i0) * stride() + k]. Loops on the matrices of the batch
+// are therefore vectorized by the compiler, which is the fastest way to work
+// on a large number of very small matrices. The stride is a multiple of 8 and
+// the memory is aligned on 64 bytes. This container should only be used with
+// numeric types.
+//
+// il::InterleavedArray2D<double, 3, 3> A{n};
+// for (il::int_t k = 0; k < A.size(); ++k) {
+//   A.Set(k, il::StaticArray2D<double, 3, 3>{0.0});
+// }
+*/
+template <typename T, il::int_t n0, il::int_t n1>
+class InterleavedArray2D {
+  static_assert(n0 > 0,
+                "il::InterleavedArray2D<T, n0, n1>: n0 must be positive");
+  static_assert(n1 > 0,
+                "il::InterleavedArray2D<T, n0, n1>: n1 must be positive");
+
+ private:
+  il::Array<T> data_;
+  il::int_t size_;
+  il::int_t stride_;
+
+ public:
+  /* \brief Construct an empty batch
+   */
+  InterleavedArray2D();
+
+  /* \brief Construct a batch of n matrices
+  // \details The entries are not initialized in release mode.
+  */
+  explicit InterleavedArray2D(il::int_t n);
+
+  /* \brief Construct a batch from an array of matrices
+   */
+  explicit InterleavedArray2D(const il::Array<il::StaticArray2D<T, n0, n1>>& A);
+
+  /* \brief Accessor for the entry (i0, i1) of the k-th matrix
+  // \details Bound checking is done in debug mode but not in release mode.
+  */
+  const T& operator()(il::int_t k, il::int_t i0, il::int_t i1) const;
+
+  T& operator()(il::int_t k, il::int_t i0, il::int_t i1);
+
+  /* \brief Get a copy of the k-th matrix
+   */
+  il::StaticArray2D<T, n0, n1> matrix(il::int_t k) const;
+
+  /* \brief Set the k-th matrix
+   */
+  void Set(il::int_t k, const il::StaticArray2D<T, n0, n1>& A);
+
+  /* \brief Get the number of matrices of the batch
+   */
+  il::int_t size() const;
+
+  /* \brief Get the distance in between the entries i and i + 1 of a matrix,
+  // the entry (i0, i1) being the entry i1 * n0 + i0
+  */
+  il::int_t stride() const;
+
+  /* \brief Get a pointer to the first element of the storage
+  // \details One should use this method only when using C-style API
+  */
+  const T* data() const;
+
+  T* Data();
+};
+
+template <typename T, il::int_t n0, il::int_t n1>
+InterleavedArray2D<T, n0, n1>::InterleavedArray2D()
+    : data_{}, size_{0}, stride_{0} {}
+
+template <typename T, il::int_t n0, il::int_t n1>
+InterleavedArray2D<T, n0, n1>::InterleavedArray2D(il::int_t n)
+    : data_{}, size_{n}, stride_{0} {
+  IL_EXPECT_FAST(n >= 0);
+
+  bool error = false;
+  stride_ = il::safeUpperRound(n, il::int_t{8}, il::io, error);
+  if (error) {
+    il::abort();
+  }
+  const il::int_t r = il::safeProduct(stride_, n0, n1, il::io, error);
+  if (error) {
+    il::abort();
+  }
+  data_ = il::Array<T>{r, il::align, 64};
+}
+
+template <typename T, il::int_t n0, il::int_t n1>
+InterleavedArray2D<T, n0, n1>::InterleavedArray2D(
+    const il::Array<il::StaticArray2D<T, n0, n1>>& A)
+    : InterleavedArray2D{A.size()} {
+  for (il::int_t k = 0; k < size_; ++k) {
+    Set(k, A[k]);
+  }
+}
+
+template <typename T, il::int_t n0, il::int_t n1>
+const T& InterleavedArray2D<T, n0, n1>::operator()(il::int_t k, il::int_t i0,
+                                                   il::int_t i1) const {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(k) <
+                   static_cast<std::size_t>(size_));
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i0) < static_cast<std::size_t>(n0));
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i1) < static_cast<std::size_t>(n1));
+
+  return data_.data()[(i1 * n0 + i0) * stride_ + k];
+}
+
+template <typename T, il::int_t n0, il::int_t n1>
+T& InterleavedArray2D<T, n0, n1>::operator()(il::int_t k, il::int_t i0,
+                                             il::int_t i1) {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(k) <
+                   static_cast<std::size_t>(size_));
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i0) < static_cast<std::size_t>(n0));
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i1) < static_cast<std::size_t>(n1));
+
+  return data_.Data()[(i1 * n0 + i0) * stride_ + k];
+}
+
+template <typename T, il::int_t n0, il::int_t n1>
+il::StaticArray2D<T, n0, n1> InterleavedArray2D<T, n0, n1>::matrix(
+    il::int_t k) const {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(k) <
+                   static_cast<std::size_t>(size_));
+
+  il::StaticArray2D<T, n0, n1> A{};
+  for (il::int_t i = 0; i < n0 * n1; ++i) {
+    A.Data()[i] = data_.data()[i * stride_ + k];
+  }
+  return A;
+}
+
+template <typename T, il::int_t n0, il::int_t n1>
+void InterleavedArray2D<T, n0, n1>::Set(il::int_t k,
+                                        const il::StaticArray2D<T, n0, n1>& A) {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(k) <
+                   static_cast<std::size_t>(size_));
+
+  for (il::int_t i = 0; i < n0 * n1; ++i) {
+    data_.Data()[i * stride_ + k] = A.data()[i];
+  }
+}
+
+template <typename T, il::int_t n0, il::int_t n1>
+il::int_t InterleavedArray2D<T, n0, n1>::size() const {
+  return size_;
+}
+
+template <typename T, il::int_t n0, il::int_t n1>
+il::int_t InterleavedArray2D<T, n0, n1>::stride() const {
+  return stride_;
+}
+
+template <typename T, il::int_t n0, il::int_t n1>
+const T* InterleavedArray2D<T, n0, n1>::data() const {
+  return data_.data();
+}
+
+template <typename T, il::int_t n0, il::int_t n1>
+T* InterleavedArray2D<T, n0, n1>::Data() {
+  return data_.Data();
+}
+
+}  // namespace il
+
+#endif  // IL_INTERLEAVEDARRAY2D_H
@@ -640,3 +640,47 @@ TEST(Array2C, reserve_object_Order_c) {
               Dummy::destroyed[3] == -3 && Dummy::destroyed[4] == -2 &&
               Dummy::destroyed[5] == -1);
 }
+
+TEST(Array2C, pad_constructor) {
+  il::Array2C<double> A{3, 1024, 1.0, il::pad};
+
+  ASSERT_TRUE(A.size(0) == 3 && A.size(1) == 1024 && A.stride(0) == 1032 &&
+              A(2, 1023) == 1.0 &&
+              reinterpret_cast<std::size_t>(A.data()) % 64 == 0);
+}
+
+TEST(Array2C, pad_copy) {
+  il::Array2C<double> A{2, 512, 1.0, il::pad};
+  il::Array2C<double> B = A;
+  B.Resize(2, 2048);
+
+  ASSERT_TRUE(B.stride(0) == 2056 && B(1, 511) == 1.0);
+}
+
+TEST(Array2C, uninitialized_constructor) {
+  const il::int_t n0 = 3;
+  const il::int_t n1 = 5;
+  il::Array2C<double> A{n0, n1, il::uninitialized};
+  for (il::int_t i0 = 0; i0 < n0; ++i0) {
+    for (il::int_t i1 = 0; i1 < n1; ++i1) {
+      A(i0, i1) = static_cast<double>(i0 + i1);
+    }
+  }
+
+  ASSERT_TRUE(A.size(0) == n0 && A.size(1) == n1 && A(2, 4) == 6.0);
+}
+
+TEST(Array2C, uninitialized_constructor_object) {
+  il::Array2C<il::Array<double>> A{2, 3, il::uninitialized};
+
+  ASSERT_TRUE(A.size(0) == 2 && A.size(1) == 3 && A(0, 0).size() == 0 &&
+              A(1, 2).size() == 0);
+}
+
+TEST(Array2C, resize_uninitialized) {
+  il::Array2C<il::int_t> A{2, 2, 5};
+  A.Resize(3, 4, il::uninitialized);
+
+  ASSERT_TRUE(A.size(0) == 3 && A.size(1) == 4 && A(0, 0) == 5 &&
+              A(1, 0) == 5 && A(0, 1) == 5 && A(1, 1) == 5);
+}
@@ -19,6 +19,7 @@
 #include <gtest/gtest.h>
 
 #include <il/Array2D.h>
+#include <il/String.h>
 #include <il/container/1d/_test/Dummy_test.h>
 
 TEST(Array2D, default_constructor) {
@@ -651,3 +652,172 @@ TEST(Array2D, basic) {
   const il::int_t* const data{A.data()};
   ASSERT_TRUE(data[0] == 0 && data[1] == 1 && data[2] == 2 && data[3] == 3);
 }
+
+TEST(Array2D, hugepage_constructor_0) {
+  il::Array2D<double> A{2, 3, 0.0, il::hugepage};
+
+  ASSERT_TRUE(A.size(0) == 2 && A.size(1) == 3 && A(1, 2) == 0.0 &&
+              A.backing() == il::Backing::Heap);
+}
+
+TEST(Array2D, hugepage_constructor_1) {
+  const il::int_t n = 1024;
+  il::Array2D<double> A{n, n, 1.0, il::hugepage};
+
+#ifdef IL_HUGEPAGE
+  const bool huge_page = A.backing() == il::Backing::HugePage &&
+                         reinterpret_cast<std::size_t>(A.data()) %
+                                 il::HugePageAllocator::huge_page_size ==
+                             il::allocationHeaderSize();
+#else
+  const bool huge_page = A.backing() == il::Backing::Heap;
+#endif
+  ASSERT_TRUE(huge_page && A(n - 1, n - 1) == 1.0);
+}
+
+TEST(Array2D, parallel_constructor) {
+  const il::int_t n0 = 3;
+  const il::int_t n1 = 100;
+  const il::int_t x = 5;
+  il::Array2D<il::int_t> A{n0, n1, x, il::parallel};
+
+  bool correct_elements{true};
+  for (il::int_t i1 = 0; i1 < n1; ++i1) {
+    for (il::int_t i0 = 0; i0 < n0; ++i0) {
+      if (A(i0, i1) != x) {
+        correct_elements = false;
+      }
+    }
+  }
+
+  ASSERT_TRUE(A.size(0) == n0 && A.size(1) == n1 && correct_elements);
+}
+
+TEST(Array2D, uninitialized_constructor) {
+  const il::int_t n0 = 3;
+  const il::int_t n1 = 5;
+  il::Array2D<double> A{n0, n1, il::uninitialized};
+  for (il::int_t i1 = 0; i1 < n1; ++i1) {
+    for (il::int_t i0 = 0; i0 < n0; ++i0) {
+      A(i0, i1) = static_cast<double>(i0 + i1);
+    }
+  }
+
+  ASSERT_TRUE(A.size(0) == n0 && A.size(1) == n1 && A(2, 4) == 6.0);
+}
+
+TEST(Array2D, resize_uninitialized) {
+  il::Array2D<il::int_t> A{2, 2, 5};
+  A.Resize(4, 3, il::uninitialized);
+
+  ASSERT_TRUE(A.size(0) == 4 && A.size(1) == 3 && A(0, 0) == 5 &&
+              A(1, 0) == 5 && A(0, 1) == 5 && A(1, 1) == 5);
+}
+
+TEST(Array2D, pad_constructor_0) {
+  il::Array2D<double> A{1024, 3, il::pad};
+
+  ASSERT_TRUE(A.size(0) == 1024 && A.size(1) == 3 && A.stride(1) == 1032 &&
+              reinterpret_cast<std::size_t>(A.data()) % 64 == 0);
+}
+
+TEST(Array2D, pad_constructor_1) {
+  il::Array2D<double> A{9, 3, 1.0, il::pad};
+
+  ASSERT_TRUE(A.size(0) == 9 && A.stride(1) == 16 && A(8, 2) == 1.0 &&
+              reinterpret_cast<std::size_t>(A.data()) % 64 == 0);
+}
+
+TEST(Array2D, pad_copy) {
+  il::Array2D<double> A{512, 2, 1.0, il::pad};
+  il::Array2D<double> B = A;
+  il::Array2D<double> C{};
+  C = A;
+
+  ASSERT_TRUE(B.stride(1) == 520 && C.stride(1) == 520 && B(511, 1) == 1.0 &&
+              C(511, 1) == 1.0);
+}
+
+TEST(Array2D, pad_resize) {
+  il::Array2D<double> A{0, 0, il::pad};
+  A.Resize(256, 2);
+  A(255, 1) = 1.0;
+  A.Resize(2048, 2);
+
+  ASSERT_TRUE(A.size(0) == 2048 && A.stride(1) == 2056 && A(255, 1) == 1.0 &&
+              reinterpret_cast<std::size_t>(A.data()) % 64 == 0);
+}
+
+TEST(Array2D, parallel_copy) {
+  const il::int_t n0 = 100;
+  const il::int_t n1 = 1000;
+  il::Array2D<il::int_t> A{n0, n1, il::align, 64};
+  for (il::int_t i1 = 0; i1 < n1; ++i1) {
+    for (il::int_t i0 = 0; i0 < n0; ++i0) {
+      A(i0, i1) = i1 * n0 + i0;
+    }
+  }
+  il::Array2D<il::int_t> B{A, il::parallel};
+  il::Array2D<il::int_t> C{};
+  C.Assign(A, il::parallel);
+
+  bool correct_elements{true};
+  for (il::int_t i1 = 0; i1 < n1; ++i1) {
+    for (il::int_t i0 = 0; i0 < n0; ++i0) {
+      if (B(i0, i1) != i1 * n0 + i0 || C(i0, i1) != i1 * n0 + i0) {
+        correct_elements = false;
+      }
+    }
+  }
+
+  ASSERT_TRUE(B.size(0) == n0 && B.size(1) == n1 && B.stride(1) == 104 &&
+              C.stride(1) == 104 && correct_elements);
+}
+
+TEST(Array2D, parallel_assign_object) {
+  const il::int_t n0 = 40;
+  const il::int_t n1 = 50;
+  const il::String long_string{
+      "A string that is too long to fit in the small buffer"};
+  il::Array2D<il::String> A{n0, n1};
+  for (il::int_t i1 = 0; i1 < n1; ++i1) {
+    for (il::int_t i0 = 0; i0 < n0; ++i0) {
+      A(i0, i1) = long_string;
+      A(i0, i1).Append(static_cast<char>('a' + (i0 + i1) % 26));
+    }
+  }
+  // The array grows within its capacity in both dimensions, and then shrinks
+  il::Array2D<il::String> B{2, 3, long_string};
+  B.Reserve(n0, n1);
+  B.Assign(A, il::parallel);
+  bool correct_elements = B.size(0) == n0 && B.size(1) == n1;
+  for (il::int_t i1 = 0; i1 < n1; ++i1) {
+    for (il::int_t i0 = 0; i0 < n0; ++i0) {
+      correct_elements = correct_elements && B(i0, i1) == A(i0, i1);
+    }
+  }
+  il::Array2D<il::String> C{1, 2, long_string};
+  B.Assign(C, il::parallel);
+
+  ASSERT_TRUE(correct_elements && B.size(0) == 1 && B.size(1) == 2 &&
+              B(0, 1) == long_string);
+}
+
+TEST(Array2D, parallel_set) {
+  const il::int_t n0 = 100;
+  const il::int_t n1 = 1000;
+  il::Array2D<il::int_t> A{n0, n1};
+  A.Set(5, il::parallel);
+  A.Resize(2 * n0, n1 + 1, 3, il::parallel);
+
+  bool correct_elements{true};
+  for (il::int_t i1 = 0; i1 < n1 + 1; ++i1) {
+    for (il::int_t i0 = 0; i0 < 2 * n0; ++i0) {
+      if (A(i0, i1) != (i0 < n0 && i1 < n1 ? 5 : 3)) {
+        correct_elements = false;
+      }
+    }
+  }
+
+  ASSERT_TRUE(A.size(0) == 2 * n0 && A.size(1) == n1 + 1 && correct_elements);
+}
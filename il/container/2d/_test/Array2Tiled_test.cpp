@@ -0,0 +1,112 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#include <gtest/gtest.h>
+
+#include <il/Array2Tiled.h>
+
+TEST(Array2Tiled, default_constructor) {
+  il::Array2Tiled<double, 4, 4> A{};
+
+  ASSERT_TRUE(A.size(0) == 0 && A.size(1) == 0 && A.nbTiles(0) == 0 &&
+              A.nbTiles(1) == 0 && A.data() == nullptr);
+}
+
+TEST(Array2Tiled, constructor) {
+  il::Array2Tiled<double, 4, 2> A{5, 3, 1.0};
+
+  ASSERT_TRUE(A.size(0) == 5 && A.size(1) == 3 && A.nbTiles(0) == 2 &&
+              A.nbTiles(1) == 2 && A(4, 2) == 1.0 &&
+              reinterpret_cast<std::size_t>(A.data()) % 64 == 0);
+}
+
+TEST(Array2Tiled, layout) {
+  il::Array2Tiled<il::int_t, 4, 2> A{5, 3};
+  for (il::int_t i1 = 0; i1 < 3; ++i1) {
+    for (il::int_t i0 = 0; i0 < 5; ++i0) {
+      A(i0, i1) = 10 * i0 + i1;
+    }
+  }
+
+  // The tile (1, 1) is the fourth one and holds A(4, 2) as its first element
+  ASSERT_TRUE(A.data()[0] == 0 && A.data()[1] == 10 && A.data()[4] == 1 &&
+              A.data()[8] == 40 && A.data()[3 * 8] == 42);
+}
+
+TEST(Array2Tiled, tile) {
+  il::Array2Tiled<double, 4, 2> A{5, 3, 0.0};
+  il::Array2DEdit<double> tile = A.Tile(1, 0);
+  tile(0, 1) = 1.0;
+  il::Array2DView<double> last = A.tile(1, 1);
+
+  ASSERT_TRUE(tile.size(0) == 1 && tile.size(1) == 2 && A(4, 1) == 1.0 &&
+              last.size(0) == 1 && last.size(1) == 1);
+}
+
+TEST(Array2Tiled, array2d) {
+  il::Array2D<double> A{7, 5};
+  for (il::int_t i1 = 0; i1 < 5; ++i1) {
+    for (il::int_t i0 = 0; i0 < 7; ++i0) {
+      A(i0, i1) = static_cast<double>(10 * i0 + i1);
+    }
+  }
+  il::Array2Tiled<double, 4, 4> B{A};
+  il::Array2D<double> C = B.array2D();
+
+  bool correct = C.size(0) == 7 && C.size(1) == 5;
+  for (il::int_t i1 = 0; i1 < 5; ++i1) {
+    for (il::int_t i0 = 0; i0 < 7; ++i0) {
+      if (B(i0, i1) != A(i0, i1) || C(i0, i1) != A(i0, i1)) {
+        correct = false;
+      }
+    }
+  }
+  ASSERT_TRUE(correct);
+}
+
+TEST(Array2Tiled, array2c) {
+  il::Array2C<double> A{7, 5};
+  for (il::int_t i0 = 0; i0 < 7; ++i0) {
+    for (il::int_t i1 = 0; i1 < 5; ++i1) {
+      A(i0, i1) = static_cast<double>(10 * i0 + i1);
+    }
+  }
+  il::Array2Tiled<double, 2, 4> B{A};
+  il::Array2C<double> C = B.array2C();
+
+  bool correct = C.size(0) == 7 && C.size(1) == 5;
+  for (il::int_t i0 = 0; i0 < 7; ++i0) {
+    for (il::int_t i1 = 0; i1 < 5; ++i1) {
+      if (B(i0, i1) != A(i0, i1) || C(i0, i1) != A(i0, i1)) {
+        correct = false;
+      }
+    }
+  }
+  ASSERT_TRUE(correct);
+}
+
+TEST(Array2Tiled, copy) {
+  il::Array2Tiled<double, 4, 4> A{5, 5, 2.0};
+  il::Array2Tiled<double, 4, 4> B{};
+  B = A;
+  A(4, 4) = 0.0;
+  il::Array2Tiled<double, 4, 4> C = std::move(A);
+
+  ASSERT_TRUE(B.size(0) == 5 && B(4, 4) == 2.0 && C(4, 4) == 0.0 &&
+              A.data() == nullptr);
+}
@@ -0,0 +1,76 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include <il/InterleavedArray2D.h>
+
+TEST(InterleavedArray2D, default_constructor) {
+  il::InterleavedArray2D<double, 3, 3> A{};
+
+  ASSERT_TRUE(A.size() == 0 && A.stride() == 0);
+}
+
+TEST(InterleavedArray2D, size_constructor) {
+  il::InterleavedArray2D<double, 2, 3> A{13};
+
+  ASSERT_TRUE(A.size() == 13 && A.stride() == 16 &&
+              reinterpret_cast<std::uintptr_t>(A.data()) % 64 == 0);
+}
+
+TEST(InterleavedArray2D, layout) {
+  il::InterleavedArray2D<double, 2, 3> A{10};
+  for (il::int_t k = 0; k < A.size(); ++k) {
+    for (il::int_t i1 = 0; i1 < 3; ++i1) {
+      for (il::int_t i0 = 0; i0 < 2; ++i0) {
+        A(k, i0, i1) = static_cast<double>(100 * k + 10 * i1 + i0);
+      }
+    }
+  }
+
+  const double* data = A.data();
+  const il::int_t stride = A.stride();
+
+  ASSERT_TRUE(data[(1 * 2 + 0) * stride + 7] == 710.0 &&
+              data[(2 * 2 + 1) * stride + 3] == 321.0);
+}
+
+TEST(InterleavedArray2D, array_constructor) {
+  il::Array<il::StaticArray2D<double, 2, 2>> v{3};
+  for (il::int_t k = 0; k < v.size(); ++k) {
+    v[k] = il::StaticArray2D<double, 2, 2>{
+        il::value, {{1.0 * k, 2.0 * k}, {3.0 * k, 4.0 * k}}};
+  }
+
+  const il::InterleavedArray2D<double, 2, 2> A{v};
+  const il::StaticArray2D<double, 2, 2> B = A.matrix(2);
+
+  ASSERT_TRUE(A.size() == 3 && A(1, 1, 0) == 2.0 && A(2, 0, 1) == 6.0 &&
+              B(0, 0) == 2.0 && B(1, 0) == 4.0 && B(0, 1) == 6.0 &&
+              B(1, 1) == 8.0);
+}
+
+TEST(InterleavedArray2D, set) {
+  il::InterleavedArray2D<double, 2, 2> A{5};
+  A.Set(4, il::StaticArray2D<double, 2, 2>{il::value, {{1.0, 2.0}, {3.0, 4.0}}});
+
+  ASSERT_TRUE(A(4, 0, 0) == 1.0 && A(4, 1, 0) == 2.0 && A(4, 0, 1) == 3.0 &&
+              A(4, 1, 1) == 4.0);
+}
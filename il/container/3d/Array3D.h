@@ -25,10 +25,14 @@
 #include <initializer_list>
 // <new> is needed for placement new
 #include <new>
+// <type_traits> is needed for std::is_trivial
+#include <type_traits>
 // <utility> is needed for std::move
 #include <utility>
 
+#include <il/container/nd/StridedArrayView.h>
 #include <il/core.h>
+#include <il/core/memory/HugePage.h>
 #include <il/core/memory/allocate.h>
 
 namespace il {
@@ -70,6 +74,16 @@ class Array3D {
   */
   explicit Array3D(il::int_t n0, il::int_t n1, il::int_t n2);
 
+  /* \brief Construct an array without initializing its elements
+  // \details When T is trivial, the elements are left uninitialized, even in
+  // debug mode. It should be used for arrays that are overwritten right after
+  // their construction. Otherwise, the elements are default constructed.
+  //
+  // il::Array3D<double> A{n0, n1, n2, il::uninitialized};
+  */
+  explicit Array3D(il::int_t n0, il::int_t n1, il::int_t n2,
+                   il::uninitialized_t);
+
   /* \brief Construct an aligned array
   // \details The pointer data, when considered as an integer, satisfies
   // data_ = 0 (Modulo align_mod)
@@ -93,6 +107,20 @@ class Array3D {
   */
   explicit Array3D(il::int_t n0, il::int_t n1, il::int_t n2, const T& x);
 
+  /* \brief Construct an array backed by huge pages
+  // \details The memory is obtained from il::hugePageAllocator() which uses a
+  // 2 MiB aligned mmap with madvise(MADV_HUGEPAGE), and falls back to the heap
+  // when it is not possible. Use backing() to know which one has been used.
+  // Reallocations done later by Resize or Reserve use the allocator of the
+  // thread.
+  //
+  // il::Array3D<double> A{n0, n1, n2, il::hugepage};
+  */
+  explicit Array3D(il::int_t n0, il::int_t n1, il::int_t n2, il::hugepage_t);
+
+  explicit Array3D(il::int_t n0, il::int_t n1, il::int_t n2, const T& x,
+                   il::hugepage_t);
+
   explicit Array3D(il::int_t n0, il::int_t n1, il::int_t n2, const T& x,
                    il::align_t, il::int_t alignment);
 
@@ -185,6 +213,12 @@ class Array3D {
   */
   void Resize(il::int_t n0, il::int_t n1, il::int_t n2);
 
+  /* \brief Resizing an il::Array3D<T> without initializing the new elements
+  // \details When T is trivial, the new elements are left uninitialized, even
+  // in debug mode. Otherwise, they are default constructed.
+  */
+  void Resize(il::int_t n0, il::int_t n1, il::int_t n2, il::uninitialized_t);
+
   /* \brief Get the capacity of the il::Array3D<T>
   // \details capacity(0) gives the capacity in terms of rows and capacity(1)
   // gives the capacity in terms of columns and capacity(2) gives the capacity
@@ -204,6 +238,20 @@ class Array3D {
    */
   il::int_t alignment() const;
 
+  /* \brief Get a strided view on the array
+  // \details The view can be sliced, transposed or restricted to its diagonal
+  // without copying the elements. See il::StridedArrayView.
+  */
+  il::StridedArrayView<T, 3> view() const;
+
+  il::StridedArrayView<T, 3> view(il::Range range0, il::Range range1,
+                                  il::Range range2) const;
+
+  il::StridedArrayEdit<T, 3> Edit();
+
+  il::StridedArrayEdit<T, 3> Edit(il::Range range0, il::Range range1,
+                                  il::Range range2);
+
   /* \brief Get a pointer to const to the first element of the array
   // \details One should use this method only when using C-style API
   */
@@ -229,7 +277,22 @@ class Array3D {
   */
   il::int_t stride(il::int_t d) const;
 
+  /* \brief Get the memory backing the array
+   */
+  il::Backing backing() const;
+
  private:
+  Array3D(il::int_t n0, il::int_t n1, il::int_t n2, const il::AllocatorScope&);
+
+  Array3D(il::int_t n0, il::int_t n1, il::int_t n2, const T& x,
+          const il::AllocatorScope&);
+
+  /* \brief Used internally by Resize
+  // \details The new elements are initialized, as in Resize(n0, n1, n2), unless
+  // initialize is false and T is trivial
+  */
+  void SetSize(il::int_t n0, il::int_t n1, il::int_t n2, bool initialize);
+
   /* \brief Used internally in debug mode to check the invariance of the object
    */
   bool invariance() const;
@@ -606,6 +669,34 @@ Array3D<T>::Array3D(
   shift_ = 0;
 }
 
+template <typename T>
+Array3D<T>::Array3D(il::int_t n0, il::int_t n1, il::int_t n2, il::hugepage_t)
+    : Array3D{n0, n1, n2, il::AllocatorScope{il::hugePageAllocator()}} {}
+
+template <typename T>
+Array3D<T>::Array3D(il::int_t n0, il::int_t n1, il::int_t n2, const T& x,
+                    il::hugepage_t)
+    : Array3D{n0, n1, n2, x, il::AllocatorScope{il::hugePageAllocator()}} {}
+
+// The scope is a temporary of the delegating constructor, which keeps the huge
+// page allocator in place while the array is allocated
+template <typename T>
+Array3D<T>::Array3D(il::int_t n0, il::int_t n1, il::int_t n2,
+                    const il::AllocatorScope&)
+    : Array3D{n0, n1, n2} {}
+
+template <typename T>
+Array3D<T>::Array3D(il::int_t n0, il::int_t n1, il::int_t n2, const T& x,
+                    const il::AllocatorScope&)
+    : Array3D{n0, n1, n2, x} {}
+
+template <typename T>
+Array3D<T>::Array3D(il::int_t n0, il::int_t n1, il::int_t n2,
+                    il::uninitialized_t)
+    : Array3D{} {
+  SetSize(n0, n1, n2, false);
+}
+
 template <typename T>
 Array3D<T>::Array3D(const Array3D<T>& A) {
   const il::int_t n0 = A.size(0);
@@ -927,6 +1018,18 @@ il::int_t Array3D<T>::size(il::int_t d) const {
 
 template <typename T>
 void Array3D<T>::Resize(il::int_t n0, il::int_t n1, il::int_t n2) {
+  SetSize(n0, n1, n2, true);
+}
+
+template <typename T>
+void Array3D<T>::Resize(il::int_t n0, il::int_t n1, il::int_t n2,
+                        il::uninitialized_t) {
+  SetSize(n0, n1, n2, false);
+}
+
+template <typename T>
+void Array3D<T>::SetSize(il::int_t n0, il::int_t n1, il::int_t n2,
+                         bool initialize) {
   IL_EXPECT_FAST(n0 >= 0);
   IL_EXPECT_FAST(n1 >= 0);
   IL_EXPECT_FAST(n2 >= 0);
@@ -987,11 +1090,13 @@ void Array3D<T>::Resize(il::int_t n0, il::int_t n1, il::int_t n2) {
         il::deallocate(data_ - shift_);
       }
 #ifdef IL_DEFAULT_VALUE
-      for (il::int_t i2 = 0; i2 < n2; ++i2) {
-        for (il::int_t i1 = 0; i1 < n1; ++i1) {
-          for (il::int_t i0 = i2 < n2_old && i1 < n1_old ? n0_old : 0; i0 < n0;
-               ++i0) {
-            new_data[(i2 * r1 + i1) * r0 + i0] = il::defaultValue<T>();
+      if (initialize) {
+        for (il::int_t i2 = 0; i2 < n2; ++i2) {
+          for (il::int_t i1 = 0; i1 < n1; ++i1) {
+            for (il::int_t i0 = i2 < n2_old && i1 < n1_old ? n0_old : 0;
+                 i0 < n0; ++i0) {
+              new_data[(i2 * r1 + i1) * r0 + i0] = il::defaultValue<T>();
+            }
           }
         }
       }
@@ -1020,11 +1125,13 @@ void Array3D<T>::Resize(il::int_t n0, il::int_t n1, il::int_t n2) {
         }
         il::deallocate(data_);
       }
-      for (il::int_t i2 = 0; i2 < n2; ++i2) {
-        for (il::int_t i1 = 0; i1 < n1; ++i1) {
-          for (il::int_t i0 = i2 < n2_old && i1 < n1_old ? n0_old : 0; i0 < n0;
-               ++i0) {
-            new (new_data + (i2 * r1 + i1) * r0 + i0) T{};
+      if (initialize || !std::is_trivial<T>::value) {
+        for (il::int_t i2 = 0; i2 < n2; ++i2) {
+          for (il::int_t i1 = 0; i1 < n1; ++i1) {
+            for (il::int_t i0 = i2 < n2_old && i1 < n1_old ? n0_old : 0;
+                 i0 < n0; ++i0) {
+              new (new_data + (i2 * r1 + i1) * r0 + i0) T{};
+            }
           }
         }
       }
@@ -1037,12 +1144,14 @@ void Array3D<T>::Resize(il::int_t n0, il::int_t n1, il::int_t n2) {
   } else {
     if (il::isTrivial<T>::value) {
 #ifdef IL_DEFAULT_VALUE
-      for (il::int_t i2 = 0; i2 < n2; ++i2) {
-        for (il::int_t i1 = 0; i1 < n1; ++i1) {
-          for (il::int_t i0 = (i2 < n2_old && i1 < n1_old) ? n0_old : 0;
-               i0 < n0; ++i0) {
-            data_[(i2 * capacity(1) + i1) * capacity(0) + i0] =
-                il::defaultValue<T>();
+      if (initialize) {
+        for (il::int_t i2 = 0; i2 < n2; ++i2) {
+          for (il::int_t i1 = 0; i1 < n1; ++i1) {
+            for (il::int_t i0 = (i2 < n2_old && i1 < n1_old) ? n0_old : 0;
+                 i0 < n0; ++i0) {
+              data_[(i2 * capacity(1) + i1) * capacity(0) + i0] =
+                  il::defaultValue<T>();
+            }
           }
         }
       }
@@ -1057,11 +1166,13 @@ void Array3D<T>::Resize(il::int_t n0, il::int_t n1, il::int_t n2) {
         }
       }
     }
-    for (il::int_t i2 = 0; i2 < n2; ++i2) {
-      for (il::int_t i1 = 0; i1 < n1; ++i1) {
-        for (il::int_t i0 = (i2 < n2_old && i1 < n1_old) ? n0_old : 0; i0 < n0;
-             ++i0) {
-          new (data_ + (i2 * capacity(1) + i1) * capacity(0) + i0) T{};
+    if (initialize || !std::is_trivial<T>::value) {
+      for (il::int_t i2 = 0; i2 < n2; ++i2) {
+        for (il::int_t i1 = 0; i1 < n1; ++i1) {
+          for (il::int_t i0 = (i2 < n2_old && i1 < n1_old) ? n0_old : 0;
+               i0 < n0; ++i0) {
+            new (data_ + (i2 * capacity(1) + i1) * capacity(0) + i0) T{};
+          }
         }
       }
     }
@@ -1157,6 +1268,34 @@ il::int_t Array3D<T>::alignment() const {
   return alignment_;
 }
 
+template <typename T>
+il::StridedArrayView<T, 3> Array3D<T>::view() const {
+  const il::int_t sizes[3] = {size(0), size(1), size(2)};
+  const il::int_t strides[3] = {1, capacity(0), capacity(0) * capacity(1)};
+  return il::StridedArrayView<T, 3>{data_, sizes, strides};
+}
+
+template <typename T>
+il::StridedArrayView<T, 3> Array3D<T>::view(il::Range range0,
+                                            il::Range range1,
+                                            il::Range range2) const {
+  return view().view(range0, range1, range2);
+}
+
+template <typename T>
+il::StridedArrayEdit<T, 3> Array3D<T>::Edit() {
+  const il::int_t sizes[3] = {size(0), size(1), size(2)};
+  const il::int_t strides[3] = {1, capacity(0), capacity(0) * capacity(1)};
+  return il::StridedArrayEdit<T, 3>{data_, sizes, strides};
+}
+
+template <typename T>
+il::StridedArrayEdit<T, 3> Array3D<T>::Edit(il::Range range0,
+                                            il::Range range1,
+                                            il::Range range2) {
+  return Edit().Edit(range0, range1, range2);
+}
+
 template <typename T>
 const T* Array3D<T>::data() const {
   return data_;
@@ -1176,6 +1315,11 @@ il::int_t Array3D<T>::stride(il::int_t d) const {
              : (capacity_[0] - data_) * ((d == 1) ? 1 : (capacity_[1] - data_));
 }
 
+template <typename T>
+il::Backing Array3D<T>::backing() const {
+  return data_ ? il::backing(data_ - shift_) : il::Backing::Heap;
+}
+
 template <typename T>
 bool Array3D<T>::invariance() const {
   bool ans = true;
@@ -798,3 +798,86 @@ TEST(Array3D, basic) {
   ASSERT_TRUE(data[0] == 0 && data[1] == 1 && data[2] == 2 && data[3] == 3 &&
               data[4] == 4 && data[5] == 5 && data[6] == 6 && data[7] == 7);
 }
+
+TEST(Array3D, hugepage_constructor_0) {
+  il::Array3D<double> A{2, 3, 4, 0.0, il::hugepage};
+
+  ASSERT_TRUE(A.size(0) == 2 && A.size(1) == 3 && A.size(2) == 4 &&
+              A(1, 2, 3) == 0.0 && A.backing() == il::Backing::Heap);
+}
+
+TEST(Array3D, hugepage_constructor_1) {
+  const il::int_t n = 128;
+  il::Array3D<double> A{n, n, n, 1.0, il::hugepage};
+
+#ifdef IL_HUGEPAGE
+  const bool huge_page = A.backing() == il::Backing::HugePage &&
+                         reinterpret_cast<std::size_t>(A.data()) %
+                                 il::HugePageAllocator::huge_page_size ==
+                             il::allocationHeaderSize();
+#else
+  const bool huge_page = A.backing() == il::Backing::Heap;
+#endif
+  ASSERT_TRUE(huge_page && A(n - 1, n - 1, n - 1) == 1.0);
+}
+
+TEST(Array3D, hugepage_constructor_2) {
+  const il::int_t n = 128;
+  il::Array3D<double> A{n, n, n, il::hugepage};
+  A(n - 1, n - 1, n - 1) = 2.0;
+
+#ifdef IL_HUGEPAGE
+  const bool huge_page = A.backing() == il::Backing::HugePage;
+#else
+  const bool huge_page = A.backing() == il::Backing::Heap;
+#endif
+  ASSERT_TRUE(huge_page && A.size(2) == n && A(n - 1, n - 1, n - 1) == 2.0);
+}
+
+TEST(Array3D, backing_default) {
+  il::Array3D<double> A{};
+  il::Array3D<double> B{2, 2, 2};
+
+  ASSERT_TRUE(A.backing() == il::Backing::Heap &&
+              B.backing() == il::Backing::Heap);
+}
+
+TEST(Array3D, uninitialized_constructor) {
+  const il::int_t n0 = 2;
+  const il::int_t n1 = 3;
+  const il::int_t n2 = 4;
+  il::Array3D<double> A{n0, n1, n2, il::uninitialized};
+  for (il::int_t i2 = 0; i2 < n2; ++i2) {
+    for (il::int_t i1 = 0; i1 < n1; ++i1) {
+      for (il::int_t i0 = 0; i0 < n0; ++i0) {
+        A(i0, i1, i2) = static_cast<double>(i0 + i1 + i2);
+      }
+    }
+  }
+
+  ASSERT_TRUE(A.size(0) == n0 && A.size(1) == n1 && A.size(2) == n2 &&
+              A(1, 2, 3) == 6.0);
+}
+
+TEST(Array3D, uninitialized_constructor_object) {
+  il::Array3D<il::Array<double>> A{2, 2, 2, il::uninitialized};
+
+  ASSERT_TRUE(A.size(2) == 2 && A(0, 0, 0).size() == 0 &&
+              A(1, 1, 1).size() == 0);
+}
+
+TEST(Array3D, resize_uninitialized) {
+  il::Array3D<il::int_t> A{2, 2, 2, 5};
+  A.Resize(3, 4, 5, il::uninitialized);
+
+  bool correct = A.size(0) == 3 && A.size(1) == 4 && A.size(2) == 5;
+  for (il::int_t i2 = 0; i2 < 2; ++i2) {
+    for (il::int_t i1 = 0; i1 < 2; ++i1) {
+      for (il::int_t i0 = 0; i0 < 2; ++i0) {
+        correct = correct && A(i0, i1, i2) == 5;
+      }
+    }
+  }
+
+  ASSERT_TRUE(correct);
+}
@@ -28,6 +28,7 @@
 // <utility> is needed for std::move
 #include <utility>
 
+#include <il/container/nd/StridedArrayView.h>
 #include <il/core.h>
 #include <il/core/memory/allocate.h>
 
@@ -169,6 +170,20 @@ class Array4C {
   */
   void Reserve(il::int_t r0, il::int_t r1, il::int_t r2, il::int_t r3);
 
+  /* \brief Get a strided view on the array
+  // \details The view can be sliced, transposed or restricted to its diagonal
+  // without copying the elements. See il::StridedArrayView.
+  */
+  il::StridedArrayView<T, 4> view() const;
+
+  il::StridedArrayView<T, 4> view(il::Range range0, il::Range range1,
+                                  il::Range range2, il::Range range3) const;
+
+  il::StridedArrayEdit<T, 4> Edit();
+
+  il::StridedArrayEdit<T, 4> Edit(il::Range range0, il::Range range1,
+                                  il::Range range2, il::Range range3);
+
   /* \brief Get a pointer to const to the first element of the array
   // \details One should use this method only when using C-style API
   */
@@ -984,6 +999,38 @@ void Array4C<T>::Reserve(il::int_t r0, il::int_t r1, il::int_t r2,
   }
 }
 
+template <typename T>
+il::StridedArrayView<T, 4> Array4C<T>::view() const {
+  const il::int_t sizes[4] = {size(0), size(1), size(2), size(3)};
+  const il::int_t strides[4] = {capacity(1) * capacity(2) * capacity(3),
+                                capacity(2) * capacity(3), capacity(3), 1};
+  return il::StridedArrayView<T, 4>{data_, sizes, strides};
+}
+
+template <typename T>
+il::StridedArrayView<T, 4> Array4C<T>::view(il::Range range0,
+                                            il::Range range1,
+                                            il::Range range2,
+                                            il::Range range3) const {
+  return view().view(range0, range1, range2, range3);
+}
+
+template <typename T>
+il::StridedArrayEdit<T, 4> Array4C<T>::Edit() {
+  const il::int_t sizes[4] = {size(0), size(1), size(2), size(3)};
+  const il::int_t strides[4] = {capacity(1) * capacity(2) * capacity(3),
+                                capacity(2) * capacity(3), capacity(3), 1};
+  return il::StridedArrayEdit<T, 4>{data_, sizes, strides};
+}
+
+template <typename T>
+il::StridedArrayEdit<T, 4> Array4C<T>::Edit(il::Range range0,
+                                            il::Range range1,
+                                            il::Range range2,
+                                            il::Range range3) {
+  return Edit().Edit(range0, range1, range2, range3);
+}
+
 template <typename T>
 const T* Array4C<T>::data() const {
   return data_;
@@ -25,10 +25,14 @@
 #include <initializer_list>
 // <new> is needed for placement new
 #include <new>
+// <type_traits> is needed for std::is_trivial
+#include <type_traits>
 // <utility> is needed for std::move
 #include <utility>
 
+#include <il/container/nd/StridedArrayView.h>
 #include <il/core.h>
+#include <il/core/memory/HugePage.h>
 #include <il/core/memory/allocate.h>
 
 namespace il {
@@ -70,6 +74,16 @@ class Array4D {
   */
   explicit Array4D(il::int_t n0, il::int_t n1, il::int_t n2, il::int_t n3);
 
+  /* \brief Construct an array without initializing its elements
+  // \details When T is trivial, the elements are left uninitialized, even in
+  // debug mode. It should be used for arrays that are overwritten right after
+  // their construction. Otherwise, the elements are default constructed.
+  //
+  // il::Array4D<double> A{n0, n1, n2, n3, il::uninitialized};
+  */
+  explicit Array4D(il::int_t n0, il::int_t n1, il::int_t n2, il::int_t n3,
+                   il::uninitialized_t);
+
   /* \brief Construct an array of n rows and p columns with a value
   /
   // // Construct an array of double with 3 rows and 5 columns, initialized with
@@ -79,6 +93,21 @@ class Array4D {
   explicit Array4D(il::int_t n0, il::int_t n1, il::int_t n2, il::int_t n3,
                    const T& x);
 
+  /* \brief Construct an array backed by huge pages
+  // \details The memory is obtained from il::hugePageAllocator() which uses a
+  // 2 MiB aligned mmap with madvise(MADV_HUGEPAGE), and falls back to the heap
+  // when it is not possible. Use backing() to know which one has been used.
+  // Reallocations done later by Resize or Reserve use the allocator of the
+  // thread.
+  //
+  // il::Array4D<double> A{n0, n1, n2, n3, il::hugepage};
+  */
+  explicit Array4D(il::int_t n0, il::int_t n1, il::int_t n2, il::int_t n3,
+                   il::hugepage_t);
+
+  explicit Array4D(il::int_t n0, il::int_t n1, il::int_t n2, il::int_t n3,
+                   const T& x, il::hugepage_t);
+
   /* \brief The copy constructor
   // \details The different size and capacity of the constructed il::Array4D<T>
   // are equal to the size of the source array.
@@ -154,6 +183,13 @@ class Array4D {
   */
   void Resize(il::int_t n0, il::int_t n1, il::int_t n2, il::int_t n3);
 
+  /* \brief Resizing an il::Array4D<T> without initializing the new elements
+  // \details When T is trivial, the new elements are left uninitialized, even
+  // in debug mode. Otherwise, they are default constructed.
+  */
+  void Resize(il::int_t n0, il::int_t n1, il::int_t n2, il::int_t n3,
+              il::uninitialized_t);
+
   /* \brief Get the capacity of the il::Array4D<T>
   // \details capacity(0) gives the capacity in terms of rows and capacity(1)
   // gives the capacity in terms of columns and capacity(2) gives the capacity
@@ -169,6 +205,20 @@ class Array4D {
   */
   void Reserve(il::int_t r0, il::int_t r1, il::int_t r2, il::int_t r3);
 
+  /* \brief Get a strided view on the array
+  // \details The view can be sliced, transposed or restricted to its diagonal
+  // without copying the elements. See il::StridedArrayView.
+  */
+  il::StridedArrayView<T, 4> view() const;
+
+  il::StridedArrayView<T, 4> view(il::Range range0, il::Range range1,
+                                  il::Range range2, il::Range range3) const;
+
+  il::StridedArrayEdit<T, 4> Edit();
+
+  il::StridedArrayEdit<T, 4> Edit(il::Range range0, il::Range range1,
+                                  il::Range range2, il::Range range3);
+
   /* \brief Get a pointer to const to the first element of the array
   // \details One should use this method only when using C-style API
   */
@@ -184,7 +234,24 @@ class Array4D {
   */
   //  il::int_t stride(il::int_t d) const;
 
+  /* \brief Get the memory backing the array
+   */
+  il::Backing backing() const;
+
  private:
+  Array4D(il::int_t n0, il::int_t n1, il::int_t n2, il::int_t n3,
+          const il::AllocatorScope&);
+
+  Array4D(il::int_t n0, il::int_t n1, il::int_t n2, il::int_t n3, const T& x,
+          const il::AllocatorScope&);
+
+  /* \brief Used internally by Resize
+  // \details The new elements are initialized, as in Resize(n0, n1, n2, n3),
+  // unless initialize is false and T is trivial
+  */
+  void SetSize(il::int_t n0, il::int_t n1, il::int_t n2, il::int_t n3,
+               bool initialize);
+
   /* \brief Used internally in debug mode to check the invariance of the object
    */
   bool invariance() const;
@@ -311,6 +378,35 @@ Array4D<T>::Array4D(il::int_t n0, il::int_t n1, il::int_t n2, il::int_t n3,
   shift_ = 0;
 }
 
+template <typename T>
+Array4D<T>::Array4D(il::int_t n0, il::int_t n1, il::int_t n2, il::int_t n3,
+                    il::hugepage_t)
+    : Array4D{n0, n1, n2, n3, il::AllocatorScope{il::hugePageAllocator()}} {}
+
+template <typename T>
+Array4D<T>::Array4D(il::int_t n0, il::int_t n1, il::int_t n2, il::int_t n3,
+                    const T& x, il::hugepage_t)
+    : Array4D{n0, n1, n2, n3, x, il::AllocatorScope{il::hugePageAllocator()}} {}
+
+// The scope is a temporary of the delegating constructor, which keeps the huge
+// page allocator in place while the array is allocated
+template <typename T>
+Array4D<T>::Array4D(il::int_t n0, il::int_t n1, il::int_t n2, il::int_t n3,
+                    const il::AllocatorScope&)
+    : Array4D{n0, n1, n2, n3} {}
+
+template <typename T>
+Array4D<T>::Array4D(il::int_t n0, il::int_t n1, il::int_t n2, il::int_t n3,
+                    const T& x, const il::AllocatorScope&)
+    : Array4D{n0, n1, n2, n3, x} {}
+
+template <typename T>
+Array4D<T>::Array4D(il::int_t n0, il::int_t n1, il::int_t n2, il::int_t n3,
+                    il::uninitialized_t)
+    : Array4D{} {
+  SetSize(n0, n1, n2, n3, false);
+}
+
 template <typename T>
 Array4D<T>::Array4D(const Array4D<T>& A) {
   const il::int_t n0 = A.size(0);
@@ -703,6 +799,18 @@ il::int_t Array4D<T>::size(il::int_t d) const {
 template <typename T>
 void Array4D<T>::Resize(il::int_t n0, il::int_t n1, il::int_t n2,
                         il::int_t n3) {
+  SetSize(n0, n1, n2, n3, true);
+}
+
+template <typename T>
+void Array4D<T>::Resize(il::int_t n0, il::int_t n1, il::int_t n2, il::int_t n3,
+                        il::uninitialized_t) {
+  SetSize(n0, n1, n2, n3, false);
+}
+
+template <typename T>
+void Array4D<T>::SetSize(il::int_t n0, il::int_t n1, il::int_t n2,
+                         il::int_t n3, bool initialize) {
   IL_EXPECT_FAST(n0 >= 0);
   IL_EXPECT_FAST(n1 >= 0);
   IL_EXPECT_FAST(n2 >= 0);
@@ -769,14 +877,16 @@ void Array4D<T>::Resize(il::int_t n0, il::int_t n1, il::int_t n2,
         il::deallocate(data_ - shift_);
       }
 #ifdef IL_DEFAULT_VALUE
-      for (il::int_t i3 = 0; i3 < n3; ++i3) {
-        for (il::int_t i2 = 0; i2 < n2; ++i2) {
-          for (il::int_t i1 = 0; i1 < n1; ++i1) {
-            for (il::int_t i0 =
-                     (i3 < n3_old && i2 < n2_old && i1 < n1_old) ? n0_old : 0;
-                 i0 < n0; ++i0) {
-              new_data[((i3 * r2 + i2) * r1 + i1) * r0 + i0] =
-                  il::defaultValue<T>();
+      if (initialize) {
+        for (il::int_t i3 = 0; i3 < n3; ++i3) {
+          for (il::int_t i2 = 0; i2 < n2; ++i2) {
+            for (il::int_t i1 = 0; i1 < n1; ++i1) {
+              for (il::int_t i0 =
+                       (i3 < n3_old && i2 < n2_old && i1 < n1_old) ? n0_old : 0;
+                   i0 < n0; ++i0) {
+                new_data[((i3 * r2 + i2) * r1 + i1) * r0 + i0] =
+                    il::defaultValue<T>();
+              }
             }
           }
         }
@@ -820,13 +930,15 @@ void Array4D<T>::Resize(il::int_t n0, il::int_t n1, il::int_t n2,
         }
         il::deallocate(data_);
       }
-      for (il::int_t i3 = 0; i3 < n3; ++i3) {
-        for (il::int_t i2 = 0; i2 < n2; ++i2) {
-          for (il::int_t i1 = 0; i1 < n1; ++i1) {
-            for (il::int_t i0 =
-                     (i3 < n3_old && i2 < n2_old && i1 < n1_old) ? n0_old : 0;
-                 i0 < n0; ++i0) {
-              new (new_data + ((i3 * r2 + i2) * r1 + i1) * r0 + i0) T{};
+      if (initialize || !std::is_trivial<T>::value) {
+        for (il::int_t i3 = 0; i3 < n3; ++i3) {
+          for (il::int_t i2 = 0; i2 < n2; ++i2) {
+            for (il::int_t i1 = 0; i1 < n1; ++i1) {
+              for (il::int_t i0 =
+                       (i3 < n3_old && i2 < n2_old && i1 < n1_old) ? n0_old : 0;
+                   i0 < n0; ++i0) {
+                new (new_data + ((i3 * r2 + i2) * r1 + i1) * r0 + i0) T{};
+              }
             }
           }
         }
@@ -841,14 +953,17 @@ void Array4D<T>::Resize(il::int_t n0, il::int_t n1, il::int_t n2,
   } else {
     if (il::isTrivial<T>::value) {
 #ifdef IL_DEFAULT_VALUE
-      for (il::int_t i3 = 0; i3 < n3; ++i3) {
-        for (il::int_t i2 = 0; i2 < n2; ++i2) {
-          for (il::int_t i1 = 0; i1 < n1; ++i1) {
-            for (il::int_t i0 =
-                     (i3 < n3_old && i2 < n2_old && i1 < n1_old) ? n0_old : 0;
-                 i0 < n0; ++i0) {
-              data_[((i3 * capacity(2) + i2) * capacity(1) + i1) * capacity(0) +
-                    i0] = il::defaultValue<T>();
+      if (initialize) {
+        for (il::int_t i3 = 0; i3 < n3; ++i3) {
+          for (il::int_t i2 = 0; i2 < n2; ++i2) {
+            for (il::int_t i1 = 0; i1 < n1; ++i1) {
+              for (il::int_t i0 =
+                       (i3 < n3_old && i2 < n2_old && i1 < n1_old) ? n0_old : 0;
+                   i0 < n0; ++i0) {
+                data_[((i3 * capacity(2) + i2) * capacity(1) + i1) *
+                          capacity(0) +
+                      i0] = il::defaultValue<T>();
+              }
             }
           }
         }
@@ -868,15 +983,17 @@ void Array4D<T>::Resize(il::int_t n0, il::int_t n1, il::int_t n2,
         }
       }
     }
-    for (il::int_t i3 = 0; i3 < n3; ++i3) {
-      for (il::int_t i2 = 0; i2 < n2; ++i2) {
-        for (il::int_t i1 = 0; i1 < n1; ++i1) {
-          for (il::int_t i0 =
-                   (i3 < n3_old && i2 < n2_old && i1 < n1_old) ? n0_old : 0;
-               i0 < n0; ++i0) {
-            new (data_ +
-                 ((i3 * capacity(2) + i2) * capacity(1) + i1) * capacity(0) +
-                 i0) T{};
+    if (initialize || !std::is_trivial<T>::value) {
+      for (il::int_t i3 = 0; i3 < n3; ++i3) {
+        for (il::int_t i2 = 0; i2 < n2; ++i2) {
+          for (il::int_t i1 = 0; i1 < n1; ++i1) {
+            for (il::int_t i0 =
+                     (i3 < n3_old && i2 < n2_old && i1 < n1_old) ? n0_old : 0;
+                 i0 < n0; ++i0) {
+              new (data_ +
+                   ((i3 * capacity(2) + i2) * capacity(1) + i1) * capacity(0) +
+                   i0) T{};
+            }
           }
         }
       }
@@ -984,6 +1101,38 @@ void Array4D<T>::Reserve(il::int_t r0, il::int_t r1, il::int_t r2,
   }
 }
 
+template <typename T>
+il::StridedArrayView<T, 4> Array4D<T>::view() const {
+  const il::int_t sizes[4] = {size(0), size(1), size(2), size(3)};
+  const il::int_t strides[4] = {1, capacity(0), capacity(0) * capacity(1),
+                                capacity(0) * capacity(1) * capacity(2)};
+  return il::StridedArrayView<T, 4>{data_, sizes, strides};
+}
+
+template <typename T>
+il::StridedArrayView<T, 4> Array4D<T>::view(il::Range range0,
+                                            il::Range range1,
+                                            il::Range range2,
+                                            il::Range range3) const {
+  return view().view(range0, range1, range2, range3);
+}
+
+template <typename T>
+il::StridedArrayEdit<T, 4> Array4D<T>::Edit() {
+  const il::int_t sizes[4] = {size(0), size(1), size(2), size(3)};
+  const il::int_t strides[4] = {1, capacity(0), capacity(0) * capacity(1),
+                                capacity(0) * capacity(1) * capacity(2)};
+  return il::StridedArrayEdit<T, 4>{data_, sizes, strides};
+}
+
+template <typename T>
+il::StridedArrayEdit<T, 4> Array4D<T>::Edit(il::Range range0,
+                                            il::Range range1,
+                                            il::Range range2,
+                                            il::Range range3) {
+  return Edit().Edit(range0, range1, range2, range3);
+}
+
 template <typename T>
 const T* Array4D<T>::data() const {
   return data_;
@@ -994,6 +1143,11 @@ T* Array4D<T>::Data() {
   return data_;
 }
 
+template <typename T>
+il::Backing Array4D<T>::backing() const {
+  return data_ ? il::backing(data_ - shift_) : il::Backing::Heap;
+}
+
 template <typename T>
 bool Array4D<T>::invariance() const {
   bool ans = true;
@@ -0,0 +1,119 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#include <gtest/gtest.h>
+
+#include <il/Array.h>
+#include <il/Array4D.h>
+
+TEST(Array4D, hugepage_constructor_0) {
+  il::Array4D<double> A{2, 3, 4, 5, 0.0, il::hugepage};
+
+  ASSERT_TRUE(A.size(0) == 2 && A.size(1) == 3 && A.size(2) == 4 &&
+              A.size(3) == 5 && A(1, 2, 3, 4) == 0.0 &&
+              A.backing() == il::Backing::Heap);
+}
+
+TEST(Array4D, hugepage_constructor_1) {
+  const il::int_t n = 32;
+  il::Array4D<double> A{n, n, n, n, 1.0, il::hugepage};
+
+#ifdef IL_HUGEPAGE
+  const bool huge_page = A.backing() == il::Backing::HugePage &&
+                         reinterpret_cast<std::size_t>(A.data()) %
+                                 il::HugePageAllocator::huge_page_size ==
+                             il::allocationHeaderSize();
+#else
+  const bool huge_page = A.backing() == il::Backing::Heap;
+#endif
+  ASSERT_TRUE(huge_page && A(n - 1, n - 1, n - 1, n - 1) == 1.0);
+}
+
+TEST(Array4D, hugepage_constructor_2) {
+  const il::int_t n = 32;
+  il::Array4D<double> A{n, n, n, n, il::hugepage};
+  A(n - 1, n - 1, n - 1, n - 1) = 2.0;
+
+#ifdef IL_HUGEPAGE
+  const bool huge_page = A.backing() == il::Backing::HugePage;
+#else
+  const bool huge_page = A.backing() == il::Backing::Heap;
+#endif
+  ASSERT_TRUE(huge_page && A.size(3) == n &&
+              A(n - 1, n - 1, n - 1, n - 1) == 2.0);
+}
+
+TEST(Array4D, backing_default) {
+  il::Array4D<double> A{};
+  il::Array4D<double> B{2, 2, 2, 2};
+
+  ASSERT_TRUE(A.backing() == il::Backing::Heap &&
+              B.backing() == il::Backing::Heap);
+}
+
+TEST(Array4D, uninitialized_constructor) {
+  il::Array4D<double> A{2, 3, 4, 5, il::uninitialized};
+  for (il::int_t i3 = 0; i3 < 5; ++i3) {
+    for (il::int_t i2 = 0; i2 < 4; ++i2) {
+      for (il::int_t i1 = 0; i1 < 3; ++i1) {
+        for (il::int_t i0 = 0; i0 < 2; ++i0) {
+          A(i0, i1, i2, i3) = static_cast<double>(i0 + i1 + i2 + i3);
+        }
+      }
+    }
+  }
+
+  ASSERT_TRUE(A.size(0) == 2 && A.size(1) == 3 && A.size(2) == 4 &&
+              A.size(3) == 5 && A(1, 2, 3, 4) == 10.0);
+}
+
+TEST(Array4D, uninitialized_constructor_object) {
+  il::Array4D<il::Array<double>> A{2, 2, 2, 2, il::uninitialized};
+
+  ASSERT_TRUE(A.size(3) == 2 && A(0, 0, 0, 0).size() == 0 &&
+              A(1, 1, 1, 1).size() == 0);
+}
+
+TEST(Array4D, resize_uninitialized) {
+  il::Array4D<il::int_t> A{2, 2, 2, 2};
+  for (il::int_t i3 = 0; i3 < 2; ++i3) {
+    for (il::int_t i2 = 0; i2 < 2; ++i2) {
+      for (il::int_t i1 = 0; i1 < 2; ++i1) {
+        for (il::int_t i0 = 0; i0 < 2; ++i0) {
+          A(i0, i1, i2, i3) = i0 + 2 * i1 + 4 * i2 + 8 * i3;
+        }
+      }
+    }
+  }
+  A.Resize(3, 3, 4, 5, il::uninitialized);
+
+  bool correct = A.size(0) == 3 && A.size(1) == 3 && A.size(2) == 4 &&
+                 A.size(3) == 5;
+  for (il::int_t i3 = 0; i3 < 2; ++i3) {
+    for (il::int_t i2 = 0; i2 < 2; ++i2) {
+      for (il::int_t i1 = 0; i1 < 2; ++i1) {
+        for (il::int_t i0 = 0; i0 < 2; ++i0) {
+          correct =
+              correct && A(i0, i1, i2, i3) == i0 + 2 * i1 + 4 * i2 + 8 * i3;
+        }
+      }
+    }
+  }
+
+  ASSERT_TRUE(correct);
+}
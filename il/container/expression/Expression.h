@@ -0,0 +1,307 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#ifndef IL_EXPRESSION_H
+#define IL_EXPRESSION_H
+
+// <cmath> is needed for std::sqrt, std::exp, std::log, std::sin, std::cos
+#include <cmath>
+// <utility> is needed for std::declval
+#include <utility>
+
+#include <il/core.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Expression templates
+////////////////////////////////////////////////////////////////////////////////
+//
+// An arithmetic expression on arrays is not evaluated where it is written. It
+// builds a small object that records the operations and the arrays involved,
+// and the whole expression is evaluated element by element when it is
+// assigned to an array:
+//
+// il::Array<double> z{n};
+// z = a * x + b * y + c;
+//
+// This is one loop that reads x and y and writes z once, without any
+// temporary array, and that the compiler can vectorize. The expression only
+// keeps pointers to the arrays: it must be assigned in the statement where it
+// is built. The operators are defined in <il/expression.h>.
+//
+// An element of the result only depends on the elements of the operands with
+// the same indices. When the size of the destination does not change, the
+// result is written in place while the operands are read: an operand may be
+// the destination itself, so z = z + x is fine, but it must not be a view
+// that overlaps the destination with shifted indices, such as a view of z
+// starting at z[1]. Mixing arrays of different ranks or sizes is an error.
+
+namespace il {
+
+/* \brief Base class of all the expressions
+// \details An expression E gives its rank with E::rank, the type of its
+// elements with E::value_type, its sizes with size(d), and its elements with
+// operator[] for rank 1 and operator() for rank 2. A scalar has rank 0.
+*/
+template <typename E>
+class Expression {
+ public:
+  const E& derived() const { return static_cast<const E&>(*this); }
+};
+
+template <typename T>
+class ScalarExpression : public il::Expression<il::ScalarExpression<T>> {
+ private:
+  T value_;
+
+ public:
+  static const int rank = 0;
+  using value_type = T;
+
+  explicit ScalarExpression(const T& value) : value_(value) {}
+  il::int_t size(il::int_t d) const {
+    IL_UNUSED(d);
+    return 0;
+  }
+  T operator[](il::int_t i) const {
+    IL_UNUSED(i);
+    return value_;
+  }
+  T operator()(il::int_t i0, il::int_t i1) const {
+    IL_UNUSED(i0);
+    IL_UNUSED(i1);
+    return value_;
+  }
+};
+
+template <typename T>
+class ArrayExpression : public il::Expression<il::ArrayExpression<T>> {
+ private:
+  const T* data_;
+  il::int_t size_;
+
+ public:
+  static const int rank = 1;
+  using value_type = T;
+
+  ArrayExpression(const T* data, il::int_t n) : data_(data), size_(n) {}
+  il::int_t size(il::int_t d) const {
+    IL_EXPECT_MEDIUM(d == 0);
+    IL_UNUSED(d);
+    return size_;
+  }
+  const T& operator[](il::int_t i) const {
+    IL_EXPECT_MEDIUM(static_cast<std::size_t>(i) <
+                     static_cast<std::size_t>(size_));
+    return data_[i];
+  }
+};
+
+template <typename T>
+class Array2DExpression : public il::Expression<il::Array2DExpression<T>> {
+ private:
+  const T* data_;
+  il::int_t size_[2];
+  il::int_t stride_;
+
+ public:
+  static const int rank = 2;
+  using value_type = T;
+
+  Array2DExpression(const T* data, il::int_t n0, il::int_t n1,
+                    il::int_t stride)
+      : data_(data), size_{n0, n1}, stride_(stride) {}
+  il::int_t size(il::int_t d) const {
+    IL_EXPECT_MEDIUM(static_cast<std::size_t>(d) <
+                     static_cast<std::size_t>(2));
+    return size_[d];
+  }
+  const T& operator()(il::int_t i0, il::int_t i1) const {
+    IL_EXPECT_MEDIUM(static_cast<std::size_t>(i0) <
+                     static_cast<std::size_t>(size_[0]));
+    IL_EXPECT_MEDIUM(static_cast<std::size_t>(i1) <
+                     static_cast<std::size_t>(size_[1]));
+    return data_[i1 * stride_ + i0];
+  }
+};
+
+template <typename Op, typename E>
+class UnaryExpression : public il::Expression<il::UnaryExpression<Op, E>> {
+ private:
+  E e_;
+
+ public:
+  static const int rank = E::rank;
+  using value_type =
+      decltype(Op::apply(std::declval<typename E::value_type>()));
+
+  explicit UnaryExpression(const E& e) : e_(e) {}
+  il::int_t size(il::int_t d) const { return e_.size(d); }
+  value_type operator[](il::int_t i) const { return Op::apply(e_[i]); }
+  value_type operator()(il::int_t i0, il::int_t i1) const {
+    return Op::apply(e_(i0, i1));
+  }
+};
+
+template <typename Op, typename L, typename R>
+class BinaryExpression
+    : public il::Expression<il::BinaryExpression<Op, L, R>> {
+ private:
+  L l_;
+  R r_;
+
+ public:
+  static_assert(L::rank == 0 || R::rank == 0 || L::rank == R::rank,
+                "il::BinaryExpression: operands must have the same rank");
+  static const int rank = L::rank > R::rank ? L::rank : R::rank;
+  using value_type =
+      decltype(Op::apply(std::declval<typename L::value_type>(),
+                         std::declval<typename R::value_type>()));
+
+  BinaryExpression(const L& l, const R& r) : l_(l), r_(r) {
+    for (il::int_t d = 0; d < (L::rank == R::rank ? rank : 0); ++d) {
+      IL_EXPECT_FAST(l_.size(d) == r_.size(d));
+    }
+  }
+  il::int_t size(il::int_t d) const {
+    return L::rank > 0 ? l_.size(d) : r_.size(d);
+  }
+  value_type operator[](il::int_t i) const { return Op::apply(l_[i], r_[i]); }
+  value_type operator()(il::int_t i0, il::int_t i1) const {
+    return Op::apply(l_(i0, i1), r_(i0, i1));
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Operations
+////////////////////////////////////////////////////////////////////////////////
+
+struct PlusOperation {
+  template <typename A, typename B>
+  static auto apply(const A& a, const B& b) -> decltype(a + b) {
+    return a + b;
+  }
+};
+
+struct MinusOperation {
+  template <typename A, typename B>
+  static auto apply(const A& a, const B& b) -> decltype(a - b) {
+    return a - b;
+  }
+};
+
+struct TimesOperation {
+  template <typename A, typename B>
+  static auto apply(const A& a, const B& b) -> decltype(a * b) {
+    return a * b;
+  }
+};
+
+struct DivideOperation {
+  template <typename A, typename B>
+  static auto apply(const A& a, const B& b) -> decltype(a / b) {
+    return a / b;
+  }
+};
+
+struct NegateOperation {
+  template <typename A>
+  static auto apply(const A& a) -> decltype(-a) {
+    return -a;
+  }
+};
+
+struct SqrtOperation {
+  template <typename A>
+  static auto apply(const A& a) -> decltype(std::sqrt(a)) {
+    return std::sqrt(a);
+  }
+};
+
+struct ExpOperation {
+  template <typename A>
+  static auto apply(const A& a) -> decltype(std::exp(a)) {
+    return std::exp(a);
+  }
+};
+
+struct LogOperation {
+  template <typename A>
+  static auto apply(const A& a) -> decltype(std::log(a)) {
+    return std::log(a);
+  }
+};
+
+struct SinOperation {
+  template <typename A>
+  static auto apply(const A& a) -> decltype(std::sin(a)) {
+    return std::sin(a);
+  }
+};
+
+struct CosOperation {
+  template <typename A>
+  static auto apply(const A& a) -> decltype(std::cos(a)) {
+    return std::cos(a);
+  }
+};
+
+struct AbsOperation {
+  template <typename A>
+  static auto apply(const A& a) -> decltype(std::abs(a)) {
+    return std::abs(a);
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Evaluation
+////////////////////////////////////////////////////////////////////////////////
+
+// The loops only read the expression and write the destination. The compiler
+// vectorizes them, and checks at runtime that the destination does not overlap
+// the operands.
+
+template <typename E, typename T>
+void evaluate(const il::Expression<E>& expression, il::int_t n, il::io_t,
+              T* data) {
+  static_assert(E::rank == 1, "il::evaluate: expression must be of rank 1");
+  const E& e = expression.derived();
+  IL_EXPECT_FAST(e.size(0) == n);
+
+  for (il::int_t i = 0; i < n; ++i) {
+    data[i] = e[i];
+  }
+}
+
+template <typename E, typename T>
+void evaluate(const il::Expression<E>& expression, il::int_t n0, il::int_t n1,
+              il::int_t stride, il::io_t, T* data) {
+  static_assert(E::rank == 2, "il::evaluate: expression must be of rank 2");
+  const E& e = expression.derived();
+  IL_EXPECT_FAST(e.size(0) == n0);
+  IL_EXPECT_FAST(e.size(1) == n1);
+
+  for (il::int_t i1 = 0; i1 < n1; ++i1) {
+    for (il::int_t i0 = 0; i0 < n0; ++i0) {
+      data[i1 * stride + i0] = e(i0, i1);
+    }
+  }
+}
+
+}  // namespace il
+
+#endif  // IL_EXPRESSION_H
@@ -0,0 +1,130 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#include <gtest/gtest.h>
+
+#include <il/expression.h>
+
+TEST(expression, axpby) {
+  il::Array<double> x{3};
+  il::Array<double> y{3};
+  for (il::int_t i = 0; i < 3; ++i) {
+    x[i] = static_cast<double>(i);
+    y[i] = static_cast<double>(10 * i);
+  }
+  il::Array<double> z{};
+  z = 2.0 * x + y / 10.0 - 1.0;
+
+  ASSERT_TRUE(z.size() == 3 && z[0] == -1.0 && z[1] == 2.0 && z[2] == 5.0);
+}
+
+TEST(expression, aliasing) {
+  il::Array<double> x{3, 1.0};
+  il::Array<double> y{3, 2.0};
+  x = x + 3.0 * y;
+
+  ASSERT_TRUE(x.size() == 3 && x[0] == 7.0 && x[1] == 7.0 && x[2] == 7.0);
+}
+
+TEST(expression, resize) {
+  il::Array<double> x{3, 4.0};
+  il::Array<double> z{5, 0.0};
+  z = -x;
+
+  ASSERT_TRUE(z.size() == 3 && z[0] == -4.0 && z[1] == -4.0 && z[2] == -4.0);
+}
+
+TEST(expression, resize_alignment) {
+  il::Array<double> x{7, 4.0};
+  il::Array<double> z{3, 0.0, il::align, 64};
+  z = -x;
+
+  ASSERT_TRUE(z.size() == 7 && z.alignment() == 64 &&
+              reinterpret_cast<std::size_t>(z.data()) % 64 == 0 &&
+              z[0] == -4.0 && z[6] == -4.0);
+}
+
+TEST(expression, function) {
+  il::Array<double> x{2};
+  x[0] = 4.0;
+  x[1] = -9.0;
+  il::Array<double> z{2};
+  z = il::sqrt(il::abs(x)) + il::exp(0.0 * x);
+
+  ASSERT_TRUE(z[0] == 3.0 && z[1] == 4.0);
+}
+
+TEST(expression, view) {
+  il::Array<double> x{4, 1.0};
+  il::Array<double> z{4, 0.0};
+  il::ArrayEdit<double> z_edit = z.Edit(il::Range{1, 3});
+  z_edit = x.view(il::Range{0, 2}) * 2.0;
+
+  ASSERT_TRUE(z[0] == 0.0 && z[1] == 2.0 && z[2] == 2.0 && z[3] == 0.0);
+}
+
+TEST(expression, array2d) {
+  il::Array2D<double> A{2, 3};
+  for (il::int_t i1 = 0; i1 < 3; ++i1) {
+    for (il::int_t i0 = 0; i0 < 2; ++i0) {
+      A(i0, i1) = static_cast<double>(i0 + 2 * i1);
+    }
+  }
+  il::Array2D<double> B{2, 3, 1.0};
+  il::Array2D<double> C{};
+  C = 2.0 * A - B;
+
+  bool correct = C.size(0) == 2 && C.size(1) == 3;
+  for (il::int_t i1 = 0; i1 < 3; ++i1) {
+    for (il::int_t i0 = 0; i0 < 2; ++i0) {
+      if (C(i0, i1) != 2.0 * (i0 + 2 * i1) - 1.0) {
+        correct = false;
+      }
+    }
+  }
+  ASSERT_TRUE(correct);
+}
+
+TEST(expression, array2d_view) {
+  il::Array2D<double> A{4, 4, 1.0};
+  il::Array2D<double> B{4, 4, 0.0};
+  il::Array2DEdit<double> B_edit = B.Edit(il::Range{1, 3}, il::Range{1, 3});
+  B_edit = A.view(il::Range{0, 2}, il::Range{0, 2}) + 1.0;
+
+  bool correct = true;
+  for (il::int_t i1 = 0; i1 < 4; ++i1) {
+    for (il::int_t i0 = 0; i0 < 4; ++i0) {
+      const bool inside = i0 >= 1 && i0 < 3 && i1 >= 1 && i1 < 3;
+      if (B(i0, i1) != (inside ? 2.0 : 0.0)) {
+        correct = false;
+      }
+    }
+  }
+  ASSERT_TRUE(correct);
+}
+
+TEST(expression, array2d_resize_alignment) {
+  il::Array2D<double> A{5, 3, 1.0};
+  il::Array2D<double> C{2, 2, 0.0, il::align, 32};
+  C = A + 1.0;
+
+  ASSERT_TRUE(C.size(0) == 5 && C.size(1) == 3 && C.capacity(0) == 8 &&
+              C.alignment() == 32 &&
+              reinterpret_cast<std::size_t>(C.data()) % 32 == 0 &&
+              C(0, 0) == 2.0 && C(4, 2) == 2.0);
+}
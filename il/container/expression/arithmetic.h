@@ -0,0 +1,191 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#ifndef IL_ARITHMETIC_H
+#define IL_ARITHMETIC_H
+
+// <type_traits> is needed for std::enable_if, std::is_arithmetic and
+// std::is_base_of
+#include <type_traits>
+
+#include <il/container/1d/Array.h>
+#include <il/container/1d/ArrayView.h>
+#include <il/container/2d/Array2D.h>
+#include <il/container/2d/Array2DView.h>
+#include <il/container/expression/Expression.h>
+
+namespace il {
+
+// il::ExpressionOf<X>::type is the expression used for an operand of type X
+// and il::ExpressionOf<X>::convert builds it. There is no type for the
+// operands that cannot be part of an expression, so that the operators below
+// do not exist for them.
+
+template <typename X, typename Enable = void>
+struct ExpressionOf {};
+
+template <typename X>
+struct ExpressionOf<X, typename std::enable_if<std::is_base_of<
+                           il::Expression<X>, X>::value>::type> {
+  using type = X;
+  static const X& convert(const X& x) { return x; }
+};
+
+template <typename X>
+struct ExpressionOf<
+    X, typename std::enable_if<std::is_arithmetic<X>::value>::type> {
+  using type = il::ScalarExpression<X>;
+  static type convert(const X& x) { return type{x}; }
+};
+
+template <typename T>
+struct ExpressionOf<il::Array<T>> {
+  using type = il::ArrayExpression<T>;
+  static type convert(const il::Array<T>& v) {
+    return type{v.data(), v.size()};
+  }
+};
+
+template <typename T>
+struct ExpressionOf<il::ArrayView<T>> {
+  using type = il::ArrayExpression<T>;
+  static type convert(const il::ArrayView<T>& v) {
+    return type{v.data(), v.size()};
+  }
+};
+
+template <typename T>
+struct ExpressionOf<il::ArrayEdit<T>> : il::ExpressionOf<il::ArrayView<T>> {};
+
+template <typename T>
+struct ExpressionOf<il::Array2D<T>> {
+  using type = il::Array2DExpression<T>;
+  static type convert(const il::Array2D<T>& A) {
+    return type{A.data(), A.size(0), A.size(1), A.stride(1)};
+  }
+};
+
+template <typename T>
+struct ExpressionOf<il::Array2DView<T>> {
+  using type = il::Array2DExpression<T>;
+  static type convert(const il::Array2DView<T>& A) {
+    return type{A.data(), A.size(0), A.size(1), A.stride(1)};
+  }
+};
+
+template <typename T>
+struct ExpressionOf<il::Array2DEdit<T>>
+    : il::ExpressionOf<il::Array2DView<T>> {};
+
+// At least one of the operands must be an array or an expression, so that
+// il::BinaryExpressionOf does not catch operations on scalars.
+
+template <typename Op, typename L, typename R, typename Enable = void>
+struct BinaryExpressionOf {};
+
+template <typename Op, typename L, typename R>
+struct BinaryExpressionOf<
+    Op, L, R,
+    typename std::enable_if<(il::ExpressionOf<L>::type::rank +
+                             il::ExpressionOf<R>::type::rank > 0)>::type> {
+  using type = il::BinaryExpression<Op, typename il::ExpressionOf<L>::type,
+                                    typename il::ExpressionOf<R>::type>;
+  static type make(const L& l, const R& r) {
+    return type{il::ExpressionOf<L>::convert(l),
+                il::ExpressionOf<R>::convert(r)};
+  }
+};
+
+template <typename Op, typename X, typename Enable = void>
+struct UnaryExpressionOf {};
+
+template <typename Op, typename X>
+struct UnaryExpressionOf<
+    Op, X,
+    typename std::enable_if<(il::ExpressionOf<X>::type::rank > 0)>::type> {
+  using type = il::UnaryExpression<Op, typename il::ExpressionOf<X>::type>;
+  static type make(const X& x) { return type{il::ExpressionOf<X>::convert(x)}; }
+};
+
+template <typename L, typename R>
+typename il::BinaryExpressionOf<il::PlusOperation, L, R>::type operator+(
+    const L& l, const R& r) {
+  return il::BinaryExpressionOf<il::PlusOperation, L, R>::make(l, r);
+}
+
+template <typename L, typename R>
+typename il::BinaryExpressionOf<il::MinusOperation, L, R>::type operator-(
+    const L& l, const R& r) {
+  return il::BinaryExpressionOf<il::MinusOperation, L, R>::make(l, r);
+}
+
+template <typename L, typename R>
+typename il::BinaryExpressionOf<il::TimesOperation, L, R>::type operator*(
+    const L& l, const R& r) {
+  return il::BinaryExpressionOf<il::TimesOperation, L, R>::make(l, r);
+}
+
+template <typename L, typename R>
+typename il::BinaryExpressionOf<il::DivideOperation, L, R>::type operator/(
+    const L& l, const R& r) {
+  return il::BinaryExpressionOf<il::DivideOperation, L, R>::make(l, r);
+}
+
+template <typename X>
+typename il::UnaryExpressionOf<il::NegateOperation, X>::type operator-(
+    const X& x) {
+  return il::UnaryExpressionOf<il::NegateOperation, X>::make(x);
+}
+
+// The element-wise functions are in the il namespace as the std ones cannot be
+// overloaded. On scalars, they are not defined, except il::abs that is in
+// <il/math.h>.
+
+template <typename X>
+typename il::UnaryExpressionOf<il::SqrtOperation, X>::type sqrt(const X& x) {
+  return il::UnaryExpressionOf<il::SqrtOperation, X>::make(x);
+}
+
+template <typename X>
+typename il::UnaryExpressionOf<il::ExpOperation, X>::type exp(const X& x) {
+  return il::UnaryExpressionOf<il::ExpOperation, X>::make(x);
+}
+
+template <typename X>
+typename il::UnaryExpressionOf<il::LogOperation, X>::type log(const X& x) {
+  return il::UnaryExpressionOf<il::LogOperation, X>::make(x);
+}
+
+template <typename X>
+typename il::UnaryExpressionOf<il::SinOperation, X>::type sin(const X& x) {
+  return il::UnaryExpressionOf<il::SinOperation, X>::make(x);
+}
+
+template <typename X>
+typename il::UnaryExpressionOf<il::CosOperation, X>::type cos(const X& x) {
+  return il::UnaryExpressionOf<il::CosOperation, X>::make(x);
+}
+
+template <typename X>
+typename il::UnaryExpressionOf<il::AbsOperation, X>::type abs(const X& x) {
+  return il::UnaryExpressionOf<il::AbsOperation, X>::make(x);
+}
+
+}  // namespace il
+
+#endif  // IL_ARITHMETIC_H
@@ -0,0 +1,354 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#ifndef IL_CONCURRENTMAP_H
+#define IL_CONCURRENTMAP_H
+
+// <cstdint> is needed for std::uint64_t
+#include <cstdint>
+// <memory> is needed for std::unique_ptr
+#include <memory>
+// <mutex> is needed for std::mutex
+#include <mutex>
+
+#include <il/Array.h>
+#include <il/Array2D.h>
+#include <il/container/hash/HashFunction.h>
+#include <il/container/hash/SwissMap.h>
+#include <il/core/thread/parallel.h>
+
+namespace il {
+
+// il::ConcurrentMap is a hash map whose member functions can be called from
+// many threads at the same time. It is split into 256 shards, each of them
+// being an il::SwissMap protected by its own lock. The hash of a key is mixed
+// with il::hashFold, then its 8 high bits give the shard and the shard uses
+// its low bits. Any il::HashFunction can therefore be used, whether it returns
+// the high bits or the low bits of a hash. As the shards grow one at a time,
+// there is never a global pause to resize the whole map.
+//
+// As the map can change at any time, the functions do not return il::spot_t
+// or references to the values: the values are copied.
+//
+// il::ConcurrentMap<il::String, il::int_t> map{};
+// il::parallelFor(0, n, 1, [&](il::int_t i_begin, il::int_t i_end) {
+//   for (il::int_t i = i_begin; i < i_end; ++i) {
+//     map.Set(name[i], i);
+//   }
+// });
+
+template <typename K, typename V, typename F = HashFunction<K>>
+class ConcurrentMap {
+ private:
+  static const int nb_shards_log2_ = 8;
+  static const il::int_t nb_shards_ = il::int_t{1} << nb_shards_log2_;
+  // The number of bits asked to F, which is the most the shards can use
+  static const int nb_hash_bits_ = 64 - nb_shards_log2_;
+
+  template <typename T>
+  static std::uint64_t mixedHash(const T& key, std::size_t seed) {
+    const std::uint64_t h = il::hashSeeded<F>(key, nb_hash_bits_, seed);
+    return il::hashFold(h, 0x9e3779b97f4a7c15ull);
+  }
+
+  // The hash function of the shards, which uses the low bits of the mixed
+  // hash as its high bits are the ones that choose the shard
+  struct ShardHash {
+    template <typename T>
+    static std::size_t hash(const T& key, int p, std::size_t seed) {
+      IL_EXPECT_MEDIUM(p <= nb_hash_bits_);
+
+      return static_cast<std::size_t>(mixedHash(key, seed) &
+                                      ((std::uint64_t{1} << p) - 1));
+    }
+    template <typename T0, typename T1>
+    static bool isEqual(const T0& key0, const T1& key1) {
+      return F::isEqual(key0, key1);
+    }
+  };
+
+  // The padding keeps the locks of two shards on different cache lines
+  struct Shard {
+    std::mutex mutex;
+    il::SwissMap<K, V, ShardHash> map;
+    char padding[64];
+  };
+
+  std::unique_ptr<Shard[]> shard_;
+  std::size_t seed_;
+
+ public:
+  ConcurrentMap();
+  ConcurrentMap(il::int_t n);
+  ConcurrentMap(il::int_t n, std::size_t seed);
+  ConcurrentMap(const ConcurrentMap<K, V, F>& map) = delete;
+  ConcurrentMap& operator=(const ConcurrentMap<K, V, F>& map) = delete;
+
+  void Set(const K& key, const V& value);
+  void Set(K&& key, V&& value);
+  bool SetIfAbsent(const K& key, const V& value);
+  void Set(il::parallel_t, const il::Array<K>& keys,
+           const il::Array<V>& values);
+
+  bool search(const K& key, il::io_t, V& value) const;
+  bool contains(const K& key) const;
+  V valueForKey(const K& key, const V& default_value) const;
+  bool erase(const K& key);
+
+  void Clear();
+  il::int_t nbElements() const;
+  std::size_t seed() const;
+  void Reserve(il::int_t n);
+
+ private:
+  il::int_t shardIndex(const K& key) const;
+  static il::int_t shardCapacity(il::int_t n);
+};
+
+template <typename K, typename V, typename F>
+ConcurrentMap<K, V, F>::ConcurrentMap() : ConcurrentMap{0, 0} {}
+
+template <typename K, typename V, typename F>
+ConcurrentMap<K, V, F>::ConcurrentMap(il::int_t n) : ConcurrentMap{n, 0} {}
+
+template <typename K, typename V, typename F>
+ConcurrentMap<K, V, F>::ConcurrentMap(il::int_t n, std::size_t seed)
+    : shard_{new Shard[nb_shards_]}, seed_{seed} {
+  IL_EXPECT_FAST(n >= 0);
+
+  const il::int_t n_shard = shardCapacity(n);
+  for (il::int_t j = 0; j < nb_shards_; ++j) {
+    shard_[j].map = il::SwissMap<K, V, ShardHash>{n_shard, seed};
+  }
+}
+
+template <typename K, typename V, typename F>
+il::int_t ConcurrentMap<K, V, F>::shardIndex(const K& key) const {
+  return static_cast<il::int_t>(mixedHash(key, seed_) >>
+                                (64 - nb_shards_log2_));
+}
+
+// The number of elements of a shard when there are n elements in the map:
+// n / 256 on average, plus some room for the deviation from the average
+template <typename K, typename V, typename F>
+il::int_t ConcurrentMap<K, V, F>::shardCapacity(il::int_t n) {
+  if (n == 0) {
+    return 0;
+  }
+  const il::int_t n_shard = (n + nb_shards_ - 1) / nb_shards_;
+  return n_shard + n_shard / 8 + 8;
+}
+
+template <typename K, typename V, typename F>
+void ConcurrentMap<K, V, F>::Set(const K& key, const V& value) {
+  Shard& shard = shard_[shardIndex(key)];
+  std::lock_guard<std::mutex> lock{shard.mutex};
+  shard.map.Set(key, value);
+}
+
+template <typename K, typename V, typename F>
+void ConcurrentMap<K, V, F>::Set(K&& key, V&& value) {
+  Shard& shard = shard_[shardIndex(key)];
+  std::lock_guard<std::mutex> lock{shard.mutex};
+  shard.map.Set(std::move(key), std::move(value));
+}
+
+// Insert (key, value) if the key is not in the map and return true, or
+// leave the map unchanged and return false. When many threads call it for
+// the same key, exactly one of them inserts its value.
+template <typename K, typename V, typename F>
+bool ConcurrentMap<K, V, F>::SetIfAbsent(const K& key, const V& value) {
+  Shard& shard = shard_[shardIndex(key)];
+  std::lock_guard<std::mutex> lock{shard.mutex};
+  il::spot_t i = shard.map.search(key);
+  if (shard.map.found(i)) {
+    return false;
+  }
+  shard.map.Set(key, value, il::io, i);
+  return true;
+}
+
+/* \brief Set all the (keys[k], values[k]) in parallel
+// \details The keys are hashed in parallel to find their shards, and they are
+// grouped by shard with a counting sort: every chunk of keys counts its keys
+// per shard, the prefix sums of the counts give to every chunk and every
+// shard its own range in an array of indices, and the chunks scatter the
+// indices of their keys there. Then every shard is filled by one thread,
+// which only locks it while filling it. The work is O(n + 256 T) with T
+// threads. As the sort keeps the order of the keys within a shard, the map
+// ends up with the value of the last occurrence of a key, as with a loop
+// calling Set.
+*/
+template <typename K, typename V, typename F>
+void ConcurrentMap<K, V, F>::Set(il::parallel_t, const il::Array<K>& keys,
+                                 const il::Array<V>& values) {
+  IL_EXPECT_FAST(keys.size() == values.size());
+
+  const il::int_t n = keys.size();
+  if (n == 0) {
+    return;
+  }
+  const il::int_t nb_threads = il::nbThreads();
+  const il::int_t nb_grains = 1 + (n - 1) / il::parallelGrain<K>();
+  const il::int_t nb_chunks = nb_grains < nb_threads ? nb_grains : nb_threads;
+  // The chunk c is [c * q + min(c, r), (c + 1) * q + min(c + 1, r))
+  const il::int_t q = n / nb_chunks;
+  const il::int_t r = n % nb_chunks;
+
+  // count(j, c) is the number of keys of the chunk c in the shard j, and then
+  // the position of the first of them in order
+  il::Array<unsigned char> shard_index{n};
+  il::Array2D<il::int_t> count{nb_shards_, nb_chunks, 0};
+  il::parallelForChunks(
+      0, nb_chunks, nb_chunks,
+      [this, q, r, &keys, &shard_index, &count](il::int_t c_begin,
+                                                il::int_t c_end) {
+        for (il::int_t c = c_begin; c < c_end; ++c) {
+          const il::int_t k_begin = c * q + (c < r ? c : r);
+          const il::int_t k_end = k_begin + q + (c < r ? 1 : 0);
+          for (il::int_t k = k_begin; k < k_end; ++k) {
+            const il::int_t j = shardIndex(keys[k]);
+            shard_index[k] = static_cast<unsigned char>(j);
+            ++count(j, c);
+          }
+        }
+      });
+  il::Array<il::int_t> shard_begin{nb_shards_ + 1};
+  il::int_t position = 0;
+  for (il::int_t j = 0; j < nb_shards_; ++j) {
+    shard_begin[j] = position;
+    for (il::int_t c = 0; c < nb_chunks; ++c) {
+      const il::int_t m = count(j, c);
+      count(j, c) = position;
+      position += m;
+    }
+  }
+  shard_begin[nb_shards_] = position;
+  il::Array<il::int_t> order{n, il::uninitialized};
+  il::parallelForChunks(
+      0, nb_chunks, nb_chunks,
+      [q, r, &shard_index, &count, &order](il::int_t c_begin,
+                                           il::int_t c_end) {
+        for (il::int_t c = c_begin; c < c_end; ++c) {
+          const il::int_t k_begin = c * q + (c < r ? c : r);
+          const il::int_t k_end = k_begin + q + (c < r ? 1 : 0);
+          for (il::int_t k = k_begin; k < k_end; ++k) {
+            il::int_t& next = count(shard_index[k], c);
+            order[next] = k;
+            ++next;
+          }
+        }
+      });
+
+  il::parallelFor(
+      0, nb_shards_, 1,
+      [this, &keys, &values, &shard_begin, &order](il::int_t j_begin,
+                                                   il::int_t j_end) {
+        for (il::int_t j = j_begin; j < j_end; ++j) {
+          std::lock_guard<std::mutex> lock{shard_[j].mutex};
+          il::SwissMap<K, V, ShardHash>& map = shard_[j].map;
+          map.Reserve(map.nbElements() + shard_begin[j + 1] - shard_begin[j]);
+          for (il::int_t i = shard_begin[j]; i < shard_begin[j + 1]; ++i) {
+            map.Set(keys[order[i]], values[order[i]]);
+          }
+        }
+      });
+}
+
+template <typename K, typename V, typename F>
+bool ConcurrentMap<K, V, F>::search(const K& key, il::io_t, V& value) const {
+  Shard& shard = shard_[shardIndex(key)];
+  std::lock_guard<std::mutex> lock{shard.mutex};
+  const il::spot_t i = shard.map.search(key);
+  if (shard.map.found(i)) {
+    value = shard.map.value(i);
+    return true;
+  } else {
+    return false;
+  }
+}
+
+template <typename K, typename V, typename F>
+bool ConcurrentMap<K, V, F>::contains(const K& key) const {
+  Shard& shard = shard_[shardIndex(key)];
+  std::lock_guard<std::mutex> lock{shard.mutex};
+  return shard.map.found(shard.map.search(key));
+}
+
+template <typename K, typename V, typename F>
+V ConcurrentMap<K, V, F>::valueForKey(const K& key,
+                                      const V& default_value) const {
+  Shard& shard = shard_[shardIndex(key)];
+  std::lock_guard<std::mutex> lock{shard.mutex};
+  return shard.map.valueForKey(key, default_value);
+}
+
+template <typename K, typename V, typename F>
+bool ConcurrentMap<K, V, F>::erase(const K& key) {
+  Shard& shard = shard_[shardIndex(key)];
+  std::lock_guard<std::mutex> lock{shard.mutex};
+  const il::spot_t i = shard.map.search(key);
+  if (shard.map.found(i)) {
+    shard.map.erase(i);
+    return true;
+  } else {
+    return false;
+  }
+}
+
+template <typename K, typename V, typename F>
+void ConcurrentMap<K, V, F>::Clear() {
+  for (il::int_t j = 0; j < nb_shards_; ++j) {
+    std::lock_guard<std::mutex> lock{shard_[j].mutex};
+    shard_[j].map.Clear();
+  }
+}
+
+// When other threads change the map, the result is only an estimate as the
+// shards are counted one after the other
+template <typename K, typename V, typename F>
+il::int_t ConcurrentMap<K, V, F>::nbElements() const {
+  il::int_t n = 0;
+  for (il::int_t j = 0; j < nb_shards_; ++j) {
+    std::lock_guard<std::mutex> lock{shard_[j].mutex};
+    n += shard_[j].map.nbElements();
+  }
+  return n;
+}
+
+template <typename K, typename V, typename F>
+std::size_t ConcurrentMap<K, V, F>::seed() const {
+  return seed_;
+}
+
+// Make room for n elements in the map. It can be called while other threads
+// use the map: the shards are locked and grown one at a time.
+template <typename K, typename V, typename F>
+void ConcurrentMap<K, V, F>::Reserve(il::int_t n) {
+  IL_EXPECT_FAST(n >= 0);
+
+  const il::int_t n_shard = shardCapacity(n);
+  for (il::int_t j = 0; j < nb_shards_; ++j) {
+    std::lock_guard<std::mutex> lock{shard_[j].mutex};
+    shard_[j].map.Reserve(n_shard);
+  }
+}
+
+}  // namespace il
+
+#endif  // IL_CONCURRENTMAP_H
@@ -0,0 +1,195 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#ifndef IL_CONTROLGROUP_H
+#define IL_CONTROLGROUP_H
+
+// <cstdint> is needed for std::uint32_t
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IL_CONTROL_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define IL_CONTROL_NEON
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include <il/core.h>
+
+namespace il {
+
+// The control bytes of the hash tables with metadata (il::SwissMap,
+// il::SwissSet). There is one byte per bucket:
+// - a full bucket stores 7 bits of the hash of its key: 0b0hhhhhhh
+// - an empty bucket stores 0b10000000
+// - a deleted bucket (tombstone) stores 0b11111110
+const signed char control_empty = -128;
+const signed char control_deleted = -2;
+
+/* \brief Index of the lowest bit set in a non zero mask
+*/
+inline int lowestBit(std::uint32_t mask) {
+  IL_EXPECT_MEDIUM(mask != 0);
+
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctz(mask);
+#elif defined(_MSC_VER)
+  unsigned long k;
+  _BitScanForward(&k, mask);
+  return static_cast<int>(k);
+#else
+  int k = 0;
+  while ((mask & 1) == 0) {
+    mask >>= 1;
+    ++k;
+  }
+  return k;
+#endif
+}
+
+/* \brief Group of 16 control bytes compared all at once
+// \details The k-th bit of the masks returned by the member functions is set
+// when the k-th byte of the group matches. The bytes are compared with SSE2
+// on x86 and with NEON on ARM64, which gives the matches of a whole group in
+// a few instructions. The group does not need to be aligned.
+*/
+class ControlGroup {
+ public:
+  static const il::int_t size = 16;
+
+ private:
+#if defined(IL_CONTROL_SSE2)
+  __m128i control_;
+#elif defined(IL_CONTROL_NEON)
+  int8x16_t control_;
+#else
+  const signed char* control_;
+#endif
+
+ public:
+  explicit ControlGroup(const signed char* control);
+  std::uint32_t match(signed char h) const;
+  std::uint32_t matchEmpty() const;
+  std::uint32_t matchEmptyOrDeleted() const;
+  std::uint32_t matchFull() const;
+
+#if defined(IL_CONTROL_NEON)
+ private:
+  static std::uint32_t mask(uint8x16_t v);
+#endif
+};
+
+#if defined(IL_CONTROL_SSE2)
+
+inline ControlGroup::ControlGroup(const signed char* control)
+    : control_{_mm_loadu_si128(reinterpret_cast<const __m128i*>(control))} {}
+
+inline std::uint32_t ControlGroup::match(signed char h) const {
+  return static_cast<std::uint32_t>(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h), control_)));
+}
+
+inline std::uint32_t ControlGroup::matchEmpty() const {
+  return match(il::control_empty);
+}
+
+inline std::uint32_t ControlGroup::matchEmptyOrDeleted() const {
+  // Empty and deleted are the only control bytes lower than -1
+  return static_cast<std::uint32_t>(
+      _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), control_)));
+}
+
+inline std::uint32_t ControlGroup::matchFull() const {
+  return static_cast<std::uint32_t>(_mm_movemask_epi8(control_)) ^ 0xFFFFu;
+}
+
+#elif defined(IL_CONTROL_NEON)
+
+inline ControlGroup::ControlGroup(const signed char* control)
+    : control_{vld1q_s8(reinterpret_cast<const int8_t*>(control))} {}
+
+inline std::uint32_t ControlGroup::mask(uint8x16_t v) {
+  // NEON has no movemask: keep one distinct bit per byte and add the bytes
+  // of each half
+  static const uint8_t bit[16] = {1, 2, 4, 8, 16, 32, 64, 128,
+                                  1, 2, 4, 8, 16, 32, 64, 128};
+  const uint8x16_t w = vandq_u8(v, vld1q_u8(bit));
+  return static_cast<std::uint32_t>(vaddv_u8(vget_low_u8(w))) |
+         (static_cast<std::uint32_t>(vaddv_u8(vget_high_u8(w))) << 8);
+}
+
+inline std::uint32_t ControlGroup::match(signed char h) const {
+  return mask(vceqq_s8(control_, vdupq_n_s8(h)));
+}
+
+inline std::uint32_t ControlGroup::matchEmpty() const {
+  return match(il::control_empty);
+}
+
+inline std::uint32_t ControlGroup::matchEmptyOrDeleted() const {
+  return mask(vcltq_s8(control_, vdupq_n_s8(-1)));
+}
+
+inline std::uint32_t ControlGroup::matchFull() const {
+  return mask(vcgezq_s8(control_));
+}
+
+#else
+
+inline ControlGroup::ControlGroup(const signed char* control)
+    : control_{control} {}
+
+inline std::uint32_t ControlGroup::match(signed char h) const {
+  std::uint32_t ans = 0;
+  for (int k = 0; k < 16; ++k) {
+    ans |= static_cast<std::uint32_t>(control_[k] == h) << k;
+  }
+  return ans;
+}
+
+inline std::uint32_t ControlGroup::matchEmpty() const {
+  return match(il::control_empty);
+}
+
+inline std::uint32_t ControlGroup::matchEmptyOrDeleted() const {
+  std::uint32_t ans = 0;
+  for (int k = 0; k < 16; ++k) {
+    ans |= static_cast<std::uint32_t>(control_[k] < -1) << k;
+  }
+  return ans;
+}
+
+inline std::uint32_t ControlGroup::matchFull() const {
+  std::uint32_t ans = 0;
+  for (int k = 0; k < 16; ++k) {
+    ans |= static_cast<std::uint32_t>(control_[k] >= 0) << k;
+  }
+  return ans;
+}
+
+#endif
+
+}  // namespace il
+
+#endif  // IL_CONTROLGROUP_H
@@ -0,0 +1,397 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#ifndef IL_FROZENMAP_H
+#define IL_FROZENMAP_H
+
+// <cstdint> is needed for std::uint64_t
+#include <cstdint>
+// <cstring> is needed for std::memcpy and std::memcmp
+#include <cstring>
+
+#include <il/Array.h>
+#include <il/Map.h>
+#include <il/MapArray.h>
+#include <il/String.h>
+#include <il/container/hash/HashFunction.h>
+#include <il/container/hash/PerfectHash.h>
+
+namespace il {
+
+template <typename T>
+class SaveHelperData;
+template <typename T>
+class LoadHelperData;
+
+// il::FrozenMap is a hash map which can not be changed once it has been
+// built from an il::Map or an il::MapArray. It uses a minimal perfect hash
+// function (il::PerfectHash) built for its keys: the n keys and values are
+// stored in arrays of size n with no empty slot, and a search looks at only
+// one of them. It is meant for lookup tables which are built once and
+// searched many times.
+//
+// The spots of a map with n elements are 0, 1, ..., n - 1, and the order in
+// which the elements are visited has nothing to do with the order of the
+// original map.
+//
+// il::Map<il::String, il::int_t> map{};
+// ...
+// const il::FrozenMap<il::String, il::int_t> frozen_map{map};
+// const il::spot_t i = frozen_map.search("dimension");
+
+template <typename K, typename V, typename F = HashFunction<K>>
+class FrozenMap {
+ private:
+  il::PerfectHash perfect_hash_;
+  il::Array<K> key_;
+  il::Array<V> value_;
+  std::size_t seed_;
+
+ public:
+  FrozenMap();
+  explicit FrozenMap(const il::Map<K, V, F>& map);
+  explicit FrozenMap(const il::MapArray<K, V, F>& map);
+
+  il::spot_t search(const K& key) const;
+  template <typename T, typename = il::enableIfHeterogeneous<K, T, F>>
+  il::spot_t search(const T& key) const;
+  bool found(il::spot_t i) const;
+
+  const K& key(il::spot_t i) const;
+  const V& value(il::spot_t i) const;
+  const V& valueForKey(const K& key, const V& default_value) const;
+  template <typename T, typename = il::enableIfHeterogeneous<K, T, F>>
+  const V& valueForKey(const T& key, const V& default_value) const;
+
+  il::int_t nbElements() const;
+  std::size_t seed() const;
+
+  il::spot_t spotBegin() const;
+  il::spot_t spotEnd() const;
+  il::spot_t next(il::spot_t i) const;
+
+ private:
+  template <typename M>
+  void Build(const M& map);
+  template <typename T>
+  il::spot_t searchKey(const T& key) const;
+};
+
+template <typename K, typename V, typename F>
+FrozenMap<K, V, F>::FrozenMap()
+    : perfect_hash_{}, key_{}, value_{}, seed_{0} {}
+
+template <typename K, typename V, typename F>
+FrozenMap<K, V, F>::FrozenMap(const il::Map<K, V, F>& map) : FrozenMap{} {
+  Build(map);
+}
+
+template <typename K, typename V, typename F>
+FrozenMap<K, V, F>::FrozenMap(const il::MapArray<K, V, F>& map)
+    : FrozenMap{} {
+  Build(map);
+}
+
+// The keys are hashed on 64 bits. In the unlikely event where the perfect
+// hash function can not be built for these hashes, for instance because two
+// of them are equal, the keys are hashed again with another seed.
+template <typename K, typename V, typename F>
+template <typename M>
+void FrozenMap<K, V, F>::Build(const M& map) {
+  const il::int_t n = map.nbElements();
+  il::Array<il::spot_t> spot{n};
+  il::int_t j = 0;
+  for (il::spot_t i = map.spotBegin(); i != map.spotEnd(); i = map.next(i)) {
+    spot[j] = i;
+    ++j;
+  }
+
+  il::Array<std::uint64_t> hash{n};
+  seed_ = 0;
+  while (true) {
+    for (il::int_t k = 0; k < n; ++k) {
+      hash[k] = il::hashSeeded<F>(map.key(spot[k]), 64, seed_);
+    }
+    if (perfect_hash_.Build(hash)) {
+      break;
+    }
+    if (seed_ == 64) {
+      // Only a hash function which does not depend on its seed can end up
+      // here, if it gives the same hash to two different keys
+      il::abort();
+    }
+    ++seed_;
+  }
+
+  key_.Resize(n);
+  value_.Resize(n);
+  for (il::int_t k = 0; k < n; ++k) {
+    const il::int_t i = perfect_hash_.slot(hash[k]);
+    key_[i] = map.key(spot[k]);
+    value_[i] = map.value(spot[k]);
+  }
+}
+
+template <typename K, typename V, typename F>
+template <typename T>
+il::spot_t FrozenMap<K, V, F>::searchKey(const T& key) const {
+  if (key_.size() == 0) {
+    return il::spot_t{-1};
+  }
+  const il::int_t i =
+      perfect_hash_.slot(il::hashSeeded<F>(key, 64, seed_));
+  return il::spot_t{F::isEqual(key_[i], key) ? i : -1};
+}
+
+template <typename K, typename V, typename F>
+il::spot_t FrozenMap<K, V, F>::search(const K& key) const {
+  return searchKey(key);
+}
+
+template <typename K, typename V, typename F>
+template <typename T, typename>
+il::spot_t FrozenMap<K, V, F>::search(const T& key) const {
+  return searchKey(key);
+}
+
+template <typename K, typename V, typename F>
+bool FrozenMap<K, V, F>::found(il::spot_t i) const {
+  return i.index >= 0;
+}
+
+template <typename K, typename V, typename F>
+const K& FrozenMap<K, V, F>::key(il::spot_t i) const {
+  return key_[i.index];
+}
+
+template <typename K, typename V, typename F>
+const V& FrozenMap<K, V, F>::value(il::spot_t i) const {
+  return value_[i.index];
+}
+
+template <typename K, typename V, typename F>
+const V& FrozenMap<K, V, F>::valueForKey(const K& key,
+                                         const V& default_value) const {
+  const il::spot_t i = searchKey(key);
+  return found(i) ? value_[i.index] : default_value;
+}
+
+template <typename K, typename V, typename F>
+template <typename T, typename>
+const V& FrozenMap<K, V, F>::valueForKey(const T& key,
+                                         const V& default_value) const {
+  const il::spot_t i = searchKey(key);
+  return found(i) ? value_[i.index] : default_value;
+}
+
+template <typename K, typename V, typename F>
+il::int_t FrozenMap<K, V, F>::nbElements() const {
+  return key_.size();
+}
+
+template <typename K, typename V, typename F>
+std::size_t FrozenMap<K, V, F>::seed() const {
+  return seed_;
+}
+
+template <typename K, typename V, typename F>
+il::spot_t FrozenMap<K, V, F>::spotBegin() const {
+  return il::spot_t{0};
+}
+
+template <typename K, typename V, typename F>
+il::spot_t FrozenMap<K, V, F>::spotEnd() const {
+  return il::spot_t{key_.size()};
+}
+
+template <typename K, typename V, typename F>
+il::spot_t FrozenMap<K, V, F>::next(il::spot_t i) const {
+  return il::spot_t{i.index + 1};
+}
+
+// For strings, the keys are stored one after the other in a single array of
+// bytes: key i is made of the bytes in [offset_[i], offset_[i + 1]). There
+// is no il::String object, and therefore no allocation and no space lost to
+// the small string buffer. The search takes an il::StringView, so il::String
+// and string literals can be searched without any copy.
+template <typename V, typename F>
+class FrozenMap<il::String, V, F> {
+ private:
+  il::PerfectHash perfect_hash_;
+  il::Array<char> arena_;
+  il::Array<il::int_t> offset_;
+  il::Array<V> value_;
+  std::size_t seed_;
+
+  friend class il::SaveHelperData<FrozenMap<il::String, V, F>>;
+  friend class il::LoadHelperData<FrozenMap<il::String, V, F>>;
+
+ public:
+  FrozenMap();
+  explicit FrozenMap(const il::Map<il::String, V, F>& map);
+  explicit FrozenMap(const il::MapArray<il::String, V, F>& map);
+
+  il::spot_t search(const il::StringView& key) const;
+  bool found(il::spot_t i) const;
+
+  il::StringView key(il::spot_t i) const;
+  const V& value(il::spot_t i) const;
+  const V& valueForKey(const il::StringView& key,
+                       const V& default_value) const;
+
+  il::int_t nbElements() const;
+  std::size_t seed() const;
+
+  il::spot_t spotBegin() const;
+  il::spot_t spotEnd() const;
+  il::spot_t next(il::spot_t i) const;
+
+ private:
+  template <typename M>
+  void Build(const M& map);
+};
+
+template <typename V, typename F>
+FrozenMap<il::String, V, F>::FrozenMap()
+    : perfect_hash_{}, arena_{}, offset_{1, 0}, value_{}, seed_{0} {}
+
+template <typename V, typename F>
+FrozenMap<il::String, V, F>::FrozenMap(const il::Map<il::String, V, F>& map)
+    : FrozenMap{} {
+  Build(map);
+}
+
+template <typename V, typename F>
+FrozenMap<il::String, V, F>::FrozenMap(
+    const il::MapArray<il::String, V, F>& map)
+    : FrozenMap{} {
+  Build(map);
+}
+
+template <typename V, typename F>
+template <typename M>
+void FrozenMap<il::String, V, F>::Build(const M& map) {
+  const il::int_t n = map.nbElements();
+  il::Array<il::spot_t> spot{n};
+  il::int_t j = 0;
+  for (il::spot_t i = map.spotBegin(); i != map.spotEnd(); i = map.next(i)) {
+    spot[j] = i;
+    ++j;
+  }
+
+  il::Array<std::uint64_t> hash{n};
+  seed_ = 0;
+  while (true) {
+    for (il::int_t k = 0; k < n; ++k) {
+      hash[k] = il::hashSeeded<F>(il::StringView{map.key(spot[k])}, 64, seed_);
+    }
+    if (perfect_hash_.Build(hash)) {
+      break;
+    }
+    if (seed_ == 64) {
+      il::abort();
+    }
+    ++seed_;
+  }
+
+  il::Array<il::int_t> slot_spot{n};
+  for (il::int_t k = 0; k < n; ++k) {
+    slot_spot[perfect_hash_.slot(hash[k])] = k;
+  }
+  offset_.Resize(n + 1);
+  offset_[0] = 0;
+  for (il::int_t i = 0; i < n; ++i) {
+    offset_[i + 1] = offset_[i] + map.key(spot[slot_spot[i]]).size();
+  }
+  arena_.Resize(offset_[n]);
+  value_.Resize(n);
+  for (il::int_t i = 0; i < n; ++i) {
+    const il::String& key = map.key(spot[slot_spot[i]]);
+    std::memcpy(arena_.Data() + offset_[i], key.data(),
+                static_cast<std::size_t>(key.size()));
+    value_[i] = map.value(spot[slot_spot[i]]);
+  }
+}
+
+template <typename V, typename F>
+il::spot_t FrozenMap<il::String, V, F>::search(
+    const il::StringView& key) const {
+  if (value_.size() == 0) {
+    return il::spot_t{-1};
+  }
+  const il::int_t i =
+      perfect_hash_.slot(il::hashSeeded<F>(key, 64, seed_));
+  const il::int_t n = offset_[i + 1] - offset_[i];
+  const bool equal =
+      n == key.size() &&
+      std::memcmp(arena_.data() + offset_[i], key.data(),
+                  static_cast<std::size_t>(n)) == 0;
+  return il::spot_t{equal ? i : -1};
+}
+
+template <typename V, typename F>
+bool FrozenMap<il::String, V, F>::found(il::spot_t i) const {
+  return i.index >= 0;
+}
+
+template <typename V, typename F>
+il::StringView FrozenMap<il::String, V, F>::key(il::spot_t i) const {
+  return il::StringView{il::StringType::Byte, arena_.data() + offset_[i.index],
+                        offset_[i.index + 1] - offset_[i.index]};
+}
+
+template <typename V, typename F>
+const V& FrozenMap<il::String, V, F>::value(il::spot_t i) const {
+  return value_[i.index];
+}
+
+template <typename V, typename F>
+const V& FrozenMap<il::String, V, F>::valueForKey(
+    const il::StringView& key, const V& default_value) const {
+  const il::spot_t i = search(key);
+  return found(i) ? value_[i.index] : default_value;
+}
+
+template <typename V, typename F>
+il::int_t FrozenMap<il::String, V, F>::nbElements() const {
+  return value_.size();
+}
+
+template <typename V, typename F>
+std::size_t FrozenMap<il::String, V, F>::seed() const {
+  return seed_;
+}
+
+template <typename V, typename F>
+il::spot_t FrozenMap<il::String, V, F>::spotBegin() const {
+  return il::spot_t{0};
+}
+
+template <typename V, typename F>
+il::spot_t FrozenMap<il::String, V, F>::spotEnd() const {
+  return il::spot_t{value_.size()};
+}
+
+template <typename V, typename F>
+il::spot_t FrozenMap<il::String, V, F>::next(il::spot_t i) const {
+  return il::spot_t{i.index + 1};
+}
+
+}  // namespace il
+
+#endif  // IL_FROZENMAP_H
@@ -19,13 +19,207 @@
 #ifndef IL_HASHFUNCTION_H
 #define IL_HASHFUNCTION_H
 
+// <atomic> is needed for std::atomic
+#include <atomic>
+// <cstdint> is needed for std::uint64_t
+#include <cstdint>
+// <cstring> is needed for std::memcpy
+#include <cstring>
 #include <limits>
+// <random> is needed for std::random_device
+#include <random>
+// <type_traits> is needed for std::enable_if
+#include <type_traits>
+// <utility> is needed for std::declval
+#include <utility>
 
 #include <il/String.h>
 #include <il/core.h>
 
 namespace il {
 
+/* \brief Multiply a by b and store the low and the high 64 bits of the
+// product in a and b
+*/
+inline void hashMultiply(il::io_t, std::uint64_t& a, std::uint64_t& b) {
+#if defined(__SIZEOF_INT128__)
+  const __uint128_t r = static_cast<__uint128_t>(a) * b;
+  a = static_cast<std::uint64_t>(r);
+  b = static_cast<std::uint64_t>(r >> 64);
+#else
+  const std::uint64_t a_high = a >> 32;
+  const std::uint64_t a_low = static_cast<std::uint32_t>(a);
+  const std::uint64_t b_high = b >> 32;
+  const std::uint64_t b_low = static_cast<std::uint32_t>(b);
+  const std::uint64_t high = a_high * b_high;
+  const std::uint64_t middle_0 = a_high * b_low;
+  const std::uint64_t middle_1 = b_high * a_low;
+  const std::uint64_t low = a_low * b_low;
+  const std::uint64_t t = low + (middle_0 << 32);
+  std::uint64_t carry = t < low ? 1 : 0;
+  const std::uint64_t r_low = t + (middle_1 << 32);
+  carry += r_low < t ? 1 : 0;
+  a = r_low;
+  b = high + (middle_0 >> 32) + (middle_1 >> 32) + carry;
+#endif
+}
+
+/* \brief Multiply a by b and xor the low and the high 64 bits of the
+// product
+*/
+inline std::uint64_t hashFold(std::uint64_t a, std::uint64_t b) {
+  il::hashMultiply(il::io, a, b);
+  return a ^ b;
+}
+
+inline std::uint64_t hashRead64(const unsigned char* p) {
+  std::uint64_t v;
+  std::memcpy(&v, p, sizeof(std::uint64_t));
+  return v;
+}
+
+inline std::uint64_t hashRead32(const unsigned char* p) {
+  std::uint32_t v;
+  std::memcpy(&v, p, sizeof(std::uint32_t));
+  return v;
+}
+
+/* \brief Hash n bytes starting at s
+// \details The bytes are read 8 at a time and mixed with 64x64 -> 128 bit
+// multiplications, as in wyhash. Strings of at most 16 bytes are read with
+// 2 to 4 loads and no loop. All the 64 bits of the result are of good
+// quality, so that any of them can be used to index the buckets of a hash
+// table. Different seeds give unrelated hash functions.
+*/
+inline std::uint64_t hashBytes(const char* s, il::int_t n,
+                               std::uint64_t seed) {
+  IL_EXPECT_MEDIUM(n >= 0);
+
+  const std::uint64_t k0 = 0xa0761d6478bd642full;
+  const std::uint64_t k1 = 0xe7037ed1a0b428dbull;
+  const std::uint64_t k2 = 0x8ebc6af09c88c6e3ull;
+  const std::uint64_t k3 = 0x589965cc75374cc3ull;
+
+  const unsigned char* p = reinterpret_cast<const unsigned char*>(s);
+  const std::size_t len = static_cast<std::size_t>(n);
+  seed ^= il::hashFold(seed ^ k0, k1);
+  std::uint64_t a;
+  std::uint64_t b;
+  if (len <= 16) {
+    if (len >= 4) {
+      // Overlapping loads of the first and the last 8 bytes
+      const std::size_t d = (len >> 3) << 2;
+      a = (il::hashRead32(p) << 32) | il::hashRead32(p + d);
+      b = (il::hashRead32(p + len - 4) << 32) |
+          il::hashRead32(p + len - 4 - d);
+    } else if (len > 0) {
+      a = (static_cast<std::uint64_t>(p[0]) << 16) |
+          (static_cast<std::uint64_t>(p[len >> 1]) << 8) | p[len - 1];
+      b = 0;
+    } else {
+      a = 0;
+      b = 0;
+    }
+  } else {
+    std::size_t i = len;
+    if (i > 48) {
+      // Three independent lanes to hide the latency of the multiplications
+      std::uint64_t seed_1 = seed;
+      std::uint64_t seed_2 = seed;
+      do {
+        seed = il::hashFold(il::hashRead64(p) ^ k1,
+                            il::hashRead64(p + 8) ^ seed);
+        seed_1 = il::hashFold(il::hashRead64(p + 16) ^ k2,
+                              il::hashRead64(p + 24) ^ seed_1);
+        seed_2 = il::hashFold(il::hashRead64(p + 32) ^ k3,
+                              il::hashRead64(p + 40) ^ seed_2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= seed_1 ^ seed_2;
+    }
+    while (i > 16) {
+      seed = il::hashFold(il::hashRead64(p) ^ k1,
+                          il::hashRead64(p + 8) ^ seed);
+      p += 16;
+      i -= 16;
+    }
+    // The last 16 bytes, which might overlap the ones already read
+    a = il::hashRead64(p + i - 16);
+    b = il::hashRead64(p + i - 8);
+  }
+  a ^= k1;
+  b ^= seed;
+  il::hashMultiply(il::io, a, b);
+  return il::hashFold(a ^ k0 ^ len, b ^ k1);
+}
+
+/* \brief Get a random seed for a hash table
+// \details Each call returns a different seed. Giving such a seed to a hash
+// table makes it resistant to keys chosen to collide, and makes the order of
+// its elements unrelated to the one of the other tables.
+//
+// il::Map<il::String, il::int_t> map{n, il::randomHashSeed()};
+*/
+inline std::size_t randomHashSeed() {
+  static const std::uint64_t base = []() {
+    std::random_device device{};
+    return (static_cast<std::uint64_t>(device()) << 32) ^ device();
+  }();
+  static std::atomic<std::uint64_t> counter{0};
+  const std::uint64_t k = counter.fetch_add(1, std::memory_order_relaxed);
+  return static_cast<std::size_t>(
+      il::hashFold(base ^ k, 0x9e3779b97f4a7c15ull));
+}
+
+/* \brief Hash x with the seed when the hash function accepts a seed
+// \details Calls F::hash(x, p, seed) if it exists and F::hash(x, p)
+// otherwise, so that hash functions written without seed still work.
+*/
+template <typename F, typename T>
+auto hashSeeded(const T& x, int p, std::size_t seed, int)
+    -> decltype(F::hash(x, p, seed)) {
+  return F::hash(x, p, seed);
+}
+
+template <typename F, typename T>
+std::size_t hashSeeded(const T& x, int p, std::size_t, long) {
+  return F::hash(x, p);
+}
+
+template <typename F, typename T>
+std::size_t hashSeeded(const T& x, int p, std::size_t seed) {
+  return il::hashSeeded<F>(x, p, seed, 0);
+}
+
+/* \brief Enable the search of a key of type T in a hash table with keys of
+// type K and hash function F, without constructing a key of type K
+// \details The hash function opts in by declaring a member type
+// is_transparent, as in the standard library, and by providing
+// hash(const T&, p) and isEqual(const K&, const T&). They must give the same
+// results as for the key of type K with the same value.
+*/
+// T is only used to delay the check until a search is called with a key of
+// type T
+template <typename F, typename T>
+struct isTransparent {
+ private:
+  template <typename G>
+  static std::true_type test(typename G::is_transparent*);
+  template <typename G>
+  static std::false_type test(...);
+
+ public:
+  static const bool value = decltype(test<F>(nullptr))::value;
+};
+
+template <typename K, typename T, typename F>
+using enableIfHeterogeneous = typename std::enable_if<
+    il::isTransparent<F, T>::value,
+    decltype(F::hash(std::declval<const T&>(), 0),
+             F::isEqual(std::declval<const K&>(), std::declval<const T&>()),
+             void())>::type;
+
 template <typename T>
 class HashFunction {
  public:
@@ -34,6 +228,7 @@ class HashFunction {
   //  static inline void constructEmpty(il::io_t, T* val);
   //  static inline void constructTombstone(il::io_t, T* val);
   //  static std::size_t hash(const T& val, int p);
+  //  static std::size_t hash(const T& val, int p, std::size_t seed);
   //  static bool isEqual(const T& val0, const T& val1);
 };
 template <>
@@ -59,6 +254,16 @@ class HashFunction<int> {
     return (y * knuth) >> (64 - p);
 #else
     return static_cast<std::size_t>(val);
+#endif
+  }
+  static std::size_t hash(int val, int p, std::size_t seed) {
+#ifdef IL_64_BIT
+    const std::size_t knuth = 11133510565745311;
+    const std::size_t y = static_cast<std::size_t>(val) ^ seed;
+
+    return (y * knuth) >> (64 - p);
+#else
+    return static_cast<std::size_t>(val) ^ seed;
 #endif
   }
   static bool isEqual(int val0, int val1) { return val0 == val1; }
@@ -97,6 +302,16 @@ class HashFunction<long> {
     return (y * knuth) >> (64 - p);
 #else
     return static_cast<std::size_t>(val);
+#endif
+  }
+  static std::size_t hash(long val, int p, std::size_t seed) {
+#ifdef IL_64_BIT
+    const std::size_t knuth = 11133510565745311;
+    const std::size_t y = static_cast<std::size_t>(val) ^ seed;
+
+    return (y * knuth) >> (64 - p);
+#else
+    return static_cast<std::size_t>(val) ^ seed;
 #endif
   }
   static bool isEqual(long val0, long val1) { return val0 == val1; }
@@ -105,6 +320,8 @@ class HashFunction<long> {
 template <>
 class HashFunction<il::String> {
  public:
+  // The keys can be searched for with il::StringView and string literals
+  using is_transparent = void;
   static constexpr il::int_t max_small_size_ =
       static_cast<il::int_t>(3 * sizeof(std::size_t) - 2);
   static inline bool isEmpty(const il::String& s) {
@@ -125,33 +342,36 @@ class HashFunction<il::String> {
     unsigned char* p = reinterpret_cast<unsigned char*>(s);
     p[max_small_size_ + 1] = 0x1E_uchar;
   }
+  // The bucket index is given by the p high bits of the hash
   static std::size_t hash(const il::String& s, int p) {
-    const std::size_t mask = (1 << p) - 1;
-    const il::int_t n = s.size();
-    const char* p_string = s.asCString();
-    std::size_t hash = 5381;
-    for (il::int_t i = 0; i < n; ++i) {
-      hash = ((hash << 5) + hash) + p_string[i];
-    }
-    return hash & mask;
+    return hash(s, p, std::size_t{0});
+  }
+  static std::size_t hash(const il::String& s, int p, std::size_t seed) {
+    return static_cast<std::size_t>(
+        il::hashBytes(s.asCString(), s.size(), seed) >> (64 - p));
+  }
+  static std::size_t hash(const il::StringView& s, int p) {
+    return hash(s, p, std::size_t{0});
+  }
+  static std::size_t hash(const il::StringView& s, int p, std::size_t seed) {
+    return static_cast<std::size_t>(
+        il::hashBytes(s.data(), s.size(), seed) >> (64 - p));
   }
   static std::size_t hash(const char* s, il::int_t n, int p) {
-    const std::size_t mask = (1 << p) - 1;
-    std::size_t hash = 5381;
-    for (il::int_t i = 0; i < n; ++i) {
-      hash = ((hash << 5) + hash) + s[i];
-    }
-    return hash & mask;
+    return hash(s, n, p, std::size_t{0});
+  }
+  static std::size_t hash(const char* s, il::int_t n, int p,
+                          std::size_t seed) {
+    return static_cast<std::size_t>(il::hashBytes(s, n, seed) >> (64 - p));
   }
   template <il::int_t m>
   static std::size_t hash(const char (&s)[m], int p) {
-    const std::size_t mask = (1 << p) - 1;
-    const il::int_t n = m - 1;
-    std::size_t hash = 5381;
-    for (il::int_t i = 0; i < n; ++i) {
-      hash = ((hash << 5) + hash) + s[i];
-    }
-    return hash & mask;
+    return hash(s, p, std::size_t{0});
+  }
+  template <il::int_t m>
+  static std::size_t hash(const char (&s)[m], int p, std::size_t seed) {
+    return static_cast<std::size_t>(il::hashBytes(s, m - 1, seed) >>
+                                    (64 - p));
   }
   static bool isEqual(const il::String& s0, const il::String& s1) {
     const il::int_t n0 = s0.size();
@@ -182,6 +402,9 @@ class HashFunction<il::String> {
     }
     return i == n0;
   }
+  static bool isEqual(const il::String& s0, const il::StringView& s1) {
+    return isEqual(s0, s1.data(), s1.size());
+  }
   template <il::int_t m>
   static bool isEqual(const il::String& s0, const char (&s1)[m]) {
     const il::int_t n0 = s0.size();
@@ -54,6 +54,7 @@ class Map {
   il::int_t nb_elements_;
   il::int_t nb_tombstones_;
   int p_;
+  std::size_t seed_;
   static constexpr il::int_t kMaxSize_ =
       3 * static_cast<il::int_t>(static_cast<std::size_t>(1)
                                  << (8 * sizeof(std::size_t) - 4));
@@ -67,6 +68,7 @@ class Map {
  public:
   Map();
   Map(il::int_t n);
+  Map(il::int_t n, std::size_t seed);
   Map(il::value_t, std::initializer_list<il::KeyValue<K, V>> list);
   Map(const Map<K, V, F>& map);
   Map(Map<K, V, F>&& map);
@@ -86,6 +88,8 @@ class Map {
 
   // Searching for a key
   il::spot_t search(const K& key) const;
+  template <typename T, typename = il::enableIfHeterogeneous<K, T, F>>
+  il::spot_t search(const T& key) const;
   template <il::int_t m>
   il::spot_t searchCString(const char (&key)[m]) const;
   il::spot_t searchCString(const char* key, il::int_t n) const;
@@ -108,6 +112,8 @@ class Map {
   V& Value(il::spot_t i);
   const V& valueForKey(const K& key) const;
   const V& valueForKey(const K& key, const V& default_value) const;
+  template <typename T, typename = il::enableIfHeterogeneous<K, T, F>>
+  const V& valueForKey(const T& key, const V& default_value) const;
   template <il::int_t m>
   const V& valueForCString(const char (&key)[m]) const;
   template <il::int_t m>
@@ -121,6 +127,7 @@ class Map {
   il::int_t nbElements() const;
   il::int_t nbTombstones() const;
   il::int_t nbBuckets() const;
+  std::size_t seed() const;
   void Reserve(il::int_t r);
   void Rehash();
 
@@ -140,6 +147,8 @@ class Map {
   double load() const;
   double displaced() const;
   double displacedTwice() const;
+  template <typename E>
+  il::spot_t searchWithHash(std::size_t i, const E& is_equal) const;
   void ReserveWithP(int p);
 };
 
@@ -171,6 +180,7 @@ Map<K, V, F>::Map() {
   nb_elements_ = 0;
   nb_tombstones_ = 0;
   p_ = -1;
+  seed_ = 0;
 #ifdef IL_DEBUGGER_HELPERS
   size_ = 0;
 #endif
@@ -180,7 +190,16 @@ Map<K, V, F>::Map() {
 }
 
 template <typename K, typename V, typename F>
-Map<K, V, F>::Map(il::int_t n) {
+Map<K, V, F>::Map(il::int_t n) : Map{n, 0} {}
+
+/* \brief Construct a map with room for n elements whose hash function is
+// seeded with seed
+// \details Two maps with different seeds store their keys in unrelated
+// orders. Use il::randomHashSeed() for a map whose keys might be chosen by an
+// adversary.
+*/
+template <typename K, typename V, typename F>
+Map<K, V, F>::Map(il::int_t n, std::size_t seed) {
   IL_EXPECT_FAST(n >= 0);
   IL_EXPECT_FAST(n <= kMaxSize_);
 
@@ -206,6 +225,7 @@ Map<K, V, F>::Map(il::int_t n) {
   }
   nb_elements_ = 0;
   nb_tombstones_ = 0;
+  seed_ = seed;
 #ifdef IL_DEBUG_CLASS
   hash_ = 0;
 #endif
@@ -218,6 +238,7 @@ Map<K, V, F>::Map(il::value_t, std::initializer_list<il::KeyValue<K, V>> list) {
   }
   const il::int_t n = static_cast<il::int_t>(list.size());
 
+  seed_ = 0;
   if (n == 0) {
     bucket_ = nullptr;
     p_ = -1;
@@ -257,6 +278,7 @@ Map<K, V, F>::Map(il::value_t, std::initializer_list<il::KeyValue<K, V>> list) {
 template <typename K, typename V, typename F>
 Map<K, V, F>::Map(const Map<K, V, F>& map) {
   p_ = map.p_;
+  seed_ = map.seed_;
 #ifdef IL_DEBUGGER_HELPERS
   size_ = map.size_;
 #endif
@@ -284,6 +306,7 @@ template <typename K, typename V, typename F>
 Map<K, V, F>::Map(Map<K, V, F>&& map) {
   bucket_ = map.bucket_;
   p_ = map.p_;
+  seed_ = map.seed_;
 #ifdef IL_DEBUGGER_HELPERS
   size_ = map.size_;
 #endif
@@ -344,6 +367,7 @@ Map<K, V, F>& Map<K, V, F>::operator=(const Map<K, V, F>& map) {
   }
   nb_elements_ = map.nb_elements_;
   nb_tombstones_ = map.nb_tombstones_;
+  seed_ = map.seed_;
 #ifdef IL_DEBUG_CLASS
   hash_ = map.hash_;
 #endif
@@ -357,7 +381,7 @@ Map<K, V, F>& Map<K, V, F>::operator=(Map<K, V, F>&& map) {
     if (old_p >= 0) {
       const il::int_t old_m = nbBuckets(old_p);
       for (il::int_t i = 0; i < old_m; ++i) {
-        if (!F::is_empy(bucket_ + i) && !F::isTombstone(bucket_ + i)) {
+        if (!F::isEmpty(bucket_[i].key) && !F::isTombstone(bucket_[i].key)) {
           (&((bucket_ + i)->value))->~V();
           (&((bucket_ + i)->key))->~K();
         }
@@ -366,6 +390,7 @@ Map<K, V, F>& Map<K, V, F>::operator=(Map<K, V, F>&& map) {
     }
     bucket_ = map.bucket_;
     p_ = map.p_;
+    seed_ = map.seed_;
 #ifdef IL_DEBUGGER_HELPERS
     size_ = map.size_;
 #endif
@@ -485,21 +510,14 @@ void Map<K, V, F>::SetCString(const char (&key)[m], V&& value) {
 #endif
 }
 
+// Quadratic probing from the bucket i, until a key k with is_equal(k) or an
+// empty bucket is found. In the latter case, the returned spot is the place
+// where the key should be inserted.
 template <typename K, typename V, typename F>
-il::spot_t Map<K, V, F>::search(const K& key) const {
-  IL_EXPECT_MEDIUM(!F::isEmpty(key));
-  IL_EXPECT_MEDIUM(!F::isTombstone(key));
-
-  if (p_ == -1) {
-    il::spot_t s{-1};
-#ifdef IL_DEBUG_CLASS
-    s.signature = hash_;
-#endif
-    return s;
-  }
-
+template <typename E>
+il::spot_t Map<K, V, F>::searchWithHash(std::size_t i,
+                                        const E& is_equal) const {
   const std::size_t mask = (static_cast<std::size_t>(1) << p_) - 1;
-  std::size_t i = F::hash(key, p_);
   std::size_t i_tombstone = -1;
   std::size_t delta_i = 1;
   while (true) {
@@ -513,7 +531,7 @@ il::spot_t Map<K, V, F>::search(const K& key) const {
       return s;
     } else if (F::isTombstone(bucket_[i].key)) {
       i_tombstone = i;
-    } else if (F::isEqual(bucket_[i].key, key)) {
+    } else if (is_equal(bucket_[i].key)) {
       il::spot_t s{static_cast<il::int_t>(i)};
 #ifdef IL_DEBUG_CLASS
       s.signature = hash_;
@@ -527,8 +545,7 @@ il::spot_t Map<K, V, F>::search(const K& key) const {
 }
 
 template <typename K, typename V, typename F>
-template <il::int_t m>
-il::spot_t Map<K, V, F>::searchCString(const char (&key)[m]) const {
+il::spot_t Map<K, V, F>::search(const K& key) const {
   IL_EXPECT_MEDIUM(!F::isEmpty(key));
   IL_EXPECT_MEDIUM(!F::isTombstone(key));
 
@@ -540,36 +557,41 @@ il::spot_t Map<K, V, F>::searchCString(const char (&key)[m]) const {
     return s;
   }
 
-  const std::size_t mask = (static_cast<std::size_t>(1) << p_) - 1;
-  std::size_t i = F::hash(key, p_);
-  std::size_t i_tombstone = -1;
-  std::size_t delta_i = 1;
-  while (true) {
-    if (F::isEmpty(bucket_[i].key)) {
-      il::spot_t s{(i_tombstone == static_cast<std::size_t>(-1))
-                       ? -(1 + static_cast<il::int_t>(i))
-                       : -(1 + static_cast<il::int_t>(i_tombstone))};
-#ifdef IL_DEBUG_CLASS
-      s.signature = hash_;
-#endif
-      return s;
-    } else if (F::isTombstone(bucket_[i].key)) {
-      i_tombstone = i;
-    } else if (F::isEqual(bucket_[i].key, key)) {
-      il::spot_t s{static_cast<il::int_t>(i)};
+  return searchWithHash(il::hashSeeded<F>(key, p_, seed_),
+                        [&key](const K& k) { return F::isEqual(k, key); });
+}
+
+/* \brief Search for a key given with another type than K, such as an
+// il::StringView for an il::Map<il::String, V>
+// \details This function is only available when the hash function is
+// transparent (see il::enableIfHeterogeneous). No key of type K is
+// constructed, and the spot returned can be used to insert the key.
+//
+// il::Map<il::String, il::int_t> map{};
+// const il::StringView name = line.subview(0, 4);
+// il::spot_t i = map.search(name);
+*/
+template <typename K, typename V, typename F>
+template <typename T, typename>
+il::spot_t Map<K, V, F>::search(const T& key) const {
+  if (p_ == -1) {
+    il::spot_t s{-1};
 #ifdef IL_DEBUG_CLASS
-      s.signature = hash_;
+    s.signature = hash_;
 #endif
-      return s;
-    }
-    i += delta_i;
-    i &= mask;
-    ++delta_i;
+    return s;
   }
+
+  return searchWithHash(il::hashSeeded<F>(key, p_, seed_),
+                        [&key](const K& k) { return F::isEqual(k, key); });
 }
 
 template <typename K, typename V, typename F>
-il::spot_t Map<K, V, F>::searchCString(const char* key, il::int_t n) const {
+template <il::int_t m>
+il::spot_t Map<K, V, F>::searchCString(const char (&key)[m]) const {
+  IL_EXPECT_MEDIUM(!F::isEmpty(key));
+  IL_EXPECT_MEDIUM(!F::isTombstone(key));
+
   if (p_ == -1) {
     il::spot_t s{-1};
 #ifdef IL_DEBUG_CLASS
@@ -578,32 +600,23 @@ il::spot_t Map<K, V, F>::searchCString(const char* key, il::int_t n) const {
     return s;
   }
 
-  const std::size_t mask = (static_cast<std::size_t>(1) << p_) - 1;
-  std::size_t i = F::hash(key, n) & mask;
-  std::size_t i_tombstone = -1;
-  std::size_t delta_i = 1;
-  while (true) {
-    if (F::isEmpty(bucket_[i].key)) {
-      il::spot_t s{(i_tombstone == static_cast<std::size_t>(-1))
-                       ? -(1 + static_cast<il::int_t>(i))
-                       : -(1 + static_cast<il::int_t>(i_tombstone))};
-#ifdef IL_DEBUG_CLASS
-      s.signature = hash_;
-#endif
-      return s;
-    } else if (F::isTombstone(bucket_[i].key)) {
-      i_tombstone = i;
-    } else if (F::isEqual(bucket_[i].key, key, n)) {
-      il::spot_t s{static_cast<il::int_t>(i)};
+  return searchWithHash(il::hashSeeded<F>(key, p_, seed_),
+                        [&key](const K& k) { return F::isEqual(k, key); });
+}
+
+template <typename K, typename V, typename F>
+il::spot_t Map<K, V, F>::searchCString(const char* key, il::int_t n) const {
+  if (p_ == -1) {
+    il::spot_t s{-1};
 #ifdef IL_DEBUG_CLASS
-      s.signature = hash_;
+    s.signature = hash_;
 #endif
-      return s;
-    }
-    i += delta_i;
-    i &= mask;
-    ++delta_i;
+    return s;
   }
+
+  return searchWithHash(F::hash(key, n, p_, seed_), [key, n](const K& k) {
+    return F::isEqual(k, key, n);
+  });
 }
 
 template <typename K, typename V, typename F>
@@ -868,10 +881,22 @@ const V& Map<K, V, F>::valueForKey(const K& key, const V& default_value) const {
   }
 }
 
+template <typename K, typename V, typename F>
+template <typename T, typename>
+const V& Map<K, V, F>::valueForKey(const T& key,
+                                   const V& default_value) const {
+  const il::spot_t i = search(key);
+  if (found(i)) {
+    return value(i);
+  } else {
+    return default_value;
+  }
+}
+
 template <typename K, typename V, typename F>
 template <il::int_t m>
 const V& Map<K, V, F>::valueForCString(const char (&key)[m]) const {
-  const il::spot_t i = search(key);
+  const il::spot_t i = searchCString(key);
   if (found(i)) {
     return value(i);
   } else {
@@ -883,7 +908,7 @@ template <typename K, typename V, typename F>
 template <il::int_t m>
 const V& Map<K, V, F>::valueForCString(const char (&key)[m],
                                        const V& default_value) const {
-  const il::spot_t i = search(key);
+  const il::spot_t i = searchCString(key);
   if (found(i)) {
     return value(i);
   } else {
@@ -907,6 +932,11 @@ il::int_t Map<K, V, F>::nbBuckets() const {
                    : 0;
 }
 
+template <typename K, typename V, typename F>
+std::size_t Map<K, V, F>::seed() const {
+  return seed_;
+}
+
 template <typename K, typename V, typename F>
 il::int_t Map<K, V, F>::nbBuckets(int p) {
   return (p >= 0) ? static_cast<il::int_t>(static_cast<std::size_t>(1) << p)
@@ -933,8 +963,8 @@ double Map<K, V, F>::displaced() const {
   il::int_t nb_displaced = 0;
   for (il::int_t i = 0; i < m; ++i) {
     if (!F::isEmpty(bucket_[i].key) && !F::isTombstone(bucket_[i].key)) {
-      const il::int_t hashed =
-          static_cast<il::int_t>(F::hash(bucket_[i].key, p_));
+      const il::int_t hashed = static_cast<il::int_t>(
+          il::hashSeeded<F>(bucket_[i].key, p_, seed_));
       if (i != hashed) {
         ++nb_displaced;
       }
@@ -951,8 +981,8 @@ double Map<K, V, F>::displacedTwice() const {
   il::int_t nb_displaced_twice = 0;
   for (il::int_t i = 0; i < m; ++i) {
     if (!F::isEmpty(bucket_[i].key) && !F::isTombstone(bucket_[i].key)) {
-      const il::int_t hashed =
-          static_cast<il::int_t>(F::hash(bucket_[i].key, p_));
+      const il::int_t hashed = static_cast<il::int_t>(
+          il::hashSeeded<F>(bucket_[i].key, p_, seed_));
       if (i != hashed && (((i - 1) - hashed) & mask) != 0) {
         ++nb_displaced_twice;
       }
@@ -985,7 +1015,7 @@ void Map<K, V, F>::Clear() {
 
 template <typename K, typename V, typename F>
 il::spot_t Map<K, V, F>::spotBegin() const {
-  const il::int_t m = il::int_t{1} << p_;
+  const il::int_t m = nbBuckets();
 
   il::int_t i = 0;
   while (i < m &&
@@ -1003,7 +1033,7 @@ il::spot_t Map<K, V, F>::spotBegin() const {
 template <typename K, typename V, typename F>
 il::spot_t Map<K, V, F>::spotEnd() const {
   il::spot_t s;
-  s.index = il::int_t{1} << p_;
+  s.index = nbBuckets();
 #ifdef IL_DEBUG_CLASS
   s.signature = hash_;
 #endif
@@ -1015,7 +1045,7 @@ il::spot_t Map<K, V, F>::next(il::spot_t i) const {
 #ifdef IL_DEBUG_CLASS
   IL_EXPECT_MEDIUM(i.signature == hash_);
 #endif
-  const il::int_t m = il::int_t{1} << p_;
+  const il::int_t m = nbBuckets();
 
   il::int_t i_local = i.index;
   ++i_local;
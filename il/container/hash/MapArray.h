@@ -36,6 +36,7 @@ class MapArray {
  public:
   MapArray();
   MapArray(il::int_t n);
+  MapArray(il::int_t n, std::size_t seed);
   MapArray(il::value_t, std::initializer_list<il::KeyValue<K, V>> list);
   void Set(const K& key, const V& value);
   void Set(const K& key, V&& value);
@@ -48,6 +49,8 @@ class MapArray {
   il::int_t size() const;
   il::int_t capacity() const;
   il::spot_t search(const K& key) const;
+  template <typename T, typename = il::enableIfHeterogeneous<K, T, F>>
+  il::spot_t search(const T& key) const;
   template <il::int_t m>
   il::spot_t searchCString(const char (&key)[m]) const;
   bool found(il::spot_t i) const;
@@ -75,6 +78,15 @@ MapArray<K, V, F>::MapArray(il::int_t n) : array_{}, map_{n} {
 #endif
 }
 
+template <typename K, typename V, typename F>
+MapArray<K, V, F>::MapArray(il::int_t n, std::size_t seed)
+    : array_{}, map_{n, seed} {
+  array_.Reserve(n);
+#ifdef IL_DEBUG_CLASS
+  hash_ = 0;
+#endif
+}
+
 template <typename K, typename V, typename F>
 MapArray<K, V, F>::MapArray(il::value_t,
                             std::initializer_list<il::KeyValue<K, V>> list) {
@@ -182,10 +194,24 @@ il::spot_t MapArray<K, V, F>::search(const K& key) const {
   return s;
 }
 
+// Search for a key given with another type than K, such as an il::StringView
+// for an il::MapArray<il::String, V>
+template <typename K, typename V, typename F>
+template <typename T, typename>
+il::spot_t MapArray<K, V, F>::search(const T& key) const {
+  const il::spot_t i = map_.search(key);
+  il::spot_t s;
+  s.index = map_.found(i) ? map_.value(i) : i.index;
+#ifdef IL_DEBUG_CLASS
+  s.signature = map_.hash();
+#endif
+  return s;
+}
+
 template <typename K, typename V, typename F>
 template <il::int_t m>
 il::spot_t MapArray<K, V, F>::searchCString(const char (&key)[m]) const {
-  const il::spot_t i = map_.search(key);
+  const il::spot_t i = map_.searchCString(key);
   il::spot_t s;
   s.index = map_.found(i) ? map_.value(i) : i.index;
 #ifdef IL_DEBUG_CLASS
@@ -0,0 +1,280 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#ifndef IL_PERFECTHASH_H
+#define IL_PERFECTHASH_H
+
+// <cstdint> is needed for std::uint64_t
+#include <cstdint>
+
+#include <il/Array.h>
+#include <il/container/hash/HashFunction.h>
+
+namespace il {
+
+/* \brief Minimal perfect hash function for a set of n distinct 64-bit hashes
+// \details It gives a different slot in [0, n) to each of the hashes it has
+// been built with, with no collision, so that a table indexed by the slots
+// needs one probe per search. The hashes of other keys are mapped to any
+// slot, and the key stored in the slot must be compared to the one searched
+// for.
+//
+// The construction follows the "hash and displace" method (CHD, PTHash).
+// The hashes are split into buckets of 4 hashes on average. The buckets are
+// processed from the largest to the smallest, and each of them gets the
+// first pilot k such that the positions mix(h ^ k) of its hashes are all
+// free in a table of m = 1.03 n positions. The positions in [n, m) that
+// are used are then remapped to the free ones in [0, n). The function
+// takes 4 bytes per bucket and 4 bytes per position in [n, m), i.e. about
+// 1.1 bytes per hash.
+*/
+class PerfectHash {
+ private:
+  il::int_t n_;
+  il::int_t m_;
+  il::Array<std::uint32_t> pilot_;
+  il::Array<std::uint32_t> remap_;
+
+ public:
+  PerfectHash();
+  PerfectHash(il::int_t n, il::int_t m, il::Array<std::uint32_t> pilot,
+              il::Array<std::uint32_t> remap);
+
+  bool Build(const il::Array<std::uint64_t>& hash);
+  il::int_t slot(std::uint64_t h) const;
+
+  il::int_t nbSlots() const;
+  il::int_t nbPositions() const;
+  const il::Array<std::uint32_t>& pilot() const;
+  const il::Array<std::uint32_t>& remap() const;
+
+ private:
+  static std::uint64_t reduce(std::uint64_t h, il::int_t n);
+  static std::uint64_t mix(std::uint64_t x);
+  static il::int_t bucket(std::uint64_t h, il::int_t nb_buckets);
+  static std::uint64_t position(std::uint64_t h, std::uint64_t k,
+                                il::int_t m);
+};
+
+inline PerfectHash::PerfectHash() : n_{0}, m_{0}, pilot_{}, remap_{} {}
+
+// Used to load a function which has been built before. The pilots and the
+// remapped positions must come from a call to Build with n hashes.
+inline PerfectHash::PerfectHash(il::int_t n, il::int_t m,
+                                il::Array<std::uint32_t> pilot,
+                                il::Array<std::uint32_t> remap)
+    : n_{n}, m_{m}, pilot_{std::move(pilot)}, remap_{std::move(remap)} {
+  IL_EXPECT_FAST(n >= 0 && m >= n);
+  IL_EXPECT_FAST(remap_.size() == m - n);
+  IL_EXPECT_FAST(n == 0 || pilot_.size() > 0);
+}
+
+// Index in [0, n) of h times n / 2^64, which only uses the high bits of h
+inline std::uint64_t PerfectHash::reduce(std::uint64_t h, il::int_t n) {
+  std::uint64_t low = h;
+  std::uint64_t high = static_cast<std::uint64_t>(n);
+  il::hashMultiply(il::io, low, high);
+  return high;
+}
+
+// The finalizer of MurmurHash3, a bijection which mixes all the bits of x
+inline std::uint64_t PerfectHash::mix(std::uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xFF51AFD7ED558CCDull;
+  x ^= x >> 33;
+  x *= 0xC4CEB9FE1A85EC53ull;
+  x ^= x >> 33;
+  return x;
+}
+
+// The bucket of a hash. The hash is mixed first as the high bits of some
+// hash functions, such as the multiplicative ones used for integers, are not
+// well distributed for small keys. As in PTHash, 60% of the hashes go to the
+// first 30% of the buckets. The buckets of the end are therefore small, which
+// makes it easy to place them when the table is almost full.
+inline il::int_t PerfectHash::bucket(std::uint64_t h, il::int_t nb_buckets) {
+  const std::uint64_t x = mix(h ^ 0xD6E8FEB86659FD93ull);
+  const std::uint64_t nb_dense = static_cast<std::uint64_t>(
+      nb_buckets == 1 ? 1 : (3 * nb_buckets) / 10 + 1);
+  const std::uint64_t low = x & 0xFFFFFFFFull;
+  if ((x >> 32) < 0x9999999Aull) {
+    return static_cast<il::int_t>((low * nb_dense) >> 32);
+  } else {
+    const std::uint64_t nb_sparse =
+        static_cast<std::uint64_t>(nb_buckets) - nb_dense;
+    return static_cast<il::int_t>(
+        nb_sparse == 0 ? 0 : nb_dense + ((low * nb_sparse) >> 32));
+  }
+}
+
+// The position of a hash in the table for the pilot k
+inline std::uint64_t PerfectHash::position(std::uint64_t h, std::uint64_t k,
+                                           il::int_t m) {
+  return reduce(mix(h ^ (k * 0x9E3779B97F4A7C15ull)), m);
+}
+
+inline il::int_t PerfectHash::slot(std::uint64_t h) const {
+  IL_EXPECT_MEDIUM(n_ > 0);
+
+  const il::int_t b = bucket(h, pilot_.size());
+  const std::uint64_t p = position(h, pilot_[b], m_);
+  return p < static_cast<std::uint64_t>(n_)
+             ? static_cast<il::int_t>(p)
+             : static_cast<il::int_t>(
+                   remap_[static_cast<il::int_t>(p) - n_]);
+}
+
+/* \brief Build the function for the given hashes
+// \details Return false if no function has been found, which happens when
+// two hashes are equal or when they are so badly distributed that a bucket
+// can not be placed in the table. The keys should then be hashed again with
+// another seed.
+*/
+inline bool PerfectHash::Build(const il::Array<std::uint64_t>& hash) {
+  IL_EXPECT_FAST(hash.size() <= 0xFFFFFFFF);
+
+  const il::int_t n = hash.size();
+  n_ = n;
+  if (n == 0) {
+    m_ = 0;
+    pilot_.Resize(0);
+    remap_.Resize(0);
+    return true;
+  }
+  m_ = n + n / 32 + 1;
+  const il::int_t nb_buckets = (n + 3) / 4;
+
+  // Sort the hashes by bucket
+  il::Array<il::int_t> bucket_begin{nb_buckets + 1, 0};
+  for (il::int_t i = 0; i < n; ++i) {
+    ++bucket_begin[bucket(hash[i], nb_buckets) + 1];
+  }
+  il::int_t max_bucket_size = 0;
+  for (il::int_t b = 0; b < nb_buckets; ++b) {
+    if (bucket_begin[b + 1] > max_bucket_size) {
+      max_bucket_size = bucket_begin[b + 1];
+    }
+    bucket_begin[b + 1] += bucket_begin[b];
+  }
+  il::Array<std::uint64_t> bucket_hash{n};
+  {
+    il::Array<il::int_t> next = bucket_begin;
+    for (il::int_t i = 0; i < n; ++i) {
+      const il::int_t b = bucket(hash[i], nb_buckets);
+      bucket_hash[next[b]] = hash[i];
+      ++next[b];
+    }
+  }
+
+  // Sort the buckets from the largest to the smallest
+  il::Array<il::int_t> size_begin{max_bucket_size + 2, 0};
+  for (il::int_t b = 0; b < nb_buckets; ++b) {
+    const il::int_t s = bucket_begin[b + 1] - bucket_begin[b];
+    ++size_begin[max_bucket_size - s + 1];
+  }
+  for (il::int_t s = 0; s <= max_bucket_size; ++s) {
+    size_begin[s + 1] += size_begin[s];
+  }
+  il::Array<il::int_t> bucket_order{nb_buckets};
+  for (il::int_t b = 0; b < nb_buckets; ++b) {
+    const il::int_t s = bucket_begin[b + 1] - bucket_begin[b];
+    bucket_order[size_begin[max_bucket_size - s]] = b;
+    ++size_begin[max_bucket_size - s];
+  }
+
+  // Find a pilot for every bucket. With hashes which are well distributed,
+  // the pilots are small: their average is about 60.
+  const std::uint64_t max_pilot = 1 << 20;
+  pilot_.Resize(nb_buckets);
+  il::Array<unsigned char> taken{m_, 0};
+  il::Array<il::int_t> bucket_position{max_bucket_size};
+  for (il::int_t ib = 0; ib < nb_buckets; ++ib) {
+    const il::int_t b = bucket_order[ib];
+    const il::int_t i_begin = bucket_begin[b];
+    const il::int_t s = bucket_begin[b + 1] - i_begin;
+    if (s == 0) {
+      pilot_[b] = 0;
+      continue;
+    }
+    for (il::int_t j0 = 0; j0 < s; ++j0) {
+      for (il::int_t j1 = j0 + 1; j1 < s; ++j1) {
+        if (bucket_hash[i_begin + j0] == bucket_hash[i_begin + j1]) {
+          return false;
+        }
+      }
+    }
+    std::uint64_t k = 0;
+    while (true) {
+      il::int_t j = 0;
+      while (j < s) {
+        const il::int_t p = static_cast<il::int_t>(
+            position(bucket_hash[i_begin + j], k, m_));
+        if (taken[p] != 0) {
+          break;
+        }
+        taken[p] = 1;
+        bucket_position[j] = p;
+        ++j;
+      }
+      if (j == s) {
+        break;
+      }
+      for (il::int_t jj = 0; jj < j; ++jj) {
+        taken[bucket_position[jj]] = 0;
+      }
+      if (k == max_pilot) {
+        return false;
+      }
+      ++k;
+    }
+    pilot_[b] = static_cast<std::uint32_t>(k);
+  }
+
+  // Map the positions in [n, m) which are used to the free slots
+  remap_.Resize(m_ - n);
+  il::int_t free_slot = 0;
+  for (il::int_t p = n; p < m_; ++p) {
+    if (taken[p] != 0) {
+      while (taken[free_slot] != 0) {
+        ++free_slot;
+      }
+      remap_[p - n] = static_cast<std::uint32_t>(free_slot);
+      ++free_slot;
+    } else {
+      remap_[p - n] = 0;
+    }
+  }
+
+  return true;
+}
+
+inline il::int_t PerfectHash::nbSlots() const { return n_; }
+
+inline il::int_t PerfectHash::nbPositions() const { return m_; }
+
+inline const il::Array<std::uint32_t>& PerfectHash::pilot() const {
+  return pilot_;
+}
+
+inline const il::Array<std::uint32_t>& PerfectHash::remap() const {
+  return remap_;
+}
+
+}  // namespace il
+
+#endif  // IL_PERFECTHASH_H
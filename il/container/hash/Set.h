@@ -20,7 +20,6 @@
 #define IL_SET_H
 
 #include <il/container/hash/HashFunction.h>
-#include <il/container/hash/Spot.h>
 
 namespace il {
 
@@ -41,10 +40,14 @@ class Set {
   ~Set();
 
   il::spot_t search(const T& x) const;
-  void Add(const T& x, il::io_t, il::spot_t i);
+  template <typename U, typename = il::enableIfHeterogeneous<T, U, F>>
+  il::spot_t search(const U& x) const;
+  void Add(const T& x, il::io_t, il::spot_t& i);
   void Add(const T& x);
   bool found(il::spot_t i) const;
   bool contains(const T& x) const;
+  template <typename U, typename = il::enableIfHeterogeneous<T, U, F>>
+  bool contains(const U& x) const;
   void Clear();
   const T& element(il::spot_t i) const;
   il::spot_t spotBegin() const;
@@ -55,6 +58,8 @@ class Set {
  private:
   il::int_t nbBuckets() const;
   il::int_t nbBuckets(int p) const;
+  template <typename U>
+  il::spot_t searchKey(const U& x) const;
   void ReserveWithP(int p);
 };
 
@@ -103,7 +108,7 @@ Set<T, F>& Set<T, F>::operator=(const Set<T, F>& set) {
     if (old_p >= 0) {
       const il::int_t old_m = nbBuckets(old_p);
       for (il::int_t i = 0; i < old_m; ++i) {
-        if (!F::isEmpty(bucket_ + i) && !F::isTombstone(bucket_ + i)) {
+        if (!F::isEmpty(bucket_[i]) && !F::isTombstone(bucket_[i])) {
           (bucket_ + i)->~T();
         }
       }
@@ -137,9 +142,8 @@ Set<T, F>& Set<T, F>::operator=(Set<T, F>&& set) {
     if (old_p >= 0) {
       const il::int_t old_m = nbBuckets(old_p);
       for (il::int_t i = 0; i < old_m; ++i) {
-        if (!F::is_empy(bucket_ + i) && !F::isTombstone(bucket_ + i)) {
-          (&((bucket_ + i)->value))->~V();
-          (&((bucket_ + i)->key))->~K();
+        if (!F::isEmpty(bucket_[i]) && !F::isTombstone(bucket_[i])) {
+          (bucket_ + i)->~T();
         }
       }
       il::deallocate(bucket_);
@@ -174,6 +178,20 @@ il::spot_t Set<T, F>::search(const T& x) const {
   IL_EXPECT_MEDIUM(!F::isEmpty(x));
   IL_EXPECT_MEDIUM(!F::isTombstone(x));
 
+  return searchKey(x);
+}
+
+// Search for an element given with another type than T, such as an
+// il::StringView for an il::Set<il::String>
+template <typename T, typename F>
+template <typename U, typename>
+il::spot_t Set<T, F>::search(const U& x) const {
+  return searchKey(x);
+}
+
+template <typename T, typename F>
+template <typename U>
+il::spot_t Set<T, F>::searchKey(const U& x) const {
   if (p_ == -1) {
     return il::spot_t{};
   }
@@ -241,6 +259,13 @@ bool Set<T, F>::contains(const T& x) const {
   return i.index >= 0;
 }
 
+template <typename T, typename F>
+template <typename U, typename>
+bool Set<T, F>::contains(const U& x) const {
+  const il::spot_t i = search(x);
+  return i.index >= 0;
+}
+
 template <typename T, typename F>
 void Set<T, F>::Clear() {
   if (p_ >= 0) {
@@ -249,9 +274,11 @@ void Set<T, F>::Clear() {
       if (!F::isEmpty(bucket_[i]) && !F::isTombstone(bucket_[i])) {
         (bucket_ + i)->~T();
       }
+      F::constructEmpty(il::io, bucket_ + i);
     }
   }
   nb_elements_ = 0;
+  nb_tombstones_ = 0;
 }
 
 template <typename T, typename F>
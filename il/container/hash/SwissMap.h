@@ -0,0 +1,625 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#ifndef IL_SWISSMAP_H
+#define IL_SWISSMAP_H
+
+// <cstring> is needed for std::memcpy and std::memset
+#include <cstring>
+// <utility> is needed for std::forward
+#include <utility>
+
+#include <il/container/hash/ControlGroup.h>
+#include <il/container/hash/HashFunction.h>
+#include <il/container/hash/Map.h>
+
+namespace il {
+
+// il::SwissMap has the same interface as il::Map, but it stores one control
+// byte per bucket next to the buckets. The control byte tells if the bucket
+// is empty, deleted or full, and in the later case it also stores 7 bits of
+// the hash of the key. A search compares 16 control bytes at once and only
+// looks at the keys whose 7 bits match, which is 1 out of 128 for the other
+// keys. A search for a key that is not in the map usually stops at the first
+// group of 16 control bytes, without reading any key.
+//
+// The hash function F must provide hash and isEqual. As empty and deleted
+// buckets are known from the control bytes, it does not need the special
+// values of the keys used by il::Map. The map can be filled up to 7/8 of its
+// buckets, and it has at least 16 buckets.
+//
+// The number of buckets is m = 2^p, and they are split into m / 16 groups.
+// A key is looked for in the group given by the p - 4 high bits of its hash
+// and then in the following groups with quadratic probing, until a group
+// with an empty bucket is found.
+
+template <typename K, typename V, typename F = HashFunction<K>>
+class SwissMap {
+ private:
+  signed char* control_;
+  KeyValue<K, V>* bucket_;
+  il::int_t nb_elements_;
+  il::int_t nb_tombstones_;
+  int p_;
+  std::size_t seed_;
+
+ public:
+  SwissMap();
+  SwissMap(il::int_t n);
+  SwissMap(il::int_t n, std::size_t seed);
+  SwissMap(il::value_t, std::initializer_list<il::KeyValue<K, V>> list);
+  SwissMap(const SwissMap<K, V, F>& map);
+  SwissMap(SwissMap<K, V, F>&& map);
+  SwissMap& operator=(const SwissMap<K, V, F>& map);
+  SwissMap& operator=(SwissMap<K, V, F>&& map);
+  ~SwissMap();
+
+  // All the insertions
+  void Set(const K& key, const V& value);
+  void Set(const K& key, V&& value);
+  void Set(K&& key, const V& value);
+  void Set(K&& key, V&& value);
+
+  // Searching for a key
+  il::spot_t search(const K& key) const;
+  template <typename T, typename = il::enableIfHeterogeneous<K, T, F>>
+  il::spot_t search(const T& key) const;
+  template <il::int_t m>
+  il::spot_t searchCString(const char (&key)[m]) const;
+  il::spot_t searchCString(const char* key, il::int_t n) const;
+  bool found(il::spot_t i) const;
+
+  // Inserting a new (key, value)
+  void Set(const K& key, const V& value, il::io_t, il::spot_t& i);
+  void Set(const K& key, V&& value, il::io_t, il::spot_t& i);
+  void Set(K&& key, const V& value, il::io_t, il::spot_t& i);
+  void Set(K&& key, V&& value, il::io_t, il::spot_t& i);
+
+  // Getting the key and values for a given slot
+  const K& key(il::spot_t i) const;
+  const V& value(il::spot_t i) const;
+  V& Value(il::spot_t i);
+  const V& valueForKey(const K& key, const V& default_value) const;
+  template <typename T, typename = il::enableIfHeterogeneous<K, T, F>>
+  const V& valueForKey(const T& key, const V& default_value) const;
+
+  void erase(il::spot_t i);
+
+  // Changing the size
+  void Clear();
+  bool isEmpty() const;
+  il::int_t nbElements() const;
+  il::int_t nbTombstones() const;
+  il::int_t nbBuckets() const;
+  std::size_t seed() const;
+  void Reserve(il::int_t n);
+
+  // Looping over the map
+  il::spot_t spotBegin() const;
+  il::spot_t spotEnd() const;
+  il::spot_t next(il::spot_t i) const;
+
+ private:
+  static int pForSlots(il::int_t n);
+  static il::int_t nbBuckets(int p);
+  template <typename E>
+  il::spot_t searchWithHash(std::size_t h, const E& is_equal) const;
+  template <typename KK, typename VV>
+  void Insert(KK&& key, VV&& value, il::io_t, il::spot_t& i);
+  void Allocate(int p);
+  void ReserveWithP(int p);
+};
+
+template <typename K, typename V, typename F>
+int SwissMap<K, V, F>::pForSlots(il::int_t n) {
+  IL_EXPECT_FAST(n >= 0);
+
+  if (n == 0) {
+    return -1;
+  }
+  // We want n <= (7 / 8) 2^p
+  int p = 4;
+  while (8 * static_cast<std::size_t>(n) >
+         7 * (static_cast<std::size_t>(1) << p)) {
+    ++p;
+  }
+  return p;
+}
+
+template <typename K, typename V, typename F>
+il::int_t SwissMap<K, V, F>::nbBuckets(int p) {
+  return (p >= 0) ? static_cast<il::int_t>(static_cast<std::size_t>(1) << p)
+                  : 0;
+}
+
+template <typename K, typename V, typename F>
+void SwissMap<K, V, F>::Allocate(int p) {
+  // The 7 bits of the control bytes are taken from the hash, which must
+  // have p - 4 + 7 bits
+  if (p > static_cast<int>(8 * sizeof(std::size_t)) - 8) {
+    il::abort();
+  }
+  const il::int_t m = nbBuckets(p);
+  control_ = il::allocateArray<signed char>(m);
+  std::memset(control_, il::control_empty, static_cast<std::size_t>(m));
+  bucket_ = il::allocateArray<KeyValue<K, V>>(m);
+  p_ = p;
+}
+
+template <typename K, typename V, typename F>
+SwissMap<K, V, F>::SwissMap() : SwissMap{0, 0} {}
+
+template <typename K, typename V, typename F>
+SwissMap<K, V, F>::SwissMap(il::int_t n) : SwissMap{n, 0} {}
+
+template <typename K, typename V, typename F>
+SwissMap<K, V, F>::SwissMap(il::int_t n, std::size_t seed) {
+  IL_EXPECT_FAST(n >= 0);
+
+  const int p = pForSlots(n);
+  if (p >= 0) {
+    Allocate(p);
+  } else {
+    control_ = nullptr;
+    bucket_ = nullptr;
+    p_ = -1;
+  }
+  nb_elements_ = 0;
+  nb_tombstones_ = 0;
+  seed_ = seed;
+}
+
+template <typename K, typename V, typename F>
+SwissMap<K, V, F>::SwissMap(il::value_t,
+                            std::initializer_list<il::KeyValue<K, V>> list)
+    : SwissMap{static_cast<il::int_t>(list.size()), 0} {
+  for (auto it = list.begin(); it != list.end(); ++it) {
+    il::spot_t i = search(it->key);
+    IL_EXPECT_FAST(!found(i));
+    Set(it->key, it->value, il::io, i);
+  }
+}
+
+template <typename K, typename V, typename F>
+SwissMap<K, V, F>::SwissMap(const SwissMap<K, V, F>& map) {
+  // Same number of buckets and same seed: every key stays in its bucket
+  if (map.p_ >= 0) {
+    Allocate(map.p_);
+    const il::int_t m = nbBuckets();
+    std::memcpy(control_, map.control_, static_cast<std::size_t>(m));
+    for (il::int_t i = 0; i < m; ++i) {
+      if (control_[i] >= 0) {
+        new (bucket_ + i) KeyValue<K, V>(map.bucket_[i].key,
+                                         map.bucket_[i].value);
+      }
+    }
+  } else {
+    control_ = nullptr;
+    bucket_ = nullptr;
+    p_ = -1;
+  }
+  nb_elements_ = map.nb_elements_;
+  nb_tombstones_ = map.nb_tombstones_;
+  seed_ = map.seed_;
+}
+
+template <typename K, typename V, typename F>
+SwissMap<K, V, F>::SwissMap(SwissMap<K, V, F>&& map) {
+  control_ = map.control_;
+  bucket_ = map.bucket_;
+  nb_elements_ = map.nb_elements_;
+  nb_tombstones_ = map.nb_tombstones_;
+  p_ = map.p_;
+  seed_ = map.seed_;
+  map.control_ = nullptr;
+  map.bucket_ = nullptr;
+  map.nb_elements_ = 0;
+  map.nb_tombstones_ = 0;
+  map.p_ = -1;
+}
+
+template <typename K, typename V, typename F>
+SwissMap<K, V, F>& SwissMap<K, V, F>::operator=(const SwissMap<K, V, F>& map) {
+  if (this != &map) {
+    SwissMap<K, V, F> copy{map};
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+template <typename K, typename V, typename F>
+SwissMap<K, V, F>& SwissMap<K, V, F>::operator=(SwissMap<K, V, F>&& map) {
+  if (this != &map) {
+    this->~SwissMap();
+    control_ = map.control_;
+    bucket_ = map.bucket_;
+    nb_elements_ = map.nb_elements_;
+    nb_tombstones_ = map.nb_tombstones_;
+    p_ = map.p_;
+    seed_ = map.seed_;
+    map.control_ = nullptr;
+    map.bucket_ = nullptr;
+    map.nb_elements_ = 0;
+    map.nb_tombstones_ = 0;
+    map.p_ = -1;
+  }
+  return *this;
+}
+
+template <typename K, typename V, typename F>
+SwissMap<K, V, F>::~SwissMap() {
+  if (p_ >= 0) {
+    const il::int_t m = nbBuckets();
+    for (il::int_t i = 0; i < m; ++i) {
+      if (control_[i] >= 0) {
+        (bucket_ + i)->~KeyValue<K, V>();
+      }
+    }
+    il::deallocate(bucket_);
+    il::deallocate(control_);
+  }
+}
+
+template <typename K, typename V, typename F>
+void SwissMap<K, V, F>::Set(const K& key, const V& value) {
+  il::spot_t i = search(key);
+  if (!found(i)) {
+    Set(key, value, il::io, i);
+  } else {
+    bucket_[i.index].value = value;
+  }
+}
+
+template <typename K, typename V, typename F>
+void SwissMap<K, V, F>::Set(const K& key, V&& value) {
+  il::spot_t i = search(key);
+  if (!found(i)) {
+    Set(key, std::move(value), il::io, i);
+  } else {
+    bucket_[i.index].value = std::move(value);
+  }
+}
+
+template <typename K, typename V, typename F>
+void SwissMap<K, V, F>::Set(K&& key, const V& value) {
+  il::spot_t i = search(key);
+  if (!found(i)) {
+    Set(std::move(key), value, il::io, i);
+  } else {
+    bucket_[i.index].value = value;
+  }
+}
+
+template <typename K, typename V, typename F>
+void SwissMap<K, V, F>::Set(K&& key, V&& value) {
+  il::spot_t i = search(key);
+  if (!found(i)) {
+    Set(std::move(key), std::move(value), il::io, i);
+  } else {
+    bucket_[i.index].value = std::move(value);
+  }
+}
+
+// When the key is not found, the returned index is -(1 + (j * 128 + h))
+// where j is the bucket where the key should be inserted and h the 7 bits of
+// its hash for the control byte.
+template <typename K, typename V, typename F>
+template <typename E>
+il::spot_t SwissMap<K, V, F>::searchWithHash(std::size_t h,
+                                             const E& is_equal) const {
+  const signed char h7 = static_cast<signed char>(h & 0x7F);
+  const std::size_t group_mask =
+      (static_cast<std::size_t>(1) << (p_ - 4)) - 1;
+  std::size_t g = (h >> 7) & group_mask;
+  std::size_t delta_g = 0;
+  std::size_t i_insert = static_cast<std::size_t>(-1);
+  while (true) {
+    const signed char* control = control_ + g * il::ControlGroup::size;
+    const il::ControlGroup group{control};
+    for (std::uint32_t mask = group.match(h7); mask != 0; mask &= mask - 1) {
+      const std::size_t i = g * il::ControlGroup::size + il::lowestBit(mask);
+      if (is_equal(bucket_[i].key)) {
+        return il::spot_t{static_cast<il::int_t>(i)};
+      }
+    }
+    if (i_insert == static_cast<std::size_t>(-1)) {
+      const std::uint32_t mask = group.matchEmptyOrDeleted();
+      if (mask != 0) {
+        i_insert = g * il::ControlGroup::size + il::lowestBit(mask);
+      }
+    }
+    if (group.matchEmpty() != 0) {
+      return il::spot_t{
+          -(1 + static_cast<il::int_t>((i_insert << 7) |
+                                       static_cast<std::size_t>(h7)))};
+    }
+    ++delta_g;
+    g = (g + delta_g) & group_mask;
+  }
+}
+
+template <typename K, typename V, typename F>
+il::spot_t SwissMap<K, V, F>::search(const K& key) const {
+  if (p_ == -1) {
+    return il::spot_t{-1};
+  }
+  const std::size_t h = il::hashSeeded<F>(key, p_ + 3, seed_);
+  return searchWithHash(h, [&key](const K& k) { return F::isEqual(k, key); });
+}
+
+// Search for a key given with another type than K, such as an il::StringView
+// for an il::SwissMap<il::String, V>
+template <typename K, typename V, typename F>
+template <typename T, typename>
+il::spot_t SwissMap<K, V, F>::search(const T& key) const {
+  if (p_ == -1) {
+    return il::spot_t{-1};
+  }
+  const std::size_t h = il::hashSeeded<F>(key, p_ + 3, seed_);
+  return searchWithHash(h, [&key](const K& k) { return F::isEqual(k, key); });
+}
+
+template <typename K, typename V, typename F>
+template <il::int_t m>
+il::spot_t SwissMap<K, V, F>::searchCString(const char (&key)[m]) const {
+  if (p_ == -1) {
+    return il::spot_t{-1};
+  }
+  const std::size_t h = il::hashSeeded<F>(key, p_ + 3, seed_);
+  return searchWithHash(h, [&key](const K& k) { return F::isEqual(k, key); });
+}
+
+template <typename K, typename V, typename F>
+il::spot_t SwissMap<K, V, F>::searchCString(const char* key,
+                                            il::int_t n) const {
+  if (p_ == -1) {
+    return il::spot_t{-1};
+  }
+  const std::size_t h = F::hash(key, n, p_ + 3, seed_);
+  return searchWithHash(
+      h, [key, n](const K& k) { return F::isEqual(k, key, n); });
+}
+
+template <typename K, typename V, typename F>
+bool SwissMap<K, V, F>::found(il::spot_t i) const {
+  return i.index >= 0;
+}
+
+template <typename K, typename V, typename F>
+template <typename KK, typename VV>
+void SwissMap<K, V, F>::Insert(KK&& key, VV&& value, il::io_t, il::spot_t& i) {
+  IL_EXPECT_FAST(!found(i));
+
+  std::size_t code = static_cast<std::size_t>(-(1 + i.index));
+  if (p_ == -1 ||
+      (control_[code >> 7] == il::control_empty &&
+       8 * static_cast<std::size_t>(nb_elements_ + nb_tombstones_ + 1) >
+           7 * static_cast<std::size_t>(nbBuckets()))) {
+    // Rebuild the table in place when it is mostly filled with tombstones,
+    // and double its number of buckets otherwise
+    const int p =
+        (p_ >= 0 && 32 * static_cast<std::size_t>(nb_elements_ + 1) <=
+                        25 * static_cast<std::size_t>(nbBuckets()))
+            ? p_
+            : pForSlots(2 * (nb_elements_ + 1));
+    ReserveWithP(p);
+    code = static_cast<std::size_t>(-(1 + search(key).index));
+  }
+  const std::size_t j = code >> 7;
+  if (control_[j] == il::control_deleted) {
+    --nb_tombstones_;
+  }
+  control_[j] = static_cast<signed char>(code & 0x7F);
+  new (bucket_ + j)
+      KeyValue<K, V>(std::forward<KK>(key), std::forward<VV>(value));
+  ++nb_elements_;
+  i.index = static_cast<il::int_t>(j);
+}
+
+template <typename K, typename V, typename F>
+void SwissMap<K, V, F>::Set(const K& key, const V& value, il::io_t,
+                            il::spot_t& i) {
+  Insert(key, value, il::io, i);
+}
+
+template <typename K, typename V, typename F>
+void SwissMap<K, V, F>::Set(const K& key, V&& value, il::io_t, il::spot_t& i) {
+  Insert(key, std::move(value), il::io, i);
+}
+
+template <typename K, typename V, typename F>
+void SwissMap<K, V, F>::Set(K&& key, const V& value, il::io_t, il::spot_t& i) {
+  Insert(std::move(key), value, il::io, i);
+}
+
+template <typename K, typename V, typename F>
+void SwissMap<K, V, F>::Set(K&& key, V&& value, il::io_t, il::spot_t& i) {
+  Insert(std::move(key), std::move(value), il::io, i);
+}
+
+template <typename K, typename V, typename F>
+const K& SwissMap<K, V, F>::key(il::spot_t i) const {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i.index) <
+                   static_cast<std::size_t>(nbBuckets()));
+  IL_EXPECT_MEDIUM(control_[i.index] >= 0);
+
+  return bucket_[i.index].key;
+}
+
+template <typename K, typename V, typename F>
+const V& SwissMap<K, V, F>::value(il::spot_t i) const {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i.index) <
+                   static_cast<std::size_t>(nbBuckets()));
+  IL_EXPECT_MEDIUM(control_[i.index] >= 0);
+
+  return bucket_[i.index].value;
+}
+
+template <typename K, typename V, typename F>
+V& SwissMap<K, V, F>::Value(il::spot_t i) {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i.index) <
+                   static_cast<std::size_t>(nbBuckets()));
+  IL_EXPECT_MEDIUM(control_[i.index] >= 0);
+
+  return bucket_[i.index].value;
+}
+
+template <typename K, typename V, typename F>
+const V& SwissMap<K, V, F>::valueForKey(const K& key,
+                                        const V& default_value) const {
+  const il::spot_t i = search(key);
+  return found(i) ? bucket_[i.index].value : default_value;
+}
+
+template <typename K, typename V, typename F>
+template <typename T, typename>
+const V& SwissMap<K, V, F>::valueForKey(const T& key,
+                                        const V& default_value) const {
+  const il::spot_t i = search(key);
+  return found(i) ? bucket_[i.index].value : default_value;
+}
+
+template <typename K, typename V, typename F>
+void SwissMap<K, V, F>::erase(il::spot_t i) {
+  IL_EXPECT_FAST(found(i));
+  IL_EXPECT_MEDIUM(control_[i.index] >= 0);
+
+  (bucket_ + i.index)->~KeyValue<K, V>();
+  // A group with an empty bucket has never been full since the last
+  // rehash, so that no search has gone past it and its buckets can be
+  // emptied. Otherwise, a tombstone keeps the probe sequences going.
+  const il::int_t g = i.index / il::ControlGroup::size;
+  const il::ControlGroup group{control_ + g * il::ControlGroup::size};
+  if (group.matchEmpty() != 0) {
+    control_[i.index] = il::control_empty;
+  } else {
+    control_[i.index] = il::control_deleted;
+    ++nb_tombstones_;
+  }
+  --nb_elements_;
+}
+
+template <typename K, typename V, typename F>
+void SwissMap<K, V, F>::Clear() {
+  if (p_ >= 0) {
+    const il::int_t m = nbBuckets();
+    for (il::int_t i = 0; i < m; ++i) {
+      if (control_[i] >= 0) {
+        (bucket_ + i)->~KeyValue<K, V>();
+      }
+    }
+    std::memset(control_, il::control_empty, static_cast<std::size_t>(m));
+  }
+  nb_elements_ = 0;
+  nb_tombstones_ = 0;
+}
+
+template <typename K, typename V, typename F>
+bool SwissMap<K, V, F>::isEmpty() const {
+  return nb_elements_ == 0;
+}
+
+template <typename K, typename V, typename F>
+il::int_t SwissMap<K, V, F>::nbElements() const {
+  return nb_elements_;
+}
+
+template <typename K, typename V, typename F>
+il::int_t SwissMap<K, V, F>::nbTombstones() const {
+  return nb_tombstones_;
+}
+
+template <typename K, typename V, typename F>
+il::int_t SwissMap<K, V, F>::nbBuckets() const {
+  return nbBuckets(p_);
+}
+
+template <typename K, typename V, typename F>
+std::size_t SwissMap<K, V, F>::seed() const {
+  return seed_;
+}
+
+template <typename K, typename V, typename F>
+void SwissMap<K, V, F>::Reserve(il::int_t n) {
+  IL_EXPECT_FAST(n >= 0);
+
+  const int p = pForSlots(n);
+  if (p > p_) {
+    ReserveWithP(p);
+  }
+}
+
+template <typename K, typename V, typename F>
+il::spot_t SwissMap<K, V, F>::spotBegin() const {
+  return next(il::spot_t{-1});
+}
+
+template <typename K, typename V, typename F>
+il::spot_t SwissMap<K, V, F>::spotEnd() const {
+  return il::spot_t{nbBuckets()};
+}
+
+template <typename K, typename V, typename F>
+il::spot_t SwissMap<K, V, F>::next(il::spot_t i) const {
+  const il::int_t m = nbBuckets();
+  il::int_t i_local = i.index + 1;
+  while (i_local < m && control_[i_local] < 0) {
+    ++i_local;
+  }
+  return il::spot_t{i_local};
+}
+
+template <typename K, typename V, typename F>
+void SwissMap<K, V, F>::ReserveWithP(int p) {
+  signed char* old_control = control_;
+  KeyValue<K, V>* old_bucket = bucket_;
+  const il::int_t old_m = nbBuckets();
+
+  Allocate(p);
+  nb_tombstones_ = 0;
+  // The keys are all different: look for an empty bucket without comparing
+  // them
+  const std::size_t group_mask = (static_cast<std::size_t>(1) << (p_ - 4)) - 1;
+  for (il::int_t i = 0; i < old_m; ++i) {
+    if (old_control[i] >= 0) {
+      const std::size_t h =
+          il::hashSeeded<F>(old_bucket[i].key, p_ + 3, seed_);
+      std::size_t g = (h >> 7) & group_mask;
+      std::size_t delta_g = 0;
+      std::uint32_t mask;
+      while ((mask = il::ControlGroup{control_ + g * il::ControlGroup::size}
+                         .matchEmpty()) == 0) {
+        ++delta_g;
+        g = (g + delta_g) & group_mask;
+      }
+      const std::size_t j = g * il::ControlGroup::size + il::lowestBit(mask);
+      control_[j] = static_cast<signed char>(h & 0x7F);
+      new (bucket_ + j) KeyValue<K, V>(std::move(old_bucket[i].key),
+                                       std::move(old_bucket[i].value));
+      (old_bucket + i)->~KeyValue<K, V>();
+    }
+  }
+  if (old_m > 0) {
+    il::deallocate(old_bucket);
+    il::deallocate(old_control);
+  }
+}
+
+}  // namespace il
+
+#endif  // IL_SWISSMAP_H
@@ -0,0 +1,482 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#ifndef IL_SWISSSET_H
+#define IL_SWISSSET_H
+
+// <cstring> is needed for std::memcpy and std::memset
+#include <cstring>
+// <utility> is needed for std::forward
+#include <utility>
+
+#include <il/container/hash/ControlGroup.h>
+#include <il/container/hash/HashFunction.h>
+
+namespace il {
+
+// il::SwissSet has the same interface as il::Set and the same layout as
+// il::SwissMap: one control byte per bucket, with 7 bits of the hash of the
+// element for the full buckets, probed 16 at a time.
+
+template <typename T, typename F = HashFunction<T>>
+class SwissSet {
+ private:
+  signed char* control_;
+  T* bucket_;
+  il::int_t nb_elements_;
+  il::int_t nb_tombstones_;
+  int p_;
+  std::size_t seed_;
+
+ public:
+  SwissSet();
+  SwissSet(il::int_t n);
+  SwissSet(il::int_t n, std::size_t seed);
+  SwissSet(const SwissSet<T, F>& set);
+  SwissSet(SwissSet<T, F>&& set);
+  SwissSet& operator=(const SwissSet<T, F>& set);
+  SwissSet& operator=(SwissSet<T, F>&& set);
+  ~SwissSet();
+
+  il::spot_t search(const T& x) const;
+  template <typename U, typename = il::enableIfHeterogeneous<T, U, F>>
+  il::spot_t search(const U& x) const;
+  void Add(const T& x, il::io_t, il::spot_t& i);
+  void Add(T&& x, il::io_t, il::spot_t& i);
+  void Add(const T& x);
+  void Add(T&& x);
+  bool found(il::spot_t i) const;
+  bool contains(const T& x) const;
+  template <typename U, typename = il::enableIfHeterogeneous<T, U, F>>
+  bool contains(const U& x) const;
+  const T& element(il::spot_t i) const;
+  void erase(il::spot_t i);
+
+  void Clear();
+  bool isEmpty() const;
+  il::int_t nbElements() const;
+  il::int_t nbTombstones() const;
+  il::int_t nbBuckets() const;
+  std::size_t seed() const;
+  void Reserve(il::int_t n);
+
+  il::spot_t spotBegin() const;
+  il::spot_t spotEnd() const;
+  il::spot_t next(il::spot_t i) const;
+
+ private:
+  static int pForSlots(il::int_t n);
+  static il::int_t nbBuckets(int p);
+  template <typename U>
+  il::spot_t searchKey(const U& x) const;
+  template <typename TT>
+  void Insert(TT&& x, il::io_t, il::spot_t& i);
+  void Allocate(int p);
+  void ReserveWithP(int p);
+};
+
+template <typename T, typename F>
+int SwissSet<T, F>::pForSlots(il::int_t n) {
+  IL_EXPECT_FAST(n >= 0);
+
+  if (n == 0) {
+    return -1;
+  }
+  // We want n <= (7 / 8) 2^p
+  int p = 4;
+  while (8 * static_cast<std::size_t>(n) >
+         7 * (static_cast<std::size_t>(1) << p)) {
+    ++p;
+  }
+  return p;
+}
+
+template <typename T, typename F>
+il::int_t SwissSet<T, F>::nbBuckets(int p) {
+  return (p >= 0) ? static_cast<il::int_t>(static_cast<std::size_t>(1) << p)
+                  : 0;
+}
+
+template <typename T, typename F>
+void SwissSet<T, F>::Allocate(int p) {
+  if (p > static_cast<int>(8 * sizeof(std::size_t)) - 8) {
+    il::abort();
+  }
+  const il::int_t m = nbBuckets(p);
+  control_ = il::allocateArray<signed char>(m);
+  std::memset(control_, il::control_empty, static_cast<std::size_t>(m));
+  bucket_ = il::allocateArray<T>(m);
+  p_ = p;
+}
+
+template <typename T, typename F>
+SwissSet<T, F>::SwissSet() : SwissSet{0, 0} {}
+
+template <typename T, typename F>
+SwissSet<T, F>::SwissSet(il::int_t n) : SwissSet{n, 0} {}
+
+template <typename T, typename F>
+SwissSet<T, F>::SwissSet(il::int_t n, std::size_t seed) {
+  IL_EXPECT_FAST(n >= 0);
+
+  const int p = pForSlots(n);
+  if (p >= 0) {
+    Allocate(p);
+  } else {
+    control_ = nullptr;
+    bucket_ = nullptr;
+    p_ = -1;
+  }
+  nb_elements_ = 0;
+  nb_tombstones_ = 0;
+  seed_ = seed;
+}
+
+template <typename T, typename F>
+SwissSet<T, F>::SwissSet(const SwissSet<T, F>& set) {
+  if (set.p_ >= 0) {
+    Allocate(set.p_);
+    const il::int_t m = nbBuckets();
+    std::memcpy(control_, set.control_, static_cast<std::size_t>(m));
+    for (il::int_t i = 0; i < m; ++i) {
+      if (control_[i] >= 0) {
+        new (bucket_ + i) T(set.bucket_[i]);
+      }
+    }
+  } else {
+    control_ = nullptr;
+    bucket_ = nullptr;
+    p_ = -1;
+  }
+  nb_elements_ = set.nb_elements_;
+  nb_tombstones_ = set.nb_tombstones_;
+  seed_ = set.seed_;
+}
+
+template <typename T, typename F>
+SwissSet<T, F>::SwissSet(SwissSet<T, F>&& set) {
+  control_ = set.control_;
+  bucket_ = set.bucket_;
+  nb_elements_ = set.nb_elements_;
+  nb_tombstones_ = set.nb_tombstones_;
+  p_ = set.p_;
+  seed_ = set.seed_;
+  set.control_ = nullptr;
+  set.bucket_ = nullptr;
+  set.nb_elements_ = 0;
+  set.nb_tombstones_ = 0;
+  set.p_ = -1;
+}
+
+template <typename T, typename F>
+SwissSet<T, F>& SwissSet<T, F>::operator=(const SwissSet<T, F>& set) {
+  if (this != &set) {
+    SwissSet<T, F> copy{set};
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+template <typename T, typename F>
+SwissSet<T, F>& SwissSet<T, F>::operator=(SwissSet<T, F>&& set) {
+  if (this != &set) {
+    this->~SwissSet();
+    control_ = set.control_;
+    bucket_ = set.bucket_;
+    nb_elements_ = set.nb_elements_;
+    nb_tombstones_ = set.nb_tombstones_;
+    p_ = set.p_;
+    seed_ = set.seed_;
+    set.control_ = nullptr;
+    set.bucket_ = nullptr;
+    set.nb_elements_ = 0;
+    set.nb_tombstones_ = 0;
+    set.p_ = -1;
+  }
+  return *this;
+}
+
+template <typename T, typename F>
+SwissSet<T, F>::~SwissSet() {
+  if (p_ >= 0) {
+    const il::int_t m = nbBuckets();
+    for (il::int_t i = 0; i < m; ++i) {
+      if (control_[i] >= 0) {
+        (bucket_ + i)->~T();
+      }
+    }
+    il::deallocate(bucket_);
+    il::deallocate(control_);
+  }
+}
+
+// When x is not found, the returned index is -(1 + (j * 128 + h)) where j is
+// the bucket where x should be inserted and h the 7 bits of its hash.
+template <typename T, typename F>
+template <typename U>
+il::spot_t SwissSet<T, F>::searchKey(const U& x) const {
+  if (p_ == -1) {
+    return il::spot_t{-1};
+  }
+
+  const std::size_t h = il::hashSeeded<F>(x, p_ + 3, seed_);
+  const signed char h7 = static_cast<signed char>(h & 0x7F);
+  const std::size_t group_mask =
+      (static_cast<std::size_t>(1) << (p_ - 4)) - 1;
+  std::size_t g = (h >> 7) & group_mask;
+  std::size_t delta_g = 0;
+  std::size_t i_insert = static_cast<std::size_t>(-1);
+  while (true) {
+    const il::ControlGroup group{control_ + g * il::ControlGroup::size};
+    for (std::uint32_t mask = group.match(h7); mask != 0; mask &= mask - 1) {
+      const std::size_t i = g * il::ControlGroup::size + il::lowestBit(mask);
+      if (F::isEqual(bucket_[i], x)) {
+        return il::spot_t{static_cast<il::int_t>(i)};
+      }
+    }
+    if (i_insert == static_cast<std::size_t>(-1)) {
+      const std::uint32_t mask = group.matchEmptyOrDeleted();
+      if (mask != 0) {
+        i_insert = g * il::ControlGroup::size + il::lowestBit(mask);
+      }
+    }
+    if (group.matchEmpty() != 0) {
+      return il::spot_t{
+          -(1 + static_cast<il::int_t>((i_insert << 7) |
+                                       static_cast<std::size_t>(h7)))};
+    }
+    ++delta_g;
+    g = (g + delta_g) & group_mask;
+  }
+}
+
+template <typename T, typename F>
+il::spot_t SwissSet<T, F>::search(const T& x) const {
+  return searchKey(x);
+}
+
+// Search for an element given with another type than T, such as an
+// il::StringView for an il::SwissSet<il::String>
+template <typename T, typename F>
+template <typename U, typename>
+il::spot_t SwissSet<T, F>::search(const U& x) const {
+  return searchKey(x);
+}
+
+template <typename T, typename F>
+template <typename TT>
+void SwissSet<T, F>::Insert(TT&& x, il::io_t, il::spot_t& i) {
+  IL_EXPECT_FAST(!found(i));
+
+  std::size_t code = static_cast<std::size_t>(-(1 + i.index));
+  if (p_ == -1 ||
+      (control_[code >> 7] == il::control_empty &&
+       8 * static_cast<std::size_t>(nb_elements_ + nb_tombstones_ + 1) >
+           7 * static_cast<std::size_t>(nbBuckets()))) {
+    const int p =
+        (p_ >= 0 && 32 * static_cast<std::size_t>(nb_elements_ + 1) <=
+                        25 * static_cast<std::size_t>(nbBuckets()))
+            ? p_
+            : pForSlots(2 * (nb_elements_ + 1));
+    ReserveWithP(p);
+    code = static_cast<std::size_t>(-(1 + search(x).index));
+  }
+  const std::size_t j = code >> 7;
+  if (control_[j] == il::control_deleted) {
+    --nb_tombstones_;
+  }
+  control_[j] = static_cast<signed char>(code & 0x7F);
+  new (bucket_ + j) T(std::forward<TT>(x));
+  ++nb_elements_;
+  i.index = static_cast<il::int_t>(j);
+}
+
+template <typename T, typename F>
+void SwissSet<T, F>::Add(const T& x, il::io_t, il::spot_t& i) {
+  Insert(x, il::io, i);
+}
+
+template <typename T, typename F>
+void SwissSet<T, F>::Add(T&& x, il::io_t, il::spot_t& i) {
+  Insert(std::move(x), il::io, i);
+}
+
+template <typename T, typename F>
+void SwissSet<T, F>::Add(const T& x) {
+  il::spot_t i = search(x);
+  if (!found(i)) {
+    Insert(x, il::io, i);
+  }
+}
+
+template <typename T, typename F>
+void SwissSet<T, F>::Add(T&& x) {
+  il::spot_t i = search(x);
+  if (!found(i)) {
+    Insert(std::move(x), il::io, i);
+  }
+}
+
+template <typename T, typename F>
+bool SwissSet<T, F>::found(il::spot_t i) const {
+  return i.index >= 0;
+}
+
+template <typename T, typename F>
+bool SwissSet<T, F>::contains(const T& x) const {
+  return found(search(x));
+}
+
+template <typename T, typename F>
+template <typename U, typename>
+bool SwissSet<T, F>::contains(const U& x) const {
+  return found(search(x));
+}
+
+template <typename T, typename F>
+const T& SwissSet<T, F>::element(il::spot_t i) const {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i.index) <
+                   static_cast<std::size_t>(nbBuckets()));
+  IL_EXPECT_MEDIUM(control_[i.index] >= 0);
+
+  return bucket_[i.index];
+}
+
+template <typename T, typename F>
+void SwissSet<T, F>::erase(il::spot_t i) {
+  IL_EXPECT_FAST(found(i));
+  IL_EXPECT_MEDIUM(control_[i.index] >= 0);
+
+  (bucket_ + i.index)->~T();
+  // See il::SwissMap::erase
+  const il::int_t g = i.index / il::ControlGroup::size;
+  const il::ControlGroup group{control_ + g * il::ControlGroup::size};
+  if (group.matchEmpty() != 0) {
+    control_[i.index] = il::control_empty;
+  } else {
+    control_[i.index] = il::control_deleted;
+    ++nb_tombstones_;
+  }
+  --nb_elements_;
+}
+
+template <typename T, typename F>
+void SwissSet<T, F>::Clear() {
+  if (p_ >= 0) {
+    const il::int_t m = nbBuckets();
+    for (il::int_t i = 0; i < m; ++i) {
+      if (control_[i] >= 0) {
+        (bucket_ + i)->~T();
+      }
+    }
+    std::memset(control_, il::control_empty, static_cast<std::size_t>(m));
+  }
+  nb_elements_ = 0;
+  nb_tombstones_ = 0;
+}
+
+template <typename T, typename F>
+bool SwissSet<T, F>::isEmpty() const {
+  return nb_elements_ == 0;
+}
+
+template <typename T, typename F>
+il::int_t SwissSet<T, F>::nbElements() const {
+  return nb_elements_;
+}
+
+template <typename T, typename F>
+il::int_t SwissSet<T, F>::nbTombstones() const {
+  return nb_tombstones_;
+}
+
+template <typename T, typename F>
+il::int_t SwissSet<T, F>::nbBuckets() const {
+  return nbBuckets(p_);
+}
+
+template <typename T, typename F>
+std::size_t SwissSet<T, F>::seed() const {
+  return seed_;
+}
+
+template <typename T, typename F>
+void SwissSet<T, F>::Reserve(il::int_t n) {
+  IL_EXPECT_FAST(n >= 0);
+
+  const int p = pForSlots(n);
+  if (p > p_) {
+    ReserveWithP(p);
+  }
+}
+
+template <typename T, typename F>
+il::spot_t SwissSet<T, F>::spotBegin() const {
+  return next(il::spot_t{-1});
+}
+
+template <typename T, typename F>
+il::spot_t SwissSet<T, F>::spotEnd() const {
+  return il::spot_t{nbBuckets()};
+}
+
+template <typename T, typename F>
+il::spot_t SwissSet<T, F>::next(il::spot_t i) const {
+  const il::int_t m = nbBuckets();
+  il::int_t i_local = i.index + 1;
+  while (i_local < m && control_[i_local] < 0) {
+    ++i_local;
+  }
+  return il::spot_t{i_local};
+}
+
+template <typename T, typename F>
+void SwissSet<T, F>::ReserveWithP(int p) {
+  signed char* old_control = control_;
+  T* old_bucket = bucket_;
+  const il::int_t old_m = nbBuckets();
+
+  Allocate(p);
+  nb_tombstones_ = 0;
+  const std::size_t group_mask = (static_cast<std::size_t>(1) << (p_ - 4)) - 1;
+  for (il::int_t i = 0; i < old_m; ++i) {
+    if (old_control[i] >= 0) {
+      const std::size_t h = il::hashSeeded<F>(old_bucket[i], p_ + 3, seed_);
+      std::size_t g = (h >> 7) & group_mask;
+      std::size_t delta_g = 0;
+      std::uint32_t mask;
+      while ((mask = il::ControlGroup{control_ + g * il::ControlGroup::size}
+                         .matchEmpty()) == 0) {
+        ++delta_g;
+        g = (g + delta_g) & group_mask;
+      }
+      const std::size_t j = g * il::ControlGroup::size + il::lowestBit(mask);
+      control_[j] = static_cast<signed char>(h & 0x7F);
+      new (bucket_ + j) T(std::move(old_bucket[i]));
+      (old_bucket + i)->~T();
+    }
+  }
+  if (old_m > 0) {
+    il::deallocate(old_bucket);
+    il::deallocate(old_control);
+  }
+}
+
+}  // namespace il
+
+#endif  // IL_SWISSSET_H
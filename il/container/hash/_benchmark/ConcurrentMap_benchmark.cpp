@@ -0,0 +1,177 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+// g++ -std=c++11 -O3 -march=native -DNDEBUG -I../../../..
+//     ConcurrentMap_benchmark.cpp -o ConcurrentMap_benchmark -lbenchmark
+//     -lpthread
+//
+// Searches, and searches mixed with 10% of Set, from 1 to 64 threads on a
+// map of 1 000 000 integers: il::ConcurrentMap against an il::SwissMap
+// protected by a single lock. Then, the parallel build of a map from arrays
+// of keys and values against a loop calling Set on an il::SwissMap.
+
+#include <mutex>
+
+#include <benchmark/benchmark.h>
+
+#include <il/Array.h>
+#include <il/ConcurrentMap.h>
+#include <il/SwissMap.h>
+
+static const il::int_t nb_keys = 1000000;
+
+static il::Array<int> integers(il::int_t n, unsigned int seed) {
+  il::Array<int> v{n};
+  for (il::int_t i = 0; i < n; ++i) {
+    seed = 1664525u * seed + 1013904223u;
+    v[i] = static_cast<int>(seed >> 1);
+  }
+  return v;
+}
+
+static const il::Array<int>& keys() {
+  static const il::Array<int> v = integers(nb_keys, 1234567891u);
+  return v;
+}
+
+struct LockedSwissMap {
+  std::mutex mutex;
+  il::SwissMap<int, int> map;
+};
+
+static il::ConcurrentMap<int, int>& concurrentMap() {
+  static il::ConcurrentMap<int, int> map{nb_keys};
+  static const bool filled = [&]() {
+    for (il::int_t k = 0; k < nb_keys; ++k) {
+      map.Set(keys()[k], static_cast<int>(k));
+    }
+    return true;
+  }();
+  (void)filled;
+  return map;
+}
+
+static LockedSwissMap& lockedSwissMap() {
+  static LockedSwissMap map{};
+  static const bool filled = [&]() {
+    map.map.Reserve(nb_keys);
+    for (il::int_t k = 0; k < nb_keys; ++k) {
+      map.map.Set(keys()[k], static_cast<int>(k));
+    }
+    return true;
+  }();
+  (void)filled;
+  return map;
+}
+
+// Every thread goes through the keys from its own starting point and calls
+// Set for 1 key out of nb_set_period, and search for the other ones
+static void ConcurrentMap_Search(benchmark::State& state, int nb_set_period) {
+  const il::Array<int>& v = keys();
+  il::ConcurrentMap<int, int>& map = concurrentMap();
+  il::int_t k = (state.thread_index() * nb_keys) / state.threads();
+  il::int_t nb_found = 0;
+  for (auto _ : state) {
+    for (int r = 0; r < 1000; ++r) {
+      if (++k == nb_keys) {
+        k = 0;
+      }
+      if (r % nb_set_period == 0) {
+        map.Set(v[k], static_cast<int>(k));
+      } else {
+        int value;
+        nb_found += map.search(v[k], il::io, value) ? 1 : 0;
+      }
+    }
+  }
+  benchmark::DoNotOptimize(nb_found);
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+
+static void LockedSwissMap_Search(benchmark::State& state, int nb_set_period) {
+  const il::Array<int>& v = keys();
+  LockedSwissMap& map = lockedSwissMap();
+  il::int_t k = (state.thread_index() * nb_keys) / state.threads();
+  il::int_t nb_found = 0;
+  for (auto _ : state) {
+    for (int r = 0; r < 1000; ++r) {
+      if (++k == nb_keys) {
+        k = 0;
+      }
+      std::lock_guard<std::mutex> lock{map.mutex};
+      if (r % nb_set_period == 0) {
+        map.map.Set(v[k], static_cast<int>(k));
+      } else {
+        nb_found += map.map.found(map.map.search(v[k])) ? 1 : 0;
+      }
+    }
+  }
+  benchmark::DoNotOptimize(nb_found);
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+
+static void ConcurrentMap_SearchOnly(benchmark::State& state) {
+  ConcurrentMap_Search(state, 1001);
+}
+
+static void LockedSwissMap_SearchOnly(benchmark::State& state) {
+  LockedSwissMap_Search(state, 1001);
+}
+
+static void ConcurrentMap_SearchSet(benchmark::State& state) {
+  ConcurrentMap_Search(state, 10);
+}
+
+static void LockedSwissMap_SearchSet(benchmark::State& state) {
+  LockedSwissMap_Search(state, 10);
+}
+
+static void ConcurrentMap_SetParallel(benchmark::State& state) {
+  const il::Array<int>& v = keys();
+  il::Array<int> w{nb_keys};
+  for (il::int_t k = 0; k < nb_keys; ++k) {
+    w[k] = static_cast<int>(k);
+  }
+  for (auto _ : state) {
+    il::ConcurrentMap<int, int> map{};
+    map.Set(il::parallel, v, w);
+    benchmark::DoNotOptimize(map.contains(v[0]));
+  }
+  state.SetItemsProcessed(state.iterations() * nb_keys);
+}
+
+static void SwissMap_Set(benchmark::State& state) {
+  const il::Array<int>& v = keys();
+  for (auto _ : state) {
+    il::SwissMap<int, int> map{};
+    for (il::int_t k = 0; k < nb_keys; ++k) {
+      map.Set(v[k], static_cast<int>(k));
+    }
+    benchmark::DoNotOptimize(map.found(map.search(v[0])));
+  }
+  state.SetItemsProcessed(state.iterations() * nb_keys);
+}
+
+BENCHMARK(ConcurrentMap_SearchOnly)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(LockedSwissMap_SearchOnly)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(ConcurrentMap_SearchSet)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(LockedSwissMap_SearchSet)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(ConcurrentMap_SetParallel)->Unit(benchmark::kMillisecond);
+BENCHMARK(SwissMap_Set)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
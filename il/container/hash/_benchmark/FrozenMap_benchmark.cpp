@@ -0,0 +1,189 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+// g++ -std=c++11 -O3 -march=native -DNDEBUG -I../../../..
+//     FrozenMap_benchmark.cpp -o FrozenMap_benchmark -lbenchmark -lpthread
+//
+// Searches of keys which are in the map, and of keys which are not, in maps
+// from 40-byte identifiers to integers: il::Map, il::SwissMap and
+// il::FrozenMap. The Build benchmarks give the time to build the maps and
+// the memory they use, in bytes per key, as measured by malloc (glibc).
+
+#include <malloc.h>
+#include <cstdio>
+
+#include <benchmark/benchmark.h>
+
+#include <il/Array.h>
+#include <il/FrozenMap.h>
+#include <il/Map.h>
+#include <il/String.h>
+#include <il/SwissMap.h>
+
+static il::Array<il::String> identifiers(il::int_t n, const char* prefix) {
+  il::Array<il::String> v{n};
+  for (il::int_t i = 0; i < n; ++i) {
+    char key[48];
+    std::snprintf(key, sizeof(key), "%s.boundary.elements.node_ids_%08d",
+                  prefix, static_cast<int>(i));
+    v[i] = il::String{il::StringType::Byte, key, 40};
+  }
+  return v;
+}
+
+static il::int_t allocatedBytes() {
+  return static_cast<il::int_t>(mallinfo2().uordblks);
+}
+
+template <typename M>
+static void Search(benchmark::State& state, const M& map,
+                   const il::Array<il::String>& keys) {
+  const il::int_t n = keys.size();
+  il::int_t k = 0;
+  il::int_t nb_found = 0;
+  for (auto _ : state) {
+    for (int r = 0; r < 1000; ++r) {
+      if (++k == n) {
+        k = 0;
+      }
+      nb_found += map.found(map.search(il::StringView{keys[k]})) ? 1 : 0;
+    }
+  }
+  benchmark::DoNotOptimize(nb_found);
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+
+static void Map_Search(benchmark::State& state, const char* prefix) {
+  const il::int_t n = state.range(0);
+  const il::Array<il::String> keys = identifiers(n, "mesh");
+  il::Map<il::String, il::int_t> map{n};
+  for (il::int_t i = 0; i < n; ++i) {
+    map.Set(keys[i], i);
+  }
+  Search(state, map, identifiers(n, prefix));
+}
+
+static void SwissMap_Search(benchmark::State& state, const char* prefix) {
+  const il::int_t n = state.range(0);
+  const il::Array<il::String> keys = identifiers(n, "mesh");
+  il::SwissMap<il::String, il::int_t> map{n};
+  for (il::int_t i = 0; i < n; ++i) {
+    map.Set(keys[i], i);
+  }
+  Search(state, map, identifiers(n, prefix));
+}
+
+static void FrozenMap_Search(benchmark::State& state, const char* prefix) {
+  const il::int_t n = state.range(0);
+  const il::Array<il::String> keys = identifiers(n, "mesh");
+  il::Map<il::String, il::int_t> map{n};
+  for (il::int_t i = 0; i < n; ++i) {
+    map.Set(keys[i], i);
+  }
+  const il::FrozenMap<il::String, il::int_t> frozen_map{map};
+  Search(state, frozen_map, identifiers(n, prefix));
+}
+
+static void Map_SearchHit(benchmark::State& state) {
+  Map_Search(state, "mesh");
+}
+
+static void SwissMap_SearchHit(benchmark::State& state) {
+  SwissMap_Search(state, "mesh");
+}
+
+static void FrozenMap_SearchHit(benchmark::State& state) {
+  FrozenMap_Search(state, "mesh");
+}
+
+static void Map_SearchMiss(benchmark::State& state) {
+  Map_Search(state, "grid");
+}
+
+static void SwissMap_SearchMiss(benchmark::State& state) {
+  SwissMap_Search(state, "grid");
+}
+
+static void FrozenMap_SearchMiss(benchmark::State& state) {
+  FrozenMap_Search(state, "grid");
+}
+
+// The memory is the one used by the map built from the keys, not counting
+// the array of keys
+static void Map_Build(benchmark::State& state) {
+  const il::int_t n = state.range(0);
+  const il::Array<il::String> keys = identifiers(n, "mesh");
+  il::int_t bytes = 0;
+  for (auto _ : state) {
+    const il::int_t bytes_begin = allocatedBytes();
+    il::Map<il::String, il::int_t> map{};
+    for (il::int_t i = 0; i < n; ++i) {
+      map.Set(keys[i], i);
+    }
+    bytes = allocatedBytes() - bytes_begin;
+    benchmark::DoNotOptimize(map.nbElements());
+  }
+  state.counters["bytes_per_key"] = static_cast<double>(bytes) / n;
+}
+
+static void SwissMap_Build(benchmark::State& state) {
+  const il::int_t n = state.range(0);
+  const il::Array<il::String> keys = identifiers(n, "mesh");
+  il::int_t bytes = 0;
+  for (auto _ : state) {
+    const il::int_t bytes_begin = allocatedBytes();
+    il::SwissMap<il::String, il::int_t> map{};
+    for (il::int_t i = 0; i < n; ++i) {
+      map.Set(keys[i], i);
+    }
+    bytes = allocatedBytes() - bytes_begin;
+    benchmark::DoNotOptimize(map.nbElements());
+  }
+  state.counters["bytes_per_key"] = static_cast<double>(bytes) / n;
+}
+
+// The time includes the one to build the il::Map, but the memory is the one
+// of the il::FrozenMap alone
+static void FrozenMap_Build(benchmark::State& state) {
+  const il::int_t n = state.range(0);
+  const il::Array<il::String> keys = identifiers(n, "mesh");
+  il::int_t bytes = 0;
+  for (auto _ : state) {
+    il::Map<il::String, il::int_t> map{};
+    for (il::int_t i = 0; i < n; ++i) {
+      map.Set(keys[i], i);
+    }
+    const il::int_t bytes_begin = allocatedBytes();
+    const il::FrozenMap<il::String, il::int_t> frozen_map{map};
+    bytes = allocatedBytes() - bytes_begin;
+    benchmark::DoNotOptimize(frozen_map.nbElements());
+  }
+  state.counters["bytes_per_key"] = static_cast<double>(bytes) / n;
+}
+
+BENCHMARK(Map_SearchHit)->Arg(1000)->Arg(1000000);
+BENCHMARK(SwissMap_SearchHit)->Arg(1000)->Arg(1000000);
+BENCHMARK(FrozenMap_SearchHit)->Arg(1000)->Arg(1000000);
+BENCHMARK(Map_SearchMiss)->Arg(1000)->Arg(1000000);
+BENCHMARK(SwissMap_SearchMiss)->Arg(1000)->Arg(1000000);
+BENCHMARK(FrozenMap_SearchMiss)->Arg(1000)->Arg(1000000);
+BENCHMARK(Map_Build)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(SwissMap_Build)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(FrozenMap_Build)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -16,10 +16,12 @@
 //
 //==============================================================================
 
+#include <cstdio>
 #include <iostream>
 
 #include <benchmark/benchmark.h>
 
+#include <il/Array.h>
 #include <il/Map.h>
 #include <il/String.h>
 
@@ -32,15 +34,15 @@ static void BM_MapCString(benchmark::State& state) {
   map.Set("eee", 0);
   map.Set("fff", 0);
   map.Set("ggg", 0);
-  il::int_t i;
+  il::int_t i = 0;
   while (state.KeepRunning()) {
-    i += map.searchCString("aaa");
-    i += map.searchCString("bbb");
-    i += map.searchCString("ccc");
-    i += map.searchCString("ddd");
-    i += map.searchCString("eee");
-    i += map.searchCString("fff");
-    i += map.searchCString("ggg");
+    i += map.searchCString("aaa").index;
+    i += map.searchCString("bbb").index;
+    i += map.searchCString("ccc").index;
+    i += map.searchCString("ddd").index;
+    i += map.searchCString("eee").index;
+    i += map.searchCString("fff").index;
+    i += map.searchCString("ggg").index;
   }
   std::cout << i << std::endl;
 }
@@ -48,13 +50,13 @@ static void BM_MapCString(benchmark::State& state) {
 static void BM_SetMapCString(benchmark::State& state) {
   il::Map<il::String, int> map{7};
   while (state.KeepRunning()) {
-    map.setCString("aaa", 0);
-    map.setCString("bbb", 0);
-    map.setCString("ccc", 0);
-    map.setCString("ddd", 0);
-    map.setCString("eee", 0);
-    map.setCString("fff", 0);
-    map.setCString("ggg", 0);
+    map.SetCString("aaa", 0);
+    map.SetCString("bbb", 0);
+    map.SetCString("ccc", 0);
+    map.SetCString("ddd", 0);
+    map.SetCString("eee", 0);
+    map.SetCString("fff", 0);
+    map.SetCString("ggg", 0);
   }
 }
 
@@ -67,15 +69,15 @@ static void BM_Map(benchmark::State& state) {
   map.Set("eee", 0);
   map.Set("fff", 0);
   map.Set("ggg", 0);
-  il::int_t i;
+  il::int_t i = 0;
   while (state.KeepRunning()) {
-    i += map.search("aaa");
-    i += map.search("bbb");
-    i += map.search("ccc");
-    i += map.search("ddd");
-    i += map.search("eee");
-    i += map.search("fff");
-    i += map.search("ggg");
+    i += map.search("aaa").index;
+    i += map.search("bbb").index;
+    i += map.search("ccc").index;
+    i += map.search("ddd").index;
+    i += map.search("eee").index;
+    i += map.search("fff").index;
+    i += map.search("ggg").index;
   }
   std::cout << i << std::endl;
 }
@@ -93,6 +95,177 @@ static void BM_SetMap(benchmark::State& state) {
   }
 }
 
+// Identifiers of 40 bytes which only differ by their last digits
+static il::Array<il::String> identifiers(il::int_t n, il::int_t offset) {
+  il::Array<il::String> v{};
+  v.Reserve(n);
+  char buffer[41];
+  for (il::int_t i = 0; i < n; ++i) {
+    std::snprintf(buffer, 41, "mesh.boundary.elements.node_ids_%08d",
+                  static_cast<int>(offset + i));
+    v.Append(il::String{il::StringType::Byte, buffer, 40});
+  }
+  // Shuffle the keys so that consecutive accesses do not hit consecutive
+  // buckets when the hash function preserves the order of the keys
+  unsigned int seed = 1234567891;
+  for (il::int_t i = n - 1; i > 0; --i) {
+    seed = 1664525u * seed + 1013904223u;
+    const il::int_t j = static_cast<il::int_t>(seed % (i + 1));
+    const il::String s = v[i];
+    v[i] = v[j];
+    v[j] = s;
+  }
+  return v;
+}
+
+// The hash function used by il::Map before il::hashBytes
+static std::size_t djb2(const char* s, il::int_t n) {
+  std::size_t hash = 5381;
+  for (il::int_t i = 0; i < n; ++i) {
+    hash = ((hash << 5) + hash) + s[i];
+  }
+  return hash;
+}
+
+// Fraction of the keys which are not in their bucket when the bucket index
+// is taken from the p low bits (djb2) or from the p high bits (hashBytes)
+static double displaced(const il::Array<il::String>& v, int p, bool old) {
+  const std::size_t m = std::size_t{1} << p;
+  il::Array<bool> used{static_cast<il::int_t>(m), false};
+  il::int_t nb_displaced = 0;
+  for (il::int_t k = 0; k < v.size(); ++k) {
+    std::size_t i =
+        old ? djb2(v[k].asCString(), v[k].size()) & (m - 1)
+            : il::HashFunction<il::String>::hash(v[k], p);
+    if (used[i]) {
+      ++nb_displaced;
+    }
+    std::size_t delta_i = 1;
+    while (used[i]) {
+      i = (i + delta_i) & (m - 1);
+      ++delta_i;
+    }
+    used[i] = true;
+  }
+  return static_cast<double>(nb_displaced) / v.size();
+}
+
+static void BM_HashDjb2(benchmark::State& state) {
+  const il::Array<il::String> v = identifiers(1000, 0);
+  std::size_t h = 0;
+  while (state.KeepRunning()) {
+    for (il::int_t k = 0; k < v.size(); ++k) {
+      h += djb2(v[k].asCString(), v[k].size());
+    }
+    benchmark::DoNotOptimize(h);
+  }
+  state.SetItemsProcessed(state.iterations() * v.size());
+}
+
+static void BM_HashBytes(benchmark::State& state) {
+  const il::Array<il::String> v = identifiers(1000, 0);
+  std::uint64_t h = 0;
+  while (state.KeepRunning()) {
+    for (il::int_t k = 0; k < v.size(); ++k) {
+      h += il::hashBytes(v[k].asCString(), v[k].size(), 0);
+    }
+    benchmark::DoNotOptimize(h);
+  }
+  state.SetItemsProcessed(state.iterations() * v.size());
+}
+
+static void BM_MapIdentifierSearch(benchmark::State& state) {
+  const il::int_t n = state.range(0);
+  const il::Array<il::String> v = identifiers(n, 0);
+  const il::Array<il::String> w = identifiers(n, n);
+  il::Map<il::String, il::int_t> map{n};
+  for (il::int_t k = 0; k < n; ++k) {
+    map.Set(v[k], k);
+  }
+  il::int_t nb_found = 0;
+  while (state.KeepRunning()) {
+    for (il::int_t k = 0; k < n; ++k) {
+      nb_found += map.found(map.search(v[k])) ? 1 : 0;
+      nb_found += map.found(map.search(w[k])) ? 1 : 0;
+    }
+    benchmark::DoNotOptimize(nb_found);
+  }
+  int p = 0;
+  while ((il::int_t{1} << p) < map.nbBuckets()) {
+    ++p;
+  }
+  state.SetItemsProcessed(state.iterations() * 2 * n);
+  state.counters["displaced_djb2"] = displaced(v, p, true);
+  state.counters["displaced"] = displaced(v, p, false);
+}
+
+static void BM_MapIdentifierSet(benchmark::State& state) {
+  const il::int_t n = state.range(0);
+  const il::Array<il::String> v = identifiers(n, 0);
+  while (state.KeepRunning()) {
+    il::Map<il::String, il::int_t> map{n};
+    for (il::int_t k = 0; k < n; ++k) {
+      map.Set(v[k], k);
+    }
+    benchmark::DoNotOptimize(map.nbElements());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+// The identifiers are read from a text, as in a parser, and are searched for
+// with a temporary il::String or with an il::StringView on the text
+static il::String identifierText(const il::Array<il::String>& v) {
+  il::String text{};
+  for (il::int_t k = 0; k < v.size(); ++k) {
+    text.Append(v[k]);
+  }
+  return text;
+}
+
+static void BM_MapTextSearchString(benchmark::State& state) {
+  const il::int_t n = state.range(0);
+  const il::Array<il::String> v = identifiers(n, 0);
+  const il::String text = identifierText(identifiers(n, n / 2));
+  il::Map<il::String, il::int_t> map{n};
+  for (il::int_t k = 0; k < n; ++k) {
+    map.Set(v[k], k);
+  }
+  il::int_t nb_found = 0;
+  while (state.KeepRunning()) {
+    for (il::int_t k = 0; k < n; ++k) {
+      const il::String key{il::StringType::Byte, text.data() + 40 * k, 40};
+      nb_found += map.found(map.search(key)) ? 1 : 0;
+    }
+    benchmark::DoNotOptimize(nb_found);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void BM_MapTextSearchStringView(benchmark::State& state) {
+  const il::int_t n = state.range(0);
+  const il::Array<il::String> v = identifiers(n, 0);
+  const il::String text = identifierText(identifiers(n, n / 2));
+  il::Map<il::String, il::int_t> map{n};
+  for (il::int_t k = 0; k < n; ++k) {
+    map.Set(v[k], k);
+  }
+  il::int_t nb_found = 0;
+  while (state.KeepRunning()) {
+    for (il::int_t k = 0; k < n; ++k) {
+      const il::StringView key{il::StringType::Byte, text.data() + 40 * k, 40};
+      nb_found += map.found(map.search(key)) ? 1 : 0;
+    }
+    benchmark::DoNotOptimize(nb_found);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_HashDjb2);
+BENCHMARK(BM_HashBytes);
+BENCHMARK(BM_MapIdentifierSearch)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_MapIdentifierSet)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_MapTextSearchString)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_MapTextSearchStringView)->Arg(1000)->Arg(100000);
 BENCHMARK(BM_MapCString);
 BENCHMARK(BM_Map);
 BENCHMARK(BM_SetMapCString);
@@ -0,0 +1,178 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+// g++ -std=c++11 -O3 -march=native -DNDEBUG -I../../../..
+//     SwissMap_benchmark.cpp -o SwissMap_benchmark -lbenchmark -lpthread
+//
+// Searches where 90% of the keys are not in the map, and searches where all
+// the keys are in the map, for il::Map and il::SwissMap.
+
+#include <cstdio>
+
+#include <benchmark/benchmark.h>
+
+#include <il/Array.h>
+#include <il/Map.h>
+#include <il/String.h>
+#include <il/SwissMap.h>
+
+// Identifiers of 40 bytes, in random order
+static il::Array<il::String> identifiers(il::int_t n, il::int_t offset) {
+  il::Array<il::String> v{};
+  v.Reserve(n);
+  char buffer[41];
+  for (il::int_t i = 0; i < n; ++i) {
+    std::snprintf(buffer, 41, "mesh.boundary.elements.node_ids_%08d",
+                  static_cast<int>(offset + i));
+    v.Append(il::String{il::StringType::Byte, buffer, 40});
+  }
+  unsigned int seed = 1234567891;
+  for (il::int_t i = n - 1; i > 0; --i) {
+    seed = 1664525u * seed + 1013904223u;
+    const il::int_t j = static_cast<il::int_t>(seed % (i + 1));
+    const il::String s = v[i];
+    v[i] = v[j];
+    v[j] = s;
+  }
+  return v;
+}
+
+static il::Array<int> integers(il::int_t n, unsigned int seed) {
+  il::Array<int> v{n};
+  for (il::int_t i = 0; i < n; ++i) {
+    seed = 1664525u * seed + 1013904223u;
+    v[i] = static_cast<int>(seed >> 1);
+  }
+  return v;
+}
+
+// The n keys of the map and 10 * n keys to search for, 1 out of 10 being in
+// the map when miss is true
+template <typename M>
+static void searchString(benchmark::State& state, bool miss) {
+  const il::int_t n = state.range(0);
+  const il::Array<il::String> v = identifiers(n, 0);
+  const il::Array<il::String> w = identifiers(10 * n, miss ? 0 : n);
+  M map{n};
+  for (il::int_t k = 0; k < n; ++k) {
+    map.Set(v[k], k);
+  }
+  il::Array<il::String> u{};
+  u.Reserve(10 * n);
+  for (il::int_t k = 0; k < 10 * n; ++k) {
+    u.Append(miss ? w[k] : v[k % n]);
+  }
+  il::int_t nb_found = 0;
+  while (state.KeepRunning()) {
+    for (il::int_t k = 0; k < u.size(); ++k) {
+      nb_found += map.found(map.search(u[k])) ? 1 : 0;
+    }
+    benchmark::DoNotOptimize(nb_found);
+  }
+  state.SetItemsProcessed(state.iterations() * u.size());
+}
+
+template <typename M>
+static void searchInt(benchmark::State& state, bool miss) {
+  const il::int_t n = state.range(0);
+  const il::Array<int> v = integers(n, 1);
+  const il::Array<int> w = integers(10 * n, 2);
+  M map{n};
+  for (il::int_t k = 0; k < n; ++k) {
+    map.Set(v[k], static_cast<int>(k));
+  }
+  il::Array<int> u{10 * n};
+  for (il::int_t k = 0; k < 10 * n; ++k) {
+    u[k] = (miss && k % 10 != 0) ? w[k] : v[k % n];
+  }
+  il::int_t nb_found = 0;
+  while (state.KeepRunning()) {
+    for (il::int_t k = 0; k < u.size(); ++k) {
+      nb_found += map.found(map.search(u[k])) ? 1 : 0;
+    }
+    benchmark::DoNotOptimize(nb_found);
+  }
+  state.SetItemsProcessed(state.iterations() * u.size());
+}
+
+static void Map_StringMiss(benchmark::State& state) {
+  searchString<il::Map<il::String, il::int_t>>(state, true);
+}
+
+static void SwissMap_StringMiss(benchmark::State& state) {
+  searchString<il::SwissMap<il::String, il::int_t>>(state, true);
+}
+
+static void Map_StringHit(benchmark::State& state) {
+  searchString<il::Map<il::String, il::int_t>>(state, false);
+}
+
+static void SwissMap_StringHit(benchmark::State& state) {
+  searchString<il::SwissMap<il::String, il::int_t>>(state, false);
+}
+
+static void Map_IntMiss(benchmark::State& state) {
+  searchInt<il::Map<int, int>>(state, true);
+}
+
+static void SwissMap_IntMiss(benchmark::State& state) {
+  searchInt<il::SwissMap<int, int>>(state, true);
+}
+
+static void Map_IntHit(benchmark::State& state) {
+  searchInt<il::Map<int, int>>(state, false);
+}
+
+static void SwissMap_IntHit(benchmark::State& state) {
+  searchInt<il::SwissMap<int, int>>(state, false);
+}
+
+template <typename M>
+static void setString(benchmark::State& state) {
+  const il::int_t n = state.range(0);
+  const il::Array<il::String> v = identifiers(n, 0);
+  while (state.KeepRunning()) {
+    M map{};
+    for (il::int_t k = 0; k < n; ++k) {
+      map.Set(v[k], k);
+    }
+    benchmark::DoNotOptimize(map.nbElements());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void Map_StringSet(benchmark::State& state) {
+  setString<il::Map<il::String, il::int_t>>(state);
+}
+
+static void SwissMap_StringSet(benchmark::State& state) {
+  setString<il::SwissMap<il::String, il::int_t>>(state);
+}
+
+BENCHMARK(Map_StringMiss)->Arg(1000)->Arg(100000);
+BENCHMARK(SwissMap_StringMiss)->Arg(1000)->Arg(100000);
+BENCHMARK(Map_StringHit)->Arg(1000)->Arg(100000);
+BENCHMARK(SwissMap_StringHit)->Arg(1000)->Arg(100000);
+BENCHMARK(Map_IntMiss)->Arg(1000)->Arg(100000);
+BENCHMARK(SwissMap_IntMiss)->Arg(1000)->Arg(100000);
+BENCHMARK(Map_IntHit)->Arg(1000)->Arg(100000);
+BENCHMARK(SwissMap_IntHit)->Arg(1000)->Arg(100000);
+BENCHMARK(Map_StringSet)->Arg(1000)->Arg(100000);
+BENCHMARK(SwissMap_StringSet)->Arg(1000)->Arg(100000);
+
+BENCHMARK_MAIN();
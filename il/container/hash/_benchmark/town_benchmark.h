@@ -62,4 +62,53 @@ inline void hash() {
   timer.Stop();
 
   il::print("Time per HashTable creation: {} s\n", timer.time() / nb_times);
+
+  // Lookups, and quality of the hash function: fraction of the cities which
+  // are not in the bucket given by their hash
+  il::Map<il::String, il::int_t> map{nb_expected_cities};
+  for (il::int_t i = 0; i < city.size(); ++i) {
+    map.Set(city[i], population[i]);
+  }
+  int p = 0;
+  while ((il::int_t{1} << p) < map.nbBuckets()) {
+    ++p;
+  }
+  il::int_t nb_displaced = 0;
+  for (il::int_t i = 0; i < city.size(); ++i) {
+    const il::spot_t s = map.search(city[i]);
+    if (static_cast<std::size_t>(s.index) !=
+        il::HashFunction<il::String>::hash(city[i], p)) {
+      ++nb_displaced;
+    }
+  }
+  il::print("Displaced cities: {}\n",
+            static_cast<double>(nb_displaced) / city.size());
+
+  timer.Reset();
+  timer.Start();
+  il::int_t total = 0;
+  for (il::int_t k = 0; k < nb_times; ++k) {
+    for (il::int_t i = 0; i < city.size(); ++i) {
+      total += map.value(map.search(city[i]));
+    }
+  }
+  timer.Stop();
+
+  il::print("Time per HashTable lookups: {} s\n", timer.time() / nb_times);
+
+  std::unordered_map<std::string, il::int_t> stdmap{nb_expected_cities};
+  for (il::int_t i = 0; i < stdcity.size(); ++i) {
+    stdmap[stdcity[i]] = population[i];
+  }
+  timer.Reset();
+  timer.Start();
+  for (il::int_t k = 0; k < nb_times; ++k) {
+    for (il::int_t i = 0; i < stdcity.size(); ++i) {
+      total += stdmap.find(stdcity[i])->second;
+    }
+  }
+  timer.Stop();
+
+  il::print("Time per HashTable lookups: {} s\n", timer.time() / nb_times);
+  il::print("Total population: {}\n", total);
 }
@@ -0,0 +1,210 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <il/ConcurrentMap.h>
+#include <il/String.h>
+
+TEST(ConcurrentMap, constructor_default) {
+  il::ConcurrentMap<int, int> map{};
+
+  ASSERT_TRUE(map.nbElements() == 0 && !map.contains(0) &&
+              map.valueForKey(0, -1) == -1);
+}
+
+TEST(ConcurrentMap, set_search_erase) {
+  il::ConcurrentMap<int, int> map{100};
+  for (int i = 0; i < 1000; ++i) {
+    map.Set(i, 2 * i);
+  }
+  map.Set(7, 0);
+  int value = -1;
+  const bool found_7 = map.search(7, il::io, value) && value == 0;
+  const bool found_999 = map.search(999, il::io, value) && value == 1998;
+  const bool erased = map.erase(3) && !map.erase(3) && !map.contains(3);
+
+  ASSERT_TRUE(found_7 && found_999 && erased &&
+              !map.search(1000, il::io, value) && map.nbElements() == 999);
+}
+
+TEST(ConcurrentMap, set_if_absent) {
+  il::ConcurrentMap<int, int> map{};
+  const bool first = map.SetIfAbsent(1, 1);
+  const bool second = map.SetIfAbsent(1, 2);
+
+  ASSERT_TRUE(first && !second && map.valueForKey(1, 0) == 1);
+}
+
+TEST(ConcurrentMap, string_keys) {
+  const il::int_t n = 5000;
+  il::ConcurrentMap<il::String, il::int_t> map{};
+  for (il::int_t i = 0; i < n; ++i) {
+    char key[48];
+    std::snprintf(key, sizeof(key), "mesh.boundary.elements.node_ids_%08d",
+                  static_cast<int>(i));
+    map.Set(il::String{il::StringType::Byte, key, 40}, i);
+  }
+  bool correct = map.nbElements() == n;
+  for (il::int_t i = 0; i < n; ++i) {
+    char key[48];
+    std::snprintf(key, sizeof(key), "mesh.boundary.elements.node_ids_%08d",
+                  static_cast<int>(i));
+    correct = correct &&
+              map.valueForKey(il::String{il::StringType::Byte, key, 40}, -1) ==
+                  i;
+  }
+
+  ASSERT_TRUE(correct);
+}
+
+TEST(ConcurrentMap, threads) {
+  const int nb_threads = 8;
+  const int n = 20000;
+  il::ConcurrentMap<int, int> map{};
+  std::thread thread[nb_threads];
+  for (int t = 0; t < nb_threads; ++t) {
+    thread[t] = std::thread{[&map, t]() {
+      for (int i = t; i < n; i += nb_threads) {
+        map.Set(i, i + 1);
+        if (i % 3 == 0) {
+          map.erase(i);
+        }
+      }
+    }};
+  }
+  for (int t = 0; t < nb_threads; ++t) {
+    thread[t].join();
+  }
+  bool correct = true;
+  for (int i = 0; i < n; ++i) {
+    correct = correct && map.valueForKey(i, 0) == (i % 3 == 0 ? 0 : i + 1);
+  }
+
+  ASSERT_TRUE(correct && map.nbElements() == n - (n + 2) / 3);
+}
+
+TEST(ConcurrentMap, threads_set_if_absent) {
+  const int nb_threads = 8;
+  const int n = 5000;
+  il::ConcurrentMap<int, int> map{};
+  std::atomic<int> nb_inserted{0};
+  std::thread thread[nb_threads];
+  for (int t = 0; t < nb_threads; ++t) {
+    thread[t] = std::thread{[&map, &nb_inserted, t]() {
+      for (int i = 0; i < n; ++i) {
+        if (map.SetIfAbsent(i, t)) {
+          ++nb_inserted;
+        }
+      }
+    }};
+  }
+  for (int t = 0; t < nb_threads; ++t) {
+    thread[t].join();
+  }
+
+  ASSERT_TRUE(nb_inserted == n && map.nbElements() == n);
+}
+
+TEST(ConcurrentMap, threads_reserve) {
+  const int nb_threads = 4;
+  const int n = 20000;
+  il::ConcurrentMap<int, int> map{};
+  std::thread thread[nb_threads];
+  for (int t = 0; t < nb_threads; ++t) {
+    thread[t] = std::thread{[&map, t]() {
+      for (int i = t; i < n; i += nb_threads) {
+        map.Set(i, i);
+        if (i % 1000 == 0) {
+          map.Reserve(2 * i);
+        }
+      }
+    }};
+  }
+  for (int t = 0; t < nb_threads; ++t) {
+    thread[t].join();
+  }
+  bool correct = map.nbElements() == n;
+  for (int i = 0; i < n; ++i) {
+    correct = correct && map.valueForKey(i, -1) == i;
+  }
+
+  ASSERT_TRUE(correct);
+}
+
+TEST(ConcurrentMap, set_parallel) {
+  const il::int_t n = 100000;
+  il::Array<il::int_t> keys{n};
+  il::Array<il::int_t> values{n};
+  for (il::int_t k = 0; k < n; ++k) {
+    keys[k] = k % (n / 2);
+    values[k] = k;
+  }
+  il::ConcurrentMap<il::int_t, il::int_t> map{};
+  map.Set(-1, -1);
+  map.Set(il::parallel, keys, values);
+  bool correct =
+      map.nbElements() == n / 2 + 1 && map.valueForKey(-1, 0) == -1;
+  for (il::int_t i = 0; i < n / 2; ++i) {
+    correct = correct && map.valueForKey(i, -1) == i + n / 2;
+  }
+
+  ASSERT_TRUE(correct);
+}
+
+TEST(ConcurrentMap, clear) {
+  il::ConcurrentMap<int, int> map{};
+  for (int i = 0; i < 100; ++i) {
+    map.Set(i, i);
+  }
+  map.Clear();
+  map.Set(1, 1);
+
+  ASSERT_TRUE(map.nbElements() == 1 && !map.contains(2) &&
+              map.valueForKey(1, 0) == 1);
+}
+
+// A hash function that returns the low bits of the key, as the basic hash
+// suggested in <il/container/hash/HashFunction.h>
+struct LowBitsHash {
+  static std::size_t hash(int val, int p) {
+    const std::size_t mask = (static_cast<std::size_t>(1) << p) - 1;
+    return static_cast<std::size_t>(val) & mask;
+  }
+  static bool isEqual(int val0, int val1) { return val0 == val1; }
+};
+
+TEST(ConcurrentMap, low_bits_hash) {
+  // With the low bits of the hash choosing the shard, all these keys would be
+  // in the same shard
+  const int n = 10000;
+  il::ConcurrentMap<int, int, LowBitsHash> map{};
+  for (int i = 0; i < n; ++i) {
+    map.Set(256 * i, i);
+  }
+  bool correct = map.nbElements() == n && !map.contains(1);
+  for (int i = 0; i < n; ++i) {
+    correct = correct && map.valueForKey(256 * i, -1) == i;
+  }
+
+  ASSERT_TRUE(correct);
+}
@@ -0,0 +1,237 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#include <cstdint>
+#include <cstdio>
+
+#include <gtest/gtest.h>
+
+#include <il/FrozenMap.h>
+#include <il/Map.h>
+#include <il/MapArray.h>
+#include <il/String.h>
+#include <il/data.h>
+
+static il::String frozenMapKey(il::int_t i) {
+  char key[48];
+  std::snprintf(key, sizeof(key), "mesh.boundary.elements.node_ids_%08d",
+                static_cast<int>(i));
+  return il::String{il::StringType::Byte, key, 40};
+}
+
+static bool isMinimalPerfect(il::int_t n) {
+  il::Array<std::uint64_t> hash{n};
+  std::uint64_t x = 88172645463325252ull;
+  for (il::int_t i = 0; i < n; ++i) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    hash[i] = x;
+  }
+  il::PerfectHash perfect_hash{};
+  if (!perfect_hash.Build(hash)) {
+    return false;
+  }
+  il::Array<bool> taken{n, false};
+  for (il::int_t i = 0; i < n; ++i) {
+    const il::int_t j = perfect_hash.slot(hash[i]);
+    if (j < 0 || j >= n || taken[j]) {
+      return false;
+    }
+    taken[j] = true;
+  }
+  return perfect_hash.nbSlots() == n && perfect_hash.pilot().size() <= n;
+}
+
+TEST(PerfectHash, bijective) {
+  ASSERT_TRUE(isMinimalPerfect(0) && isMinimalPerfect(1) &&
+              isMinimalPerfect(2) && isMinimalPerfect(7) &&
+              isMinimalPerfect(1000) && isMinimalPerfect(100000));
+}
+
+TEST(PerfectHash, duplicate) {
+  il::Array<std::uint64_t> hash{3};
+  hash[0] = 1;
+  hash[1] = 2;
+  hash[2] = 1;
+  il::PerfectHash perfect_hash{};
+
+  ASSERT_TRUE(!perfect_hash.Build(hash));
+}
+
+TEST(FrozenMap, default_constructor) {
+  il::FrozenMap<int, int> map{};
+  il::FrozenMap<il::String, int> string_map{};
+
+  ASSERT_TRUE(map.nbElements() == 0 && !map.found(map.search(0)) &&
+              string_map.nbElements() == 0 &&
+              !string_map.found(string_map.search("a")) &&
+              map.spotBegin().index == map.spotEnd().index);
+}
+
+TEST(FrozenMap, empty) {
+  const il::Map<int, int> map{};
+  const il::MapArray<int, int> map_array{};
+  const il::FrozenMap<int, int> frozen_map{map};
+  const il::FrozenMap<int, int> frozen_map_array{map_array};
+
+  ASSERT_TRUE(frozen_map.nbElements() == 0 &&
+              !frozen_map.found(frozen_map.search(0)) &&
+              frozen_map.spotBegin().index == frozen_map.spotEnd().index &&
+              frozen_map_array.nbElements() == 0 &&
+              frozen_map_array.valueForKey(0, -1) == -1);
+}
+
+TEST(FrozenMap, empty_string) {
+  const il::Map<il::String, int> map{};
+  const il::MapArray<il::String, int> map_array{};
+  const il::FrozenMap<il::String, int> frozen_map{map};
+  const il::FrozenMap<il::String, int> frozen_map_array{map_array};
+
+  ASSERT_TRUE(frozen_map.nbElements() == 0 &&
+              !frozen_map.found(frozen_map.search("")) &&
+              frozen_map.spotBegin().index == frozen_map.spotEnd().index &&
+              frozen_map_array.nbElements() == 0 &&
+              frozen_map_array.valueForKey("a", -1) == -1);
+}
+
+TEST(FrozenMap, integer) {
+  const int n = 10000;
+  il::Map<int, int> map{};
+  for (int i = 0; i < n; ++i) {
+    map.Set(3 * i, i);
+  }
+  const il::FrozenMap<int, int> frozen_map{map};
+  bool correct = frozen_map.nbElements() == n;
+  for (int i = 0; i < n; ++i) {
+    const il::spot_t j = frozen_map.search(3 * i);
+    correct = correct && frozen_map.found(j) && frozen_map.key(j) == 3 * i &&
+              frozen_map.value(j) == i;
+    correct = correct && !frozen_map.found(frozen_map.search(3 * i + 1)) &&
+              frozen_map.valueForKey(3 * i + 2, -1) == -1;
+  }
+
+  ASSERT_TRUE(correct);
+}
+
+TEST(FrozenMap, iterate) {
+  il::Map<int, int> map{};
+  for (int i = 0; i < 100; ++i) {
+    map.Set(i, i);
+  }
+  const il::FrozenMap<int, int> frozen_map{map};
+  int sum = 0;
+  il::int_t count = 0;
+  for (il::spot_t i = frozen_map.spotBegin(); i != frozen_map.spotEnd();
+       i = frozen_map.next(i)) {
+    sum += frozen_map.value(i);
+    ++count;
+  }
+
+  ASSERT_TRUE(count == 100 && sum == 4950);
+}
+
+TEST(FrozenMap, string) {
+  const il::int_t n = 5000;
+  il::Map<il::String, il::int_t> map{};
+  for (il::int_t i = 0; i < n; ++i) {
+    map.Set(frozenMapKey(i), i);
+  }
+  map.Set("", -2);
+  const il::FrozenMap<il::String, il::int_t> frozen_map{map};
+  bool correct = frozen_map.nbElements() == n + 1 &&
+                 frozen_map.valueForKey("", 0) == -2 &&
+                 frozen_map.valueForKey("mesh", 0) == 0;
+  for (il::int_t i = 0; i < n; ++i) {
+    const il::String key = frozenMapKey(i);
+    const il::spot_t j = frozen_map.search(key);
+    correct = correct && frozen_map.found(j) && frozen_map.value(j) == i &&
+              il::String{frozen_map.key(j)} == key;
+    correct = correct &&
+              frozen_map.valueForKey(il::StringView{key}.subview(0, 39), -1) ==
+                  -1;
+  }
+
+  ASSERT_TRUE(correct);
+}
+
+TEST(FrozenMap, string_literal) {
+  il::MapArray<il::String, int> map{};
+  map.Set("dimension", 3);
+  map.Set("nb_elements", 1000);
+  map.Set("a long key which is not stored in the small string buffer", 7);
+  const il::FrozenMap<il::String, int> frozen_map{map};
+
+  ASSERT_TRUE(
+      frozen_map.nbElements() == 3 &&
+      frozen_map.valueForKey("dimension", 0) == 3 &&
+      frozen_map.valueForKey("nb_elements", 0) == 1000 &&
+      frozen_map.valueForKey(
+          "a long key which is not stored in the small string buffer", 0) ==
+          7 &&
+      !frozen_map.found(frozen_map.search("dimensions")));
+}
+
+TEST(FrozenMap, save_load) {
+  const il::String filename = IL_FOLDER "/../gtest/tmp/frozen_map.data";
+  const il::int_t n = 1000;
+  il::Map<il::String, double> map{};
+  for (il::int_t i = 0; i < n; ++i) {
+    map.Set(frozenMapKey(i), 0.5 * i);
+  }
+  const il::FrozenMap<il::String, double> frozen_map{map};
+
+  il::Status status{};
+  il::save(frozen_map, filename, il::io, status);
+  status.AbortOnError();
+  const il::FrozenMap<il::String, double> loaded_map =
+      il::load<il::FrozenMap<il::String, double>>(filename, il::io, status);
+  status.AbortOnError();
+  il::Status wrong_type_status{};
+  il::load<il::FrozenMap<il::String, float>>(filename, il::io,
+                                              wrong_type_status);
+  const bool wrong_type =
+      !wrong_type_status.Ok() &&
+      wrong_type_status.error() == il::Error::BinaryFileWrongType;
+  std::remove(filename.asCString());
+
+  bool correct = wrong_type && loaded_map.nbElements() == n &&
+                 loaded_map.seed() == frozen_map.seed() &&
+                 !loaded_map.found(loaded_map.search("mesh"));
+  for (il::int_t i = 0; i < n; ++i) {
+    correct = correct && loaded_map.valueForKey(frozenMapKey(i), -1.0) ==
+                             0.5 * static_cast<double>(i);
+  }
+
+  ASSERT_TRUE(correct);
+}
+
+TEST(FrozenMap, load_wrong_format) {
+  const il::String filename = IL_FOLDER "/../gtest/tmp/frozen_map.data";
+  std::FILE* file = std::fopen(filename.asCString(), "wb");
+  std::fputs("ILFROZEN but not really", file);
+  std::fclose(file);
+
+  il::Status status{};
+  const il::FrozenMap<il::String, int> map =
+      il::load<il::FrozenMap<il::String, int>>(filename, il::io, status);
+  const bool failed = !status.Ok();
+  std::remove(filename.asCString());
+
+  ASSERT_TRUE(failed && map.nbElements() == 0);
+}
@@ -0,0 +1,131 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#include <cstdio>
+
+#include <gtest/gtest.h>
+
+#include <il/Array.h>
+#include <il/container/hash/HashFunction.h>
+
+// Keys of 40 bytes that only differ by a few digits
+static il::String identifier(il::int_t i) {
+  char buffer[41];
+  std::snprintf(buffer, 41, "mesh.boundary.elements.node_ids_%08d",
+                static_cast<int>(i));
+  return il::String{il::StringType::Byte, buffer, 40};
+}
+
+TEST(HashFunction, string_consistent) {
+  const il::String s = "hello";
+  const int p = 10;
+
+  const std::size_t h = il::HashFunction<il::String>::hash(s, p);
+  ASSERT_TRUE(il::HashFunction<il::String>::hash("hello", p) == h &&
+              il::HashFunction<il::String>::hash(s.asCString(), 5, p) == h &&
+              h < (std::size_t{1} << p));
+}
+
+TEST(HashFunction, string_consistent_seed) {
+  const il::String s = identifier(17);
+  const int p = 20;
+  const std::size_t seed = 123456789;
+
+  const std::size_t h = il::HashFunction<il::String>::hash(s, p, seed);
+  ASSERT_TRUE(il::HashFunction<il::String>::hash(s.asCString(), s.size(), p,
+                                                 seed) == h &&
+              il::HashFunction<il::String>::hash(s, p) ==
+                  il::HashFunction<il::String>::hash(s, p, std::size_t{0}));
+}
+
+TEST(HashFunction, all_lengths) {
+  // Every length goes through a different path in il::hashBytes
+  const il::int_t n = 100;
+  char buffer[n];
+  for (il::int_t i = 0; i < n; ++i) {
+    buffer[i] = 'a';
+  }
+  il::Array<std::uint64_t> h{n + 1};
+  for (il::int_t i = 0; i <= n; ++i) {
+    h[i] = il::hashBytes(buffer, i, 0);
+  }
+
+  bool distinct = true;
+  for (il::int_t i = 0; i <= n; ++i) {
+    for (il::int_t j = 0; j < i; ++j) {
+      if (h[i] == h[j]) {
+        distinct = false;
+      }
+    }
+  }
+  ASSERT_TRUE(distinct);
+}
+
+TEST(HashFunction, every_byte_matters) {
+  const il::int_t n = 70;
+  char buffer[n];
+  for (il::int_t i = 0; i < n; ++i) {
+    buffer[i] = 'x';
+  }
+  const std::uint64_t h = il::hashBytes(buffer, n, 0);
+
+  bool ok = true;
+  for (il::int_t i = 0; i < n; ++i) {
+    buffer[i] = 'y';
+    if (il::hashBytes(buffer, n, 0) == h) {
+      ok = false;
+    }
+    buffer[i] = 'x';
+  }
+  ASSERT_TRUE(ok);
+}
+
+TEST(HashFunction, seed) {
+  const il::String s = identifier(0);
+
+  const std::uint64_t h0 = il::hashBytes(s.asCString(), s.size(), 0);
+  const std::uint64_t h1 = il::hashBytes(s.asCString(), s.size(), 1);
+  const std::uint64_t h2 = il::hashBytes(s.asCString(), s.size(), 2);
+  ASSERT_TRUE(h0 != h1 && h0 != h2 && h1 != h2);
+}
+
+TEST(HashFunction, random_seed) {
+  const std::size_t seed0 = il::randomHashSeed();
+  const std::size_t seed1 = il::randomHashSeed();
+
+  ASSERT_TRUE(seed0 != seed1);
+}
+
+TEST(HashFunction, distribution) {
+  // With a perfectly random hash function, n keys in n buckets leave about
+  // n / e buckets empty
+  const int p = 12;
+  const il::int_t n = il::int_t{1} << p;
+  il::Array<il::int_t> count{n, 0};
+  for (il::int_t i = 0; i < n; ++i) {
+    ++count[il::HashFunction<il::String>::hash(identifier(i), p)];
+  }
+  il::int_t nb_empty = 0;
+  for (il::int_t i = 0; i < n; ++i) {
+    if (count[i] == 0) {
+      ++nb_empty;
+    }
+  }
+
+  ASSERT_TRUE(nb_empty > 1400 && nb_empty < 1620);
+}
@@ -17,11 +17,13 @@
 //==============================================================================
 
 #include <cmath>
+#include <cstdio>
 #include <limits>
 
 #include <gtest/gtest.h>
 
 #include <il/Map.h>
+#include <il/MapArray.h>
 
 TEST(Map, constructor_default_0) {
   il::Map<int, int> map{};
@@ -30,6 +32,16 @@ TEST(Map, constructor_default_0) {
               map.nbBuckets() == 0);
 }
 
+TEST(Map, iterate_empty) {
+  il::Map<int, int> map{};
+  il::int_t nb_spots = 0;
+  for (il::spot_t i = map.spotBegin(); i != map.spotEnd(); i = map.next(i)) {
+    ++nb_spots;
+  }
+
+  ASSERT_TRUE(nb_spots == 0);
+}
+
 TEST(Map, constructor_initializer_list_0) {
   il::Map<int, int> map{il::value, {{0, 0}}};
 
@@ -57,3 +69,98 @@ TEST(Map, constructor_initializer_list_4) {
   ASSERT_TRUE(map.nbElements() == 4 && map.nbTombstones() == 0 &&
               map.nbBuckets() == 8);
 }
+
+TEST(Map, string_keys) {
+  const il::int_t n = 10000;
+  il::Map<il::String, il::int_t> map{};
+  char buffer[41];
+  for (il::int_t i = 0; i < n; ++i) {
+    std::snprintf(buffer, 41, "mesh.boundary.elements.node_ids_%08d",
+                  static_cast<int>(i));
+    map.Set(il::String{il::StringType::Byte, buffer, 40}, i);
+  }
+
+  bool ok = map.nbElements() == n;
+  for (il::int_t i = 0; i < n; ++i) {
+    std::snprintf(buffer, 41, "mesh.boundary.elements.node_ids_%08d",
+                  static_cast<int>(i));
+    const il::spot_t s =
+        map.search(il::String{il::StringType::Byte, buffer, 40});
+    const il::spot_t s_cstring = map.searchCString(buffer, 40);
+    if (!map.found(s) || map.value(s) != i || s_cstring.index != s.index) {
+      ok = false;
+    }
+    std::snprintf(buffer, 41, "mesh.boundary.elements.node_ids_%08d",
+                  static_cast<int>(n + i));
+    if (map.found(map.searchCString(buffer, 40))) {
+      ok = false;
+    }
+  }
+  ASSERT_TRUE(ok);
+}
+
+TEST(Map, seed) {
+  const std::size_t seed = il::randomHashSeed();
+  il::Map<il::String, int> map{3, seed};
+  map.Set("aaa", 0);
+  map.Set("bbb", 1);
+  map.Set("ccc", 2);
+  il::Map<il::String, int> map_copy = map;
+
+  const il::spot_t i = map_copy.searchCString("bbb");
+  ASSERT_TRUE(map.seed() == seed && map_copy.seed() == seed &&
+              map_copy.found(i) && map_copy.value(i) == 1 &&
+              !map_copy.found(map_copy.searchCString("ddd")));
+}
+
+TEST(Map, seed_int) {
+  il::Map<int, int> map{100, 987654321};
+  for (int i = 0; i < 100; ++i) {
+    map.Set(i, 2 * i);
+  }
+
+  bool ok = map.nbElements() == 100;
+  for (int i = 0; i < 100; ++i) {
+    const il::spot_t s = map.search(i);
+    if (!map.found(s) || map.value(s) != 2 * i) {
+      ok = false;
+    }
+  }
+  ASSERT_TRUE(ok && !map.found(map.search(100)));
+}
+
+TEST(Map, search_string_view) {
+  il::Map<il::String, int> map{};
+  map.Set("alpha", 0);
+  map.Set("beta", 1);
+  map.Set("mesh.boundary.elements.node_ids", 2);
+  const il::String line = "beta mesh.boundary.elements.node_ids gamma";
+  const il::StringView beta = line.subview(0, 4);
+  const il::StringView ids = line.subview(5, 36);
+  const il::StringView gamma = line.subview(37, 42);
+
+  const il::spot_t i = map.search(beta);
+  const il::spot_t j = map.search(ids);
+  il::spot_t k = map.search(gamma);
+  const bool ok = map.found(i) && map.value(i) == 1 && map.found(j) &&
+                  map.value(j) == 2 && !map.found(k) &&
+                  map.valueForKey(ids, -1) == 2 &&
+                  map.valueForKey(gamma, -1) == -1 &&
+                  map.valueForKey("alpha", -1) == 0;
+  map.Set(il::String{gamma}, 3, il::io, k);
+
+  ASSERT_TRUE(ok && map.nbElements() == 4 &&
+              map.valueForKey("gamma", -1) == 3);
+}
+
+TEST(Map, search_string_view_map_array) {
+  il::MapArray<il::String, int> map{};
+  map.Set("alpha", 0);
+  map.Set("beta", 1);
+  const il::String line = "alpha beta";
+  const il::spot_t i = map.search(line.subview(6, 10));
+  const il::spot_t j = map.search(line.subview(0, 4));
+
+  ASSERT_TRUE(map.found(i) && map.value(i) == 1 && !map.found(j) &&
+              map.found(map.search("alpha")));
+}
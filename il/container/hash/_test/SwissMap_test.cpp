@@ -0,0 +1,228 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#include <cstdio>
+#include <unordered_map>
+
+#include <gtest/gtest.h>
+
+#include <il/SwissMap.h>
+
+TEST(SwissMap, constructor_default) {
+  il::SwissMap<int, int> map{};
+
+  ASSERT_TRUE(map.nbElements() == 0 && map.nbTombstones() == 0 &&
+              map.nbBuckets() == 0 && map.spotBegin().index == 0 &&
+              map.spotEnd().index == 0 && !map.found(map.search(0)));
+}
+
+TEST(SwissMap, constructor_size) {
+  il::SwissMap<int, int> map0{14};
+  il::SwissMap<int, int> map1{15};
+
+  ASSERT_TRUE(map0.nbBuckets() == 16 && map1.nbBuckets() == 32);
+}
+
+TEST(SwissMap, constructor_initializer_list) {
+  il::SwissMap<int, int> map{il::value, {{0, 5}, {1, 6}, {2, 7}}};
+
+  const il::spot_t i = map.search(1);
+  ASSERT_TRUE(map.nbElements() == 3 && map.nbBuckets() == 16 &&
+              map.found(i) && map.key(i) == 1 && map.value(i) == 6);
+}
+
+TEST(SwissMap, set) {
+  il::SwissMap<int, int> map{};
+  map.Set(3, 4);
+  map.Set(5, 6);
+  map.Set(3, 7);
+
+  ASSERT_TRUE(map.nbElements() == 2 && map.valueForKey(3, -1) == 7 &&
+              map.valueForKey(5, -1) == 6 && map.valueForKey(4, -1) == -1);
+}
+
+TEST(SwissMap, set_spot) {
+  il::SwissMap<int, int> map{};
+  il::spot_t i = map.search(3);
+  const bool found_before = map.found(i);
+  map.Set(3, 4, il::io, i);
+
+  ASSERT_TRUE(!found_before && map.found(i) && map.key(i) == 3 &&
+              map.value(i) == 4 && map.search(3).index == i.index);
+}
+
+TEST(SwissMap, negative_keys) {
+  // il::Map reserves the lowest int for its empty buckets, il::SwissMap does
+  // not need any special key
+  il::SwissMap<int, int> map{};
+  map.Set(std::numeric_limits<int>::min(), 1);
+  map.Set(std::numeric_limits<int>::min() + 1, 2);
+
+  ASSERT_TRUE(map.valueForKey(std::numeric_limits<int>::min(), 0) == 1 &&
+              map.valueForKey(std::numeric_limits<int>::min() + 1, 0) == 2);
+}
+
+TEST(SwissMap, string) {
+  const il::int_t n = 10000;
+  il::SwissMap<il::String, il::int_t> map{};
+  char buffer[41];
+  for (il::int_t i = 0; i < n; ++i) {
+    std::snprintf(buffer, 41, "mesh.boundary.elements.node_ids_%08d",
+                  static_cast<int>(i));
+    map.Set(il::String{il::StringType::Byte, buffer, 40}, i);
+  }
+
+  bool ok = map.nbElements() == n;
+  for (il::int_t i = 0; i < 2 * n; ++i) {
+    std::snprintf(buffer, 41, "mesh.boundary.elements.node_ids_%08d",
+                  static_cast<int>(i));
+    const il::spot_t s = map.searchCString(buffer, 40);
+    if (i < n) {
+      ok = ok && map.found(s) && map.value(s) == i &&
+           map.search(il::String{il::StringType::Byte, buffer, 40}).index ==
+               s.index;
+    } else {
+      ok = ok && !map.found(s);
+    }
+  }
+  ASSERT_TRUE(ok && map.found(map.searchCString("mesh.boundary.elements."
+                                                "node_ids_00000017")));
+}
+
+TEST(SwissMap, erase) {
+  il::SwissMap<int, int> map{};
+  for (int i = 0; i < 100; ++i) {
+    map.Set(i, i);
+  }
+  for (int i = 0; i < 100; i += 2) {
+    map.erase(map.search(i));
+  }
+
+  bool ok = map.nbElements() == 50;
+  for (int i = 0; i < 100; ++i) {
+    ok = ok && (map.found(map.search(i)) == (i % 2 == 1));
+  }
+  ASSERT_TRUE(ok);
+}
+
+TEST(SwissMap, loop) {
+  il::SwissMap<int, int> map{};
+  for (int i = 0; i < 1000; ++i) {
+    map.Set(i, 2 * i);
+  }
+  for (int i = 0; i < 1000; i += 3) {
+    map.erase(map.search(i));
+  }
+
+  il::int_t nb = 0;
+  il::int_t sum = 0;
+  for (il::spot_t i = map.spotBegin(); i != map.spotEnd(); i = map.next(i)) {
+    ++nb;
+    sum += map.value(i) - 2 * map.key(i);
+  }
+  ASSERT_TRUE(nb == map.nbElements() && nb == 666 && sum == 0);
+}
+
+TEST(SwissMap, copy) {
+  il::SwissMap<il::String, int> map{};
+  map.Set("aaa", 0);
+  map.Set("bbb", 1);
+  il::SwissMap<il::String, int> map_copy{map};
+  il::SwissMap<il::String, int> map_assign{};
+  map_assign.Set("ccc", 2);
+  map_assign = map;
+  map.Set("bbb", 3);
+
+  ASSERT_TRUE(map_copy.nbElements() == 2 &&
+              map_copy.value(map_copy.searchCString("bbb")) == 1 &&
+              map_assign.nbElements() == 2 &&
+              map_assign.value(map_assign.searchCString("bbb")) == 1 &&
+              !map_assign.found(map_assign.searchCString("ccc")));
+}
+
+TEST(SwissMap, move) {
+  il::SwissMap<il::String, int> map{};
+  map.Set("aaa", 0);
+  il::SwissMap<il::String, int> map_move{std::move(map)};
+
+  ASSERT_TRUE(map.nbElements() == 0 && map.nbBuckets() == 0 &&
+              map_move.nbElements() == 1 &&
+              map_move.found(map_move.searchCString("aaa")));
+}
+
+TEST(SwissMap, clear) {
+  il::SwissMap<il::String, int> map{};
+  map.Set("aaa", 0);
+  map.Set("bbb", 1);
+  map.Clear();
+  map.Set("bbb", 2);
+
+  ASSERT_TRUE(map.nbElements() == 1 && map.nbBuckets() == 16 &&
+              map.value(map.searchCString("bbb")) == 2 &&
+              !map.found(map.searchCString("aaa")));
+}
+
+TEST(SwissMap, random) {
+  // Insertions and deletions compared with std::unordered_map, with many
+  // tombstones
+  il::SwissMap<int, int> map{0, il::randomHashSeed()};
+  std::unordered_map<int, int> std_map{};
+  unsigned int k = 1234567891;
+  bool ok = true;
+  for (int step = 0; step < 200000; ++step) {
+    k = 1664525u * k + 1013904223u;
+    const int key = static_cast<int>((k >> 8) % 3000);
+    const il::spot_t i = map.search(key);
+    const bool std_found = std_map.find(key) != std_map.end();
+    ok = ok && (map.found(i) == std_found);
+    if ((k >> 4) % 2 == 0) {
+      if (!map.found(i)) {
+        il::spot_t j = i;
+        map.Set(key, step, il::io, j);
+        std_map[key] = step;
+      }
+    } else if (map.found(i)) {
+      map.erase(i);
+      std_map.erase(key);
+    }
+  }
+  ok = ok && map.nbElements() == static_cast<il::int_t>(std_map.size());
+  for (auto it = std_map.begin(); it != std_map.end(); ++it) {
+    ok = ok && map.valueForKey(it->first, -1) == it->second;
+  }
+  ASSERT_TRUE(ok);
+}
+
+TEST(SwissMap, search_string_view) {
+  il::SwissMap<il::String, int> map{};
+  map.Set("alpha", 0);
+  map.Set("mesh.boundary.elements.node_ids", 1);
+  const il::String line = "mesh.boundary.elements.node_ids gamma";
+  const il::StringView ids = line.subview(0, 31);
+  const il::StringView gamma = line.subview(32, 37);
+
+  const il::spot_t i = map.search(ids);
+  il::spot_t j = map.search(gamma);
+  const bool ok = map.found(i) && map.value(i) == 1 && !map.found(j) &&
+                  map.valueForKey(ids, -1) == 1 &&
+                  map.valueForKey("alpha", -1) == 0;
+  map.Set(il::String{gamma}, 2, il::io, j);
+
+  ASSERT_TRUE(ok && map.nbElements() == 3 &&
+              map.valueForKey(il::String{"gamma"}, -1) == 2);
+}
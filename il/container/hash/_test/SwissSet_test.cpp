@@ -0,0 +1,100 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#include <gtest/gtest.h>
+
+#include <il/Set.h>
+#include <il/SwissSet.h>
+
+TEST(SwissSet, add) {
+  il::SwissSet<int> set{};
+  for (int i = 0; i < 1000; ++i) {
+    set.Add(3 * i);
+    set.Add(3 * i);
+  }
+
+  bool ok = set.nbElements() == 1000;
+  for (int i = 0; i < 3000; ++i) {
+    ok = ok && (set.contains(i) == (i % 3 == 0));
+  }
+  ASSERT_TRUE(ok);
+}
+
+TEST(SwissSet, string) {
+  il::SwissSet<il::String> set{};
+  set.Add(il::String{"aaa"});
+  set.Add(il::String{"bbb"});
+  const il::spot_t i = set.search(il::String{"bbb"});
+
+  ASSERT_TRUE(set.nbElements() == 2 && set.found(i) &&
+              set.element(i) == il::String{"bbb"} &&
+              !set.contains(il::String{"ccc"}));
+}
+
+TEST(SwissSet, erase) {
+  il::SwissSet<int> set{};
+  for (int i = 0; i < 100; ++i) {
+    set.Add(i);
+  }
+  for (int i = 0; i < 100; i += 2) {
+    set.erase(set.search(i));
+  }
+
+  il::int_t nb = 0;
+  bool ok = true;
+  for (il::spot_t i = set.spotBegin(); i != set.spotEnd(); i = set.next(i)) {
+    ++nb;
+    ok = ok && set.element(i) % 2 == 1;
+  }
+  ASSERT_TRUE(ok && nb == 50 && set.nbElements() == 50);
+}
+
+TEST(SwissSet, contains_string_view) {
+  il::SwissSet<il::String> set{};
+  set.Add("alpha");
+  set.Add("mesh.boundary.elements.node_ids");
+  const il::String line = "alpha mesh.boundary.elements.node_ids beta";
+
+  ASSERT_TRUE(set.contains(line.subview(0, 5)) &&
+              set.contains(line.subview(6, 37)) &&
+              !set.contains(line.subview(38, 42)) && set.contains("alpha"));
+}
+
+TEST(Set, add) {
+  il::Set<int> set{};
+  for (int i = 0; i < 100; ++i) {
+    set.Add(2 * i);
+  }
+
+  bool ok = set.nbElements() == 100;
+  for (int i = 0; i < 200; ++i) {
+    ok = ok && (set.contains(i) == (i % 2 == 0));
+  }
+  ASSERT_TRUE(ok);
+}
+
+TEST(Set, contains_string_view) {
+  il::Set<il::String> set{};
+  set.Add("alpha");
+  set.Add("mesh.boundary.elements.node_ids");
+  const il::String line = "alpha mesh.boundary.elements.node_ids beta";
+
+  ASSERT_TRUE(set.contains(line.subview(0, 5)) &&
+              set.contains(line.subview(6, 37)) &&
+              !set.contains(line.subview(38, 42)) && set.contains("alpha"));
+}
@@ -0,0 +1,445 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#ifndef IL_STRIDEDARRAYVIEW_H
+#define IL_STRIDEDARRAYVIEW_H
+
+#include <il/container/1d/ArrayView.h>
+#include <il/container/2d/Array2CView.h>
+#include <il/container/2d/Array2DView.h>
+#include <il/core.h>
+
+namespace il {
+
+/* \brief A view on an N-dimensional array with arbitrary strides
+// \details The element (i0, ..., i(N-1)) of the view is at
+// data() + i0 * stride(0) + ... + i(N-1) * stride(N-1). Any sub-block, any
+// permutation of the dimensions, any diagonal and any slice of the view is
+// another strided view on the same memory, so none of them copies the
+// elements.
+//
+// il::Array4D<double> A{n0, n1, n2, n3};
+// il::StridedArrayView<double, 4> B =
+//     A.view(il::Range{0, n0}, il::Range{0, n1}, il::Range{1, 3},
+//            il::Range{0, 2});
+// il::StridedArrayView<double, 2> C = B.slice(3, 1).slice(2, 0);
+// il::Array2DView<double> D = C.asArray2DView();
+//
+// The conversions to il::ArrayView, il::Array2DView and il::Array2CView are
+// possible when one of the strides is 1, and the resulting views can be
+// given to the BLAS wrappers.
+*/
+template <typename T, il::int_t N>
+class StridedArrayView {
+  static_assert(N >= 1, "il::StridedArrayView<T, N>: N must be positive");
+
+  template <typename U, il::int_t M>
+  friend class StridedArrayView;
+
+ protected:
+  T* data_;
+  il::int_t size_[N];
+  il::int_t stride_[N];
+
+ public:
+  /* \brief Default constructor
+  // \details It creates a view with all its sizes equal to 0.
+  */
+  StridedArrayView();
+
+  /* \brief Construct a view from a pointer, its N sizes and its N strides
+  //
+  // const il::int_t size[2] = {n0, n1};
+  // const il::int_t stride[2] = {1, ld};
+  // il::StridedArrayView<double, 2> v{data, size, stride};
+  */
+  StridedArrayView(const T* data, const il::int_t* size,
+                   const il::int_t* stride);
+
+  /* \brief Accessor
+  // \details Access (read only) the (i0, ..., i(N-1))-th element of the view.
+  // Bound checking is done in debug mode but not in release mode.
+  */
+  template <typename... I>
+  const T& operator()(I... i) const;
+
+  /* \brief Get the size of the view along the dimension d
+   */
+  il::int_t size(il::int_t d) const;
+
+  /* \brief Memory distance (in sizeof(T)) in between two consecutive elements
+  // along the dimension d
+  */
+  il::int_t stride(il::int_t d) const;
+
+  /* \brief Get a pointer to const to the first element of the view
+  // \details One should use this method only when using C-style API
+  */
+  const T* data() const;
+
+  /* \brief Get the sub-block of the view given by one range per dimension
+  //
+  // il::StridedArrayView<double, 3> w =
+  //     v.view(il::Range{0, 2}, il::Range{1, 3}, il::Range{0, 4});
+  */
+  template <typename... R>
+  il::StridedArrayView<T, N> view(R... range) const;
+
+  /* \brief Keep one element out of step along the dimension d
+   */
+  il::StridedArrayView<T, N> stepped(il::int_t d, il::int_t step) const;
+
+  /* \brief Fix the index along the dimension d to i
+  // \details The dimension d is removed from the view.
+  */
+  il::StridedArrayView<T, N - 1> slice(il::int_t d, il::int_t i) const;
+
+  /* \brief Reverse the order of the dimensions
+  // \details For a matrix, this is the transposed matrix.
+  */
+  il::StridedArrayView<T, N> transposed() const;
+
+  /* \brief Swap the dimensions d0 and d1
+   */
+  il::StridedArrayView<T, N> transposed(il::int_t d0, il::int_t d1) const;
+
+  /* \brief Get the elements (i, ..., i) of the view
+   */
+  il::StridedArrayView<T, 1> diagonal() const;
+
+  /* \brief Get an il::ArrayView on a view of dimension 1 with a stride of 1
+   */
+  il::ArrayView<T> asArrayView() const;
+
+  /* \brief Get an il::Array2DView on a view of dimension 2 with stride(0) == 1
+   */
+  il::Array2DView<T> asArray2DView() const;
+
+  /* \brief Get an il::Array2CView on a view of dimension 2 with stride(1) == 1
+   */
+  il::Array2CView<T> asArray2CView() const;
+
+ protected:
+  il::int_t offset(const il::int_t* index) const;
+  il::StridedArrayView<T, N> subView(const il::Range* range) const;
+};
+
+template <typename T, il::int_t N>
+StridedArrayView<T, N>::StridedArrayView() {
+  data_ = nullptr;
+  for (il::int_t d = 0; d < N; ++d) {
+    size_[d] = 0;
+    stride_[d] = 0;
+  }
+}
+
+template <typename T, il::int_t N>
+StridedArrayView<T, N>::StridedArrayView(const T* data, const il::int_t* size,
+                                         const il::int_t* stride) {
+  data_ = const_cast<T*>(data);
+  for (il::int_t d = 0; d < N; ++d) {
+    IL_EXPECT_FAST(size[d] >= 0);
+    size_[d] = size[d];
+    stride_[d] = stride[d];
+  }
+}
+
+template <typename T, il::int_t N>
+template <typename... I>
+const T& StridedArrayView<T, N>::operator()(I... i) const {
+  static_assert(sizeof...(I) == N,
+                "il::StridedArrayView<T, N>: N indices are needed");
+  const il::int_t index[N] = {static_cast<il::int_t>(i)...};
+  return data_[offset(index)];
+}
+
+template <typename T, il::int_t N>
+il::int_t StridedArrayView<T, N>::size(il::int_t d) const {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(d) < static_cast<std::size_t>(N));
+  return size_[d];
+}
+
+template <typename T, il::int_t N>
+il::int_t StridedArrayView<T, N>::stride(il::int_t d) const {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(d) < static_cast<std::size_t>(N));
+  return stride_[d];
+}
+
+template <typename T, il::int_t N>
+const T* StridedArrayView<T, N>::data() const {
+  return data_;
+}
+
+template <typename T, il::int_t N>
+template <typename... R>
+il::StridedArrayView<T, N> StridedArrayView<T, N>::view(R... range) const {
+  static_assert(sizeof...(R) == N,
+                "il::StridedArrayView<T, N>: N ranges are needed");
+  const il::Range r[N] = {range...};
+  return subView(r);
+}
+
+template <typename T, il::int_t N>
+il::StridedArrayView<T, N> StridedArrayView<T, N>::stepped(
+    il::int_t d, il::int_t step) const {
+  IL_EXPECT_FAST(static_cast<std::size_t>(d) < static_cast<std::size_t>(N));
+  IL_EXPECT_FAST(step > 0);
+
+  il::StridedArrayView<T, N> ans = *this;
+  ans.size_[d] = (size_[d] + step - 1) / step;
+  ans.stride_[d] = stride_[d] * step;
+  return ans;
+}
+
+template <typename T, il::int_t N>
+il::StridedArrayView<T, N - 1> StridedArrayView<T, N>::slice(
+    il::int_t d, il::int_t i) const {
+  static_assert(N >= 2, "il::StridedArrayView<T, N>: cannot slice a view of "
+                        "dimension 1");
+  IL_EXPECT_FAST(static_cast<std::size_t>(d) < static_cast<std::size_t>(N));
+  IL_EXPECT_FAST(static_cast<std::size_t>(i) <
+                 static_cast<std::size_t>(size_[d]));
+
+  il::StridedArrayView<T, N - 1> ans{};
+  ans.data_ = data_ + i * stride_[d];
+  il::int_t k = 0;
+  for (il::int_t e = 0; e < N; ++e) {
+    if (e != d) {
+      ans.size_[k] = size_[e];
+      ans.stride_[k] = stride_[e];
+      ++k;
+    }
+  }
+  return ans;
+}
+
+template <typename T, il::int_t N>
+il::StridedArrayView<T, N> StridedArrayView<T, N>::transposed() const {
+  il::StridedArrayView<T, N> ans = *this;
+  for (il::int_t d = 0; d < N; ++d) {
+    ans.size_[d] = size_[N - 1 - d];
+    ans.stride_[d] = stride_[N - 1 - d];
+  }
+  return ans;
+}
+
+template <typename T, il::int_t N>
+il::StridedArrayView<T, N> StridedArrayView<T, N>::transposed(
+    il::int_t d0, il::int_t d1) const {
+  IL_EXPECT_FAST(static_cast<std::size_t>(d0) < static_cast<std::size_t>(N));
+  IL_EXPECT_FAST(static_cast<std::size_t>(d1) < static_cast<std::size_t>(N));
+
+  il::StridedArrayView<T, N> ans = *this;
+  ans.size_[d0] = size_[d1];
+  ans.stride_[d0] = stride_[d1];
+  ans.size_[d1] = size_[d0];
+  ans.stride_[d1] = stride_[d0];
+  return ans;
+}
+
+template <typename T, il::int_t N>
+il::StridedArrayView<T, 1> StridedArrayView<T, N>::diagonal() const {
+  il::StridedArrayView<T, 1> ans{};
+  ans.data_ = data_;
+  ans.size_[0] = size_[0];
+  ans.stride_[0] = 0;
+  for (il::int_t d = 0; d < N; ++d) {
+    ans.size_[0] = il::min(ans.size_[0], size_[d]);
+    ans.stride_[0] += stride_[d];
+  }
+  return ans;
+}
+
+template <typename T, il::int_t N>
+il::ArrayView<T> StridedArrayView<T, N>::asArrayView() const {
+  static_assert(N == 1, "il::StridedArrayView<T, N>: N must be 1");
+  IL_EXPECT_FAST(size_[0] <= 1 || stride_[0] == 1);
+
+  return il::ArrayView<T>{data_, size_[0]};
+}
+
+template <typename T, il::int_t N>
+il::Array2DView<T> StridedArrayView<T, N>::asArray2DView() const {
+  static_assert(N == 2, "il::StridedArrayView<T, N>: N must be 2");
+  IL_EXPECT_FAST(size_[0] <= 1 || stride_[0] == 1);
+  IL_EXPECT_FAST(size_[1] <= 1 || stride_[1] >= size_[0]);
+
+  return il::Array2DView<T>{data_, size_[0], size_[1],
+                            il::max(stride_[1], static_cast<il::int_t>(1))};
+}
+
+template <typename T, il::int_t N>
+il::Array2CView<T> StridedArrayView<T, N>::asArray2CView() const {
+  static_assert(N == 2, "il::StridedArrayView<T, N>: N must be 2");
+  IL_EXPECT_FAST(size_[1] <= 1 || stride_[1] == 1);
+  IL_EXPECT_FAST(size_[0] <= 1 || stride_[0] >= size_[1]);
+
+  return il::Array2CView<T>{data_, size_[0], size_[1],
+                            il::max(stride_[0], static_cast<il::int_t>(1))};
+}
+
+template <typename T, il::int_t N>
+il::int_t StridedArrayView<T, N>::offset(const il::int_t* index) const {
+  il::int_t ans = 0;
+  for (il::int_t d = 0; d < N; ++d) {
+    IL_EXPECT_MEDIUM(static_cast<std::size_t>(index[d]) <
+                     static_cast<std::size_t>(size_[d]));
+    ans += index[d] * stride_[d];
+  }
+  return ans;
+}
+
+template <typename T, il::int_t N>
+il::StridedArrayView<T, N> StridedArrayView<T, N>::subView(
+    const il::Range* range) const {
+  il::StridedArrayView<T, N> ans = *this;
+  for (il::int_t d = 0; d < N; ++d) {
+    IL_EXPECT_FAST(0 <= range[d].begin && range[d].begin <= range[d].end &&
+                   range[d].end <= size_[d]);
+    ans.data_ += range[d].begin * stride_[d];
+    ans.size_[d] = range[d].end - range[d].begin;
+  }
+  return ans;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, il::int_t N>
+class StridedArrayEdit : public StridedArrayView<T, N> {
+  template <typename U, il::int_t M>
+  friend class StridedArrayEdit;
+
+ public:
+  /* \brief Default constructor
+  // \details It creates a view with all its sizes equal to 0.
+  */
+  StridedArrayEdit();
+
+  /* \brief Construct a view from a pointer, its N sizes and its N strides
+   */
+  StridedArrayEdit(T* data, const il::int_t* size, const il::int_t* stride);
+
+  /* \brief Accessor
+  // \details Access (read and write) the (i0, ..., i(N-1))-th element of the
+  // view. Bound checking is done in debug mode but not in release mode.
+  */
+  template <typename... I>
+  T& operator()(I... i);
+
+  /* \brief Get a pointer to the first element of the view
+  // \details One should use this method only when using C-style API
+  */
+  T* Data();
+
+  template <typename... R>
+  il::StridedArrayEdit<T, N> Edit(R... range);
+
+  il::StridedArrayEdit<T, N> Stepped(il::int_t d, il::int_t step);
+
+  il::StridedArrayEdit<T, N - 1> Slice(il::int_t d, il::int_t i);
+
+  il::StridedArrayEdit<T, N> Transposed();
+
+  il::StridedArrayEdit<T, N> Transposed(il::int_t d0, il::int_t d1);
+
+  il::StridedArrayEdit<T, 1> Diagonal();
+
+  il::ArrayEdit<T> asArrayEdit();
+
+  il::Array2DEdit<T> asArray2DEdit();
+
+ private:
+  explicit StridedArrayEdit(const il::StridedArrayView<T, N>& v);
+};
+
+template <typename T, il::int_t N>
+StridedArrayEdit<T, N>::StridedArrayEdit() : StridedArrayView<T, N>{} {}
+
+template <typename T, il::int_t N>
+StridedArrayEdit<T, N>::StridedArrayEdit(T* data, const il::int_t* size,
+                                         const il::int_t* stride)
+    : StridedArrayView<T, N>{data, size, stride} {}
+
+template <typename T, il::int_t N>
+StridedArrayEdit<T, N>::StridedArrayEdit(const il::StridedArrayView<T, N>& v)
+    : StridedArrayView<T, N>{v} {}
+
+template <typename T, il::int_t N>
+template <typename... I>
+T& StridedArrayEdit<T, N>::operator()(I... i) {
+  static_assert(sizeof...(I) == N,
+                "il::StridedArrayEdit<T, N>: N indices are needed");
+  const il::int_t index[N] = {static_cast<il::int_t>(i)...};
+  return this->data_[this->offset(index)];
+}
+
+template <typename T, il::int_t N>
+T* StridedArrayEdit<T, N>::Data() {
+  return this->data_;
+}
+
+template <typename T, il::int_t N>
+template <typename... R>
+il::StridedArrayEdit<T, N> StridedArrayEdit<T, N>::Edit(R... range) {
+  return il::StridedArrayEdit<T, N>{this->view(range...)};
+}
+
+template <typename T, il::int_t N>
+il::StridedArrayEdit<T, N> StridedArrayEdit<T, N>::Stepped(il::int_t d,
+                                                           il::int_t step) {
+  return il::StridedArrayEdit<T, N>{this->stepped(d, step)};
+}
+
+template <typename T, il::int_t N>
+il::StridedArrayEdit<T, N - 1> StridedArrayEdit<T, N>::Slice(il::int_t d,
+                                                             il::int_t i) {
+  return il::StridedArrayEdit<T, N - 1>{this->slice(d, i)};
+}
+
+template <typename T, il::int_t N>
+il::StridedArrayEdit<T, N> StridedArrayEdit<T, N>::Transposed() {
+  return il::StridedArrayEdit<T, N>{this->transposed()};
+}
+
+template <typename T, il::int_t N>
+il::StridedArrayEdit<T, N> StridedArrayEdit<T, N>::Transposed(il::int_t d0,
+                                                              il::int_t d1) {
+  return il::StridedArrayEdit<T, N>{this->transposed(d0, d1)};
+}
+
+template <typename T, il::int_t N>
+il::StridedArrayEdit<T, 1> StridedArrayEdit<T, N>::Diagonal() {
+  return il::StridedArrayEdit<T, 1>{this->diagonal()};
+}
+
+template <typename T, il::int_t N>
+il::ArrayEdit<T> StridedArrayEdit<T, N>::asArrayEdit() {
+  il::ArrayView<T> v = this->asArrayView();
+  return il::ArrayEdit<T>{this->data_, v.size()};
+}
+
+template <typename T, il::int_t N>
+il::Array2DEdit<T> StridedArrayEdit<T, N>::asArray2DEdit() {
+  il::Array2DView<T> v = this->asArray2DView();
+  return il::Array2DEdit<T>{this->data_, v.size(0), v.size(1), v.stride(1),
+                            0, 0};
+}
+
+}  // namespace il
+
+#endif  // IL_STRIDEDARRAYVIEW_H
@@ -0,0 +1,153 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#include <gtest/gtest.h>
+
+#include <il/Array3D.h>
+#include <il/Array4C.h>
+#include <il/Array4D.h>
+#include <il/StridedArrayView.h>
+
+static il::Array4D<double> array4D(il::int_t n0, il::int_t n1, il::int_t n2,
+                                   il::int_t n3) {
+  il::Array4D<double> A{n0, n1, n2, n3};
+  for (il::int_t i3 = 0; i3 < n3; ++i3) {
+    for (il::int_t i2 = 0; i2 < n2; ++i2) {
+      for (il::int_t i1 = 0; i1 < n1; ++i1) {
+        for (il::int_t i0 = 0; i0 < n0; ++i0) {
+          A(i0, i1, i2, i3) = 1000 * i0 + 100 * i1 + 10 * i2 + i3;
+        }
+      }
+    }
+  }
+  return A;
+}
+
+TEST(StridedArrayView, default_constructor) {
+  il::StridedArrayView<double, 3> v{};
+
+  ASSERT_TRUE(v.data() == nullptr && v.size(0) == 0 && v.size(1) == 0 &&
+              v.size(2) == 0);
+}
+
+TEST(StridedArrayView, array4d) {
+  const il::Array4D<double> A = array4D(2, 3, 4, 5);
+  il::StridedArrayView<double, 4> v = A.view();
+
+  bool correct = v.size(0) == 2 && v.size(1) == 3 && v.size(2) == 4 &&
+                 v.size(3) == 5;
+  for (il::int_t i3 = 0; i3 < 5; ++i3) {
+    for (il::int_t i2 = 0; i2 < 4; ++i2) {
+      for (il::int_t i1 = 0; i1 < 3; ++i1) {
+        for (il::int_t i0 = 0; i0 < 2; ++i0) {
+          if (v(i0, i1, i2, i3) != A(i0, i1, i2, i3)) {
+            correct = false;
+          }
+        }
+      }
+    }
+  }
+  ASSERT_TRUE(correct);
+}
+
+TEST(StridedArrayView, array4c) {
+  il::Array4C<double> A{2, 3, 4, 5};
+  for (il::int_t i0 = 0; i0 < 2; ++i0) {
+    for (il::int_t i1 = 0; i1 < 3; ++i1) {
+      for (il::int_t i2 = 0; i2 < 4; ++i2) {
+        for (il::int_t i3 = 0; i3 < 5; ++i3) {
+          A(i0, i1, i2, i3) = 1000 * i0 + 100 * i1 + 10 * i2 + i3;
+        }
+      }
+    }
+  }
+  il::StridedArrayView<double, 4> v =
+      A.view(il::Range{1, 2}, il::Range{0, 3}, il::Range{2, 4},
+             il::Range{1, 5});
+
+  ASSERT_TRUE(v.size(0) == 1 && v.size(1) == 3 && v.size(2) == 2 &&
+              v.size(3) == 4 && v.stride(3) == 1 && v(0, 0, 0, 0) == 1021.0 &&
+              v(0, 2, 1, 3) == 1234.0);
+}
+
+TEST(StridedArrayView, view) {
+  const il::Array4D<double> A = array4D(4, 4, 4, 4);
+  il::StridedArrayView<double, 4> v =
+      A.view(il::Range{1, 3}, il::Range{0, 4}, il::Range{2, 3},
+             il::Range{1, 4});
+
+  ASSERT_TRUE(v.size(0) == 2 && v.size(1) == 4 && v.size(2) == 1 &&
+              v.size(3) == 3 && v(0, 0, 0, 0) == 1021.0 &&
+              v(1, 3, 0, 2) == 2323.0);
+}
+
+TEST(StridedArrayView, stepped) {
+  const il::Array4D<double> A = array4D(5, 1, 1, 1);
+  il::StridedArrayView<double, 4> v = A.view().stepped(0, 2);
+
+  ASSERT_TRUE(v.size(0) == 3 && v.stride(0) == 2 && v(0, 0, 0, 0) == 0.0 &&
+              v(1, 0, 0, 0) == 2000.0 && v(2, 0, 0, 0) == 4000.0);
+}
+
+TEST(StridedArrayView, slice) {
+  const il::Array4D<double> A = array4D(2, 3, 4, 5);
+  il::StridedArrayView<double, 2> v = A.view().slice(3, 4).slice(2, 1);
+
+  ASSERT_TRUE(v.size(0) == 2 && v.size(1) == 3 && v(1, 2) == 1214.0);
+}
+
+TEST(StridedArrayView, transposed) {
+  const il::Array4D<double> A = array4D(2, 3, 4, 5);
+  il::StridedArrayView<double, 4> v = A.view().transposed();
+  il::StridedArrayView<double, 4> w = A.view().transposed(1, 2);
+
+  ASSERT_TRUE(v.size(0) == 5 && v.size(3) == 2 && v(4, 3, 2, 1) == 1234.0 &&
+              w.size(1) == 4 && w.size(2) == 3 && w(1, 3, 2, 4) == 1234.0);
+}
+
+TEST(StridedArrayView, diagonal) {
+  const il::Array4D<double> A = array4D(3, 4, 3, 5);
+  il::StridedArrayView<double, 1> v = A.view().diagonal();
+
+  ASSERT_TRUE(v.size(0) == 3 && v(0) == 0.0 && v(1) == 1111.0 &&
+              v(2) == 2222.0);
+}
+
+TEST(StridedArrayView, asArray2DView) {
+  const il::Array4D<double> A = array4D(2, 3, 4, 5);
+  il::Array2DView<double> v = A.view().slice(3, 2).slice(1, 1).asArray2DView();
+  il::Array2CView<double> w =
+      A.view().slice(3, 2).slice(1, 1).transposed().asArray2CView();
+
+  ASSERT_TRUE(v.size(0) == 2 && v.size(1) == 4 && v(1, 3) == 1132.0 &&
+              w.size(0) == 4 && w.size(1) == 2 && w(3, 1) == 1132.0);
+}
+
+TEST(StridedArrayEdit, array3d) {
+  il::Array3D<double> A{3, 3, 3, 0.0};
+  il::StridedArrayEdit<double, 1> v = A.Edit().Diagonal();
+  for (il::int_t i = 0; i < v.size(0); ++i) {
+    v(i) = 1.0;
+  }
+  il::StridedArrayEdit<double, 3> w =
+      A.Edit(il::Range{0, 1}, il::Range{0, 3}, il::Range{2, 3});
+  w(0, 1, 0) = 2.0;
+
+  ASSERT_TRUE(A(0, 0, 0) == 1.0 && A(1, 1, 1) == 1.0 && A(2, 2, 2) == 1.0 &&
+              A(1, 0, 0) == 0.0 && A(0, 1, 2) == 2.0);
+}
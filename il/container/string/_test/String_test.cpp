@@ -115,6 +115,14 @@ TEST(String, append_3) {
                                "Hello world! I am so happy to be there"));
 }
 
+TEST(String, subview_large) {
+  const il::String s{"Hello world! I am so happy to be there"};
+  const il::StringView v = s.subview(33, 38);
+
+  ASSERT_TRUE(!s.isSmall() && v.size() == 5 && v.data() == s.data() + 33 &&
+              v[0] == 't' && v[4] == 'e');
+}
+
 // TEST(String, append_4) {
 //  il::String s = "HelloHelloHelloHello";
 //  s.Append(s);
@@ -25,6 +25,8 @@
 #include <climits>
 // <cstdlib> is needed for std::abort()
 #include <cstdlib>
+// <type_traits> is needed for std::is_trivially_copyable
+#include <type_traits>
 
 #include <complex>
 
@@ -238,6 +240,18 @@ const emplace_t emplace{};
 struct align_t {};
 const align_t align{};
 
+struct hugepage_t {};
+const hugepage_t hugepage{};
+
+struct pad_t {};
+const pad_t pad{};
+
+struct parallel_t {};
+const parallel_t parallel{};
+
+struct uninitialized_t {};
+const uninitialized_t uninitialized{};
+
 struct unit_t {};
 const unit_t unit{};
 
@@ -562,6 +576,20 @@ inline std::complex<double> defaultValue<std::complex<double>>() {
 #endif
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Relocation of objects
+////////////////////////////////////////////////////////////////////////////////
+
+// An object is relocatable if it can be moved to another place in memory with
+// memcpy, the original being discarded without calling its destructor. The
+// arrays of relocatable objects are grown with realloc, in place if possible.
+// This trait can be specialized for types that do not point to themselves.
+template <typename T>
+struct isRelocatable {
+  static constexpr bool value =
+      il::isTrivial<T>::value || std::is_trivially_copyable<T>::value;
+};
+
 }  // namespace il
 
 #endif  // IL_BASE_H
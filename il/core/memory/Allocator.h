@@ -0,0 +1,142 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#ifndef IL_ALLOCATOR_H
+#define IL_ALLOCATOR_H
+
+// <cstddef> is needed for std::size_t
+#include <cstddef>
+// <cstdlib> is used for std::malloc
+#include <cstdlib>
+// <cstring> is needed for memcpy
+#include <cstring>
+
+#include <il/core/core.h>
+
+namespace il {
+
+/* \brief Interface for the memory resources used by the containers
+// \details Every owning container (il::Array, il::Array2D, il::Array3D,
+// il::Map, il::String, ...) gets its memory through il::allocateArray, which
+// forwards the request to the allocator of the current thread. The memory
+// returned by Allocate must be aligned for any fundamental type. When the
+// allocator can not satisfy the request, it should return nullptr and the
+// program will be aborted by il::allocateArray.
+//
+// The block is always given back to the allocator that has created it, with
+// the same number of bytes that has been requested, even if the allocator of
+// the thread has changed in between.
+//
+// Reallocate is used to grow the arrays of relocatable types. Its default
+// implementation allocates a new block, copies the content and deallocates
+// the old block. Allocators that can resize a block in place should override
+// it. It returns nullptr, and leaves the block untouched, when it fails.
+*/
+class Allocator {
+ public:
+  virtual ~Allocator() {}
+  virtual void* Allocate(std::size_t n_bytes) = 0;
+  virtual void Deallocate(void* p, std::size_t n_bytes) = 0;
+  virtual void* Reallocate(void* p, std::size_t n_bytes_old,
+                           std::size_t n_bytes);
+};
+
+inline void* Allocator::Reallocate(void* p, std::size_t n_bytes_old,
+                                   std::size_t n_bytes) {
+  void* q = Allocate(n_bytes);
+  if (!q) {
+    return nullptr;
+  }
+  std::memcpy(q, p, n_bytes_old < n_bytes ? n_bytes_old : n_bytes);
+  Deallocate(p, n_bytes_old);
+  return q;
+}
+
+/* \brief The allocator used by default, which is a thin layer over std::malloc
+// and std::free
+*/
+class MallocAllocator : public il::Allocator {
+ public:
+  void* Allocate(std::size_t n_bytes) override;
+  void Deallocate(void* p, std::size_t n_bytes) override;
+  void* Reallocate(void* p, std::size_t n_bytes_old,
+                   std::size_t n_bytes) override;
+};
+
+inline void* MallocAllocator::Allocate(std::size_t n_bytes) {
+  return std::malloc(n_bytes);
+}
+
+inline void MallocAllocator::Deallocate(void* p, std::size_t n_bytes) {
+  IL_UNUSED(n_bytes);
+
+  std::free(p);
+}
+
+inline void* MallocAllocator::Reallocate(void* p, std::size_t n_bytes_old,
+                                         std::size_t n_bytes) {
+  IL_UNUSED(n_bytes_old);
+
+  return std::realloc(p, n_bytes);
+}
+
+/* \brief Get the allocator used by the current thread
+// \details The function returns nullptr when the thread uses the default
+// allocator. In this case, il::allocateArray calls std::malloc, or the pool
+// allocator when the library is compiled with IL_THREAD_CACHE, directly so
+// that the default behavior does not pay for a virtual call.
+*/
+inline il::Allocator*& threadAllocator() {
+  static thread_local il::Allocator* allocator = nullptr;
+  return allocator;
+}
+
+/* \brief Change the allocator used by the current thread for the lifetime of
+// the scope
+// \details All the containers constructed, resized or grown within the scope
+// get their memory from the allocator. Their memory is given back to the same
+// allocator when they are destroyed, even if it happens outside the scope.
+// Scopes can be nested.
+//
+// il::MallocAllocator allocator{};
+// {
+//   il::AllocatorScope scope{allocator};
+//   il::Array<double> v{n};
+// }
+*/
+class AllocatorScope {
+ private:
+  il::Allocator* previous_;
+
+ public:
+  explicit AllocatorScope(il::Allocator& allocator);
+  AllocatorScope(const AllocatorScope& other) = delete;
+  AllocatorScope& operator=(const AllocatorScope& other) = delete;
+  ~AllocatorScope();
+};
+
+inline AllocatorScope::AllocatorScope(il::Allocator& allocator) {
+  previous_ = il::threadAllocator();
+  il::threadAllocator() = &allocator;
+}
+
+inline AllocatorScope::~AllocatorScope() { il::threadAllocator() = previous_; }
+
+}  // namespace il
+
+#endif  // IL_ALLOCATOR_H
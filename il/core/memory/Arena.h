@@ -0,0 +1,220 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#ifndef IL_ARENA_H
+#define IL_ARENA_H
+
+// <cstddef> is needed for std::max_align_t
+#include <cstddef>
+// <cstdlib> is used for std::malloc
+#include <cstdlib>
+
+#include <il/core/memory/Allocator.h>
+
+namespace il {
+
+/* \brief A monotonic allocator for short-lived containers
+// \details Memory is taken from large chunks by bumping a pointer. Giving
+// back a block does nothing unless it is the last one that has been
+// allocated. All the memory is released at once with Reset() or at the end of
+// an il::ArenaScope, in O(1). The chunks are kept for the next allocations
+// and are only given back to the system when the arena is destroyed.
+//
+// The containers that have been allocated from the arena must not be used
+// after the memory has been released.
+//
+// il::Arena arena{};
+// for (il::int_t step = 0; step < nb_steps; ++step) {
+//   il::ArenaScope scope{arena};
+//   il::Array<double> residual{n};
+//   ...
+// }
+*/
+class Arena : public il::Allocator {
+  friend class ArenaScope;
+
+ private:
+  struct Chunk {
+    Chunk* next;
+    std::size_t capacity;
+  };
+  Chunk* first_;
+  Chunk* chunk_;
+  unsigned char* top_;
+  unsigned char* end_;
+  std::size_t chunk_capacity_;
+
+ public:
+  /* \brief Construct an arena whose chunks have a capacity of n bytes
+  // \details No memory allocation is done until the first allocation.
+  */
+  explicit Arena(il::int_t n = 1048576);
+  Arena(const Arena& other) = delete;
+  Arena& operator=(const Arena& other) = delete;
+  ~Arena();
+  void* Allocate(std::size_t n_bytes) override;
+  void Deallocate(void* p, std::size_t n_bytes) override;
+  void* Reallocate(void* p, std::size_t n_bytes_old,
+                   std::size_t n_bytes) override;
+
+  /* \brief Release all the memory allocated from the arena
+   */
+  void Reset();
+
+  /* \brief Get the number of bytes held by the chunks of the arena
+   */
+  il::int_t capacity() const;
+
+ private:
+  static std::size_t roundUp(std::size_t n_bytes);
+  static unsigned char* begin(Chunk* chunk);
+  void* AllocateNextChunk(std::size_t n_bytes);
+};
+
+inline Arena::Arena(il::int_t n) {
+  IL_EXPECT_FAST(n > 0);
+
+  first_ = nullptr;
+  chunk_ = nullptr;
+  top_ = nullptr;
+  end_ = nullptr;
+  chunk_capacity_ = roundUp(static_cast<std::size_t>(n));
+}
+
+inline Arena::~Arena() {
+  Chunk* chunk = first_;
+  while (chunk) {
+    Chunk* next = chunk->next;
+    std::free(chunk);
+    chunk = next;
+  }
+}
+
+inline void* Arena::Allocate(std::size_t n_bytes) {
+  const std::size_t n = roundUp(n_bytes);
+  if (n <= static_cast<std::size_t>(end_ - top_)) {
+    unsigned char* p = top_;
+    top_ += n;
+    return p;
+  } else {
+    return AllocateNextChunk(n);
+  }
+}
+
+inline void Arena::Deallocate(void* p, std::size_t n_bytes) {
+  unsigned char* q = static_cast<unsigned char*>(p);
+  if (q + roundUp(n_bytes) == top_) {
+    top_ = q;
+  }
+}
+
+// The most recent block is resized in place if it fits in the current chunk
+inline void* Arena::Reallocate(void* p, std::size_t n_bytes_old,
+                               std::size_t n_bytes) {
+  unsigned char* q = static_cast<unsigned char*>(p);
+  if (q + roundUp(n_bytes_old) == top_ &&
+      roundUp(n_bytes) <= static_cast<std::size_t>(end_ - q)) {
+    top_ = q + roundUp(n_bytes);
+    return p;
+  }
+  return il::Allocator::Reallocate(p, n_bytes_old, n_bytes);
+}
+
+inline void Arena::Reset() {
+  chunk_ = nullptr;
+  top_ = nullptr;
+  end_ = nullptr;
+}
+
+inline il::int_t Arena::capacity() const {
+  std::size_t ans = 0;
+  for (Chunk* chunk = first_; chunk; chunk = chunk->next) {
+    ans += chunk->capacity;
+  }
+  return static_cast<il::int_t>(ans);
+}
+
+inline std::size_t Arena::roundUp(std::size_t n_bytes) {
+  const std::size_t alignment = alignof(std::max_align_t);
+  return ((n_bytes + alignment - 1) / alignment) * alignment;
+}
+
+inline unsigned char* Arena::begin(Chunk* chunk) {
+  return reinterpret_cast<unsigned char*>(chunk) + roundUp(sizeof(Chunk));
+}
+
+inline void* Arena::AllocateNextChunk(std::size_t n_bytes) {
+  Chunk* next = chunk_ ? chunk_->next : first_;
+  if (!next || next->capacity < n_bytes) {
+    const std::size_t capacity = il::max(chunk_capacity_, n_bytes);
+    Chunk* chunk =
+        static_cast<Chunk*>(std::malloc(roundUp(sizeof(Chunk)) + capacity));
+    if (!chunk) {
+      return nullptr;
+    }
+    chunk->next = next;
+    chunk->capacity = capacity;
+    if (chunk_) {
+      chunk_->next = chunk;
+    } else {
+      first_ = chunk;
+    }
+    next = chunk;
+  }
+  chunk_ = next;
+  top_ = begin(chunk_) + n_bytes;
+  end_ = begin(chunk_) + chunk_->capacity;
+  return begin(chunk_);
+}
+
+/* \brief Allocate all the containers of a scope from an arena
+// \details The memory allocated from the arena within the scope is released
+// when the scope ends. Scopes on the same arena can be nested: an inner scope
+// only releases the memory it has allocated.
+*/
+class ArenaScope {
+ private:
+  il::AllocatorScope allocator_scope_;
+  il::Arena& arena_;
+  il::Arena::Chunk* chunk_;
+  unsigned char* top_;
+  unsigned char* end_;
+
+ public:
+  explicit ArenaScope(il::Arena& arena);
+  ArenaScope(const ArenaScope& other) = delete;
+  ArenaScope& operator=(const ArenaScope& other) = delete;
+  ~ArenaScope();
+};
+
+inline ArenaScope::ArenaScope(il::Arena& arena)
+    : allocator_scope_{arena}, arena_(arena) {
+  chunk_ = arena.chunk_;
+  top_ = arena.top_;
+  end_ = arena.end_;
+}
+
+inline ArenaScope::~ArenaScope() {
+  arena_.chunk_ = chunk_;
+  arena_.top_ = top_;
+  arena_.end_ = end_;
+}
+
+}  // namespace il
+
+#endif  // IL_ARENA_H
@@ -0,0 +1,176 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#ifndef IL_HUGEPAGE_H
+#define IL_HUGEPAGE_H
+
+// <cstdlib> is used for std::malloc
+#include <cstdlib>
+
+// IL_UNIX is defined in <il/core/core.h>
+#include <il/core/core.h>
+
+#ifdef IL_UNIX
+// <sys/mman.h> is needed for mmap, mremap and madvise
+#include <sys/mman.h>
+#endif
+
+#include <il/core/memory/allocate.h>
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+#define IL_HUGEPAGE
+#endif
+
+namespace il {
+
+enum class Backing { Heap, HugePage };
+
+/* \brief An allocator that backs large blocks with transparent huge pages
+// \details Blocks of at least 1 MiB are obtained with an anonymous mmap aligned
+// on 2 MiB, and madvise(MADV_HUGEPAGE) is called on them so that the kernel
+// backs them with huge pages. This reduces TLB misses on large arrays. If
+// the system does not support it, or if any of those calls fails, the block
+// is obtained from std::malloc.
+//
+// The blocks coming from the heap are never aligned on 2 MiB, which is how
+// the allocator knows how to release a block.
+*/
+class HugePageAllocator : public il::Allocator {
+ public:
+  static const std::size_t huge_page_size = 2097152;
+
+  void* Allocate(std::size_t n_bytes) override;
+  void Deallocate(void* p, std::size_t n_bytes) override;
+  void* Reallocate(void* p, std::size_t n_bytes_old,
+                   std::size_t n_bytes) override;
+
+ private:
+  static void* AllocateHeap(std::size_t n_bytes);
+  static std::size_t roundUp(std::size_t n_bytes);
+};
+
+inline void* HugePageAllocator::Allocate(std::size_t n_bytes) {
+#ifdef IL_HUGEPAGE
+  if (n_bytes >= huge_page_size / 2) {
+    const std::size_t n = roundUp(n_bytes);
+    void* q = mmap(nullptr, n + huge_page_size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (q != MAP_FAILED) {
+      unsigned char* begin = static_cast<unsigned char*>(q);
+      const std::size_t r =
+          reinterpret_cast<std::size_t>(begin) % huge_page_size;
+      const std::size_t head = r == 0 ? 0 : huge_page_size - r;
+      unsigned char* p = begin + head;
+      if (head > 0) {
+        munmap(begin, head);
+      }
+      munmap(p + n, huge_page_size - head);
+      if (madvise(p, n, MADV_HUGEPAGE) == 0) {
+        return p;
+      }
+      munmap(p, n);
+    }
+  }
+#endif
+  return AllocateHeap(n_bytes);
+}
+
+inline void HugePageAllocator::Deallocate(void* p, std::size_t n_bytes) {
+  unsigned char* q = static_cast<unsigned char*>(p);
+#ifdef IL_HUGEPAGE
+  if (reinterpret_cast<std::size_t>(q) % huge_page_size == 0) {
+    munmap(q, roundUp(n_bytes));
+    return;
+  }
+#else
+  IL_UNUSED(n_bytes);
+#endif
+  std::free(q - q[-1]);
+}
+
+// A block backed by huge pages is grown with mremap, which only succeeds if
+// the pages that follow the block are free as the block must stay aligned on
+// 2 MiB. Otherwise, a new block is allocated and the content is copied.
+inline void* HugePageAllocator::Reallocate(void* p, std::size_t n_bytes_old,
+                                           std::size_t n_bytes) {
+#ifdef IL_HUGEPAGE
+  if (reinterpret_cast<std::size_t>(p) % huge_page_size == 0 &&
+      n_bytes >= huge_page_size / 2) {
+    const std::size_t n_old = roundUp(n_bytes_old);
+    const std::size_t n = roundUp(n_bytes);
+    if (n == n_old) {
+      return p;
+    }
+    if (mremap(p, n_old, n, 0) != MAP_FAILED) {
+      if (n > n_old) {
+        madvise(static_cast<unsigned char*>(p) + n_old, n - n_old,
+                MADV_HUGEPAGE);
+      }
+      return p;
+    }
+  }
+#endif
+  return il::Allocator::Reallocate(p, n_bytes_old, n_bytes);
+}
+
+// The offset to the pointer given by std::malloc is stored in the byte that
+// precedes the block
+inline void* HugePageAllocator::AllocateHeap(std::size_t n_bytes) {
+  const std::size_t alignment = alignof(std::max_align_t);
+  bool error = false;
+  const std::size_t n = il::safeSum(n_bytes, 2 * alignment, il::io, error);
+  if (error) {
+    return nullptr;
+  }
+  unsigned char* q = static_cast<unsigned char*>(std::malloc(n));
+  if (!q) {
+    return nullptr;
+  }
+  const std::size_t offset =
+      reinterpret_cast<std::size_t>(q + alignment) % huge_page_size == 0
+          ? 2 * alignment
+          : alignment;
+  unsigned char* p = q + offset;
+  p[-1] = static_cast<unsigned char>(offset);
+  return p;
+}
+
+inline std::size_t HugePageAllocator::roundUp(std::size_t n_bytes) {
+  return ((n_bytes + huge_page_size - 1) / huge_page_size) * huge_page_size;
+}
+
+inline il::HugePageAllocator& hugePageAllocator() {
+  static il::HugePageAllocator* allocator = new il::HugePageAllocator{};
+  return *allocator;
+}
+
+/* \brief Get the memory backing a block returned by il::allocateArray
+ */
+inline il::Backing backing(const void* p) {
+  const il::AllocationHeader* header = il::allocationHeader(p);
+  const bool huge_page =
+      header->allocator == &il::hugePageAllocator() &&
+      reinterpret_cast<std::size_t>(header) %
+              il::HugePageAllocator::huge_page_size ==
+          0;
+  return huge_page ? il::Backing::HugePage : il::Backing::Heap;
+}
+
+}  // namespace il
+
+#endif  // IL_HUGEPAGE_H
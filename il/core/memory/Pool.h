@@ -0,0 +1,293 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#ifndef IL_POOL_H
+#define IL_POOL_H
+
+// <cstdlib> is used for std::malloc
+#include <cstdlib>
+// <mutex> is needed for std::mutex
+#include <mutex>
+
+#include <il/core/memory/Allocator.h>
+
+namespace il {
+
+/* \brief A pool allocator with power-of-two size classes and thread caches
+// \details Blocks from 32 bytes to 64 KiB are rounded up to the next power of
+// two. Every thread keeps a free list for each size class, so most
+// allocations and deallocations are a push or a pop on a thread-local list
+// without any lock. When a list is empty, a batch of blocks is taken from a
+// global list or carved in a new slab. When a list gets too long, a batch is
+// given back to the global list so that memory freed by one thread can be
+// reused by the others. Larger blocks go straight to std::malloc.
+//
+// Once the cache of a thread has been destroyed, which happens for the main
+// thread before the destructors of the static objects run, the blocks of the
+// thread go straight to the global lists.
+//
+// The slabs are never given back to the system. The pool is shared by all
+// threads and is used within an il::AllocatorScope:
+//
+// il::AllocatorScope scope{il::poolAllocator()};
+// il::Map<il::String, il::int_t> map{};
+*/
+class PoolAllocator : public il::Allocator {
+ public:
+  static const int nb_size_classes = 12;
+
+  void* Allocate(std::size_t n_bytes) override;
+  void Deallocate(void* p, std::size_t n_bytes) override;
+  void* Reallocate(void* p, std::size_t n_bytes_old,
+                   std::size_t n_bytes) override;
+
+  /* \brief Get the size of the blocks handed out for a request of n bytes
+  // \details Returns 0 if the request is too large to be handled by the pool.
+  */
+  static std::size_t blockSize(std::size_t n_bytes);
+
+ private:
+  struct Block {
+    Block* next;
+  };
+  struct ThreadCache {
+    Block* list[nb_size_classes];
+    il::int_t size[nb_size_classes];
+    ThreadCache();
+    ~ThreadCache();
+  };
+  struct CentralList {
+    std::mutex mutex;
+    Block* list;
+  };
+  static int sizeClass(std::size_t n_bytes);
+  static il::int_t batchSize(int k);
+  static ThreadCache* threadCache();
+  static bool& threadCacheDestroyed();
+  static CentralList& centralList(int k);
+  static void Refill(int k, il::io_t, ThreadCache& cache);
+  static void Release(int k, il::int_t n, il::io_t, ThreadCache& cache);
+  static void* AllocateGlobal(int k);
+  static void DeallocateGlobal(int k, void* p);
+};
+
+inline void* PoolAllocator::Allocate(std::size_t n_bytes) {
+  const int k = sizeClass(n_bytes);
+  if (k < 0) {
+    return std::malloc(n_bytes);
+  }
+
+  ThreadCache* cache_pointer = threadCache();
+  if (!cache_pointer) {
+    return AllocateGlobal(k);
+  }
+  ThreadCache& cache = *cache_pointer;
+  if (!cache.list[k]) {
+    Refill(k, il::io, cache);
+    if (!cache.list[k]) {
+      return nullptr;
+    }
+  }
+  Block* block = cache.list[k];
+  cache.list[k] = block->next;
+  --cache.size[k];
+  return block;
+}
+
+inline void PoolAllocator::Deallocate(void* p, std::size_t n_bytes) {
+  const int k = sizeClass(n_bytes);
+  if (k < 0) {
+    std::free(p);
+    return;
+  }
+
+  ThreadCache* cache_pointer = threadCache();
+  if (!cache_pointer) {
+    DeallocateGlobal(k, p);
+    return;
+  }
+  ThreadCache& cache = *cache_pointer;
+  Block* block = static_cast<Block*>(p);
+  block->next = cache.list[k];
+  cache.list[k] = block;
+  ++cache.size[k];
+  if (cache.size[k] > 2 * batchSize(k)) {
+    Release(k, batchSize(k), il::io, cache);
+  }
+}
+
+// A block keeps its place as long as its size class does not change
+inline void* PoolAllocator::Reallocate(void* p, std::size_t n_bytes_old,
+                                       std::size_t n_bytes) {
+  const int k = sizeClass(n_bytes);
+  if (k >= 0 && k == sizeClass(n_bytes_old)) {
+    return p;
+  }
+  if (k < 0 && sizeClass(n_bytes_old) < 0) {
+    return std::realloc(p, n_bytes);
+  }
+  return il::Allocator::Reallocate(p, n_bytes_old, n_bytes);
+}
+
+inline std::size_t PoolAllocator::blockSize(std::size_t n_bytes) {
+  const int k = sizeClass(n_bytes);
+  return k >= 0 ? static_cast<std::size_t>(32) << k : 0;
+}
+
+inline int PoolAllocator::sizeClass(std::size_t n_bytes) {
+  std::size_t block_size = 32;
+  int k = 0;
+  while (block_size < n_bytes) {
+    block_size *= 2;
+    ++k;
+    // Stops before block_size overflows for huge requests
+    if (k == nb_size_classes) {
+      return -1;
+    }
+  }
+  return k;
+}
+
+// A batch holds about 64 KiB of memory, and at least 2 blocks
+inline il::int_t PoolAllocator::batchSize(int k) {
+  const il::int_t n = static_cast<il::int_t>(65536 >> (k + 5));
+  return il::max(il::min(n, static_cast<il::int_t>(64)),
+                 static_cast<il::int_t>(2));
+}
+
+inline PoolAllocator::ThreadCache::ThreadCache() {
+  for (int k = 0; k < nb_size_classes; ++k) {
+    list[k] = nullptr;
+    size[k] = 0;
+  }
+}
+
+inline PoolAllocator::ThreadCache::~ThreadCache() {
+  for (int k = 0; k < nb_size_classes; ++k) {
+    Release(k, size[k], il::io, *this);
+  }
+  threadCacheDestroyed() = true;
+}
+
+// Returns nullptr once the cache of the thread has been destroyed
+inline PoolAllocator::ThreadCache* PoolAllocator::threadCache() {
+  if (threadCacheDestroyed()) {
+    return nullptr;
+  }
+  static thread_local ThreadCache cache{};
+  return &cache;
+}
+
+// A bool has no destructor, so it can still be read after the destruction of
+// the thread cache
+inline bool& PoolAllocator::threadCacheDestroyed() {
+  static thread_local bool destroyed = false;
+  return destroyed;
+}
+
+inline PoolAllocator::CentralList& PoolAllocator::centralList(int k) {
+  // Never destroyed so threads that exit late can still give back their blocks
+  static CentralList* central = new CentralList[nb_size_classes]();
+  return central[k];
+}
+
+inline void PoolAllocator::Refill(int k, il::io_t, ThreadCache& cache) {
+  const il::int_t n = batchSize(k);
+  const std::size_t block_size = static_cast<std::size_t>(32) << k;
+
+  CentralList& central = centralList(k);
+  {
+    std::lock_guard<std::mutex> lock{central.mutex};
+    il::int_t i = 0;
+    while (central.list && i < n) {
+      Block* block = central.list;
+      central.list = block->next;
+      block->next = cache.list[k];
+      cache.list[k] = block;
+      ++i;
+    }
+    cache.size[k] += i;
+  }
+  if (cache.list[k]) {
+    return;
+  }
+
+  unsigned char* slab = static_cast<unsigned char*>(
+      std::malloc(static_cast<std::size_t>(n) * block_size));
+  if (!slab) {
+    return;
+  }
+  for (il::int_t i = n - 1; i >= 0; --i) {
+    Block* block = reinterpret_cast<Block*>(slab + i * block_size);
+    block->next = cache.list[k];
+    cache.list[k] = block;
+  }
+  cache.size[k] += n;
+}
+
+inline void PoolAllocator::Release(int k, il::int_t n, il::io_t,
+                                   ThreadCache& cache) {
+  if (n == 0) {
+    return;
+  }
+
+  Block* first = cache.list[k];
+  Block* last = first;
+  for (il::int_t i = 1; i < n; ++i) {
+    last = last->next;
+  }
+  cache.list[k] = last->next;
+  cache.size[k] -= n;
+
+  CentralList& central = centralList(k);
+  std::lock_guard<std::mutex> lock{central.mutex};
+  last->next = central.list;
+  central.list = first;
+}
+
+inline void* PoolAllocator::AllocateGlobal(int k) {
+  CentralList& central = centralList(k);
+  {
+    std::lock_guard<std::mutex> lock{central.mutex};
+    Block* block = central.list;
+    if (block) {
+      central.list = block->next;
+      return block;
+    }
+  }
+  return std::malloc(static_cast<std::size_t>(32) << k);
+}
+
+inline void PoolAllocator::DeallocateGlobal(int k, void* p) {
+  Block* block = static_cast<Block*>(p);
+  CentralList& central = centralList(k);
+  std::lock_guard<std::mutex> lock{central.mutex};
+  block->next = central.list;
+  central.list = block;
+}
+
+/* \brief Get the pool allocator shared by all the threads
+ */
+inline il::PoolAllocator& poolAllocator() {
+  static il::PoolAllocator* pool = new il::PoolAllocator{};
+  return *pool;
+}
+
+}  // namespace il
+
+#endif  // IL_POOL_H
@@ -0,0 +1,109 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#include <gtest/gtest.h>
+
+#include <il/Array.h>
+#include <il/Array2D.h>
+#include <il/core/memory/Arena.h>
+
+TEST(Arena, default_constructor) {
+  il::Arena arena{};
+
+  ASSERT_TRUE(arena.capacity() == 0);
+}
+
+TEST(Arena, scope) {
+  il::Arena arena{1024};
+  const double* p;
+  {
+    il::ArenaScope scope{arena};
+    il::Array<double> v{10, 0.0};
+    il::Array2D<double> A{3, 4, 0.0};
+    p = v.data();
+
+    ASSERT_TRUE(il::allocatorOf(v.data()) == &arena &&
+                il::allocatorOf(A.data()) == &arena);
+  }
+  {
+    il::ArenaScope scope{arena};
+    il::Array<double> v{10, 0.0};
+
+    ASSERT_TRUE(v.data() == p);
+  }
+
+  ASSERT_TRUE(arena.capacity() == 1024 && il::threadAllocator() == nullptr);
+}
+
+TEST(Arena, nested_scope) {
+  il::Arena arena{1024};
+  il::ArenaScope scope_0{arena};
+  il::Array<double> v{10};
+  const double* p;
+  {
+    il::ArenaScope scope_1{arena};
+    il::Array<double> w{10};
+    p = w.data();
+  }
+  il::Array<double> w{10};
+
+  ASSERT_TRUE(w.data() == p && v.data() != p);
+}
+
+TEST(Arena, large_allocation) {
+  il::Arena arena{1024};
+  {
+    il::ArenaScope scope{arena};
+    il::Array<double> v{10};
+    il::Array<double> w{1000, 1.0};
+
+    ASSERT_TRUE(w[999] == 1.0);
+  }
+
+  ASSERT_TRUE(arena.capacity() >= 1024 + 1000 * 8);
+}
+
+TEST(Arena, append) {
+  il::Arena arena{1024};
+  il::ArenaScope scope{arena};
+  il::Array<il::int_t> v{};
+  for (il::int_t i = 0; i < 1000; ++i) {
+    v.Append(i);
+  }
+
+  bool correct = true;
+  for (il::int_t i = 0; i < 1000; ++i) {
+    if (v[i] != i) {
+      correct = false;
+    }
+  }
+  ASSERT_TRUE(correct);
+}
+
+TEST(Arena, append_in_place) {
+  il::Arena arena{65536};
+  il::ArenaScope scope{arena};
+  il::Array<double> v{};
+  v.Append(0.0);
+  const double* p = v.data();
+  for (il::int_t i = 1; i < 1000; ++i) {
+    v.Append(static_cast<double>(i));
+  }
+
+  ASSERT_TRUE(v.data() == p && v[999] == 999.0 && arena.capacity() == 65536);
+}
@@ -0,0 +1,146 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#include <algorithm>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <il/Array.h>
+#include <il/Map.h>
+#include <il/String.h>
+#include <il/core/memory/Pool.h>
+
+TEST(Pool, blockSize) {
+  ASSERT_TRUE(il::PoolAllocator::blockSize(1) == 32 &&
+              il::PoolAllocator::blockSize(32) == 32 &&
+              il::PoolAllocator::blockSize(33) == 64 &&
+              il::PoolAllocator::blockSize(65536) == 65536 &&
+              il::PoolAllocator::blockSize(65537) == 0 &&
+              il::PoolAllocator::blockSize(
+                  (static_cast<std::size_t>(1) << 63) + 1) == 0 &&
+              il::PoolAllocator::blockSize(static_cast<std::size_t>(-1)) ==
+                  0);
+}
+
+TEST(Pool, reuse) {
+  il::PoolAllocator& pool = il::poolAllocator();
+  void* p = pool.Allocate(40);
+  pool.Deallocate(p, 40);
+  void* q = pool.Allocate(60);
+  pool.Deallocate(q, 60);
+
+  ASSERT_TRUE(p == q);
+}
+
+TEST(Pool, string) {
+  il::AllocatorScope scope{il::poolAllocator()};
+  il::String s{"A string that does not fit in the small buffer"};
+  s.Append(" and that keeps on growing");
+
+  ASSERT_TRUE(il::allocatorOf(s.asCString()) == &il::poolAllocator() &&
+              s.isEqual("A string that does not fit in the small buffer and "
+                        "that keeps on growing"));
+}
+
+TEST(Pool, map) {
+  il::AllocatorScope scope{il::poolAllocator()};
+  il::Map<il::String, il::int_t> map{};
+  for (il::int_t i = 0; i < 1000; ++i) {
+    il::String key{"A key that does not fit in the small buffer: "};
+    key.Append(static_cast<char>('a' + i % 26));
+    key.Append(static_cast<char>('a' + (i / 26) % 26));
+    key.Append(static_cast<char>('a' + i / 676));
+    map.Set(key, i);
+  }
+
+  ASSERT_TRUE(map.nbElements() == 1000);
+}
+
+// The blocks freed by a thread are given back to the global lists, on top of
+// the ones given back before, so that another thread reuses them
+TEST(Pool, threads) {
+  const il::int_t n = 10000;
+  il::Array<void*> p{n};
+  il::Array<void*> q{n / 2};
+  std::thread producer{[&p]() {
+    for (il::int_t i = 0; i < n; ++i) {
+      p[i] = il::poolAllocator().Allocate(100);
+    }
+  }};
+  producer.join();
+  std::thread consumer{[&p]() {
+    for (il::int_t i = 0; i < n; ++i) {
+      il::poolAllocator().Deallocate(p[i], 100);
+    }
+  }};
+  consumer.join();
+  std::thread second_producer{[&q]() {
+    for (il::int_t i = 0; i < n / 2; ++i) {
+      q[i] = il::poolAllocator().Allocate(100);
+    }
+  }};
+  second_producer.join();
+  for (il::int_t i = 0; i < n / 2; ++i) {
+    il::poolAllocator().Deallocate(q[i], 100);
+  }
+  std::sort(p.begin(), p.end());
+
+  bool reused = true;
+  for (il::int_t i = 0; i < n / 2; ++i) {
+    reused = reused && std::binary_search(p.begin(), p.end(), q[i]);
+  }
+  ASSERT_TRUE(reused);
+}
+
+// Frees its block when the thread exits. As it is constructed before the
+// cache of the thread, it is destroyed after it.
+struct FreeAtThreadExit {
+  void* p = nullptr;
+  ~FreeAtThreadExit() {
+    if (p) {
+      il::poolAllocator().Deallocate(p, 100);
+    }
+  }
+};
+
+TEST(Pool, free_after_thread_cache) {
+  void* p = nullptr;
+  std::thread thread{[&p]() {
+    static thread_local FreeAtThreadExit free_at_exit{};
+    p = il::poolAllocator().Allocate(100);
+    free_at_exit.p = p;
+  }};
+  thread.join();
+  // The block is on top of the global list, and is taken by the next refill
+  const il::int_t n = 1000;
+  il::Array<void*> q{n};
+  std::thread second_thread{[&q]() {
+    for (il::int_t i = 0; i < n; ++i) {
+      q[i] = il::poolAllocator().Allocate(100);
+    }
+  }};
+  second_thread.join();
+  bool reused = false;
+  for (il::int_t i = 0; i < n; ++i) {
+    reused = reused || q[i] == p;
+    il::poolAllocator().Deallocate(q[i], 100);
+  }
+
+  ASSERT_TRUE(reused);
+}
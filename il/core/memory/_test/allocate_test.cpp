@@ -0,0 +1,203 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <il/Array.h>
+#include <il/Array2D.h>
+#include <il/Map.h>
+#include <il/String.h>
+#include <il/core/memory/allocate.h>
+
+class CountingAllocator : public il::Allocator {
+ public:
+  il::int_t nb_allocations;
+  il::int_t nb_deallocations;
+  std::size_t live_bytes;
+
+  CountingAllocator() {
+    nb_allocations = 0;
+    nb_deallocations = 0;
+    live_bytes = 0;
+  }
+  void* Allocate(std::size_t n_bytes) override {
+    ++nb_allocations;
+    live_bytes += n_bytes;
+    return std::malloc(n_bytes);
+  }
+  void Deallocate(void* p, std::size_t n_bytes) override {
+    ++nb_deallocations;
+    live_bytes -= n_bytes;
+    std::free(p);
+  }
+};
+
+TEST(allocate, default_allocator) {
+  double* p = il::allocateArray<double>(5);
+
+  ASSERT_TRUE(il::allocatorOf(p) == nullptr);
+  il::deallocate(p);
+}
+
+TEST(allocate, deallocate_nullptr) {
+  CountingAllocator allocator{};
+  {
+    il::AllocatorScope scope{allocator};
+    il::deallocate(nullptr);
+  }
+
+  ASSERT_TRUE(allocator.nb_deallocations == 0);
+}
+
+TEST(allocate, scope) {
+  CountingAllocator allocator{};
+  double* p;
+  {
+    il::AllocatorScope scope{allocator};
+    p = il::allocateArray<double>(5);
+  }
+
+  ASSERT_TRUE(il::allocatorOf(p) == &allocator &&
+              allocator.nb_allocations == 1 && allocator.live_bytes > 0);
+  il::deallocate(p);
+  ASSERT_TRUE(allocator.nb_deallocations == 1 && allocator.live_bytes == 0);
+}
+
+TEST(allocate, nested_scope) {
+  CountingAllocator allocator_0{};
+  CountingAllocator allocator_1{};
+  {
+    il::AllocatorScope scope_0{allocator_0};
+    {
+      il::AllocatorScope scope_1{allocator_1};
+      il::Array<double> v{5};
+    }
+    il::Array<double> w{5};
+  }
+  il::Array<double> z{5};
+
+  ASSERT_TRUE(il::threadAllocator() == nullptr &&
+              il::allocatorOf(z.data()) == nullptr &&
+              allocator_0.nb_allocations == 1 &&
+              allocator_0.nb_deallocations == 1 &&
+              allocator_1.nb_allocations == 1 &&
+              allocator_1.nb_deallocations == 1);
+}
+
+TEST(allocate, aligned) {
+  CountingAllocator allocator{};
+  {
+    il::AllocatorScope scope{allocator};
+    il::Array<double> v{5, il::align, 64};
+
+    ASSERT_TRUE(reinterpret_cast<std::size_t>(v.data()) % 64 == 0);
+  }
+
+  ASSERT_TRUE(allocator.nb_allocations == 1 && allocator.live_bytes == 0);
+}
+
+TEST(allocate, containers) {
+  CountingAllocator allocator{};
+  il::Array<double> v{};
+  {
+    il::AllocatorScope scope{allocator};
+    il::Array2D<double> A{3, 4};
+    il::String s{"A string that does not fit in the small buffer"};
+    il::Map<il::int_t, il::int_t> map{};
+    map.Set(1, 2);
+    v.Resize(10);
+  }
+  v.Resize(1000);
+
+  ASSERT_TRUE(allocator.nb_allocations == 4 && allocator.nb_deallocations == 4 &&
+              allocator.live_bytes == 0);
+}
+
+TEST(allocate, reallocate) {
+  double* p = il::allocateArray<double>(3);
+  p[0] = 1.0;
+  p[1] = 2.0;
+  p[2] = 3.0;
+  p = il::reallocateArray(p, 100000);
+  p[99999] = 4.0;
+
+  ASSERT_TRUE(il::allocatorOf(p) == nullptr && p[0] == 1.0 && p[1] == 2.0 &&
+              p[2] == 3.0 && p[99999] == 4.0);
+  il::deallocate(p);
+}
+
+TEST(allocate, reallocate_scope) {
+  CountingAllocator allocator{};
+  il::AllocatorScope scope{allocator};
+  il::Array<il::int_t> v{};
+  for (il::int_t i = 0; i < 1000; ++i) {
+    v.Append(i);
+  }
+
+  bool correct = true;
+  for (il::int_t i = 0; i < 1000; ++i) {
+    if (v[i] != i) {
+      correct = false;
+    }
+  }
+  ASSERT_TRUE(correct && il::allocatorOf(v.data()) == &allocator &&
+              allocator.nb_allocations == allocator.nb_deallocations + 1);
+}
+
+TEST(allocate, threads) {
+  const il::int_t nb_threads = 4;
+  il::Array<il::int_t> sum{nb_threads, 0};
+  std::thread threads[nb_threads];
+  for (il::int_t k = 0; k < nb_threads; ++k) {
+    threads[k] = std::thread{[k, &sum]() {
+      for (il::int_t j = 0; j < 100; ++j) {
+        il::Array<il::int_t> v{};
+        il::Map<il::int_t, il::int_t> map{};
+        for (il::int_t i = 0; i < 100; ++i) {
+          v.Append(i);
+          map.Set(i, i);
+        }
+        sum[k] += v[99] + map.value(map.search(99));
+      }
+    }};
+  }
+  for (il::int_t k = 0; k < nb_threads; ++k) {
+    threads[k].join();
+  }
+
+  bool correct = true;
+  for (il::int_t k = 0; k < nb_threads; ++k) {
+    if (sum[k] != 100 * 198) {
+      correct = false;
+    }
+  }
+  ASSERT_TRUE(correct);
+}
+
+#ifdef IL_THREAD_CACHE
+TEST(allocate, thread_cache) {
+  double* p = il::allocateArray<double>(5);
+  il::deallocate(p);
+  double* q = il::allocateArray<double>(6);
+
+  ASSERT_TRUE(q == p && il::allocatorOf(q) == nullptr);
+  il::deallocate(q);
+}
+#endif
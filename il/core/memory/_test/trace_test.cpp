@@ -0,0 +1,116 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include <il/Array.h>
+#include <il/core/memory/allocate.h>
+
+#ifdef IL_TRACE_ALLOCATION
+
+TEST(trace, stats) {
+  il::resetAllocationTrace();
+  {
+    il::Array<double> v{100};
+    il::Array<double> w{100};
+  }
+  const il::AllocationStats stats = il::allocationStats();
+
+  ASSERT_TRUE(stats.nb_allocations == 2 && stats.nb_deallocations == 2 &&
+              stats.n_bytes == 1600 && stats.live_bytes == 0 &&
+              stats.peak_live_bytes == 1600);
+}
+
+TEST(trace, type) {
+  il::resetAllocationTrace();
+  {
+    il::Array<double> v{100};
+    il::Array<int> w{100};
+  }
+  const il::AllocationStats stats =
+      il::allocationTracer().stats(typeid(int).name());
+
+  ASSERT_TRUE(stats.nb_allocations == 1 && stats.n_bytes == 100 * sizeof(int));
+}
+
+TEST(trace, site) {
+  const char* site;
+  {
+    il::AllocationSite scope{"assembly"};
+    il::Array<double> v{100};
+    site = il::allocationHeader(v.data())->record.site;
+  }
+
+  ASSERT_TRUE(site != nullptr && il::threadAllocationSite() == nullptr);
+}
+
+TEST(trace, site_name) {
+  char name[16] = "assembly";
+  bool same_name = false;
+  {
+    il::AllocationSite scope{name};
+    name[0] = 'A';
+    il::Array<double> v{100};
+    same_name =
+        std::strcmp(il::allocationHeader(v.data())->record.site, "assembly") ==
+        0;
+  }
+
+  ASSERT_TRUE(same_name);
+}
+
+TEST(trace, reset_live) {
+  il::Array<double> v{100};
+  il::resetAllocationTrace();
+  const il::AllocationStats reset_stats = il::allocationStats();
+  { il::Array<double> w{50}; }
+  v = il::Array<double>{};
+  const il::AllocationStats stats = il::allocationStats();
+
+  ASSERT_TRUE(reset_stats.nb_allocations == 0 &&
+              reset_stats.live_bytes >= 800 &&
+              stats.nb_allocations == 1 && stats.nb_deallocations == 2 &&
+              stats.nb_live_blocks == reset_stats.nb_live_blocks - 1 &&
+              stats.live_bytes == reset_stats.live_bytes - 800 &&
+              stats.peak_live_bytes == reset_stats.live_bytes + 400);
+}
+
+TEST(trace, lifetime) {
+  il::resetAllocationTrace();
+  { il::Array<double> v{100}; }
+  il::int_t nb_blocks = 0;
+  for (int k = 0; k < il::AllocationTracer::nb_lifetime_buckets; ++k) {
+    nb_blocks += il::allocationTracer().lifetime(k);
+  }
+
+  ASSERT_TRUE(nb_blocks == 1);
+}
+
+#else
+
+TEST(trace, disabled) {
+  IL_ALLOCATION_SITE;
+  il::Array<double> v{100};
+  const il::AllocationStats stats = il::allocationStats();
+
+  ASSERT_TRUE(stats.nb_allocations == 0 && stats.n_bytes == 0);
+}
+
+#endif
@@ -19,19 +19,140 @@
 #ifndef IL_ALLOCATE_H
 #define IL_ALLOCATE_H
 
+// <cstddef> is needed for std::max_align_t
+#include <cstddef>
 // <cstdlib> is used for std::malloc
 #include <cstdlib>
+// <cstring> is needed for memcpy
+#include <cstring>
+#ifdef IL_TRACE_ALLOCATION
+// <typeinfo> is needed for typeid
+#include <typeinfo>
+#endif
 
 #include <il/core/math/safe_arithmetic.h>
+#include <il/core/memory/Allocator.h>
+#ifdef IL_THREAD_CACHE
+#include <il/core/memory/Pool.h>
+#endif
+#include <il/core/memory/trace.h>
 #include <il/math.h>
 
+namespace il {
 
-//#include <iostream>
+// Every block of memory given to the containers starts with a header that
+// remembers the allocator that has created it, so il::deallocate can give it
+// back. A nullptr allocator means that the block comes from the default
+// allocator.
+struct AllocationHeader {
+  il::Allocator* allocator;
+  std::size_t n_bytes;
+#ifdef IL_TRACE_ALLOCATION
+  il::AllocationRecord record;
+#endif
+};
 
-namespace il {
+// The header size is rounded up so the memory that follows it keeps the
+// alignment given by the allocator
+constexpr std::size_t allocationHeaderSize() {
+  return ((sizeof(il::AllocationHeader) + alignof(std::max_align_t) - 1) /
+          alignof(std::max_align_t)) *
+         alignof(std::max_align_t);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Default allocator
+////////////////////////////////////////////////////////////////////////////////
+//
+// The default allocator is std::malloc. When the library is compiled with
+// IL_THREAD_CACHE, it is the pool allocator: blocks up to 64 KiB are taken
+// from a cache owned by the thread without any lock, and only go through a
+// global list, protected by a mutex, when the cache is empty or full. This
+// avoids the contention on the malloc arenas when many threads build their
+// own containers, for instance in an OpenMP region. Larger blocks go to
+// std::malloc. Memory of the pool is never given back to the system.
+
+inline void* defaultAllocate(std::size_t n_bytes) {
+#ifdef IL_THREAD_CACHE
+  return il::poolAllocator().Allocate(n_bytes);
+#else
+  return std::malloc(n_bytes);
+#endif
+}
+
+inline void defaultDeallocate(void* p, std::size_t n_bytes) {
+#ifdef IL_THREAD_CACHE
+  il::poolAllocator().Deallocate(p, n_bytes);
+#else
+  IL_UNUSED(n_bytes);
+  std::free(p);
+#endif
+}
+
+inline void* defaultReallocate(void* p, std::size_t n_bytes_old,
+                               std::size_t n_bytes) {
+#ifdef IL_THREAD_CACHE
+  return il::poolAllocator().Reallocate(p, n_bytes_old, n_bytes);
+#else
+  IL_UNUSED(n_bytes_old);
+  return std::realloc(p, n_bytes);
+#endif
+}
+
+inline void* allocateBytes(std::size_t n_bytes) {
+  bool error = false;
+  const std::size_t n_total =
+      il::safeSum(n_bytes, il::allocationHeaderSize(), il::io, error);
+  if (error) {
+    il::abort();
+  }
+
+  il::Allocator* allocator = il::threadAllocator();
+  void* raw =
+      allocator ? allocator->Allocate(n_total) : il::defaultAllocate(n_total);
+  if (!raw) {
+    il::abort();
+  }
+  il::AllocationHeader* header = static_cast<il::AllocationHeader*>(raw);
+  header->allocator = allocator;
+  header->n_bytes = n_total;
+
+  return static_cast<unsigned char*>(raw) + il::allocationHeaderSize();
+}
+
+inline il::AllocationHeader* allocationHeader(const void* p) {
+  IL_EXPECT_FAST(p);
+
+  return reinterpret_cast<il::AllocationHeader*>(
+      const_cast<unsigned char*>(static_cast<const unsigned char*>(p)) -
+      il::allocationHeaderSize());
+}
+
+/* \brief Get the allocator that has created the block p
+// \details The pointer p must have been returned by il::allocateArray. The
+// function returns nullptr if the block comes from the default allocator.
+*/
+inline il::Allocator* allocatorOf(const void* p) {
+  return il::allocationHeader(p)->allocator;
+}
+
+#ifdef IL_TRACE_ALLOCATION
+inline void traceAllocation(const void* p, const char* type) {
+  il::AllocationHeader* header = il::allocationHeader(p);
+  il::allocationTracer().Allocate(
+      type, header->n_bytes - il::allocationHeaderSize(), il::io,
+      header->record);
+}
+
+inline void traceDeallocation(const void* p) {
+  const il::AllocationHeader* header = il::allocationHeader(p);
+  il::allocationTracer().Deallocate(
+      header->record, header->n_bytes - il::allocationHeaderSize());
+}
+#endif
 
 template <typename T>
-T* allocateArray(il::int_t n) {
+std::size_t arrayBytes(il::int_t n) {
   IL_EXPECT_FAST(n >= 0);
 
   const std::size_t u_n = static_cast<std::size_t>(n);
@@ -41,15 +162,15 @@ T* allocateArray(il::int_t n) {
   if (u_n >= u_max_integer) {
     il::abort();
   }
-  const std::size_t n_bytes = sizeof(T) * u_n;
-
-  T* p = static_cast<T*>(std::malloc(n_bytes));
-  if (!p && n_bytes > 0) {
-    il::abort();
-  }
+  return sizeof(T) * u_n;
+}
 
-//  std::cout << "Allocated: " << p << std::endl;
-//
+template <typename T>
+T* allocateArray(il::int_t n) {
+  T* p = static_cast<T*>(il::allocateBytes(il::arrayBytes<T>(n)));
+#ifdef IL_TRACE_ALLOCATION
+  il::traceAllocation(p, typeid(T).name());
+#endif
   return p;
 }
 
@@ -76,10 +197,10 @@ T* allocateArray(il::int_t n, il::int_t align_r, il::int_t align_mod, il::io_t,
     il::abort();
   }
 
-  T* p = static_cast<T*>(std::malloc(n_bytes));
-  if (!p && n_bytes > 0) {
-    il::abort();
-  }
+  T* p = static_cast<T*>(il::allocateBytes(n_bytes));
+#ifdef IL_TRACE_ALLOCATION
+  il::traceAllocation(p, typeid(T).name());
+#endif
   const std::size_t align_r_unsigned = static_cast<std::size_t>(align_r);
   const std::size_t p_int = reinterpret_cast<std::size_t>(p);
   const std::size_t r = p_int % align_mod_unsigned;
@@ -95,10 +216,106 @@ T* allocateArray(il::int_t n, il::int_t align_r, il::int_t align_mod, il::io_t,
   return aligned_p;
 }
 
+/* \brief Leading dimension of a padded 2D array
+// \details The leading dimension r, which is a multiple of nb_lanes, is
+// increased by nb_lanes when r * sizeof(T) is a multiple of 512 bytes. The L1
+// cache has 64 sets of 64 bytes, so with a stride of 4096 bytes all the
+// columns of an array fall in the same set, and with any multiple of 512 bytes
+// they fall in at most 8 sets. Loads and stores which are 4096 bytes apart
+// also alias in the store buffer. When nb_lanes * sizeof(T) is 64 bytes, the
+// padded stride is an odd number of cache lines and the columns go through all
+// the sets.
+*/
+template <typename T>
+il::int_t padLeadingDimension(il::int_t r, il::int_t nb_lanes, il::io_t,
+                              bool& error) {
+  IL_EXPECT_FAST(r >= 0);
+  IL_EXPECT_FAST(nb_lanes > 0);
+
+  const std::size_t cache_set_period = 512;
+  // The product may wrap around, which does not change its value modulo 512
+  const std::size_t n_bytes = static_cast<std::size_t>(r) * sizeof(T);
+  if (r > 0 && n_bytes % cache_set_period == 0) {
+    return il::safeSum(r, nb_lanes, il::io, error);
+  } else {
+    error = false;
+    return r;
+  }
+}
+
 inline void deallocate(void* p) {
-//  std::cout << "Deallocated: " << p << std::endl;
-//
-  std::free(p); }
+  if (!p) {
+    return;
+  }
+
+#ifdef IL_TRACE_ALLOCATION
+  il::traceDeallocation(p);
+#endif
+  il::AllocationHeader* header = il::allocationHeader(p);
+  il::Allocator* allocator = header->allocator;
+  if (allocator) {
+    allocator->Deallocate(header, header->n_bytes);
+  } else {
+    il::defaultDeallocate(header, header->n_bytes);
+  }
+}
+
+/* \brief Resize a block returned by il::allocateArray(n) to n elements
+// \details The content of the block is kept, up to the smallest size. The
+// block is moved bytewise, so this function must only be used for the types
+// that are il::isRelocatable. When the block has been created by the allocator
+// of the current thread, it is resized in place if the allocator can do it:
+// std::realloc, which uses mremap for large blocks on Linux, is used for the
+// default allocator. Otherwise, the new block comes from the allocator of the
+// current thread.
+*/
+template <typename T>
+T* reallocateArray(T* data, il::int_t n) {
+  IL_EXPECT_FAST(data);
+
+  const std::size_t n_bytes = il::arrayBytes<T>(n);
+  bool error = false;
+  const std::size_t n_total =
+      il::safeSum(n_bytes, il::allocationHeaderSize(), il::io, error);
+  if (error) {
+    il::abort();
+  }
+
+  il::AllocationHeader* header = il::allocationHeader(data);
+  il::Allocator* allocator = header->allocator;
+  if (allocator != il::threadAllocator()) {
+    const std::size_t n_bytes_old =
+        header->n_bytes - il::allocationHeaderSize();
+    T* new_data = static_cast<T*>(il::allocateBytes(n_bytes));
+#ifdef IL_TRACE_ALLOCATION
+    il::traceAllocation(new_data, typeid(T).name());
+#endif
+    std::memcpy(static_cast<void*>(new_data), static_cast<const void*>(data),
+                n_bytes_old < n_bytes ? n_bytes_old : n_bytes);
+    il::deallocate(data);
+    return new_data;
+  }
+
+#ifdef IL_TRACE_ALLOCATION
+  il::traceDeallocation(data);
+#endif
+  void* raw = allocator
+                  ? allocator->Reallocate(header, header->n_bytes, n_total)
+                  : il::defaultReallocate(header, header->n_bytes, n_total);
+  if (!raw) {
+    il::abort();
+  }
+  header = static_cast<il::AllocationHeader*>(raw);
+  header->n_bytes = n_total;
+  T* new_data = reinterpret_cast<T*>(static_cast<unsigned char*>(raw) +
+                                     il::allocationHeaderSize());
+#ifdef IL_TRACE_ALLOCATION
+  il::traceAllocation(new_data, typeid(T).name());
+#endif
+
+  return new_data;
+}
+
 }  // namespace il
 
 #endif  // IL_ALLOCATE_H
@@ -0,0 +1,354 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#ifndef IL_TRACE_H
+#define IL_TRACE_H
+
+// <cstdio> is needed for std::FILE and std::fprintf
+#include <cstdio>
+
+#ifdef IL_TRACE_ALLOCATION
+// <chrono> is needed for std::chrono::steady_clock
+#include <chrono>
+// <map>, <set> and <string> are used instead of the containers of the library
+// as they must not allocate their memory through il::allocateArray
+#include <map>
+// <mutex> is needed for std::mutex
+#include <mutex>
+#include <set>
+#include <string>
+#ifdef __GNUC__
+// <cxxabi.h> is needed for abi::__cxa_demangle
+#include <cxxabi.h>
+#endif
+#endif
+
+#include <il/core/core.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Allocation tracing
+////////////////////////////////////////////////////////////////////////////////
+//
+// When the library is compiled with IL_TRACE_ALLOCATION, every block given by
+// il::allocateArray is recorded with its type, its allocation site and its
+// date of birth. The statistics are gathered per type and per site, and
+// il::printAllocationReport dumps them on demand:
+//
+// {
+//   il::AllocationSite site{"assembly"};
+//   il::Array<double> v{n};
+//   il::Map<il::String, il::int_t> map{};
+//   ...
+// }
+// il::printAllocationReport(stdout);
+//
+// The allocation site of a block is the innermost il::AllocationSite of the
+// thread that allocates it. Its name is copied by the tracer, so it does not
+// need to be a string literal. The macro IL_ALLOCATION_SITE opens a site named
+// after the current file and line. Without IL_TRACE_ALLOCATION, the sites and
+// the report cost nothing.
+
+namespace il {
+
+// The number of live blocks and the live bytes include the blocks allocated
+// before the last reset of the trace, the other counters do not
+struct AllocationStats {
+  il::int_t nb_allocations;
+  il::int_t nb_deallocations;
+  il::int_t nb_live_blocks;
+  std::size_t n_bytes;
+  std::size_t live_bytes;
+  std::size_t peak_live_bytes;
+};
+
+/* \brief Name the allocation site of the blocks allocated by the thread for the
+// lifetime of the scope
+*/
+class AllocationSite {
+#ifdef IL_TRACE_ALLOCATION
+ private:
+  const char* previous_;
+#endif
+
+ public:
+  explicit AllocationSite(const char* name);
+  AllocationSite(const AllocationSite& other) = delete;
+  AllocationSite& operator=(const AllocationSite& other) = delete;
+  ~AllocationSite();
+};
+
+#define IL_ALLOCATION_SITE_STRING(line) #line
+#define IL_ALLOCATION_SITE_LINE(line) IL_ALLOCATION_SITE_STRING(line)
+#define IL_ALLOCATION_SITE_NAME(line) il_allocation_site_##line
+#define IL_ALLOCATION_SITE_VARIABLE(line) IL_ALLOCATION_SITE_NAME(line)
+#define IL_ALLOCATION_SITE                                  \
+  il::AllocationSite IL_ALLOCATION_SITE_VARIABLE(__LINE__) { \
+    __FILE__ ":" IL_ALLOCATION_SITE_LINE(__LINE__)          \
+  }
+
+#ifdef IL_TRACE_ALLOCATION
+
+// Information stored in the header of every block when allocations are traced
+struct AllocationRecord {
+  const char* type;
+  const char* site;
+  std::chrono::steady_clock::time_point birth;
+};
+
+/* \brief Get the allocation site of the current thread
+// \details The function returns nullptr outside of any il::AllocationSite.
+// Otherwise, the name is the copy owned by il::allocationTracer() which lives
+// as long as the program.
+*/
+inline const char*& threadAllocationSite() {
+  static thread_local const char* site = nullptr;
+  return site;
+}
+
+class AllocationTracer {
+ public:
+  // The bucket k of the lifetime histogram counts the blocks that have lived
+  // between 2^k and 2^(k+1) microseconds. The first bucket also counts the
+  // blocks that have lived less than a microsecond.
+  static const int nb_lifetime_buckets = 32;
+
+ private:
+  std::mutex mutex_;
+  il::AllocationStats total_;
+  std::map<std::string, il::AllocationStats> type_;
+  std::map<std::string, il::AllocationStats> site_;
+  // The nodes of a std::set never move, so the names can be kept in the
+  // records of the blocks
+  std::set<std::string> site_name_;
+  il::int_t lifetime_[nb_lifetime_buckets];
+
+ public:
+  AllocationTracer();
+  void Allocate(const char* type, std::size_t n_bytes, il::io_t,
+                il::AllocationRecord& record);
+  void Deallocate(const il::AllocationRecord& record, std::size_t n_bytes);
+  il::AllocationStats stats();
+  il::AllocationStats stats(const char* type);
+  il::int_t lifetime(int k);
+  const char* siteName(const char* name);
+  void Print(std::FILE* file);
+  void Reset();
+
+ private:
+  static void Allocate(std::size_t n_bytes, il::io_t,
+                       il::AllocationStats& stats);
+  static void Deallocate(std::size_t n_bytes, il::io_t,
+                         il::AllocationStats& stats);
+  static void Reset(il::io_t, il::AllocationStats& stats);
+  static void Print(const char* name, const il::AllocationStats& stats,
+                    std::FILE* file);
+  static std::string typeName(const char* type);
+};
+
+inline AllocationTracer::AllocationTracer()
+    : total_{0, 0, 0, 0, 0, 0}, lifetime_{} {}
+
+inline void AllocationTracer::Allocate(const char* type, std::size_t n_bytes,
+                                       il::io_t, il::AllocationRecord& record) {
+  record.type = type;
+  record.site = il::threadAllocationSite();
+  record.birth = std::chrono::steady_clock::now();
+
+  std::lock_guard<std::mutex> lock{mutex_};
+  Allocate(n_bytes, il::io, total_);
+  Allocate(n_bytes, il::io, type_[type]);
+  Allocate(n_bytes, il::io, site_[record.site ? record.site : "unknown"]);
+}
+
+inline void AllocationTracer::Deallocate(const il::AllocationRecord& record,
+                                         std::size_t n_bytes) {
+  const auto microseconds =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - record.birth)
+          .count();
+  int k = 0;
+  while (k + 1 < nb_lifetime_buckets && (microseconds >> (k + 1)) > 0) {
+    ++k;
+  }
+
+  std::lock_guard<std::mutex> lock{mutex_};
+  Deallocate(n_bytes, il::io, total_);
+  Deallocate(n_bytes, il::io, type_[record.type]);
+  Deallocate(n_bytes, il::io, site_[record.site ? record.site : "unknown"]);
+  ++lifetime_[k];
+}
+
+inline il::AllocationStats AllocationTracer::stats() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return total_;
+}
+
+inline il::AllocationStats AllocationTracer::stats(const char* type) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return type_[type];
+}
+
+inline il::int_t AllocationTracer::lifetime(int k) {
+  IL_EXPECT_FAST(k >= 0 && k < nb_lifetime_buckets);
+
+  std::lock_guard<std::mutex> lock{mutex_};
+  return lifetime_[k];
+}
+
+inline const char* AllocationTracer::siteName(const char* name) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return site_name_.insert(std::string{name}).first->c_str();
+}
+
+inline void AllocationTracer::Print(std::FILE* file) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  std::fprintf(file, "%-48s %12s %12s %14s %14s %14s\n", "", "allocations",
+               "live", "bytes", "live bytes", "peak bytes");
+  Print("Total", total_, file);
+  std::fprintf(file, "\nPer type\n");
+  for (const auto& entry : type_) {
+    Print(typeName(entry.first.c_str()).c_str(), entry.second, file);
+  }
+  std::fprintf(file, "\nPer site\n");
+  for (const auto& entry : site_) {
+    Print(entry.first.c_str(), entry.second, file);
+  }
+  std::fprintf(file, "\nLifetime of the deallocated blocks\n");
+  for (int k = 0; k < nb_lifetime_buckets; ++k) {
+    if (lifetime_[k] > 0) {
+      std::fprintf(file, "< %12.0f us %12td\n",
+                   static_cast<double>(static_cast<std::size_t>(2) << k),
+                   static_cast<std::ptrdiff_t>(lifetime_[k]));
+    }
+  }
+}
+
+// The blocks that are alive are still counted in the live blocks and bytes
+// after a reset, so they are right when these blocks are deallocated. The
+// other counters start again from 0, and the peak from the live bytes.
+inline void AllocationTracer::Reset() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  Reset(il::io, total_);
+  for (auto& entry : type_) {
+    Reset(il::io, entry.second);
+  }
+  for (auto& entry : site_) {
+    Reset(il::io, entry.second);
+  }
+  for (int k = 0; k < nb_lifetime_buckets; ++k) {
+    lifetime_[k] = 0;
+  }
+}
+
+inline void AllocationTracer::Allocate(std::size_t n_bytes, il::io_t,
+                                       il::AllocationStats& stats) {
+  ++stats.nb_allocations;
+  ++stats.nb_live_blocks;
+  stats.n_bytes += n_bytes;
+  stats.live_bytes += n_bytes;
+  if (stats.live_bytes > stats.peak_live_bytes) {
+    stats.peak_live_bytes = stats.live_bytes;
+  }
+}
+
+inline void AllocationTracer::Deallocate(std::size_t n_bytes, il::io_t,
+                                         il::AllocationStats& stats) {
+  IL_EXPECT_MEDIUM(stats.nb_live_blocks >= 1 && stats.live_bytes >= n_bytes);
+
+  ++stats.nb_deallocations;
+  --stats.nb_live_blocks;
+  stats.live_bytes -= n_bytes;
+}
+
+inline void AllocationTracer::Reset(il::io_t, il::AllocationStats& stats) {
+  stats.nb_allocations = 0;
+  stats.nb_deallocations = 0;
+  stats.n_bytes = 0;
+  stats.peak_live_bytes = stats.live_bytes;
+}
+
+inline void AllocationTracer::Print(const char* name,
+                                    const il::AllocationStats& stats,
+                                    std::FILE* file) {
+  std::fprintf(file, "%-48.48s %12td %12td %14zu %14zu %14zu\n", name,
+               static_cast<std::ptrdiff_t>(stats.nb_allocations),
+               static_cast<std::ptrdiff_t>(stats.nb_live_blocks),
+               stats.n_bytes, stats.live_bytes, stats.peak_live_bytes);
+}
+
+inline std::string AllocationTracer::typeName(const char* type) {
+#ifdef __GNUC__
+  int status = 0;
+  char* name = abi::__cxa_demangle(type, nullptr, nullptr, &status);
+  if (status == 0 && name) {
+    std::string ans{name};
+    std::free(name);
+    return ans;
+  }
+#endif
+  return std::string{type};
+}
+
+inline il::AllocationTracer& allocationTracer() {
+  // Never destroyed so blocks released by static objects can still be traced
+  static il::AllocationTracer* tracer = new il::AllocationTracer{};
+  return *tracer;
+}
+
+inline AllocationSite::AllocationSite(const char* name) {
+  previous_ = il::threadAllocationSite();
+  il::threadAllocationSite() = il::allocationTracer().siteName(name);
+}
+
+inline AllocationSite::~AllocationSite() {
+  il::threadAllocationSite() = previous_;
+}
+
+inline il::AllocationStats allocationStats() {
+  return il::allocationTracer().stats();
+}
+
+inline void printAllocationReport(std::FILE* file) {
+  il::allocationTracer().Print(file);
+}
+
+inline void resetAllocationTrace() { il::allocationTracer().Reset(); }
+
+#else
+
+inline AllocationSite::AllocationSite(const char* name) { IL_UNUSED(name); }
+
+inline AllocationSite::~AllocationSite() {}
+
+inline il::AllocationStats allocationStats() {
+  return il::AllocationStats{0, 0, 0, 0, 0, 0};
+}
+
+inline void printAllocationReport(std::FILE* file) {
+  std::fprintf(file,
+               "Allocation tracing is disabled. Compile with "
+               "IL_TRACE_ALLOCATION to enable it.\n");
+}
+
+inline void resetAllocationTrace() {}
+
+#endif
+
+}  // namespace il
+
+#endif  // IL_TRACE_H
@@ -0,0 +1,108 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#include <mutex>
+
+#include <gtest/gtest.h>
+
+#include <il/Array.h>
+#include <il/core/thread/parallel.h>
+
+TEST(parallelFor, cover) {
+  const il::int_t n = 1000;
+  il::Array<int> count{n, 0};
+  il::parallelFor(0, n, 1, [&count](il::int_t i_begin, il::int_t i_end) {
+    for (il::int_t i = i_begin; i < i_end; ++i) {
+      count[i] += 1;
+    }
+  });
+
+  bool correct = true;
+  for (il::int_t i = 0; i < n; ++i) {
+    if (count[i] != 1) {
+      correct = false;
+    }
+  }
+
+  ASSERT_TRUE(correct);
+}
+
+TEST(parallelFor, grain) {
+  il::int_t nb_calls = 0;
+  il::parallelFor(3, 10, 100,
+                  [&nb_calls](il::int_t i_begin, il::int_t i_end) {
+                    if (i_begin == 3 && i_end == 10) {
+                      ++nb_calls;
+                    }
+                  });
+
+  ASSERT_TRUE(nb_calls == 1);
+}
+
+TEST(parallelForChunks, split) {
+  std::mutex mutex;
+  il::Array<il::int_t> end_of{10, -1};
+  il::parallelForChunks(0, 10, 4,
+                        [&mutex, &end_of](il::int_t i_begin, il::int_t i_end) {
+                          std::lock_guard<std::mutex> lock{mutex};
+                          end_of[i_begin] = i_end;
+                        });
+
+  ASSERT_TRUE(end_of[0] == 3 && end_of[3] == 6 && end_of[6] == 8 &&
+              end_of[8] == 10);
+}
+
+// The chunks are the ones of an OpenMP loop with a static schedule on all the
+// threads, whatever the size of the range
+TEST(parallelForStatic, static_schedule) {
+  const il::int_t nb_threads = il::nbThreads();
+  const il::int_t n = 3 * nb_threads + 1;
+  std::mutex mutex;
+  il::Array<il::int_t> begin_of{n, -1};
+  il::parallelForStatic(0, n, 1,
+                        [&mutex, &begin_of](il::int_t i_begin,
+                                            il::int_t i_end) {
+                          std::lock_guard<std::mutex> lock{mutex};
+                          for (il::int_t i = i_begin; i < i_end; ++i) {
+                            begin_of[i] = i_begin;
+                          }
+                        });
+
+  bool correct = true;
+  for (il::int_t k = 0; k < nb_threads; ++k) {
+    const il::int_t i_begin = 3 * k + (k < 1 ? k : 1);
+    const il::int_t i_end = i_begin + 3 + (k < 1 ? 1 : 0);
+    for (il::int_t i = i_begin; i < i_end; ++i) {
+      correct = correct && begin_of[i] == i_begin;
+    }
+  }
+
+  ASSERT_TRUE(correct);
+}
+
+TEST(parallelForStatic, small) {
+  il::int_t nb_calls = 0;
+  il::parallelForStatic(0, 10, 100,
+                        [&nb_calls](il::int_t i_begin, il::int_t i_end) {
+                          if (i_begin == 0 && i_end == 10) {
+                            ++nb_calls;
+                          }
+                        });
+
+  ASSERT_TRUE(nb_calls == 1);
+}
@@ -0,0 +1,203 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#ifndef IL_PARALLEL_H
+#define IL_PARALLEL_H
+
+// <cstddef> is needed for std::size_t
+#include <cstddef>
+
+#if defined(IL_OPENMP)
+#include <omp.h>
+#elif defined(IL_TBB)
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#else
+// <memory> is needed for std::unique_ptr
+#include <memory>
+// <thread> is needed for std::thread
+#include <thread>
+#endif
+
+#include <il/core/core.h>
+
+namespace il {
+
+/* \brief Get the number of threads used by il::parallelFor
+// \details The threading backend is OpenMP when the library is compiled with
+// IL_OPENMP, TBB when it is compiled with IL_TBB, and std::thread otherwise.
+*/
+inline il::int_t nbThreads() {
+#if defined(IL_OPENMP)
+  return static_cast<il::int_t>(omp_get_max_threads());
+#elif defined(IL_TBB)
+  return static_cast<il::int_t>(tbb::this_task_arena::max_concurrency());
+#else
+  // std::thread::hardware_concurrency() is a system call, which is too slow
+  // to be made for every parallel loop
+  static const unsigned n = std::thread::hardware_concurrency();
+  return n > 0 ? static_cast<il::int_t>(n) : 1;
+#endif
+}
+
+/* \brief Get the minimum number of elements of type T given to a thread
+// \details A thread gets at least 64 KiB of memory to work on so that the
+// cost of starting the threads is small compared to the work.
+*/
+template <typename T>
+il::int_t parallelGrain() {
+  const il::int_t grain =
+      static_cast<il::int_t>(static_cast<std::size_t>(65536) / sizeof(T));
+  return grain > 0 ? grain : 1;
+}
+
+/* \brief Get the number of elements of type T in a page of memory
+// \details It is the smallest chunk for which the placement of the memory by
+// first touch makes sense, as a page belongs to a single NUMA node.
+*/
+template <typename T>
+il::int_t pageGrain() {
+  const il::int_t grain =
+      static_cast<il::int_t>(static_cast<std::size_t>(4096) / sizeof(T));
+  return grain > 0 ? grain : 1;
+}
+
+/* \brief Call f(i_begin, i_end) on nb_chunks contiguous chunks of [begin,
+// end) of about the same size, in parallel
+// \details The first (end - begin) % nb_chunks chunks have one more index
+// than the others. With OpenMP, the k-th chunk is given to the k-th thread.
+*/
+template <typename F>
+void parallelForChunks(il::int_t begin, il::int_t end, il::int_t nb_chunks,
+                       const F& f) {
+  IL_EXPECT_FAST(nb_chunks >= 1);
+
+  const il::int_t n = end - begin;
+  if (n <= 0) {
+    return;
+  } else if (nb_chunks == 1) {
+    f(begin, end);
+    return;
+  }
+
+  // The first r chunks have one more index than the others
+  const il::int_t q = n / nb_chunks;
+  const il::int_t r = n % nb_chunks;
+#if defined(IL_OPENMP)
+#pragma omp parallel for schedule(static, 1) num_threads(nb_chunks)
+  for (il::int_t k = 0; k < nb_chunks; ++k) {
+    const il::int_t i_begin = begin + k * q + (k < r ? k : r);
+    f(i_begin, i_begin + q + (k < r ? 1 : 0));
+  }
+#elif defined(IL_TBB)
+  tbb::parallel_for(tbb::blocked_range<il::int_t>{0, nb_chunks, 1},
+                    [&](const tbb::blocked_range<il::int_t>& range) {
+                      for (il::int_t k = range.begin(); k < range.end(); ++k) {
+                        const il::int_t i_begin =
+                            begin + k * q + (k < r ? k : r);
+                        f(i_begin, i_begin + q + (k < r ? 1 : 0));
+                      }
+                    });
+#else
+  // The calling thread works on the first chunk
+  std::unique_ptr<std::thread[]> threads{new std::thread[nb_chunks - 1]};
+  for (il::int_t k = 1; k < nb_chunks; ++k) {
+    const il::int_t i_begin = begin + k * q + (k < r ? k : r);
+    const il::int_t i_end = i_begin + q + (k < r ? 1 : 0);
+    threads[k - 1] = std::thread{[&f, i_begin, i_end]() { f(i_begin, i_end); }};
+  }
+  f(begin, begin + q + (r > 0 ? 1 : 0));
+  for (il::int_t k = 1; k < nb_chunks; ++k) {
+    threads[k - 1].join();
+  }
+#endif
+}
+
+/* \brief Call f(i_begin, i_end) on contiguous chunks of [begin, end) in
+// parallel
+// \details The range is split into at most il::nbThreads() chunks of about
+// the same size, each of them having at least grain indices. When there is
+// only one chunk, f(begin, end) is called on the calling thread. With
+// OpenMP, the k-th chunk is given to the k-th thread.
+//
+// As the number of chunks depends on grain, the chunks are not the ones of a
+// loop with a static schedule on all the threads when the range is small.
+// Use il::parallelForStatic when the chunks must match such a loop.
+//
+// il::parallelFor(0, n, il::parallelGrain<double>(),
+//                 [&](il::int_t i_begin, il::int_t i_end) {
+//                   for (il::int_t i = i_begin; i < i_end; ++i) {
+//                     v[i] = 0.0;
+//                   }
+//                 });
+*/
+template <typename F>
+void parallelFor(il::int_t begin, il::int_t end, il::int_t grain, const F& f) {
+  IL_EXPECT_FAST(grain >= 1);
+
+  const il::int_t n = end - begin;
+  if (n <= 0) {
+    return;
+  } else if (n <= grain) {
+    f(begin, end);
+    return;
+  }
+  const il::int_t nb_threads = il::nbThreads();
+  const il::int_t nb_grains = 1 + (n - 1) / grain;
+  const il::int_t nb_chunks = nb_grains < nb_threads ? nb_grains : nb_threads;
+  il::parallelForChunks(begin, end, nb_chunks, f);
+}
+
+/* \brief Call f(i_begin, i_end) on the chunks of [begin, end) of a loop with
+// a static schedule on all the threads
+// \details The range is split into exactly il::nbThreads() chunks, the k-th
+// one being given to the k-th thread, as
+//
+// #pragma omp parallel for schedule(static)
+// for (il::int_t i = begin; i < end; ++i) {
+//   ...
+// }
+//
+// does with il::nbThreads() threads. It is used for the first touch of the
+// memory: as a page is placed on the NUMA node of the thread which touches
+// it first, the kernels which use the same static schedule, or
+// il::parallelForStatic on the same range, only access local memory. When a
+// chunk would have less than grain indices, such as less than a page of
+// memory, the pages would be shared between threads anyway and f(begin, end)
+// is called on the calling thread.
+*/
+template <typename F>
+void parallelForStatic(il::int_t begin, il::int_t end, il::int_t grain,
+                       const F& f) {
+  IL_EXPECT_FAST(grain >= 1);
+
+  const il::int_t n = end - begin;
+  const il::int_t nb_threads = il::nbThreads();
+  if (n <= 0) {
+    return;
+  } else if (n < nb_threads * grain) {
+    f(begin, end);
+    return;
+  }
+  il::parallelForChunks(begin, end, nb_threads, f);
+}
+
+}  // namespace il
+
+#endif  // IL_PARALLEL_H
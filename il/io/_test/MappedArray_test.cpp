@@ -0,0 +1,189 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#include <cstdio>
+
+#include <gtest/gtest.h>
+
+#include <il/MappedArray.h>
+
+il::String mapped_filename = IL_FOLDER "/../gtest/tmp/c.npy";
+il::String mapped_raw_filename = IL_FOLDER "/../gtest/tmp/c.data";
+
+// Maps a .npy file of doubles with a forged header and no elements, and
+// checks that it is rejected
+template <typename A>
+static bool isForgedNumpyRejected(const il::Array<il::int_t>& shape,
+                                  bool fortran_order) {
+  il::NumpyInfo numpy_info{};
+  numpy_info.type =
+      il::String{il::StringType::Ascii, il::numpyType<double>::value,
+                 il::size(il::numpyType<double>::value)};
+  numpy_info.shape = shape;
+  numpy_info.fortran_order = fortran_order;
+  std::FILE* file = std::fopen(mapped_filename.asCString(), "wb");
+  il::Status save_status{};
+  il::saveNumpyInfo(numpy_info, il::io, file, save_status);
+  std::fclose(file);
+
+  il::Status status{};
+  A w{mapped_filename, il::MapMode::Read, il::io, status};
+  return save_status.Ok() && !status.Ok() &&
+         status.error() == il::Error::BinaryFileWrongFormat;
+}
+
+TEST(MappedArray, read) {
+  il::Array<double> v{il::value, {1.0, 2.0, 3.0}};
+  il::Status save_status{};
+  il::save(v, mapped_filename, il::io, save_status);
+
+  il::Status status{};
+  il::MappedArray<double> w{mapped_filename, il::MapMode::Read, il::io,
+                            status};
+  il::ArrayView<double> w_view = w.view();
+
+  ASSERT_TRUE(save_status.Ok() && status.Ok() && w.size() == 3 &&
+              w[0] == 1.0 && w[2] == 3.0 && w_view.size() == 3 &&
+              w_view[1] == 2.0);
+}
+
+TEST(MappedArray, read_write) {
+  il::Array<double> v{il::value, {1.0, 2.0, 3.0}};
+  il::Status save_status{};
+  il::save(v, mapped_filename, il::io, save_status);
+
+  il::Status status{};
+  il::Status sync_status{};
+  {
+    il::MappedArray<double> w{mapped_filename, il::MapMode::ReadWrite, il::io,
+                              status};
+    w[1] = 5.0;
+    w.Sync(il::io, sync_status);
+  }
+  il::Status load_status{};
+  il::Array<double> z =
+      il::load<il::Array<double>>(mapped_filename, il::io, load_status);
+
+  ASSERT_TRUE(save_status.Ok() && status.Ok() && sync_status.Ok() &&
+              load_status.Ok() && z[1] == 5.0);
+}
+
+TEST(MappedArray, copy_on_write) {
+  il::Array<double> v{il::value, {1.0, 2.0, 3.0}};
+  il::Status save_status{};
+  il::save(v, mapped_filename, il::io, save_status);
+
+  il::Status status{};
+  {
+    il::MappedArray<double> w{mapped_filename, il::MapMode::CopyOnWrite,
+                              il::io, status};
+    w.Edit()[1] = 5.0;
+  }
+  il::Status load_status{};
+  il::Array<double> z =
+      il::load<il::Array<double>>(mapped_filename, il::io, load_status);
+
+  ASSERT_TRUE(save_status.Ok() && status.Ok() && load_status.Ok() &&
+              z[1] == 2.0);
+}
+
+TEST(MappedArray, raw) {
+  const int v[4] = {1, 2, 3, 4};
+  std::FILE* file = std::fopen(mapped_raw_filename.asCString(), "wb");
+  const std::size_t written = std::fwrite(v, sizeof(int), 4, file);
+  std::fclose(file);
+
+  il::Status status{};
+  il::MappedArray<int> w{mapped_raw_filename, 3, il::MapMode::Read, il::io,
+                         status};
+
+  ASSERT_TRUE(written == 4 && status.Ok() && w.size() == 3 && w[2] == 3);
+}
+
+TEST(MappedArray, too_short) {
+  const int v[4] = {1, 2, 3, 4};
+  std::FILE* file = std::fopen(mapped_raw_filename.asCString(), "wb");
+  std::fwrite(v, sizeof(int), 4, file);
+  std::fclose(file);
+
+  il::Status status{};
+  il::MappedArray<int> w{mapped_raw_filename, 5, il::MapMode::Read, il::io,
+                         status};
+
+  ASSERT_TRUE(!status.Ok() &&
+              status.error() == il::Error::FilesystemFileNotLongEnough &&
+              w.size() == 0);
+}
+
+TEST(MappedArray, forged_header) {
+  const il::int_t large = il::int_t{1} << 60;
+  const il::Array<il::int_t> negative{il::value, {-1}};
+  const il::Array<il::int_t> too_large{il::value, {large}};
+  // The number of bytes only overflows once the header is added
+  const il::Array<il::int_t> too_large_header{il::value, {large - 1}};
+
+  ASSERT_TRUE(
+      isForgedNumpyRejected<il::MappedArray<double>>(negative, true) &&
+      isForgedNumpyRejected<il::MappedArray<double>>(too_large, true) &&
+      isForgedNumpyRejected<il::MappedArray<double>>(too_large_header, true));
+}
+
+TEST(MappedArray2D, read) {
+  il::Array2D<double> A{il::value, {{1.0, 2.0}, {3.0, 4.0}, {5.0, 6.0}}};
+  il::Status save_status{};
+  il::save(A, mapped_filename, il::io, save_status);
+
+  il::Status status{};
+  il::MappedArray2D<double> B{mapped_filename, il::MapMode::Read, il::io,
+                              status};
+  il::Array2DView<double> B_view = B.view();
+
+  ASSERT_TRUE(save_status.Ok() && status.Ok() && B.size(0) == 2 &&
+              B.size(1) == 3 && B(1, 0) == 2.0 && B(0, 2) == 5.0 &&
+              B_view(1, 2) == 6.0);
+}
+
+TEST(MappedArray2D, wrong_rank) {
+  il::Array<double> v{il::value, {1.0, 2.0, 3.0}};
+  il::Status save_status{};
+  il::save(v, mapped_filename, il::io, save_status);
+
+  il::Status status{};
+  il::MappedArray2D<double> B{mapped_filename, il::MapMode::Read, il::io,
+                              status};
+
+  ASSERT_TRUE(save_status.Ok() && !status.Ok() &&
+              status.error() == il::Error::BinaryFileWrongRank);
+}
+
+TEST(MappedArray2D, c_order) {
+  const il::Array<il::int_t> shape{il::value, {2, 3}};
+
+  ASSERT_TRUE(isForgedNumpyRejected<il::MappedArray2D<double>>(shape, false));
+}
+
+TEST(MappedArray2D, forged_header) {
+  const il::int_t large = il::int_t{1} << 31;
+  // The product of the sizes is positive
+  const il::Array<il::int_t> negative{il::value, {-2, -3}};
+  const il::Array<il::int_t> too_large{il::value, {large, large}};
+
+  ASSERT_TRUE(
+      isForgedNumpyRejected<il::MappedArray2D<double>>(negative, true) &&
+      isForgedNumpyRejected<il::MappedArray2D<double>>(too_large, true));
+}
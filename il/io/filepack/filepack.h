@@ -19,9 +19,12 @@
 #ifndef IL_FILEPACK_H
 #define IL_FILEPACK_H
 
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
 
 #include <il/Array.h>
+#include <il/FrozenMap.h>
 #include <il/Map.h>
 #include <il/MapArray.h>
 #include <il/String.h>
@@ -738,6 +741,224 @@ class SaveHelperDataWithOptions<il::MapArray<il::String, il::Dynamic>,
   }
 };
 
+// An il::FrozenMap<il::String, V> is saved with its perfect hash function,
+// so that it does not have to be built again when it is loaded. The file is
+// made of
+//
+// - 8 bytes: "ILFROZEN"
+// - 8 bytes: sizeof(V)
+// - 8 bytes: the seed of the hash function
+// - 3 x 8 bytes: n, m and the number of pilots
+// - the pilots and the m - n remapped positions as 4-byte integers
+// - the n + 1 offsets of the keys as 8-byte integers
+// - the bytes of the keys and the n values
+//
+// in the byte order of the machine. As the values are written as they are
+// in memory, V must be a trivial type.
+
+template <typename V, typename F>
+class SaveHelperData<il::FrozenMap<il::String, V, F>> {
+  static_assert(il::isTrivial<V>::value,
+                "il::FrozenMap<il::String, V>: V must be a trivial type to "
+                "be saved");
+
+ public:
+  static void save(const il::FrozenMap<il::String, V, F>& map,
+                   const il::String& filename, il::io_t, il::Status& status) {
+#ifdef IL_UNIX
+    std::FILE* file = std::fopen(filename.asCString(), "wb");
+    if (!file) {
+      status.SetError(il::Error::FilesystemFileNotFound);
+      return;
+    }
+#else
+    il::UTF16String filename_utf16 = il::toUtf16(filename);
+    std::FILE* file;
+    errno_t error_nb = _wfopen_s(&file, filename_utf16.asWString(), L"wb");
+    if (error_nb != 0) {
+      status.SetError(il::Error::FilesystemFileNotFound);
+      return;
+    }
+#endif
+
+    const il::PerfectHash& perfect_hash = map.perfect_hash_;
+    const std::uint64_t header[5] = {
+        static_cast<std::uint64_t>(sizeof(V)),
+        static_cast<std::uint64_t>(map.seed_),
+        static_cast<std::uint64_t>(perfect_hash.nbSlots()),
+        static_cast<std::uint64_t>(perfect_hash.nbPositions()),
+        static_cast<std::uint64_t>(perfect_hash.pilot().size())};
+    bool ok = std::fwrite("ILFROZEN", 1, 8, file) == 8 &&
+              std::fwrite(header, sizeof(std::uint64_t), 5, file) == 5;
+    ok = ok && write(perfect_hash.pilot(), file) &&
+         write(perfect_hash.remap(), file) && write(map.offset_, file) &&
+         write(map.arena_, file) && write(map.value_, file);
+
+    const int error = std::fclose(file);
+    if (!ok) {
+      status.SetError(il::Error::FilesystemCanNotWriteToFile);
+      return;
+    }
+    if (error != 0) {
+      status.SetError(il::Error::FilesystemCanNotCloseFile);
+      return;
+    }
+
+    status.SetOk();
+    return;
+  }
+
+ private:
+  template <typename T>
+  static bool write(const il::Array<T>& v, std::FILE* file) {
+    const std::size_t n = static_cast<std::size_t>(v.size());
+    return n == 0 || std::fwrite(v.data(), sizeof(T), n, file) == n;
+  }
+};
+
+template <typename V, typename F>
+class LoadHelperData<il::FrozenMap<il::String, V, F>> {
+  static_assert(il::isTrivial<V>::value,
+                "il::FrozenMap<il::String, V>: V must be a trivial type to "
+                "be loaded");
+
+ public:
+  static il::FrozenMap<il::String, V, F> load(const il::String& filename,
+                                              il::io_t, il::Status& status) {
+    il::FrozenMap<il::String, V, F> ans{};
+
+#ifdef IL_UNIX
+    std::FILE* file = std::fopen(filename.asCString(), "rb");
+    if (!file) {
+      status.SetError(il::Error::FilesystemFileNotFound);
+      return ans;
+    }
+#else
+    il::UTF16String filename_utf16 = il::toUtf16(filename);
+    std::FILE* file;
+    errno_t error_nb = _wfopen_s(&file, filename_utf16.asWString(), L"rb");
+    if (error_nb != 0) {
+      status.SetError(il::Error::FilesystemFileNotFound);
+      return ans;
+    }
+#endif
+
+    loadFromFile(file, il::io, ans, status);
+    const int error = std::fclose(file);
+    if (!status.Ok()) {
+      status.Rearm();
+      return il::FrozenMap<il::String, V, F>{};
+    }
+    if (error != 0) {
+      status.SetError(il::Error::FilesystemCanNotCloseFile);
+      return il::FrozenMap<il::String, V, F>{};
+    }
+
+    status.SetOk();
+    return ans;
+  }
+
+ private:
+  // The sizes read from the file are checked against its length before any
+  // allocation, and the remapped positions and the offsets are checked so
+  // that a corrupted file can not make a search read out of the arrays.
+  static void loadFromFile(std::FILE* file, il::io_t,
+                           il::FrozenMap<il::String, V, F>& map,
+                           il::Status& status) {
+    std::uint64_t file_size = 0;
+    if (std::fseek(file, 0, SEEK_END) == 0) {
+      const long end = std::ftell(file);
+      file_size = end > 0 ? static_cast<std::uint64_t>(end) : 0;
+    }
+    std::rewind(file);
+
+    char magic[8];
+    std::uint64_t header[5];
+    if (std::fread(magic, 1, 8, file) != 8) {
+      status.SetError(il::Error::FilesystemFileNotLongEnough);
+      return;
+    }
+    if (std::memcmp(magic, "ILFROZEN", 8) != 0) {
+      status.SetError(il::Error::BinaryFileWrongFormat);
+      return;
+    }
+    if (std::fread(header, sizeof(std::uint64_t), 5, file) != 5) {
+      status.SetError(il::Error::FilesystemFileNotLongEnough);
+      return;
+    }
+    if (header[0] != sizeof(V)) {
+      status.SetError(il::Error::BinaryFileWrongType);
+      return;
+    }
+    const std::uint64_t n = header[2];
+    const std::uint64_t m = header[3];
+    const std::uint64_t nb_pilots = header[4];
+    const bool valid_sizes =
+        n <= 0xFFFFFFFFu &&
+        (n == 0 ? (m == 0 && nb_pilots == 0)
+                : (m >= n && m <= 2 * n + 1 && nb_pilots > 0 &&
+                   nb_pilots <= n));
+    if (!valid_sizes) {
+      status.SetError(il::Error::BinaryFileWrongFormat);
+      return;
+    }
+    std::uint64_t size = 48 + 4 * (nb_pilots + m - n) + 8 * (n + 1) +
+                         n * static_cast<std::uint64_t>(sizeof(V));
+    if (size > file_size) {
+      status.SetError(il::Error::FilesystemFileNotLongEnough);
+      return;
+    }
+
+    il::Array<std::uint32_t> pilot{static_cast<il::int_t>(nb_pilots)};
+    il::Array<std::uint32_t> remap{static_cast<il::int_t>(m - n)};
+    il::Array<il::int_t> offset{static_cast<il::int_t>(n + 1)};
+    if (!read(il::io, pilot, file) || !read(il::io, remap, file) ||
+        !read(il::io, offset, file)) {
+      status.SetError(il::Error::FilesystemFileNotLongEnough);
+      return;
+    }
+    bool valid = offset[0] == 0;
+    for (il::int_t i = 0; i < remap.size(); ++i) {
+      valid = valid && remap[i] < n;
+    }
+    for (il::int_t i = 0; i < offset.size() - 1; ++i) {
+      valid = valid && offset[i + 1] >= offset[i];
+    }
+    if (!valid) {
+      status.SetError(il::Error::BinaryFileWrongFormat);
+      return;
+    }
+    const il::int_t arena_size = offset[offset.size() - 1];
+    size += static_cast<std::uint64_t>(arena_size);
+    if (size > file_size) {
+      status.SetError(il::Error::FilesystemFileNotLongEnough);
+      return;
+    }
+
+    il::Array<char> arena{arena_size};
+    il::Array<V> value{static_cast<il::int_t>(n)};
+    if (!read(il::io, arena, file) || !read(il::io, value, file)) {
+      status.SetError(il::Error::FilesystemFileNotLongEnough);
+      return;
+    }
+
+    map.perfect_hash_ =
+        il::PerfectHash{static_cast<il::int_t>(n), static_cast<il::int_t>(m),
+                        std::move(pilot), std::move(remap)};
+    map.arena_ = std::move(arena);
+    map.offset_ = std::move(offset);
+    map.value_ = std::move(value);
+    map.seed_ = static_cast<std::size_t>(header[1]);
+    status.SetOk();
+  }
+
+  template <typename T>
+  static bool read(il::io_t, il::Array<T>& v, std::FILE* file) {
+    const std::size_t n = static_cast<std::size_t>(v.size());
+    return n == 0 || std::fread(v.Data(), sizeof(T), n, file) == n;
+  }
+};
+
 }  // namespace il
 
 #endif  // IL_FILEPACK_H
@@ -0,0 +1,693 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#ifndef IL_MAPPEDARRAY_H
+#define IL_MAPPEDARRAY_H
+
+// <cerrno> is needed for errno
+#include <cerrno>
+// <cstddef> is needed for std::size_t
+#include <cstddef>
+// <cstdio> is needed for std::FILE
+#include <cstdio>
+
+// IL_UNIX is defined in <il/core/core.h>
+#include <il/core/core.h>
+
+#ifdef IL_UNIX
+// <fcntl.h> is needed for open
+#include <fcntl.h>
+// <sys/mman.h> is needed for mmap, munmap and msync
+#include <sys/mman.h>
+// <sys/stat.h> is needed for fstat
+#include <sys/stat.h>
+// <unistd.h> is needed for close
+#include <unistd.h>
+#endif
+
+#include <il/container/1d/ArrayView.h>
+#include <il/container/2d/Array2DView.h>
+#include <il/io/numpy/numpy.h>
+
+namespace il {
+
+/* \brief The way a file is mapped in memory
+// \details With Read, the elements can only be read. With ReadWrite, the
+// changes to the elements are written to the file and are seen by the other
+// processes that map the same file. With CopyOnWrite, the changes are private
+// to the process and are never written to the file.
+*/
+enum class MapMode : unsigned char { Read, ReadWrite, CopyOnWrite };
+
+/* \brief Used internally by il::MappedArray and il::MappedArray2D to own the
+// mapping of the first bytes of a file
+*/
+class FileMapping {
+ private:
+  void* base_;
+  std::size_t length_;
+
+ public:
+  FileMapping();
+  FileMapping(const il::String& filename, std::size_t length,
+              il::MapMode mode, il::io_t, il::Status& status);
+  FileMapping(const FileMapping& other) = delete;
+  FileMapping(FileMapping&& other);
+  FileMapping& operator=(const FileMapping& other) = delete;
+  FileMapping& operator=(FileMapping&& other);
+  ~FileMapping();
+  const unsigned char* data() const;
+  unsigned char* Data();
+  void Sync(il::io_t, il::Status& status);
+
+ private:
+  void Unmap();
+};
+
+inline FileMapping::FileMapping() : base_{nullptr}, length_{0} {}
+
+inline FileMapping::FileMapping(const il::String& filename, std::size_t length,
+                                il::MapMode mode, il::io_t,
+                                il::Status& status)
+    : FileMapping{} {
+#ifdef IL_UNIX
+  const int fd = ::open(filename.asCString(),
+                        mode == il::MapMode::ReadWrite ? O_RDWR : O_RDONLY);
+  if (fd == -1) {
+    if (errno == EACCES) {
+      status.SetError(mode == il::MapMode::ReadWrite
+                          ? il::Error::FilesystemNoWriteAccess
+                          : il::Error::FilesystemNoReadAccess);
+    } else {
+      status.SetError(il::Error::FilesystemFileNotFound);
+    }
+    IL_SET_SOURCE(status);
+    return;
+  }
+
+  struct stat file_stat;
+  if (::fstat(fd, &file_stat) != 0 ||
+      static_cast<std::size_t>(file_stat.st_size) < length) {
+    ::close(fd);
+    status.SetError(il::Error::FilesystemFileNotLongEnough);
+    IL_SET_SOURCE(status);
+    return;
+  }
+
+  // The mapping stays valid once the file descriptor has been closed
+  if (length > 0) {
+    const int protection = mode == il::MapMode::Read
+                               ? PROT_READ
+                               : PROT_READ | PROT_WRITE;
+    const int flags =
+        mode == il::MapMode::CopyOnWrite ? MAP_PRIVATE : MAP_SHARED;
+    void* base = ::mmap(nullptr, length, protection, flags, fd, 0);
+    if (base == MAP_FAILED) {
+      ::close(fd);
+      status.SetError(il::Error::FilesystemNoReadAccess);
+      IL_SET_SOURCE(status);
+      return;
+    }
+    base_ = base;
+    length_ = length;
+  }
+  ::close(fd);
+  status.SetOk();
+#else
+  IL_UNUSED(filename);
+  IL_UNUSED(length);
+  IL_UNUSED(mode);
+  status.SetError(il::Error::Unimplemented);
+  IL_SET_SOURCE(status);
+#endif
+}
+
+inline FileMapping::FileMapping(FileMapping&& other)
+    : base_{other.base_}, length_{other.length_} {
+  other.base_ = nullptr;
+  other.length_ = 0;
+}
+
+inline FileMapping& FileMapping::operator=(FileMapping&& other) {
+  if (this != &other) {
+    Unmap();
+    base_ = other.base_;
+    length_ = other.length_;
+    other.base_ = nullptr;
+    other.length_ = 0;
+  }
+  return *this;
+}
+
+inline FileMapping::~FileMapping() { Unmap(); }
+
+inline const unsigned char* FileMapping::data() const {
+  return static_cast<const unsigned char*>(base_);
+}
+
+inline unsigned char* FileMapping::Data() {
+  return static_cast<unsigned char*>(base_);
+}
+
+inline void FileMapping::Sync(il::io_t, il::Status& status) {
+#ifdef IL_UNIX
+  if (base_ && ::msync(base_, length_, MS_SYNC) != 0) {
+    status.SetError(il::Error::FilesystemCanNotWriteToFile);
+    IL_SET_SOURCE(status);
+    return;
+  }
+#endif
+  status.SetOk();
+}
+
+inline void FileMapping::Unmap() {
+#ifdef IL_UNIX
+  if (base_) {
+    ::munmap(base_, length_);
+  }
+#endif
+  base_ = nullptr;
+  length_ = 0;
+}
+
+/* \brief Read the header of a .npy file
+// \details The offset is set to the position of the first element of the
+// array in the file.
+*/
+inline il::NumpyInfo getNumpyInfo(const il::String& filename, il::io_t,
+                                  std::size_t& offset, il::Status& status) {
+#ifdef IL_UNIX
+  std::FILE* file = std::fopen(filename.asCString(), "rb");
+#else
+  il::UTF16String filename_utf16 = il::toUtf16(filename);
+  std::FILE* file = _wfopen(filename_utf16.asWString(), L"rb");
+#endif
+  if (!file) {
+    status.SetError(il::Error::FilesystemFileNotFound);
+    IL_SET_SOURCE(status);
+    return il::NumpyInfo{};
+  }
+
+  il::Status info_status{};
+  il::NumpyInfo numpy_info = il::getNumpyInfo(il::io, file, info_status);
+  const long position = std::ftell(file);
+  const int error = std::fclose(file);
+  if (!info_status.Ok()) {
+    status = std::move(info_status);
+    return numpy_info;
+  }
+  if (position < 0 || error != 0) {
+    status.SetError(il::Error::FilesystemCanNotCloseFile);
+    IL_SET_SOURCE(status);
+    return numpy_info;
+  }
+
+  offset = static_cast<std::size_t>(position);
+  status.SetOk();
+  return numpy_info;
+}
+
+/* \brief A one-dimensional array whose elements live in a file mapped in
+// memory
+// \details The elements are read from the file by the operating system when
+// they are first accessed, so constructing the array costs nothing whatever
+// its size, and arrays larger than the memory of the machine can be used. Two
+// processes that map the same file in Read mode share the same physical
+// memory. The array can be mapped from a .npy file, or from a raw file that
+// only contains the elements. The file is unmapped when the array is
+// destroyed.
+//
+// il::Status status{};
+// il::MappedArray<double> v{"v.npy", il::MapMode::Read, il::io, status};
+// status.AbortOnError();
+// const double x = il::norm(v.view(), il::Norm::L2);
+*/
+template <typename T>
+class MappedArray {
+  static_assert(il::isTrivial<T>::value,
+                "il::MappedArray<T>: T must be a trivial type");
+
+ private:
+  il::FileMapping mapping_;
+  T* data_;
+  il::int_t size_;
+  il::MapMode mode_;
+
+ public:
+  /* \brief Default constructor
+  // \details It creates an array of size 0 that is not backed by any file.
+  */
+  MappedArray();
+
+  /* \brief Map a .npy file of rank 1
+  // \details The type of the elements stored in the file must be T.
+  */
+  MappedArray(const il::String& filename, il::MapMode mode, il::io_t,
+              il::Status& status);
+
+  /* \brief Map the first n elements of a raw file
+   */
+  MappedArray(const il::String& filename, il::int_t n, il::MapMode mode,
+              il::io_t, il::Status& status);
+
+  MappedArray(const MappedArray<T>& v) = delete;
+  MappedArray(MappedArray<T>&& v);
+  MappedArray& operator=(const MappedArray<T>& v) = delete;
+  MappedArray& operator=(MappedArray<T>&& v);
+
+  /* \brief Accessor
+  // \details Writing to an element of a file mapped with il::MapMode::Read
+  // crashes the program. Edit() and Data() check the mode in debug mode.
+  */
+  const T& operator[](il::int_t i) const;
+  T& operator[](il::int_t i);
+
+  il::int_t size() const;
+  il::MapMode mode() const;
+  il::ArrayView<T> view() const;
+  il::ArrayEdit<T> Edit();
+  const T* data() const;
+  T* Data();
+
+  /* \brief Write the changes made to the elements to the file
+  // \details This is only useful with il::MapMode::ReadWrite, as the
+  // operating system would otherwise write them at a time of its choice.
+  */
+  void Sync(il::io_t, il::Status& status);
+
+ private:
+  void Map(const il::String& filename, std::size_t offset, il::int_t n,
+           il::io_t, il::Status& status);
+};
+
+template <typename T>
+MappedArray<T>::MappedArray()
+    : mapping_{}, data_{nullptr}, size_{0}, mode_{il::MapMode::Read} {}
+
+template <typename T>
+MappedArray<T>::MappedArray(const il::String& filename, il::MapMode mode,
+                            il::io_t, il::Status& status)
+    : MappedArray{} {
+  std::size_t offset = 0;
+  il::Status info_status{};
+  il::NumpyInfo numpy_info =
+      il::getNumpyInfo(filename, il::io, offset, info_status);
+  if (!info_status.Ok()) {
+    status = std::move(info_status);
+    return;
+  }
+  if (!(numpy_info.type.isEqual(il::numpyType<T>::value))) {
+    status.SetError(il::Error::BinaryFileWrongType);
+    IL_SET_SOURCE(status);
+    return;
+  } else if (numpy_info.shape.size() != 1) {
+    status.SetError(il::Error::BinaryFileWrongRank);
+    IL_SET_SOURCE(status);
+    return;
+  }
+
+  mode_ = mode;
+  Map(filename, offset, numpy_info.shape[0], il::io, status);
+}
+
+template <typename T>
+MappedArray<T>::MappedArray(const il::String& filename, il::int_t n,
+                            il::MapMode mode, il::io_t, il::Status& status)
+    : MappedArray{} {
+  IL_EXPECT_FAST(n >= 0);
+
+  mode_ = mode;
+  Map(filename, 0, n, il::io, status);
+}
+
+template <typename T>
+MappedArray<T>::MappedArray(MappedArray<T>&& v)
+    : mapping_{std::move(v.mapping_)},
+      data_{v.data_},
+      size_{v.size_},
+      mode_{v.mode_} {
+  v.data_ = nullptr;
+  v.size_ = 0;
+}
+
+template <typename T>
+MappedArray<T>& MappedArray<T>::operator=(MappedArray<T>&& v) {
+  if (this != &v) {
+    mapping_ = std::move(v.mapping_);
+    data_ = v.data_;
+    size_ = v.size_;
+    mode_ = v.mode_;
+    v.data_ = nullptr;
+    v.size_ = 0;
+  }
+  return *this;
+}
+
+template <typename T>
+const T& MappedArray<T>::operator[](il::int_t i) const {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i) <
+                   static_cast<std::size_t>(size_));
+
+  return data_[i];
+}
+
+template <typename T>
+T& MappedArray<T>::operator[](il::int_t i) {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i) <
+                   static_cast<std::size_t>(size_));
+
+  return data_[i];
+}
+
+template <typename T>
+il::int_t MappedArray<T>::size() const {
+  return size_;
+}
+
+template <typename T>
+il::MapMode MappedArray<T>::mode() const {
+  return mode_;
+}
+
+template <typename T>
+il::ArrayView<T> MappedArray<T>::view() const {
+  return il::ArrayView<T>{data_, size_};
+}
+
+template <typename T>
+il::ArrayEdit<T> MappedArray<T>::Edit() {
+  IL_EXPECT_MEDIUM(mode_ != il::MapMode::Read);
+
+  return il::ArrayEdit<T>{data_, size_};
+}
+
+template <typename T>
+const T* MappedArray<T>::data() const {
+  return data_;
+}
+
+template <typename T>
+T* MappedArray<T>::Data() {
+  IL_EXPECT_MEDIUM(mode_ != il::MapMode::Read);
+
+  return data_;
+}
+
+template <typename T>
+void MappedArray<T>::Sync(il::io_t, il::Status& status) {
+  mapping_.Sync(il::io, status);
+}
+
+template <typename T>
+void MappedArray<T>::Map(const il::String& filename, std::size_t offset,
+                         il::int_t n, il::io_t, il::Status& status) {
+  // The size comes from the header of the file which might be forged
+  bool error_bytes = false;
+  bool error_length = false;
+  const il::int_t n_bytes = il::safeProduct(
+      n, static_cast<il::int_t>(sizeof(T)), il::io, error_bytes);
+  const il::int_t length = il::safeSum(static_cast<il::int_t>(offset),
+                                       n_bytes, il::io, error_length);
+  if (n < 0 || error_bytes || error_length || offset % alignof(T) != 0) {
+    status.SetError(il::Error::BinaryFileWrongFormat);
+    IL_SET_SOURCE(status);
+    return;
+  }
+
+  il::Status map_status{};
+  il::FileMapping mapping{filename, static_cast<std::size_t>(length), mode_,
+                          il::io, map_status};
+  if (!map_status.Ok()) {
+    status = std::move(map_status);
+    return;
+  }
+
+  mapping_ = std::move(mapping);
+  data_ = n > 0 ? reinterpret_cast<T*>(mapping_.Data() + offset) : nullptr;
+  size_ = n;
+  status.SetOk();
+}
+
+/* \brief A two-dimensional array whose elements live in a file mapped in
+// memory
+// \details The elements are stored in Fortran order, the leading dimension
+// being the number of rows, as in il::Array2D<T> with no padding. See
+// il::MappedArray<T> for the benefits of mapping a file.
+//
+// il::Status status{};
+// il::MappedArray2D<double> A{"A.npy", il::MapMode::Read, il::io, status};
+// status.AbortOnError();
+// il::Array<double> y = il::dot(A.view(), x.view());
+*/
+template <typename T>
+class MappedArray2D {
+  static_assert(il::isTrivial<T>::value,
+                "il::MappedArray2D<T>: T must be a trivial type");
+
+ private:
+  il::FileMapping mapping_;
+  T* data_;
+  il::int_t size_[2];
+  il::MapMode mode_;
+
+ public:
+  /* \brief Default constructor
+  // \details It creates an array of 0 rows and 0 columns that is not backed
+  // by any file.
+  */
+  MappedArray2D();
+
+  /* \brief Map a .npy file of rank 2 stored in Fortran order
+  // \details The type of the elements stored in the file must be T.
+  */
+  MappedArray2D(const il::String& filename, il::MapMode mode, il::io_t,
+                il::Status& status);
+
+  /* \brief Map the first n0 x n1 elements of a raw file stored in Fortran
+  // order
+  */
+  MappedArray2D(const il::String& filename, il::int_t n0, il::int_t n1,
+                il::MapMode mode, il::io_t, il::Status& status);
+
+  MappedArray2D(const MappedArray2D<T>& A) = delete;
+  MappedArray2D(MappedArray2D<T>&& A);
+  MappedArray2D& operator=(const MappedArray2D<T>& A) = delete;
+  MappedArray2D& operator=(MappedArray2D<T>&& A);
+
+  /* \brief Accessor
+  // \details Writing to an element of a file mapped with il::MapMode::Read
+  // crashes the program. Edit() and Data() check the mode in debug mode.
+  */
+  const T& operator()(il::int_t i0, il::int_t i1) const;
+  T& operator()(il::int_t i0, il::int_t i1);
+
+  il::int_t size(il::int_t d) const;
+  il::int_t stride(il::int_t d) const;
+  il::MapMode mode() const;
+  il::Array2DView<T> view() const;
+  il::Array2DEdit<T> Edit();
+  const T* data() const;
+  T* Data();
+
+  /* \brief Write the changes made to the elements to the file
+   */
+  void Sync(il::io_t, il::Status& status);
+
+ private:
+  void Map(const il::String& filename, std::size_t offset, il::int_t n0,
+           il::int_t n1, il::io_t, il::Status& status);
+};
+
+template <typename T>
+MappedArray2D<T>::MappedArray2D()
+    : mapping_{}, data_{nullptr}, size_{0, 0}, mode_{il::MapMode::Read} {}
+
+template <typename T>
+MappedArray2D<T>::MappedArray2D(const il::String& filename, il::MapMode mode,
+                                il::io_t, il::Status& status)
+    : MappedArray2D{} {
+  std::size_t offset = 0;
+  il::Status info_status{};
+  il::NumpyInfo numpy_info =
+      il::getNumpyInfo(filename, il::io, offset, info_status);
+  if (!info_status.Ok()) {
+    status = std::move(info_status);
+    return;
+  }
+  if (!(numpy_info.type.isEqual(il::numpyType<T>::value))) {
+    status.SetError(il::Error::BinaryFileWrongType);
+    IL_SET_SOURCE(status);
+    return;
+  } else if (numpy_info.shape.size() != 2) {
+    status.SetError(il::Error::BinaryFileWrongRank);
+    IL_SET_SOURCE(status);
+    return;
+  } else if (!numpy_info.fortran_order) {
+    status.SetError(il::Error::BinaryFileWrongFormat);
+    IL_SET_SOURCE(status);
+    return;
+  }
+
+  mode_ = mode;
+  Map(filename, offset, numpy_info.shape[0], numpy_info.shape[1], il::io,
+      status);
+}
+
+template <typename T>
+MappedArray2D<T>::MappedArray2D(const il::String& filename, il::int_t n0,
+                                il::int_t n1, il::MapMode mode, il::io_t,
+                                il::Status& status)
+    : MappedArray2D{} {
+  IL_EXPECT_FAST(n0 >= 0);
+  IL_EXPECT_FAST(n1 >= 0);
+
+  mode_ = mode;
+  Map(filename, 0, n0, n1, il::io, status);
+}
+
+template <typename T>
+MappedArray2D<T>::MappedArray2D(MappedArray2D<T>&& A)
+    : mapping_{std::move(A.mapping_)},
+      data_{A.data_},
+      size_{A.size_[0], A.size_[1]},
+      mode_{A.mode_} {
+  A.data_ = nullptr;
+  A.size_[0] = 0;
+  A.size_[1] = 0;
+}
+
+template <typename T>
+MappedArray2D<T>& MappedArray2D<T>::operator=(MappedArray2D<T>&& A) {
+  if (this != &A) {
+    mapping_ = std::move(A.mapping_);
+    data_ = A.data_;
+    size_[0] = A.size_[0];
+    size_[1] = A.size_[1];
+    mode_ = A.mode_;
+    A.data_ = nullptr;
+    A.size_[0] = 0;
+    A.size_[1] = 0;
+  }
+  return *this;
+}
+
+template <typename T>
+const T& MappedArray2D<T>::operator()(il::int_t i0, il::int_t i1) const {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i0) <
+                   static_cast<std::size_t>(size_[0]));
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i1) <
+                   static_cast<std::size_t>(size_[1]));
+
+  return data_[i1 * size_[0] + i0];
+}
+
+template <typename T>
+T& MappedArray2D<T>::operator()(il::int_t i0, il::int_t i1) {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i0) <
+                   static_cast<std::size_t>(size_[0]));
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(i1) <
+                   static_cast<std::size_t>(size_[1]));
+
+  return data_[i1 * size_[0] + i0];
+}
+
+template <typename T>
+il::int_t MappedArray2D<T>::size(il::int_t d) const {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(d) < static_cast<std::size_t>(2));
+
+  return size_[d];
+}
+
+template <typename T>
+il::int_t MappedArray2D<T>::stride(il::int_t d) const {
+  IL_EXPECT_MEDIUM(static_cast<std::size_t>(d) < static_cast<std::size_t>(2));
+
+  return (d == 0) ? 1 : size_[0];
+}
+
+template <typename T>
+il::MapMode MappedArray2D<T>::mode() const {
+  return mode_;
+}
+
+template <typename T>
+il::Array2DView<T> MappedArray2D<T>::view() const {
+  return il::Array2DView<T>{data_, size_[0], size_[1], size_[0]};
+}
+
+template <typename T>
+il::Array2DEdit<T> MappedArray2D<T>::Edit() {
+  IL_EXPECT_MEDIUM(mode_ != il::MapMode::Read);
+
+  return il::Array2DEdit<T>{data_, size_[0], size_[1], size_[0], 0, 0};
+}
+
+template <typename T>
+const T* MappedArray2D<T>::data() const {
+  return data_;
+}
+
+template <typename T>
+T* MappedArray2D<T>::Data() {
+  IL_EXPECT_MEDIUM(mode_ != il::MapMode::Read);
+
+  return data_;
+}
+
+template <typename T>
+void MappedArray2D<T>::Sync(il::io_t, il::Status& status) {
+  mapping_.Sync(il::io, status);
+}
+
+template <typename T>
+void MappedArray2D<T>::Map(const il::String& filename, std::size_t offset,
+                           il::int_t n0, il::int_t n1, il::io_t,
+                           il::Status& status) {
+  // The sizes come from the header of the file which might be forged
+  bool error_bytes = false;
+  bool error_length = false;
+  const il::int_t n_bytes = il::safeProduct(
+      n0, n1, static_cast<il::int_t>(sizeof(T)), il::io, error_bytes);
+  const il::int_t length = il::safeSum(static_cast<il::int_t>(offset),
+                                       n_bytes, il::io, error_length);
+  if (n0 < 0 || n1 < 0 || error_bytes || error_length ||
+      offset % alignof(T) != 0) {
+    status.SetError(il::Error::BinaryFileWrongFormat);
+    IL_SET_SOURCE(status);
+    return;
+  }
+
+  const il::int_t n = n0 * n1;
+  il::Status map_status{};
+  il::FileMapping mapping{filename, static_cast<std::size_t>(length), mode_,
+                          il::io, map_status};
+  if (!map_status.Ok()) {
+    status = std::move(map_status);
+    return;
+  }
+
+  mapping_ = std::move(mapping);
+  data_ = n > 0 ? reinterpret_cast<T*>(mapping_.Data() + offset) : nullptr;
+  size_[0] = n0;
+  size_[1] = n1;
+  status.SetOk();
+}
+
+}  // namespace il
+
+#endif  // IL_MAPPEDARRAY_H
@@ -0,0 +1,231 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#include <gtest/gtest.h>
+
+#include <il/linearAlgebra/dense/blas/blas_batched.h>
+#include <il/math.h>
+
+// A batch of diagonally dominant matrices, hence invertible
+template <il::int_t n0, il::int_t n1>
+il::Array<il::StaticArray2D<double, n0, n1>> staticBatch(il::int_t nb,
+                                                         il::int_t seed) {
+  il::Array<il::StaticArray2D<double, n0, n1>> A{nb};
+  for (il::int_t k = 0; k < nb; ++k) {
+    for (il::int_t i1 = 0; i1 < n1; ++i1) {
+      for (il::int_t i0 = 0; i0 < n0; ++i0) {
+        A[k](i0, i1) =
+            static_cast<double>((7 * i0 + 3 * i1 + 5 * k + seed) % 11) - 5.0;
+      }
+    }
+    for (il::int_t i = 0; i < il::min(n0, n1); ++i) {
+      A[k](i, i) += 8.0 * n0;
+    }
+  }
+  return A;
+}
+
+template <il::int_t n0, il::int_t n1>
+double maxError(const il::StaticArray2D<double, n0, n1>& A,
+                const il::StaticArray2D<double, n0, n1>& B) {
+  double error = 0.0;
+  for (il::int_t i1 = 0; i1 < n1; ++i1) {
+    for (il::int_t i0 = 0; i0 < n0; ++i0) {
+      error = il::max(error, il::abs(A(i0, i1) - B(i0, i1)));
+    }
+  }
+  return error;
+}
+
+template <il::int_t n0, il::int_t n, il::int_t n1>
+double batchDotError(il::int_t nb) {
+  const il::Array<il::StaticArray2D<double, n0, n>> A =
+      staticBatch<n0, n>(nb, 1);
+  const il::Array<il::StaticArray2D<double, n, n1>> B =
+      staticBatch<n, n1>(nb, 2);
+
+  const il::Array<il::StaticArray2D<double, n0, n1>> C = il::dot(A, B);
+
+  double error = 0.0;
+  for (il::int_t k = 0; k < nb; ++k) {
+    error = il::max(error, maxError(C[k], il::dot(A[k], B[k])));
+  }
+  return error;
+}
+
+template <il::int_t n>
+double batchInverseError(il::int_t nb) {
+  const il::Array<il::StaticArray2D<double, n, n>> A = staticBatch<n, n>(nb, 3);
+
+  const il::Array<il::StaticArray2D<double, n, n>> B = il::inverse(A);
+
+  double error = 0.0;
+  for (il::int_t k = 0; k < nb; ++k) {
+    error = il::max(error, maxError(B[k], il::inverse(A[k])));
+  }
+  return error;
+}
+
+TEST(blas_batched, dot) {
+  ASSERT_TRUE((batchDotError<2, 2, 2>(19) == 0.0));
+  ASSERT_TRUE((batchDotError<3, 3, 3>(21) == 0.0));
+  ASSERT_TRUE((batchDotError<3, 2, 4>(8) == 0.0));
+  ASSERT_TRUE((batchDotError<4, 4, 4>(5) == 0.0));
+  ASSERT_TRUE((batchDotError<6, 6, 6>(11) == 0.0));
+  ASSERT_TRUE((batchDotError<3, 3, 3>(0) == 0.0));
+  ASSERT_TRUE((batchDotError<3, 3, 3>(3000) == 0.0));
+}
+
+TEST(blas_batched, blas) {
+  const il::int_t nb = 21;
+  const il::Array<il::StaticArray2D<double, 3, 3>> A = staticBatch<3, 3>(nb, 1);
+  const il::Array<il::StaticArray2D<double, 3, 3>> B = staticBatch<3, 3>(nb, 2);
+  const il::Array<il::StaticArray2D<double, 3, 3>> C_old =
+      staticBatch<3, 3>(nb, 3);
+  il::Array<il::StaticArray2D<double, 3, 3>> C = C_old;
+
+  il::blas(2.0, A, B, 3.0, il::io, C);
+
+  double error = 0.0;
+  for (il::int_t k = 0; k < nb; ++k) {
+    const il::StaticArray2D<double, 3, 3> AB = il::dot(A[k], B[k]);
+    for (il::int_t i1 = 0; i1 < 3; ++i1) {
+      for (il::int_t i0 = 0; i0 < 3; ++i0) {
+        error = il::max(error, il::abs(C[k](i0, i1) - (2.0 * AB(i0, i1) +
+                                                       3.0 * C_old[k](i0, i1))));
+      }
+    }
+  }
+
+  ASSERT_TRUE(error == 0.0);
+}
+
+TEST(blas_batched, inverse) {
+  ASSERT_TRUE(batchInverseError<2>(19) <= 1.0e-15);
+  ASSERT_TRUE(batchInverseError<3>(21) <= 1.0e-15);
+  ASSERT_TRUE(batchInverseError<4>(5) == 0.0);
+  ASSERT_TRUE(batchInverseError<6>(5) == 0.0);
+}
+
+TEST(blas_batched, lu) {
+  const il::int_t nb = 13;
+  const il::Array<il::StaticArray2D<double, 6, 6>> A = staticBatch<6, 6>(nb, 4);
+  il::Array<il::StaticArray2D<double, 6, 6>> lu = A;
+  il::Array<il::StaticArray<il::int_t, 6>> pivot{nb};
+  il::Array<il::StaticArray<double, 6>> x{nb};
+  for (il::int_t k = 0; k < nb; ++k) {
+    for (il::int_t i = 0; i < 6; ++i) {
+      x[k][i] = static_cast<double>(i + k);
+    }
+  }
+  const il::Array<il::StaticArray<double, 6>> b = x;
+
+  il::Status status{};
+  il::luDecomposition(il::io, pivot, lu, status);
+  status.AbortOnError();
+  il::luSolve(pivot, lu, il::io, x);
+
+  double error = 0.0;
+  for (il::int_t k = 0; k < nb; ++k) {
+    const il::StaticArray<double, 6> y = il::dot(A[k], x[k]);
+    for (il::int_t i = 0; i < 6; ++i) {
+      error = il::max(error, il::abs(y[i] - b[k][i]));
+    }
+  }
+
+  ASSERT_TRUE(error <= 1.0e-13);
+}
+
+TEST(blas_batched, lu_singular) {
+  // The batch is large enough to be split in between threads
+  const il::int_t nb = 3000;
+  il::Array<il::StaticArray2D<double, 3, 3>> A = staticBatch<3, 3>(nb, 5);
+  A[2900] = il::StaticArray2D<double, 3, 3>{0.0};
+  A[1500] = il::StaticArray2D<double, 3, 3>{1.0};
+  il::Array<il::StaticArray<il::int_t, 3>> pivot{nb};
+
+  il::Status status{};
+  il::luDecomposition(il::io, pivot, A, status);
+
+  ASSERT_TRUE(!status.Ok() && status.error() == il::Error::MatrixSingular &&
+              status.toInteger("index") == 1500);
+}
+
+TEST(blas_batched, dot_interleaved) {
+  const il::int_t nb = 77;
+  const il::Array<il::StaticArray2D<double, 3, 2>> A = staticBatch<3, 2>(nb, 1);
+  const il::Array<il::StaticArray2D<double, 2, 4>> B = staticBatch<2, 4>(nb, 2);
+  const il::InterleavedArray2D<double, 3, 2> A_interleaved{A};
+  const il::InterleavedArray2D<double, 2, 4> B_interleaved{B};
+
+  const il::InterleavedArray2D<double, 3, 4> C =
+      il::dot(A_interleaved, B_interleaved);
+
+  double error = 0.0;
+  for (il::int_t k = 0; k < nb; ++k) {
+    error = il::max(error, maxError(C.matrix(k), il::dot(A[k], B[k])));
+  }
+
+  ASSERT_TRUE(C.size() == nb && error == 0.0);
+}
+
+TEST(blas_batched, blas_interleaved) {
+  const il::int_t nb = 70;
+  const il::Array<il::StaticArray2D<double, 3, 3>> A = staticBatch<3, 3>(nb, 1);
+  const il::Array<il::StaticArray2D<double, 3, 3>> B = staticBatch<3, 3>(nb, 2);
+  const il::Array<il::StaticArray2D<double, 3, 3>> C_old =
+      staticBatch<3, 3>(nb, 3);
+  il::InterleavedArray2D<double, 3, 3> C{C_old};
+
+  il::blas(2.0, il::InterleavedArray2D<double, 3, 3>{A},
+           il::InterleavedArray2D<double, 3, 3>{B}, 3.0, il::io, C);
+
+  double error = 0.0;
+  for (il::int_t k = 0; k < nb; ++k) {
+    const il::StaticArray2D<double, 3, 3> AB = il::dot(A[k], B[k]);
+    for (il::int_t i1 = 0; i1 < 3; ++i1) {
+      for (il::int_t i0 = 0; i0 < 3; ++i0) {
+        error = il::max(error, il::abs(C(k, i0, i1) - (2.0 * AB(i0, i1) +
+                                                       3.0 * C_old[k](i0, i1))));
+      }
+    }
+  }
+
+  ASSERT_TRUE(error == 0.0);
+}
+
+template <il::int_t n>
+double interleavedInverseError(il::int_t nb) {
+  const il::Array<il::StaticArray2D<double, n, n>> A = staticBatch<n, n>(nb, 3);
+
+  const il::InterleavedArray2D<double, n, n> B =
+      il::inverse(il::InterleavedArray2D<double, n, n>{A});
+
+  double error = 0.0;
+  for (il::int_t k = 0; k < nb; ++k) {
+    error = il::max(error, maxError(B.matrix(k), il::inverse(A[k])));
+  }
+  return error;
+}
+
+TEST(blas_batched, inverse_interleaved) {
+  ASSERT_TRUE(interleavedInverseError<2>(67) <= 1.0e-15);
+  ASSERT_TRUE(interleavedInverseError<3>(131) <= 1.0e-15);
+  ASSERT_TRUE(interleavedInverseError<3>(3000) <= 1.0e-15);
+  ASSERT_TRUE(interleavedInverseError<4>(9) == 0.0);
+}
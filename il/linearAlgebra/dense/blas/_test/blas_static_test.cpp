@@ -0,0 +1,220 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#include <gtest/gtest.h>
+
+#include <il/linearAlgebra/dense/blas/blas_static.h>
+#include <il/math.h>
+
+// A diagonally dominant matrix, hence invertible
+template <il::int_t n0, il::int_t n1>
+il::StaticArray2D<double, n0, n1> staticMatrix(il::int_t seed) {
+  il::StaticArray2D<double, n0, n1> A{};
+  for (il::int_t i1 = 0; i1 < n1; ++i1) {
+    for (il::int_t i0 = 0; i0 < n0; ++i0) {
+      A(i0, i1) = static_cast<double>((7 * i0 + 3 * i1 + seed) % 11) - 5.0;
+    }
+  }
+  for (il::int_t i = 0; i < il::min(n0, n1); ++i) {
+    A(i, i) += 8.0 * n0;
+  }
+  return A;
+}
+
+template <il::int_t n0, il::int_t n, il::int_t n1>
+double dotError() {
+  const il::StaticArray2D<double, n0, n> A = staticMatrix<n0, n>(1);
+  const il::StaticArray2D<double, n, n1> B = staticMatrix<n, n1>(2);
+  const il::StaticArray2D<double, n0, n1> C = il::dot(A, B);
+
+  double error = 0.0;
+  for (il::int_t i1 = 0; i1 < n1; ++i1) {
+    for (il::int_t i0 = 0; i0 < n0; ++i0) {
+      double c = 0.0;
+      for (il::int_t i = 0; i < n; ++i) {
+        c += A(i0, i) * B(i, i1);
+      }
+      error = il::max(error, il::abs(C(i0, i1) - c));
+    }
+  }
+  return error;
+}
+
+template <il::int_t n>
+double inverseError(const il::StaticArray2D<double, n, n>& A,
+                    const il::StaticArray2D<double, n, n>& B) {
+  const il::StaticArray2D<double, n, n> C = il::dot(A, B);
+  double error = 0.0;
+  for (il::int_t i1 = 0; i1 < n; ++i1) {
+    for (il::int_t i0 = 0; i0 < n; ++i0) {
+      error = il::max(error, il::abs(C(i0, i1) - (i0 == i1 ? 1.0 : 0.0)));
+    }
+  }
+  return error;
+}
+
+TEST(blas_static, dot_matrix_matrix) {
+  ASSERT_TRUE((dotError<2, 2, 2>() == 0.0));
+  ASSERT_TRUE((dotError<3, 3, 3>() == 0.0));
+  ASSERT_TRUE((dotError<4, 4, 4>() == 0.0));
+  ASSERT_TRUE((dotError<6, 6, 6>() == 0.0));
+  ASSERT_TRUE((dotError<8, 8, 8>() == 0.0));
+  ASSERT_TRUE((dotError<4, 3, 5>() == 0.0));
+  ASSERT_TRUE((dotError<6, 2, 3>() == 0.0));
+  ASSERT_TRUE((dotError<8, 5, 1>() == 0.0));
+}
+
+TEST(blas_static, dot_matrix_vector) {
+  const il::StaticArray2D<double, 6, 6> A = staticMatrix<6, 6>(3);
+  il::StaticArray<double, 6> x{};
+  for (il::int_t i = 0; i < 6; ++i) {
+    x[i] = static_cast<double>(i) - 2.0;
+  }
+
+  const il::StaticArray<double, 6> y = il::dot(A, x);
+
+  double error = 0.0;
+  for (il::int_t i0 = 0; i0 < 6; ++i0) {
+    double c = 0.0;
+    for (il::int_t i = 0; i < 6; ++i) {
+      c += A(i0, i) * x[i];
+    }
+    error = il::max(error, il::abs(y[i0] - c));
+  }
+
+  ASSERT_TRUE(error == 0.0);
+}
+
+TEST(blas_static, blas_matrix_vector) {
+  const il::StaticArray2D<double, 4, 4> A = staticMatrix<4, 4>(4);
+  il::StaticArray<double, 4> x{il::value, {1.0, 2.0, 3.0, 4.0}};
+  il::StaticArray<double, 4> y{il::value, {1.0, -1.0, 1.0, -1.0}};
+  const il::StaticArray<double, 4> y_old = y;
+
+  il::blas(2.0, A, x, 3.0, il::io, y);
+
+  double error = 0.0;
+  for (il::int_t i0 = 0; i0 < 4; ++i0) {
+    double c = 0.0;
+    for (il::int_t i = 0; i < 4; ++i) {
+      c += A(i0, i) * x[i];
+    }
+    error = il::max(error, il::abs(y[i0] - (2.0 * c + 3.0 * y_old[i0])));
+  }
+
+  ASSERT_TRUE(error == 0.0);
+}
+
+TEST(blas_static, transpose) {
+  const il::StaticArray2D<double, 4, 4> A = staticMatrix<4, 4>(5);
+  const il::StaticArray2D<double, 3, 2> B = staticMatrix<3, 2>(6);
+
+  const il::StaticArray2D<double, 4, 4> At = il::transpose(A);
+  const il::StaticArray2D<double, 2, 3> Bt = il::transpose(B);
+
+  bool ok = true;
+  for (il::int_t i1 = 0; i1 < 4; ++i1) {
+    for (il::int_t i0 = 0; i0 < 4; ++i0) {
+      ok = ok && At(i1, i0) == A(i0, i1);
+    }
+  }
+  for (il::int_t i1 = 0; i1 < 2; ++i1) {
+    for (il::int_t i0 = 0; i0 < 3; ++i0) {
+      ok = ok && Bt(i1, i0) == B(i0, i1);
+    }
+  }
+
+  ASSERT_TRUE(ok);
+}
+
+TEST(blas_static, det) {
+  il::StaticArray2D<double, 2, 2> A2{il::value, {{1.0, 3.0}, {2.0, 4.0}}};
+  il::StaticArray2D<double, 3, 3> A3{
+      il::value, {{2.0, 0.0, 1.0}, {1.0, 3.0, 0.0}, {0.0, 1.0, 4.0}}};
+  // A permutation matrix with an odd number of interchanges, scaled by 2
+  il::StaticArray2D<double, 4, 4> A4{0.0};
+  A4(1, 0) = 2.0;
+  A4(0, 1) = 2.0;
+  A4(2, 2) = 2.0;
+  A4(3, 3) = 2.0;
+  il::StaticArray2D<double, 5, 5> A5{0.0};
+  for (il::int_t i = 0; i < 5; ++i) {
+    A5(i, i) = static_cast<double>(i + 1);
+  }
+  A5(0, 4) = 7.0;
+
+  ASSERT_TRUE(il::det(A2) == -2.0 && il::det(A3) == 25.0 &&
+              il::det(A4) == -16.0 && il::det(A5) == 120.0);
+}
+
+TEST(blas_static, det_pivoting) {
+  const il::StaticArray2D<double, 6, 6> A = staticMatrix<6, 6>(7);
+  il::StaticArray2D<double, 6, 6> B = A;
+  // Interchanging two rows changes the sign of the determinant
+  for (il::int_t i1 = 0; i1 < 6; ++i1) {
+    const double temp = B(0, i1);
+    B(0, i1) = B(5, i1);
+    B(5, i1) = temp;
+  }
+
+  const double det_a = il::det(A);
+  const double det_b = il::det(B);
+
+  ASSERT_TRUE(il::abs(det_a + det_b) <= 1.0e-13 * il::abs(det_a));
+}
+
+TEST(blas_static, inverse) {
+  const il::StaticArray2D<double, 2, 2> A2 = staticMatrix<2, 2>(1);
+  const il::StaticArray2D<double, 3, 3> A3 = staticMatrix<3, 3>(2);
+  const il::StaticArray2D<double, 4, 4> A4 = staticMatrix<4, 4>(3);
+  const il::StaticArray2D<double, 6, 6> A6 = staticMatrix<6, 6>(4);
+  const il::StaticArray2D<double, 8, 8> A8 = staticMatrix<8, 8>(5);
+
+  const double error = il::max(
+      il::max(inverseError(A2, il::inverse(A2)),
+              inverseError(A3, il::inverse(A3))),
+      il::max(inverseError(A4, il::inverse(A4)),
+              inverseError(A6, il::inverse(A6)),
+              inverseError(A8, il::inverse(A8))));
+
+  ASSERT_TRUE(error <= 1.0e-14);
+}
+
+TEST(blas_static, inverse_pivoting) {
+  // The first pivot is zero without pivoting
+  il::StaticArray2D<double, 3, 3> A{
+      il::value, {{0.0, 1.0, 2.0}, {1.0, 0.0, 3.0}, {4.0, -3.0, 8.0}}};
+  il::StaticArray2D<double, 3, 3> lu = A;
+  il::StaticArray<il::int_t, 3> pivot{};
+
+  const il::int_t info = il::luDecomposition(il::io, pivot, lu);
+  const il::StaticArray2D<double, 3, 3> B = il::luInverse(pivot, lu);
+
+  ASSERT_TRUE(info == 0 && inverseError(A, B) <= 1.0e-14 &&
+              inverseError(A, il::inverse(A)) <= 1.0e-14);
+}
+
+TEST(blas_static, lu_singular) {
+  il::StaticArray2D<double, 3, 3> A{
+      il::value, {{1.0, 2.0, 0.0}, {2.0, 4.0, 0.0}, {0.0, 0.0, 1.0}}};
+  il::StaticArray<il::int_t, 3> pivot{};
+
+  const il::int_t info = il::luDecomposition(il::io, pivot, A);
+
+  ASSERT_TRUE(info == 2);
+}
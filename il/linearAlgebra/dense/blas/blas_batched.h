@@ -0,0 +1,410 @@
+//==============================================================================
+//
+// Copyright 2018 The InsideLoop Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//==============================================================================
+
+#ifndef IL_BLAS_BATCHED_H
+#define IL_BLAS_BATCHED_H
+
+// <atomic> is needed for std::atomic
+#include <atomic>
+
+#include <il/Array.h>
+#include <il/InterleavedArray2D.h>
+#include <il/Status.h>
+#include <il/core/thread/parallel.h>
+#include <il/linearAlgebra/dense/blas/blas_static.h>
+
+namespace il {
+
+// The batched functions work on a large number of independent small matrices.
+// The batch is split into chunks given to different threads with
+// il::parallelFor.
+//
+// - With an il::Array<il::StaticArray2D<T, n0, n1>>, the matrices are handled
+//   one at a time with the kernels of blas_static.h which are vectorized
+//   within a matrix.
+// - With an il::InterleavedArray2D<T, n0, n1>, the loops on the matrices are
+//   the inner ones and they are vectorized across matrices. This is the
+//   fastest layout for matrices smaller than 4 x 4 which are too small to be
+//   vectorized on their own.
+
+////////////////////////////////////////////////////////////////////////////////
+// Batched functions on arrays of matrices
+////////////////////////////////////////////////////////////////////////////////
+
+// C[k] <- alpha A[k].B[k] + beta C[k] for 0 <= k < nb. The work is done in a
+// function rather than in the lambda given to il::parallelFor so that alpha
+// and beta are local variables that the compiler knows are not modified by
+// the stores to C.
+template <typename T, il::int_t n0, il::int_t n, il::int_t n1>
+struct StaticBatchDot {
+  static void blas(T alpha, const il::StaticArray2D<T, n0, n>* A,
+                   const il::StaticArray2D<T, n, n1>* B, T beta,
+                   il::StaticArray2D<T, n0, n1>* C, il::int_t nb) {
+    if (beta == T{0}) {
+      for (il::int_t k = 0; k < nb; ++k) {
+        T* c = C[k].Data();
+        il::StaticDot<T, n0, n, n1>::dot(A[k].data(), B[k].data(), c);
+        for (il::int_t i = 0; i < n0 * n1; ++i) {
+          c[i] *= alpha;
+        }
+      }
+    } else {
+      for (il::int_t k = 0; k < nb; ++k) {
+        T ab[n0 * n1];
+        il::StaticDot<T, n0, n, n1>::dot(A[k].data(), B[k].data(), ab);
+        T* c = C[k].Data();
+        for (il::int_t i = 0; i < n0 * n1; ++i) {
+          c[i] = alpha * ab[i] + beta * c[i];
+        }
+      }
+    }
+  }
+};
+
+// C[k] <- alpha A[k].B[k] + beta C[k] for all the matrices of the batch. When
+// beta is zero, C is not read.
+template <typename T, il::int_t n0, il::int_t n, il::int_t n1>
+void blas(T alpha, const il::Array<il::StaticArray2D<T, n0, n>>& A,
+          const il::Array<il::StaticArray2D<T, n, n1>>& B, T beta, il::io_t,
+          il::Array<il::StaticArray2D<T, n0, n1>>& C) {
+  IL_EXPECT_FAST(A.size() == B.size());
+  IL_EXPECT_FAST(A.size() == C.size());
+
+  const il::StaticArray2D<T, n0, n>* a = A.data();
+  const il::StaticArray2D<T, n, n1>* b = B.data();
+  il::StaticArray2D<T, n0, n1>* c = C.Data();
+  il::parallelFor(
+      0, A.size(), il::parallelGrain<il::StaticArray2D<T, n0, n1>>(),
+      [=](il::int_t k_begin, il::int_t k_end) {
+        il::StaticBatchDot<T, n0, n, n1>::blas(alpha, a + k_begin, b + k_begin,
+                                               beta, c + k_begin,
+                                               k_end - k_begin);
+      });
+}
+
+// Returns C with C[k] = A[k].B[k] for all the matrices of the batch
+template <typename T, il::int_t n0, il::int_t n, il::int_t n1>
+il::Array<il::StaticArray2D<T, n0, n1>> dot(
+    const il::Array<il::StaticArray2D<T, n0, n>>& A,
+    const il::Array<il::StaticArray2D<T, n, n1>>& B) {
+  IL_EXPECT_FAST(A.size() == B.size());
+
+  il::Array<il::StaticArray2D<T, n0, n1>> C{A.size()};
+  il::blas(T{1}, A, B, T{0}, il::io, C);
+  return C;
+}
+
+/* \brief Compute in place the LU factorizations of a batch of matrices
+// \details Each matrix is factorized with il::luDecomposition. If some of the
+// matrices are singular, the status is set to il::Error::MatrixSingular and
+// its "index" info is the index of the first singular matrix of the batch.
+// All the other matrices are factorized anyway.
+*/
+template <typename T, il::int_t n>
+void luDecomposition(il::io_t, il::Array<il::StaticArray<il::int_t, n>>& pivot,
+                     il::Array<il::StaticArray2D<T, n, n>>& A,
+                     il::Status& status) {
+  IL_EXPECT_FAST(pivot.size() == A.size());
+
+  const il::int_t nb = A.size();
+  il::StaticArray<il::int_t, n>* p = pivot.Data();
+  il::StaticArray2D<T, n, n>* a = A.Data();
+  std::atomic<il::int_t> first_singular{nb};
+  il::parallelFor(
+      0, nb, il::parallelGrain<il::StaticArray2D<T, n, n>>(),
+      [=, &first_singular](il::int_t k_begin, il::int_t k_end) {
+        for (il::int_t k = k_begin; k < k_end; ++k) {
+          if (il::luDecomposition(il::io, p[k], a[k]) != 0) {
+            il::int_t first = first_singular.load();
+            while (k < first &&
+                   !first_singular.compare_exchange_weak(first, k)) {
+            }
+          }
+        }
+      });
+
+  if (first_singular.load() == nb) {
+    status.SetOk();
+  } else {
+    status.SetError(il::Error::MatrixSingular);
+    IL_SET_SOURCE(status);
+    status.SetInfo("index", first_singular.load());
+  }
+}
+
+// Solve in place the systems A[k].x[k] = b[k] from the LU factorizations
+// computed by il::luDecomposition. On entry, x contains the b[k] and on exit
+// it contains the solutions.
+template <typename T, il::int_t n>
+void luSolve(const il::Array<il::StaticArray<il::int_t, n>>& pivot,
+             const il::Array<il::StaticArray2D<T, n, n>>& lu, il::io_t,
+             il::Array<il::StaticArray<T, n>>& x) {
+  IL_EXPECT_FAST(pivot.size() == lu.size());
+  IL_EXPECT_FAST(x.size() == lu.size());
+
+  const il::StaticArray<il::int_t, n>* p = pivot.data();
+  const il::StaticArray2D<T, n, n>* a = lu.data();
+  il::StaticArray<T, n>* y = x.Data();
+  il::parallelFor(0, x.size(), il::parallelGrain<il::StaticArray2D<T, n, n>>(),
+                  [=](il::int_t k_begin, il::int_t k_end) {
+                    for (il::int_t k = k_begin; k < k_end; ++k) {
+                      il::luSolve(p[k], a[k], il::io, y[k]);
+                    }
+                  });
+}
+
+// B[k] <- A[k]^(-1) for 0 <= k < nb
+template <typename T, il::int_t n>
+struct StaticBatchInverse {
+  static void inverse(const il::StaticArray2D<T, n, n>* A,
+                      il::StaticArray2D<T, n, n>* B, il::int_t nb) {
+    for (il::int_t k = 0; k < nb; ++k) {
+      B[k] = il::inverse(A[k]);
+    }
+  }
+};
+
+// Returns B with B[k] = A[k]^(-1) for all the matrices of the batch. All the
+// matrices must be invertible.
+template <typename T, il::int_t n>
+il::Array<il::StaticArray2D<T, n, n>> inverse(
+    const il::Array<il::StaticArray2D<T, n, n>>& A) {
+  il::Array<il::StaticArray2D<T, n, n>> B{A.size()};
+  const il::StaticArray2D<T, n, n>* a = A.data();
+  il::StaticArray2D<T, n, n>* b = B.Data();
+  il::parallelFor(0, A.size(), il::parallelGrain<il::StaticArray2D<T, n, n>>(),
+                  [=](il::int_t k_begin, il::int_t k_end) {
+                    il::StaticBatchInverse<T, n>::inverse(
+                        a + k_begin, b + k_begin, k_end - k_begin);
+                  });
+  return B;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Batched functions on interleaved matrices
+////////////////////////////////////////////////////////////////////////////////
+
+// C[k] <- alpha A[k].B[k] + beta C[k] for k_begin <= k < k_end, where a, b
+// and c point to interleaved matrices of strides sa, sb and sc. The matrices
+// are processed by blocks whose results are first stored in a local buffer.
+// As the compiler knows that this buffer does not alias a and b, it unrolls
+// the loops on the entries and vectorizes the loop on the matrices.
+template <typename T, il::int_t n0, il::int_t n, il::int_t n1>
+struct InterleavedDot {
+  static const il::int_t block = 32;
+
+  static void blas(T alpha, const T* a, il::int_t sa, const T* b,
+                   il::int_t sb, T beta, T* c, il::int_t sc, il::int_t k_begin,
+                   il::int_t k_end) {
+    il::int_t k0 = k_begin;
+    for (; k0 + block <= k_end; k0 += block) {
+      blasBlock(alpha, a + k0, sa, b + k0, sb, beta, c + k0, sc, block);
+    }
+    blasBlock(alpha, a + k0, sa, b + k0, sb, beta, c + k0, sc, k_end - k0);
+  }
+
+  // The function is inlined and nk is known at compile time for the full
+  // blocks
+  static void blasBlock(T alpha, const T* a, il::int_t sa, const T* b,
+                        il::int_t sb, T beta, T* c, il::int_t sc,
+                        il::int_t nk) {
+    T z[n0 * n1][block];
+    for (il::int_t k = 0; k < nk; ++k) {
+      for (il::int_t i1 = 0; i1 < n1; ++i1) {
+        for (il::int_t i0 = 0; i0 < n0; ++i0) {
+          T xy = a[i0 * sa + k] * b[(i1 * n) * sb + k];
+          for (il::int_t i = 1; i < n; ++i) {
+            xy += a[(i * n0 + i0) * sa + k] * b[(i1 * n + i) * sb + k];
+          }
+          z[i1 * n0 + i0][k] = xy;
+        }
+      }
+    }
+    for (il::int_t i = 0; i < n0 * n1; ++i) {
+      T* c_i = c + i * sc;
+      if (beta == T{0}) {
+        for (il::int_t k = 0; k < nk; ++k) {
+          c_i[k] = alpha * z[i][k];
+        }
+      } else {
+        for (il::int_t k = 0; k < nk; ++k) {
+          c_i[k] = alpha * z[i][k] + beta * c_i[k];
+        }
+      }
+    }
+  }
+};
+
+// C[k] <- alpha A[k].B[k] + beta C[k] for all the matrices of the batch. When
+// beta is zero, C is not read.
+template <typename T, il::int_t n0, il::int_t n, il::int_t n1>
+void blas(T alpha, const il::InterleavedArray2D<T, n0, n>& A,
+          const il::InterleavedArray2D<T, n, n1>& B, T beta, il::io_t,
+          il::InterleavedArray2D<T, n0, n1>& C) {
+  IL_EXPECT_FAST(A.size() == B.size());
+  IL_EXPECT_FAST(A.size() == C.size());
+
+  const T* a = A.data();
+  const T* b = B.data();
+  T* c = C.Data();
+  const il::int_t sa = A.stride();
+  const il::int_t sb = B.stride();
+  const il::int_t sc = C.stride();
+  il::parallelFor(
+      0, A.size(), il::parallelGrain<il::StaticArray2D<T, n0, n1>>(),
+      [=](il::int_t k_begin, il::int_t k_end) {
+        il::InterleavedDot<T, n0, n, n1>::blas(alpha, a, sa, b, sb, beta, c,
+                                               sc, k_begin, k_end);
+      });
+}
+
+// Returns C with C[k] = A[k].B[k] for all the matrices of the batch
+template <typename T, il::int_t n0, il::int_t n, il::int_t n1>
+il::InterleavedArray2D<T, n0, n1> dot(
+    const il::InterleavedArray2D<T, n0, n>& A,
+    const il::InterleavedArray2D<T, n, n1>& B) {
+  IL_EXPECT_FAST(A.size() == B.size());
+
+  il::InterleavedArray2D<T, n0, n1> C{A.size()};
+  il::blas(T{1}, A, B, T{0}, il::io, C);
+  return C;
+}
+
+// B[k] <- A[k]^(-1) for k_begin <= k < k_end. The matrices of size 2 and 3
+// are inverted in closed form, by blocks, with loops vectorized across
+// matrices as in il::InterleavedDot. The larger ones are inverted one at a
+// time.
+template <typename T, il::int_t n>
+struct InterleavedInverse {
+  static void inverse(const il::InterleavedArray2D<T, n, n>& A,
+                      il::int_t k_begin, il::int_t k_end, il::io_t,
+                      il::InterleavedArray2D<T, n, n>& B) {
+    for (il::int_t k = k_begin; k < k_end; ++k) {
+      B.Set(k, il::inverse(A.matrix(k)));
+    }
+  }
+};
+
+template <typename T>
+struct InterleavedInverse<T, 2> {
+  static const il::int_t block = 32;
+
+  static void inverse(const il::InterleavedArray2D<T, 2, 2>& A,
+                      il::int_t k_begin, il::int_t k_end, il::io_t,
+                      il::InterleavedArray2D<T, 2, 2>& B) {
+    const T* a = A.data();
+    T* b = B.Data();
+    const il::int_t sa = A.stride();
+    const il::int_t sb = B.stride();
+    il::int_t k0 = k_begin;
+    for (; k0 + block <= k_end; k0 += block) {
+      inverseBlock(a + k0, sa, b + k0, sb, block);
+    }
+    inverseBlock(a + k0, sa, b + k0, sb, k_end - k0);
+  }
+
+  static void inverseBlock(const T* a, il::int_t sa, T* b, il::int_t sb,
+                           il::int_t nk) {
+    T y[4][block];
+    for (il::int_t k = 0; k < nk; ++k) {
+      const T inv_det =
+          T{1} / (a[k] * a[3 * sa + k] - a[sa + k] * a[2 * sa + k]);
+      y[0][k] = a[3 * sa + k] * inv_det;
+      y[1][k] = -a[sa + k] * inv_det;
+      y[2][k] = -a[2 * sa + k] * inv_det;
+      y[3][k] = a[k] * inv_det;
+    }
+    for (il::int_t i = 0; i < 4; ++i) {
+      for (il::int_t k = 0; k < nk; ++k) {
+        b[i * sb + k] = y[i][k];
+      }
+    }
+  }
+};
+
+template <typename T>
+struct InterleavedInverse<T, 3> {
+  static const il::int_t block = 32;
+
+  static void inverse(const il::InterleavedArray2D<T, 3, 3>& A,
+                      il::int_t k_begin, il::int_t k_end, il::io_t,
+                      il::InterleavedArray2D<T, 3, 3>& B) {
+    const T* a = A.data();
+    T* b = B.Data();
+    const il::int_t sa = A.stride();
+    const il::int_t sb = B.stride();
+    il::int_t k0 = k_begin;
+    for (; k0 + block <= k_end; k0 += block) {
+      inverseBlock(a + k0, sa, b + k0, sb, block);
+    }
+    inverseBlock(a + k0, sa, b + k0, sb, k_end - k0);
+  }
+
+  static void inverseBlock(const T* a, il::int_t sa, T* b, il::int_t sb,
+                           il::int_t nk) {
+    // The entry i of the k-th matrix of the block is y[i][k]
+    T y[9][block];
+    for (il::int_t k = 0; k < nk; ++k) {
+      const T a0 = a[k];
+      const T a1 = a[sa + k];
+      const T a2 = a[2 * sa + k];
+      const T a3 = a[3 * sa + k];
+      const T a4 = a[4 * sa + k];
+      const T a5 = a[5 * sa + k];
+      const T a6 = a[6 * sa + k];
+      const T a7 = a[7 * sa + k];
+      const T a8 = a[8 * sa + k];
+      const T b0 = a4 * a8 - a5 * a7;
+      const T b1 = a2 * a7 - a1 * a8;
+      const T b2 = a1 * a5 - a2 * a4;
+      const T inv_det = T{1} / (a0 * b0 + a3 * b1 + a6 * b2);
+      y[0][k] = b0 * inv_det;
+      y[1][k] = b1 * inv_det;
+      y[2][k] = b2 * inv_det;
+      y[3][k] = (a5 * a6 - a3 * a8) * inv_det;
+      y[4][k] = (a0 * a8 - a2 * a6) * inv_det;
+      y[5][k] = (a2 * a3 - a0 * a5) * inv_det;
+      y[6][k] = (a3 * a7 - a4 * a6) * inv_det;
+      y[7][k] = (a1 * a6 - a0 * a7) * inv_det;
+      y[8][k] = (a0 * a4 - a1 * a3) * inv_det;
+    }
+    for (il::int_t i = 0; i < 9; ++i) {
+      for (il::int_t k = 0; k < nk; ++k) {
+        b[i * sb + k] = y[i][k];
+      }
+    }
+  }
+};
+
+// Returns B with B[k] = A[k]^(-1) for all the matrices of the batch. All the
+// matrices must be invertible.
+template <typename T, il::int_t n>
+il::InterleavedArray2D<T, n, n> inverse(
+    const il::InterleavedArray2D<T, n, n>& A) {
+  il::InterleavedArray2D<T, n, n> B{A.size()};
+  il::parallelFor(0, A.size(), il::parallelGrain<il::StaticArray2D<T, n, n>>(),
+                  [&A, &B](il::int_t k_begin, il::int_t k_end) {
+                    il::InterleavedInverse<T, n>::inverse(A, k_begin, k_end,
+                                                          il::io, B);
+                  });
+  return B;
+}
+
+}  // namespace il
+
+#endif  // IL_BLAS_BATCHED_H
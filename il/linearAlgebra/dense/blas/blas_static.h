@@ -19,6 +19,13 @@
 #ifndef IL_BLAS_STATIC_H
 #define IL_BLAS_STATIC_H
 
+// <cmath> is needed for std::abs
+#include <cmath>
+
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
 #include <il/StaticArray.h>
 #include <il/StaticArray2D.h>
 #include <il/StaticArray3D.h>
@@ -27,6 +34,408 @@
 
 namespace il {
 
+////////////////////////////////////////////////////////////////////////////////
+// Kernels for small matrices
+////////////////////////////////////////////////////////////////////////////////
+
+/* \brief Compute C = A.B for small matrices whose sizes are known at compile
+// time
+// \details A is a n0 x n matrix, B is a n x n1 matrix and C is a n0 x n1
+// matrix, all of them stored in Fortran order. As the trip counts are known
+// at compile time, the compiler fully unrolls the loops for small matrices
+// and keeps each column of C in registers. When AVX is available, the columns
+// of A and C are explicitly held in SIMD registers for n0 = 4, 6 and 8.
+*/
+template <typename T, il::int_t n0, il::int_t n, il::int_t n1>
+struct StaticDot {
+  static void dot(const T* A, const T* B, T* C) {
+    for (il::int_t i1 = 0; i1 < n1; ++i1) {
+      T c[n0];
+      for (il::int_t i0 = 0; i0 < n0; ++i0) {
+        c[i0] = A[i0] * B[i1 * n];
+      }
+      for (il::int_t i = 1; i < n; ++i) {
+        const T b = B[i1 * n + i];
+        for (il::int_t i0 = 0; i0 < n0; ++i0) {
+          c[i0] += A[i * n0 + i0] * b;
+        }
+      }
+      for (il::int_t i0 = 0; i0 < n0; ++i0) {
+        C[i1 * n0 + i0] = c[i0];
+      }
+    }
+  }
+};
+
+#ifdef __AVX__
+inline __m256d fmadd256(__m256d a, __m256d b, __m256d c) {
+#ifdef __FMA__
+  return _mm256_fmadd_pd(a, b, c);
+#else
+  return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#endif
+}
+
+inline __m128d fmadd128(__m128d a, __m128d b, __m128d c) {
+#ifdef __FMA__
+  return _mm_fmadd_pd(a, b, c);
+#else
+  return _mm_add_pd(_mm_mul_pd(a, b), c);
+#endif
+}
+
+template <il::int_t n, il::int_t n1>
+struct StaticDot<double, 4, n, n1> {
+  static void dot(const double* A, const double* B, double* C) {
+    for (il::int_t i1 = 0; i1 < n1; ++i1) {
+      __m256d c = _mm256_mul_pd(_mm256_loadu_pd(A),
+                                _mm256_broadcast_sd(B + i1 * n));
+      for (il::int_t i = 1; i < n; ++i) {
+        c = il::fmadd256(_mm256_loadu_pd(A + 4 * i),
+                         _mm256_broadcast_sd(B + i1 * n + i), c);
+      }
+      _mm256_storeu_pd(C + 4 * i1, c);
+    }
+  }
+};
+
+template <il::int_t n, il::int_t n1>
+struct StaticDot<double, 6, n, n1> {
+  static void dot(const double* A, const double* B, double* C) {
+    for (il::int_t i1 = 0; i1 < n1; ++i1) {
+      __m256d b = _mm256_broadcast_sd(B + i1 * n);
+      __m256d c0 = _mm256_mul_pd(_mm256_loadu_pd(A), b);
+      __m128d c1 = _mm_mul_pd(_mm_loadu_pd(A + 4), _mm256_castpd256_pd128(b));
+      for (il::int_t i = 1; i < n; ++i) {
+        b = _mm256_broadcast_sd(B + i1 * n + i);
+        c0 = il::fmadd256(_mm256_loadu_pd(A + 6 * i), b, c0);
+        c1 = il::fmadd128(_mm_loadu_pd(A + 6 * i + 4),
+                          _mm256_castpd256_pd128(b), c1);
+      }
+      _mm256_storeu_pd(C + 6 * i1, c0);
+      _mm_storeu_pd(C + 6 * i1 + 4, c1);
+    }
+  }
+};
+
+template <il::int_t n, il::int_t n1>
+struct StaticDot<double, 8, n, n1> {
+  static void dot(const double* A, const double* B, double* C) {
+    for (il::int_t i1 = 0; i1 < n1; ++i1) {
+      __m256d b = _mm256_broadcast_sd(B + i1 * n);
+      __m256d c0 = _mm256_mul_pd(_mm256_loadu_pd(A), b);
+      __m256d c1 = _mm256_mul_pd(_mm256_loadu_pd(A + 4), b);
+      for (il::int_t i = 1; i < n; ++i) {
+        b = _mm256_broadcast_sd(B + i1 * n + i);
+        c0 = il::fmadd256(_mm256_loadu_pd(A + 8 * i), b, c0);
+        c1 = il::fmadd256(_mm256_loadu_pd(A + 8 * i + 4), b, c1);
+      }
+      _mm256_storeu_pd(C + 8 * i1, c0);
+      _mm256_storeu_pd(C + 8 * i1 + 4, c1);
+    }
+  }
+};
+#endif
+
+template <typename T, il::int_t n0, il::int_t n1>
+il::StaticArray2D<T, n1, n0> transpose(const il::StaticArray2D<T, n0, n1>& A) {
+  il::StaticArray2D<T, n1, n0> B{};
+  for (il::int_t i1 = 0; i1 < n1; ++i1) {
+    for (il::int_t i0 = 0; i0 < n0; ++i0) {
+      B(i1, i0) = A(i0, i1);
+    }
+  }
+  return B;
+}
+
+#ifdef __AVX__
+inline il::StaticArray2D<double, 4, 4> transpose(
+    const il::StaticArray2D<double, 4, 4>& A) {
+  const double* a = A.data();
+  const __m256d a0 = _mm256_loadu_pd(a);
+  const __m256d a1 = _mm256_loadu_pd(a + 4);
+  const __m256d a2 = _mm256_loadu_pd(a + 8);
+  const __m256d a3 = _mm256_loadu_pd(a + 12);
+  const __m256d t0 = _mm256_unpacklo_pd(a0, a1);
+  const __m256d t1 = _mm256_unpackhi_pd(a0, a1);
+  const __m256d t2 = _mm256_unpacklo_pd(a2, a3);
+  const __m256d t3 = _mm256_unpackhi_pd(a2, a3);
+
+  il::StaticArray2D<double, 4, 4> B{};
+  double* b = B.Data();
+  _mm256_storeu_pd(b, _mm256_permute2f128_pd(t0, t2, 0x20));
+  _mm256_storeu_pd(b + 4, _mm256_permute2f128_pd(t1, t3, 0x20));
+  _mm256_storeu_pd(b + 8, _mm256_permute2f128_pd(t0, t2, 0x31));
+  _mm256_storeu_pd(b + 12, _mm256_permute2f128_pd(t1, t3, 0x31));
+  return B;
+}
+#endif
+
+/* \brief Compute in place the LU factorization of a small square matrix with
+// partial pivoting
+// \details The factorization has the form A = P.L.U where P is a permutation
+// matrix, L is lower triangular with unit diagonal elements, and U is upper
+// triangular. On exit, A contains L and U, and row k has been interchanged
+// with row pivot[k] at step k, as with LAPACK's getrf (but 0-based). The
+// function returns 0 if U is invertible, and k + 1 if U(k, k) is the first
+// diagonal element of U that is exactly zero.
+*/
+template <typename T, il::int_t n>
+il::int_t luDecomposition(il::io_t, il::StaticArray<il::int_t, n>& pivot,
+                          il::StaticArray2D<T, n, n>& A) {
+  il::int_t info = 0;
+  for (il::int_t k = 0; k < n; ++k) {
+    il::int_t p = k;
+    for (il::int_t i = k + 1; i < n; ++i) {
+      if (std::abs(A(i, k)) > std::abs(A(p, k))) {
+        p = i;
+      }
+    }
+    pivot[k] = p;
+    if (A(p, k) == T{0}) {
+      if (info == 0) {
+        info = k + 1;
+      }
+      continue;
+    }
+    if (p != k) {
+      for (il::int_t j = 0; j < n; ++j) {
+        const T temp = A(k, j);
+        A(k, j) = A(p, j);
+        A(p, j) = temp;
+      }
+    }
+    const T inv_pivot = T{1} / A(k, k);
+    for (il::int_t i = k + 1; i < n; ++i) {
+      A(i, k) *= inv_pivot;
+    }
+    for (il::int_t j = k + 1; j < n; ++j) {
+      const T a = A(k, j);
+      for (il::int_t i = k + 1; i < n; ++i) {
+        A(i, j) -= A(i, k) * a;
+      }
+    }
+  }
+  return info;
+}
+
+/* \brief Compute the inverse of a matrix from its LU factorization
+// \details pivot and lu are the outputs of il::luDecomposition which must have
+// returned 0.
+*/
+template <typename T, il::int_t n>
+il::StaticArray2D<T, n, n> luInverse(const il::StaticArray<il::int_t, n>& pivot,
+                                     const il::StaticArray2D<T, n, n>& lu) {
+  // Row i of P^(-1) is the row row[i] of the identity matrix
+  il::int_t row[n];
+  for (il::int_t i = 0; i < n; ++i) {
+    row[i] = i;
+  }
+  for (il::int_t k = 0; k < n; ++k) {
+    const il::int_t p = pivot[k];
+    const il::int_t temp = row[k];
+    row[k] = row[p];
+    row[p] = temp;
+  }
+  T inv_diag[n];
+  for (il::int_t k = 0; k < n; ++k) {
+    inv_diag[k] = T{1} / lu(k, k);
+  }
+
+  // The rows of the inverse are stored in x so that the inner loops, which
+  // run on whole rows, are vectorized by the compiler
+  T x[n][n];
+  for (il::int_t i = 0; i < n; ++i) {
+    for (il::int_t j = 0; j < n; ++j) {
+      x[i][j] = (row[i] == j) ? T{1} : T{0};
+    }
+  }
+  for (il::int_t k = 0; k < n; ++k) {
+    for (il::int_t i = k + 1; i < n; ++i) {
+      const T a = lu(i, k);
+      for (il::int_t j = 0; j < n; ++j) {
+        x[i][j] -= a * x[k][j];
+      }
+    }
+  }
+  for (il::int_t k = n - 1; k >= 0; --k) {
+    for (il::int_t j = 0; j < n; ++j) {
+      x[k][j] *= inv_diag[k];
+    }
+    for (il::int_t i = 0; i < k; ++i) {
+      const T a = lu(i, k);
+      for (il::int_t j = 0; j < n; ++j) {
+        x[i][j] -= a * x[k][j];
+      }
+    }
+  }
+
+  il::StaticArray2D<T, n, n> X{};
+  for (il::int_t j = 0; j < n; ++j) {
+    for (il::int_t i = 0; i < n; ++i) {
+      X(i, j) = x[i][j];
+    }
+  }
+  return X;
+}
+
+/* \brief Solve in place the system A.x = b from the LU factorization of A
+// \details pivot and lu are the outputs of il::luDecomposition which must have
+// returned 0. On entry, x contains b and on exit it contains the solution.
+*/
+template <typename T, il::int_t n>
+void luSolve(const il::StaticArray<il::int_t, n>& pivot,
+             const il::StaticArray2D<T, n, n>& lu, il::io_t,
+             il::StaticArray<T, n>& x) {
+  for (il::int_t k = 0; k < n; ++k) {
+    const il::int_t p = pivot[k];
+    if (p != k) {
+      const T temp = x[k];
+      x[k] = x[p];
+      x[p] = temp;
+    }
+  }
+  for (il::int_t k = 0; k < n; ++k) {
+    const T y = x[k];
+    for (il::int_t i = k + 1; i < n; ++i) {
+      x[i] -= lu(i, k) * y;
+    }
+  }
+  for (il::int_t k = n - 1; k >= 0; --k) {
+    x[k] /= lu(k, k);
+    const T y = x[k];
+    for (il::int_t i = 0; i < k; ++i) {
+      x[i] -= lu(i, k) * y;
+    }
+  }
+}
+
+template <typename T>
+T det(const il::StaticArray2D<T, 2, 2>& A) {
+  return A(0, 0) * A(1, 1) - A(1, 0) * A(0, 1);
+}
+
+template <typename T>
+T det(const il::StaticArray2D<T, 3, 3>& A) {
+  return A(0, 0) * (A(1, 1) * A(2, 2) - A(2, 1) * A(1, 2)) -
+         A(1, 0) * (A(0, 1) * A(2, 2) - A(2, 1) * A(0, 2)) +
+         A(2, 0) * (A(0, 1) * A(1, 2) - A(1, 1) * A(0, 2));
+}
+
+template <typename T>
+T det(const il::StaticArray2D<T, 4, 4>& A) {
+  // 2 x 2 minors of the first two columns and of the last two columns
+  const T s0 = A(0, 0) * A(1, 1) - A(1, 0) * A(0, 1);
+  const T s1 = A(0, 0) * A(2, 1) - A(2, 0) * A(0, 1);
+  const T s2 = A(0, 0) * A(3, 1) - A(3, 0) * A(0, 1);
+  const T s3 = A(1, 0) * A(2, 1) - A(2, 0) * A(1, 1);
+  const T s4 = A(1, 0) * A(3, 1) - A(3, 0) * A(1, 1);
+  const T s5 = A(2, 0) * A(3, 1) - A(3, 0) * A(2, 1);
+  const T c5 = A(2, 2) * A(3, 3) - A(3, 2) * A(2, 3);
+  const T c4 = A(1, 2) * A(3, 3) - A(3, 2) * A(1, 3);
+  const T c3 = A(1, 2) * A(2, 3) - A(2, 2) * A(1, 3);
+  const T c2 = A(0, 2) * A(3, 3) - A(3, 2) * A(0, 3);
+  const T c1 = A(0, 2) * A(2, 3) - A(2, 2) * A(0, 3);
+  const T c0 = A(0, 2) * A(1, 3) - A(1, 2) * A(0, 3);
+  return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+}
+
+template <typename T, il::int_t n>
+T det(const il::StaticArray2D<T, n, n>& A) {
+  il::StaticArray2D<T, n, n> lu = A;
+  il::StaticArray<il::int_t, n> pivot{};
+  il::luDecomposition(il::io, pivot, lu);
+  T ans = T{1};
+  for (il::int_t k = 0; k < n; ++k) {
+    ans *= (pivot[k] == k) ? lu(k, k) : -lu(k, k);
+  }
+  return ans;
+}
+
+// The matrix A must be invertible
+template <typename T>
+il::StaticArray2D<T, 2, 2> inverse(const il::StaticArray2D<T, 2, 2>& A) {
+  const T inv_det = T{1} / il::det(A);
+  il::StaticArray2D<T, 2, 2> B{};
+  B(0, 0) = A(1, 1) * inv_det;
+  B(1, 0) = -A(1, 0) * inv_det;
+  B(0, 1) = -A(0, 1) * inv_det;
+  B(1, 1) = A(0, 0) * inv_det;
+  return B;
+}
+
+template <typename T>
+il::StaticArray2D<T, 3, 3> inverse(const il::StaticArray2D<T, 3, 3>& A) {
+  il::StaticArray2D<T, 3, 3> B{};
+  B(0, 0) = A(1, 1) * A(2, 2) - A(2, 1) * A(1, 2);
+  B(1, 0) = A(2, 0) * A(1, 2) - A(1, 0) * A(2, 2);
+  B(2, 0) = A(1, 0) * A(2, 1) - A(2, 0) * A(1, 1);
+  B(0, 1) = A(2, 1) * A(0, 2) - A(0, 1) * A(2, 2);
+  B(1, 1) = A(0, 0) * A(2, 2) - A(2, 0) * A(0, 2);
+  B(2, 1) = A(2, 0) * A(0, 1) - A(0, 0) * A(2, 1);
+  B(0, 2) = A(0, 1) * A(1, 2) - A(1, 1) * A(0, 2);
+  B(1, 2) = A(1, 0) * A(0, 2) - A(0, 0) * A(1, 2);
+  B(2, 2) = A(0, 0) * A(1, 1) - A(1, 0) * A(0, 1);
+  const T inv_det =
+      T{1} / (A(0, 0) * B(0, 0) + A(0, 1) * B(1, 0) + A(0, 2) * B(2, 0));
+  for (il::int_t k = 0; k < 9; ++k) {
+    B.Data()[k] *= inv_det;
+  }
+  return B;
+}
+
+template <typename T>
+il::StaticArray2D<T, 4, 4> inverse(const il::StaticArray2D<T, 4, 4>& A) {
+  const T s0 = A(0, 0) * A(1, 1) - A(1, 0) * A(0, 1);
+  const T s1 = A(0, 0) * A(2, 1) - A(2, 0) * A(0, 1);
+  const T s2 = A(0, 0) * A(3, 1) - A(3, 0) * A(0, 1);
+  const T s3 = A(1, 0) * A(2, 1) - A(2, 0) * A(1, 1);
+  const T s4 = A(1, 0) * A(3, 1) - A(3, 0) * A(1, 1);
+  const T s5 = A(2, 0) * A(3, 1) - A(3, 0) * A(2, 1);
+  const T c5 = A(2, 2) * A(3, 3) - A(3, 2) * A(2, 3);
+  const T c4 = A(1, 2) * A(3, 3) - A(3, 2) * A(1, 3);
+  const T c3 = A(1, 2) * A(2, 3) - A(2, 2) * A(1, 3);
+  const T c2 = A(0, 2) * A(3, 3) - A(3, 2) * A(0, 3);
+  const T c1 = A(0, 2) * A(2, 3) - A(2, 2) * A(0, 3);
+  const T c0 = A(0, 2) * A(1, 3) - A(1, 2) * A(0, 3);
+  const T inv_det =
+      T{1} / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+
+  il::StaticArray2D<T, 4, 4> B{};
+  B(0, 0) = (A(1, 1) * c5 - A(2, 1) * c4 + A(3, 1) * c3) * inv_det;
+  B(0, 1) = (-A(0, 1) * c5 + A(2, 1) * c2 - A(3, 1) * c1) * inv_det;
+  B(0, 2) = (A(0, 1) * c4 - A(1, 1) * c2 + A(3, 1) * c0) * inv_det;
+  B(0, 3) = (-A(0, 1) * c3 + A(1, 1) * c1 - A(2, 1) * c0) * inv_det;
+  B(1, 0) = (-A(1, 0) * c5 + A(2, 0) * c4 - A(3, 0) * c3) * inv_det;
+  B(1, 1) = (A(0, 0) * c5 - A(2, 0) * c2 + A(3, 0) * c1) * inv_det;
+  B(1, 2) = (-A(0, 0) * c4 + A(1, 0) * c2 - A(3, 0) * c0) * inv_det;
+  B(1, 3) = (A(0, 0) * c3 - A(1, 0) * c1 + A(2, 0) * c0) * inv_det;
+  B(2, 0) = (A(1, 3) * s5 - A(2, 3) * s4 + A(3, 3) * s3) * inv_det;
+  B(2, 1) = (-A(0, 3) * s5 + A(2, 3) * s2 - A(3, 3) * s1) * inv_det;
+  B(2, 2) = (A(0, 3) * s4 - A(1, 3) * s2 + A(3, 3) * s0) * inv_det;
+  B(2, 3) = (-A(0, 3) * s3 + A(1, 3) * s1 - A(2, 3) * s0) * inv_det;
+  B(3, 0) = (-A(1, 2) * s5 + A(2, 2) * s4 - A(3, 2) * s3) * inv_det;
+  B(3, 1) = (A(0, 2) * s5 - A(2, 2) * s2 + A(3, 2) * s1) * inv_det;
+  B(3, 2) = (-A(0, 2) * s4 + A(1, 2) * s2 - A(3, 2) * s0) * inv_det;
+  B(3, 3) = (A(0, 2) * s3 - A(1, 2) * s1 + A(2, 2) * s0) * inv_det;
+  return B;
+}
+
+template <typename T, il::int_t n>
+il::StaticArray2D<T, n, n> inverse(const il::StaticArray2D<T, n, n>& A) {
+  il::StaticArray2D<T, n, n> lu = A;
+  il::StaticArray<il::int_t, n> pivot{};
+  const il::int_t info = il::luDecomposition(il::io, pivot, lu);
+  IL_EXPECT_FAST(info == 0);
+  IL_UNUSED(info);
+
+  return il::luInverse(pivot, lu);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// blas and dot
+////////////////////////////////////////////////////////////////////////////////
+
 template <typename T, il::int_t n0, il::int_t n1, il::int_t n2>
 void blas(T alpha, const il::StaticArray3D<T, n0, n1, n2> &A, T beta, il::io_t,
           il::StaticArray3D<T, n0, n1, n2> &B) {
@@ -61,11 +470,10 @@ template <typename T, il::int_t n0, il::int_t n>
 void blas(double alpha, const il::StaticArray2D<T, n0, n> &A,
           const il::StaticArray<T, n> &B, double beta, il::io_t,
           il::StaticArray<T, n0> &C) {
+  il::StaticArray<T, n0> AB{};
+  il::StaticDot<T, n0, n, 1>::dot(A.data(), B.data(), AB.Data());
   for (il::int_t i0 = 0; i0 < n0; ++i0) {
-    C[i0] *= beta;
-    for (il::int_t i = 0; i < n; ++i) {
-      C[i0] += alpha * A(i0, i) * B[i];
-    }
+    C[i0] = alpha * AB[i0] + beta * C[i0];
   }
 }
 
@@ -112,12 +520,8 @@ T dot(const il::StaticArray<T, n>& x, const il::StaticArray<T, n>& y) {
 template <typename T, il::int_t n0, il::int_t n>
 il::StaticArray<T, n0> dot(const il::StaticArray2D<T, n0, n>& A,
                            const il::StaticArray<T, n>& B) {
-  il::StaticArray<T, n0> C{0};
-  for (il::int_t i = 0; i < n; ++i) {
-    for (il::int_t i0 = 0; i0 < n0; ++i0) {
-      C[i0] += A(i0, i) * B[i];
-    }
-  }
+  il::StaticArray<T, n0> C{};
+  il::StaticDot<T, n0, n, 1>::dot(A.data(), B.data(), C.Data());
   return C;
 }
 
@@ -153,14 +557,8 @@ il::StaticArray<T, n1> dot(const il::StaticArray<T, n>& A,
 template <typename T, il::int_t n0, il::int_t n, il::int_t n1>
 il::StaticArray2D<T, n0, n1> dot(const il::StaticArray2D<T, n0, n>& A,
                                  const il::StaticArray2D<T, n, n1>& B) {
-  il::StaticArray2D<T, n0, n1> C{0};
-  for (il::int_t i1 = 0; i1 < n1; ++i1) {
-    for (il::int_t i = 0; i < n; ++i) {
-      for (il::int_t i0 = 0; i0 < n0; ++i0) {
-        C(i0, i1) += A(i0, i) * B(i, i1);
-      }
-    }
-  }
+  il::StaticArray2D<T, n0, n1> C{};
+  il::StaticDot<T, n0, n, n1>::dot(A.data(), B.data(), C.Data());
   return C;
 }
 
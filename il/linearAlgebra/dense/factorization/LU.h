@@ -26,6 +26,7 @@
 #include <il/container/2d/LowerArray2D.h>
 #include <il/container/2d/StaticArray2D.h>
 #include <il/container/2d/UpperArray2D.h>
+#include <il/linearAlgebra/dense/blas/blas_static.h>
 #include <il/linearAlgebra/dense/norm.h>
 
 #ifdef IL_MKL
@@ -39,10 +40,13 @@ namespace il {
 template <typename MatrixType>
 class LU {};
 
+// The factorization of small matrices whose size is known at compile time is
+// done with il::luDecomposition which is fully unrolled by the compiler. It is
+// much faster than a call to LAPACK for such matrices.
 template <il::int_t n>
 class LU<il::StaticArray2D<double, n, n>> {
  private:
-  il::StaticArray<lapack_int, n> ipiv_;
+  il::StaticArray<il::int_t, n> ipiv_;
   il::StaticArray2D<double, n, n> lu_;
 
  public:
@@ -55,6 +59,9 @@ class LU<il::StaticArray2D<double, n, n>> {
   // elements, and U is upper triangular.
   LU(il::StaticArray2D<double, n, n> A, il::io_t, il::Status &status);
 
+  // Solve the system of equation with one second member
+  il::StaticArray<double, n> solve(il::StaticArray<double, n> y) const;
+
   // Compute the inverse of the matrix
   il::StaticArray2D<double, n, n> inverse() const;
 
@@ -90,35 +97,31 @@ template <il::int_t n>
 LU<il::StaticArray2D<double, n, n>>::LU(il::StaticArray2D<double, n, n> A,
                                         il::io_t, il::Status &status)
     : ipiv_{}, lu_{} {
-  const int layout = LAPACK_COL_MAJOR;
-  const lapack_int lapack_n = static_cast<lapack_int>(n);
-  il::StaticArray<lapack_int, n> ipiv{};
-  const lapack_int lapack_error = LAPACKE_dgetrf(
-      layout, lapack_n, lapack_n, A.Data(), lapack_n, ipiv.Data());
-  IL_EXPECT_FAST(lapack_error >= 0);
+  il::StaticArray<il::int_t, n> ipiv{};
+  const il::int_t error = il::luDecomposition(il::io, ipiv, A);
 
-  if (lapack_error == 0) {
+  if (error == 0) {
     status.SetOk();
     ipiv_ = ipiv;
     lu_ = A;
   } else {
     status.SetError(il::Error::MatrixSingular);
     IL_SET_SOURCE(status);
-    status.SetInfo("rank", il::int_t{lapack_error - 1});
+    status.SetInfo("rank", il::int_t{error - 1});
   }
 }
 
+template <il::int_t n>
+il::StaticArray<double, n> LU<il::StaticArray2D<double, n, n>>::solve(
+    il::StaticArray<double, n> y) const {
+  il::luSolve(ipiv_, lu_, il::io, y);
+  return y;
+}
+
 template <il::int_t n>
 il::StaticArray2D<double, n, n> LU<il::StaticArray2D<double, n, n>>::inverse()
     const {
-  il::StaticArray2D<double, n, n> inverse = lu_;
-  const int layout = LAPACK_COL_MAJOR;
-  const lapack_int lapack_n = static_cast<lapack_int>(n);
-  const lapack_int lapack_error =
-      LAPACKE_dgetri(layout, lapack_n, inverse.Data(), lapack_n, ipiv_.data());
-  IL_EXPECT_FAST(lapack_error == 0);
-
-  return inverse;
+  return il::luInverse(ipiv_, lu_);
 }
 
 template <il::int_t n>